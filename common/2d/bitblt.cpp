@@ -33,6 +33,8 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "byteutil.h"
 #if DXX_USE_OGL
 #include "ogl_init.h"
+#else
+#include "blit_kernels.h"
 #endif
 
 #include "compiler-range_for.h"
@@ -54,10 +56,7 @@ static void gr_bm_ubitblt0x_rle(grs_canvas &dest, unsigned w, unsigned h, int dx
 #if !DXX_USE_OGL
 static void gr_linear_rep_movsdm(uint8_t *const dest, const uint8_t *const src, const uint_fast32_t num_pixels)
 {
-	auto predicate = [&](uint8_t s, uint8_t d) {
-		return s == 255 ? d : s;
-	};
-	std::transform(src, src + num_pixels, dest, dest, predicate);
+	gr_blit_row_masked(dest, src, num_pixels);
 }
 #endif
 
@@ -473,13 +472,23 @@ static void gr_bitmap_scale_to(const grs_bitmap &src, grs_bitmap &dst)
 	for (uint_fast32_t y = src.bm_h; y; --y) {
 		i = a;
 		c += b;
+		/* Scale each source row once, and copy the scaled row for
+		 * each further destination row it covers.
+		 */
+		const uint8_t *scaled = nullptr;
 		if(c >= h) {
 			c -= h;
 			goto inside;
 		}
 		while(--i>=0) {
 inside:
-			scale_line(s, d, src.bm_w, dst.bm_w);
+			if (scaled)
+				memcpy(d, scaled, dst.bm_w);
+			else
+			{
+				scale_line(s, d, src.bm_w, dst.bm_w);
+				scaled = d;
+			}
 			d += dst.bm_rowsize;
 		}
 		s += src.bm_rowsize;
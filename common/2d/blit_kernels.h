@@ -0,0 +1,231 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * Row kernels for the software bitmap blitters.
+ *
+ * The masked copy is processed in 64-bit words of 8 pixels.  Transparent
+ * pixels are found with a bitwise zero byte test, so a word is copied,
+ * skipped or merged without a branch per pixel.  Lanes are defined by
+ * memory order, so the results do not depend on the byte order of the
+ * host.  Where the compiler can target AVX2, a 32 pixel version is
+ * chosen at runtime if the CPU supports it.
+ *
+ * The RLE expanders copy each run of unique pixels with one memcpy and
+ * each run of one color with one memset.  libc chooses those by CPU
+ * feature itself.
+ *
+ * test-blit-kernels checks every kernel against the per-pixel code it
+ * replaced.  Run it with --log_level=message for timings over common
+ * bitmap sizes.
+ *
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DXX_BLIT_KERNELS_AVX2	1
+#include <immintrin.h>
+#else
+#define DXX_BLIT_KERNELS_AVX2	0
+#endif
+
+namespace dcx {
+
+/* Copy `n` pixels from `src` to `dest`, except those which are 255
+ * (TRANSPARENCY_COLOR), which leave `dest` unchanged.
+ */
+static inline void gr_blit_row_masked_word(uint8_t *dest, const uint8_t *src, std::size_t n)
+{
+	constexpr uint64_t low7 = 0x7f7f7f7f7f7f7f7f;
+	constexpr uint64_t high = ~low7;
+	for (; n >= 8; n -= 8, src += 8, dest += 8)
+	{
+		uint64_t s;
+		std::memcpy(&s, src, sizeof(s));
+		/* A byte of `t` is zero if that pixel is transparent.  Adding
+		 * 0x7f to the low 7 bits of a byte sets its high bit unless they
+		 * are all zero, and cannot carry into the next byte.
+		 */
+		const uint64_t t = ~s;
+		const uint64_t opaque = (((t & low7) + low7) | t) & high;
+		if (opaque == high)
+		{
+			std::memcpy(dest, src, sizeof(s));
+			continue;
+		}
+		if (!opaque)
+			continue;
+		const uint64_t mask = (opaque >> 7) * 0xff;
+		uint64_t d;
+		std::memcpy(&d, dest, sizeof(d));
+		d ^= (d ^ s) & mask;
+		std::memcpy(dest, &d, sizeof(d));
+	}
+	for (; n; --n, ++src, ++dest)
+		if (*src != 255)
+			*dest = *src;
+}
+
+#if DXX_BLIT_KERNELS_AVX2
+/* As gr_blit_row_masked_word, 32 pixels at a time.  Call this only if
+ * the CPU supports AVX2.
+ */
+[[gnu::target("avx2")]]
+static inline void gr_blit_row_masked_avx2(uint8_t *dest, const uint8_t *src, std::size_t n)
+{
+	const __m256i transparent = _mm256_set1_epi8(-1);
+	for (; n >= 32; n -= 32, src += 32, dest += 32)
+	{
+		const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src));
+		const __m256i t = _mm256_cmpeq_epi8(s, transparent);
+		const unsigned m = _mm256_movemask_epi8(t);
+		if (!m)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest), s);
+			continue;
+		}
+		if (m == 0xffffffffu)
+			continue;
+		const __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest), _mm256_blendv_epi8(s, d, t));
+	}
+	gr_blit_row_masked_word(dest, src, n);
+}
+#endif
+
+using gr_blit_row_masked_kernel = void(uint8_t *dest, const uint8_t *src, std::size_t n);
+
+static inline gr_blit_row_masked_kernel *gr_select_blit_row_masked()
+{
+#if DXX_BLIT_KERNELS_AVX2
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		return gr_blit_row_masked_avx2;
+#endif
+	return gr_blit_row_masked_word;
+}
+
+/* Copy a row as gr_blit_row_masked_word does, with the fastest kernel
+ * for this CPU.
+ */
+static inline void gr_blit_row_masked(uint8_t *const dest, const uint8_t *const src, const std::size_t n)
+{
+	static gr_blit_row_masked_kernel *const kernel = gr_select_blit_row_masked();
+	kernel(dest, src, n);
+}
+
+namespace blit_rle {
+
+constexpr uint8_t gr_rle_code = 0xe0;
+constexpr uint8_t gr_not_rle_code = 0x1f;
+constexpr uint8_t gr_rle_transparent = 255;
+static_assert((gr_rle_transparent & gr_rle_code) == gr_rle_code, "transparent pixels must be run coded");
+
+static inline bool gr_is_rle_code(const uint8_t x)
+{
+	return (x & gr_rle_code) == gr_rle_code;
+}
+
+/* Count the unique pixels at the start of `src`, up to `limit`.  The
+ * transparent color is itself an RLE code, so a transparent pixel is
+ * always run coded, and the masked expander can copy unique pixels
+ * without testing them.
+ */
+static inline std::size_t gr_rle_literal_span(const uint8_t *const src, const std::size_t limit)
+{
+	std::size_t n = 0;
+	while (n < limit && !gr_is_rle_code(src[n]))
+		++n;
+	return n;
+}
+
+}
+
+/* Expand pixels x1 to x2 of the RLE row at `src` to `dest`.  If `masked`,
+ * transparent pixels leave `dest` unchanged.
+ */
+template <bool masked>
+static inline void gr_rle_expand_row(uint8_t *dest, const uint8_t *src, const uint_fast32_t x1, const uint_fast32_t x2)
+{
+	using namespace blit_rle;
+	const auto fill = [](uint8_t *const d, const std::size_t count, const uint8_t color) {
+		if (!masked || color != gr_rle_transparent)
+			std::memset(d, color, count);
+	};
+	uint_fast32_t i = 0;
+	uint8_t count;
+	uint8_t color = 0;
+
+	if (x2 < x1)
+		return;
+
+	count = 0;
+	while (i < x1)
+	{
+		color = *src++;
+		if (color == gr_rle_code)
+			return;
+		if (gr_is_rle_code(color))
+		{
+			count = color & gr_not_rle_code;
+			color = *src++;
+		}
+		else
+			// unique
+			count = 1;
+		i += count;
+	}
+	count = i - x1;
+	i = x1;
+	// we know have '*count' pixels of 'color'.
+
+	if (x1 + count > x2)
+	{
+		count = x2 - x1 + 1;
+		fill(dest, count, color);
+		return;
+	}
+
+	fill(dest, count, color);
+	dest += count;
+	i += count;
+
+	while (i <= x2)
+	{
+		if (const auto n = gr_rle_literal_span(src, x2 - i + 1))
+		{
+			std::memcpy(dest, src, n);
+			src += n;
+			dest += n;
+			i += n;
+			continue;
+		}
+		color = *src++;
+		if (color == gr_rle_code)
+			return;
+		if (gr_is_rle_code(color))
+		{
+			count = color & gr_not_rle_code;
+			color = *src++;
+		}
+		else
+			// unique
+			count = 1;
+		// we know have '*count' pixels of 'color'.
+		if (i + count > x2)
+			count = x2 - i + 1;
+		fill(dest, count, color);
+		i += count;
+		dest += count;
+	}
+}
+
+}
@@ -34,7 +34,11 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "gr.h"
 #include "dxxerror.h"
 #include "rle.h"
+#if !DXX_USE_OGL
+#include "texmap.h"
+#endif
 #include "byteutil.h"
+#include "blit_kernels.h"
 
 #include "compiler-range_for.h"
 #include "d_range.h"
@@ -45,6 +49,7 @@ namespace {
 constexpr uint8_t RLE_CODE = 0xe0;
 constexpr uint8_t NOT_RLE_CODE = 0x1f;
 static_assert((RLE_CODE | NOT_RLE_CODE) == 0xff, "RLE mask error");
+static_assert(RLE_CODE == blit_rle::gr_rle_code && NOT_RLE_CODE == blit_rle::gr_not_rle_code && TRANSPARENCY_COLOR == blit_rle::gr_rle_transparent, "RLE kernels use a different encoding");
 static inline int IS_RLE_CODE(const uint8_t &x)
 {
 	return (x & RLE_CODE) == RLE_CODE;
@@ -91,116 +96,13 @@ uint8_t *gr_rle_decode(const color_palette_index *sb, color_palette_index *db, c
 // dest, from source pixels x1 to x2.
 void gr_rle_expand_scanline_masked(uint8_t *dest, const uint8_t *src, const uint_fast32_t x1, const uint_fast32_t x2)
 {
-	int i = 0;
-	ubyte count;
-	ubyte color=0;
-
-	if ( x2 < x1 ) return;
-
-	count = 0;
-	while ( i < x1 )	{
-		color = *src++;
-		if ( color == RLE_CODE ) return;
-		if ( IS_RLE_CODE(color) )	{
-			count = color & NOT_RLE_CODE;
-			color = *src++;
-		} else {
-			// unique
-			count = 1;
-		}
-		i += count;
-	}
-	count = i - x1;
-	i = x1;
-	// we know have '*count' pixels of 'color'.
-	
-	if ( x1+count > x2 )	{
-		count = x2-x1+1;
-		if ( color != TRANSPARENCY_COLOR )	rle_stosb( dest, count, color );
-		return;
-	}
-
-	if ( color != TRANSPARENCY_COLOR )	rle_stosb( dest, count, color );
-	dest += count;
-	i += count;
-
-	while( i <= x2 )
-	{
-		color = *src++;
-		if ( color == RLE_CODE ) return;
-		if ( IS_RLE_CODE(color) )	{
-			count = color & NOT_RLE_CODE;
-			color = *src++;
-		} else {
-			// unique
-			count = 1;
-		}
-		// we know have '*count' pixels of 'color'.
-		if ( i+count <= x2 )	{
-		} else {
-			count = x2-i+1;
-		}
-		if ( color != 255 )rle_stosb( dest, count, color );
-		i += count;
-		dest += count;
-	}
+	gr_rle_expand_row<true>(dest, src, x1, x2);
 }
 #endif
 
 void gr_rle_expand_scanline(uint8_t *dest, const uint8_t *src, const uint_fast32_t x1, const uint_fast32_t x2)
 {
-	int i = 0;
-	ubyte count;
-	ubyte color=0;
-
-	if ( x2 < x1 ) return;
-
-	count = 0;
-	while ( i < x1 )	{
-		color = *src++;
-		if ( color == RLE_CODE ) return;
-		if ( IS_RLE_CODE(color) )	{
-			count = color & NOT_RLE_CODE;
-			color = *src++;
-		} else {
-			// unique
-			count = 1;
-		}
-		i += count;
-	}
-	count = i - x1;
-	i = x1;
-	// we know have '*count' pixels of 'color'.
-	
-	if ( x1+count > x2 )	{
-		count = x2-x1+1;
-		rle_stosb( dest, count, color );
-		return;
-	}
-
-	rle_stosb( dest, count, color );
-	dest += count;
-	i += count;
-
-	while( i <= x2 )		{
-		auto color = *src++;
-		if ( color == RLE_CODE ) return;
-		if ( IS_RLE_CODE(color) )	{
-			count = color & (~RLE_CODE);
-			color = *src++;
-		} else {
-			// unique
-			count = 1;
-		}
-		// we know have '*count' pixels of 'color'.
-		if ( i+count <= x2 )	{
-		} else {
-			count = x2-i+1;
-		}
-		rle_stosb(dest, count, color);
-		i += count;
-		dest += count;
-	}
+	gr_rle_expand_row<false>(dest, src, x1, x2);
 }
 
 namespace {
@@ -461,6 +363,9 @@ grs_bitmap *_rle_expand_texture(const grs_bitmap &bmp)
 	}
 
 	least_recently_used->expanded_bitmap = gr_create_bitmap(bmp.bm_w, bmp.bm_h);
+#if !DXX_USE_OGL
+	tmap_mip_invalidate(*least_recently_used->expanded_bitmap.get());
+#endif
 	rle_expand_texture_sub(bmp, *least_recently_used->expanded_bitmap.get());
 	least_recently_used->rle_bitmap = &bmp;
 	least_recently_used->last_used = rle_counter;
@@ -18,8 +18,10 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 */
 
 #include <span>
+#include <vector>
 #include <stdlib.h>
 #include "rle.h"
+#include "byteutil.h"
 
 namespace dcx {
 
@@ -35,53 +37,76 @@ static int scale_final_pixel_count;
 static int scale_ydelta_minus_1;
 static int scale_whole_step;
 
-static void rls_stretch_scanline_setup( int XDelta, int YDelta );
-static void rls_stretch_scanline(const uint8_t *, uint8_t *);
-
-static void decode_row(const grs_bitmap &bmp, std::array<color_palette_index, 640> &scale_rle_data, const uint_fast32_t y)
-{
-	int offset=4+bmp.bm_h;
-
-	for (const uint_fast32_t b : std::span(&bmp.bm_data[4u], y))
-		offset += b;
-	gr_rle_decode(&bmp.bm_data[offset], scale_rle_data.data(), rle_end(bmp, scale_rle_data));
-}
-
-static void scale_up_bitmap(const grs_bitmap &source_bmp, grs_bitmap &dest_bmp, int x0, int y0, int x1, int y1, fix u0, fix v0,  fix u1, fix v1, int orientation  )
+/* Source column of each destination column.  Every row of a bitmap
+ * samples the same columns, so they are computed once per call, and each
+ * row is then a gather through this table.
+ */
+static std::vector<unsigned> scale_columns;
+
+/* Decoded rows of an RLE bitmap, with one spare transparent pixel for
+ * the upscaling rule, which can sample one column past the last.
+ */
+static std::vector<color_palette_index> scale_rle_row;
+/* Offset in bm_data of the encoded data of each row of an RLE bitmap. */
+static std::vector<unsigned> scale_rle_offsets;
+
+/* The rows of the bitmap being scaled.  An RLE bitmap is decoded a row
+ * at a time, and only for the rows which are sampled, so that a small
+ * sprite costs only the rows it draws and sprites stay out of the
+ * texture mapper's RLE cache.
+ */
+class scale_source_rows
 {
-	fix dv, v;
-	if (orientation & 1) {
-		int	t;
-		t = u0;	u0 = u1;	u1 = t;
+	const grs_bitmap &bmp;
+	const bool rle;
+	int decoded_row = -1;
+public:
+	explicit scale_source_rows(const grs_bitmap &b) :
+		bmp(b), rle(b.get_flag_mask(BM_FLAG_RLE))
+	{
+		if (!rle)
+			return;
+		const bool rle_big = bmp.get_flag_mask(BM_FLAG_RLE_BIG);
+		const auto lengths = &bmp.bm_data[4];
+		unsigned offset = 4 + (rle_big ? bmp.bm_h * 2 : bmp.bm_h);
+		scale_rle_offsets.resize(bmp.bm_h);
+		for (unsigned y = 0; y != bmp.bm_h; ++y)
+		{
+			scale_rle_offsets[y] = offset;
+			offset += rle_big ? GET_INTEL_SHORT(&lengths[y * 2]) : lengths[y];
+		}
+		scale_rle_row.assign(bmp.bm_w + 1, TRANSPARENCY_COLOR);
 	}
-
-	if (orientation & 2) {
-		int	t;
-		t = v0;	v0 = v1;	v1 = t;
-		if (v1 < v0)
-			v0--;
+	const color_palette_index *row(const int y)
+	{
+		if (!rle)
+			return &bmp.bm_data[bmp.bm_rowsize * y];
+		if (y != decoded_row)
+		{
+			decoded_row = y;
+			gr_rle_decode(&bmp.bm_data[scale_rle_offsets[y]], scale_rle_row.data(), {end(bmp), &scale_rle_row[bmp.bm_w]});
+		}
+		return scale_rle_row.data();
 	}
+};
 
-	v = v0;
-
-	dv = (v1-v0) / (y1-y0);
-
-	rls_stretch_scanline_setup(x1 - x0, f2i(u1) - f2i(u0));
-	if ( scale_ydelta_minus_1 < 1 ) return;
-
-	v = v0;
+static void rls_stretch_scanline_setup( int XDelta, int YDelta );
+static void rls_stretch_columns(unsigned first_column);
 
-	for (int y=y0; y<=y1; y++ ) {
-		rls_stretch_scanline(&source_bmp.get_bitmap_data()[source_bmp.bm_rowsize*f2i(v)+f2i(u0)], &dest_bmp.get_bitmap_data()[dest_bmp.bm_rowsize*y+x0]);
-		v += dv;
+static void scale_row(const color_palette_index *const sbits, color_palette_index *dbits, const std::span<const unsigned> columns)
+{
+	for (const auto column : columns)
+	{
+		const auto c = sbits[column];
+		if (c != TRANSPARENCY_COLOR)
+			*dbits = c;
+		dbits++;
 	}
 }
 
-static void scale_up_bitmap_rle(const grs_bitmap &source_bmp, grs_bitmap &dest_bmp, int x0, int y0, int x1, int y1, fix u0, fix v0,  fix u1, fix v1, int orientation  )
+static void scale_up_bitmap(scale_source_rows &source_rows, grs_bitmap &dest_bmp, int x0, int y0, int x1, int y1, fix u0, fix v0,  fix u1, fix v1, int orientation  )
 {
 	fix dv, v;
-	int last_row = -1;
-
 	if (orientation & 1) {
 		int	t;
 		t = u0;	u0 = u1;	u1 = t;
@@ -94,20 +119,18 @@ static void scale_up_bitmap_rle(const grs_bitmap &source_bmp, grs_bitmap &dest_b
 			v0--;
 	}
 
+	v = v0;
+
 	dv = (v1-v0) / (y1-y0);
 
 	rls_stretch_scanline_setup(x1 - x0, f2i(u1) - f2i(u0));
 	if ( scale_ydelta_minus_1 < 1 ) return;
+	rls_stretch_columns(f2i(u0));
 
 	v = v0;
 
-	std::array<color_palette_index, 640> scale_rle_data;
 	for (int y=y0; y<=y1; y++ ) {
-		if ( f2i(v) != last_row )	{
-			last_row = f2i(v);
-			decode_row(source_bmp, scale_rle_data, last_row );
-		}
-		rls_stretch_scanline(&scale_rle_data[f2i(u0)], &dest_bmp.get_bitmap_data()[dest_bmp.bm_rowsize*y+x0]);
+		scale_row(source_rows.row(f2i(v)), &dest_bmp.get_bitmap_data()[dest_bmp.bm_rowsize*y+x0], scale_columns);
 		v += dv;
 	}
 }
@@ -157,28 +180,29 @@ static void rls_stretch_scanline_setup( int XDelta, int YDelta )
 
 }
 
-static void rls_stretch_scanline(const color_palette_index *scale_source_ptr, color_palette_index *scale_dest_ptr)
+/* Compute the source column of each pixel of a stretched scanline.
+ * Each source column fills a run of destination columns, and the runs
+ * are spread over the scanline as a Bresenham line would spread them.
+ */
+static void rls_stretch_columns(const unsigned first_column)
 {
 	int ErrorTerm, initial_count, final_count;
 
-	// Draw the first, partial run of pixels
-
-	auto src_ptr = scale_source_ptr;
-	auto dest_ptr = scale_dest_ptr;
+	scale_columns.clear();
+	auto column = first_column;
 	ErrorTerm = scale_error_term;
 	initial_count = scale_initial_pixel_count;
 	final_count = scale_final_pixel_count;
 
-	const auto process_line = [&dest_ptr, &src_ptr](const unsigned len)
+	const auto process_line = [&column](const unsigned len)
 	{
-		const auto c = *src_ptr++;
-		if (c != TRANSPARENCY_COLOR)
-			std::fill_n(dest_ptr, len, c);
-		dest_ptr += len;
+		scale_columns.insert(scale_columns.end(), len, column++);
 	};
+
+	// The first, partial run of pixels
 	process_line(initial_count);
 
-	// Draw all full runs
+	// All full runs
 
 	for (int j=0; j<scale_ydelta_minus_1; j++) {
 		unsigned len = scale_whole_step;     // run is at least this long
@@ -189,113 +213,51 @@ static void rls_stretch_scanline(const color_palette_index *scale_source_ptr, co
 			ErrorTerm -= scale_adj_down;   // reset the error term
 		}
 
-		// Draw this run o' pixels
 		process_line(len);
 	}
 
-	// Draw the final run of pixels
+	// The final run of pixels
 	process_line(final_count);
 }
 
 // old stuff here...
 
-static void scale_bitmap_c(const grs_bitmap &source_bmp, grs_bitmap &dest_bmp, int x0, int y0, int x1, int y1, fix u0, fix v0,  fix u1, fix v1, int orientation  )
+/* Compute the source column of each of `width` pixels, stepping u by du
+ * per pixel.
+ */
+static void scale_columns_stepped(fix u, const fix du, const unsigned width)
 {
-	fix u, v, du, dv;
-
-	du = (u1-u0) / (x1-x0);
-	dv = (v1-v0) / (y1-y0);
-
-	if (orientation & 1) {
-		u0 = u1;
-		du = -du;
-	}
-
-	if (orientation & 2) {
-		v0 = v1;
-		dv = -dv;
-		if (dv < 0)
-			v0--;
-	}
-
-	v = v0;
-
-	for (int y=y0; y<=y1; y++ ) {
-		auto sbits = &source_bmp.get_bitmap_data()[source_bmp.bm_rowsize*f2i(v)];
-		auto dbits = &dest_bmp.get_bitmap_data()[dest_bmp.bm_rowsize*y+x0];
-		u = u0;
-		v += dv;
-		for (int x=x0; x<=x1; x++ ) {
-			auto c = sbits[u >> 16];
-			if (c != TRANSPARENCY_COLOR)
-				*dbits = c;
-			dbits++;
-			u += du;
-		}
+	scale_columns.resize(width);
+	for (auto &column : scale_columns)
+	{
+		column = f2i(u);
+		u += du;
 	}
 }
 
-static void scale_row_transparent(const std::array<ubyte, 640> &sbits, color_palette_index *dbits, int width, fix u, fix du )
+/* As scale_columns_stepped, but for the upscaling rule which RLE bitmaps
+ * have always used: each pixel takes the column after the one u was in
+ * when u last passed a whole column.
+ */
+static void scale_columns_transparent_up(fix u, const fix du, const unsigned width)
 {
-	const auto dbits_end = &dbits[width-1];
-
-	if ( du < F1_0 )	{
-		// Scaling up.
-		fix next_u;
-		int next_u_int;
-
-		next_u_int = f2i(u)+1;
-		auto c = sbits[next_u_int];
-		next_u = i2f(next_u_int);
-		if ( c != TRANSPARENCY_COLOR ) goto NonTransparent;
-
-Transparent:
-		while (1)	{
-			dbits++;
-			if ( dbits > dbits_end ) return;
-			u += du;
-			if ( u > next_u )	{
-				next_u_int = f2i(u)+1;
-				c = sbits[ next_u_int ];
-				next_u = i2f(next_u_int);
-				if ( c != TRANSPARENCY_COLOR ) goto NonTransparent;
-			}
-		}
-		return;
-
-NonTransparent:
-		while (1)	{
-			*dbits++ = c;
-			if ( dbits > dbits_end ) return;
-			u += du;
-			if ( u > next_u )	{
-				next_u_int = f2i(u)+1;
-				c = sbits[ next_u_int ];
-				next_u = i2f(next_u_int);
-				if ( c == TRANSPARENCY_COLOR ) goto Transparent;
-			}
-		}
-		return;
-
-
-
-	} else {
-		for ( int i=0; i<width; i++ ) {
-			const auto c = sbits[ f2i(u) ];
-
-			if ( c != TRANSPARENCY_COLOR )
-				*dbits = c;
-
-			dbits++;
-			u += du;
+	scale_columns.resize(width);
+	int next_u_int = f2i(u)+1;
+	fix next_u = i2f(next_u_int);
+	for (auto &column : scale_columns)
+	{
+		column = next_u_int;
+		u += du;
+		if ( u > next_u )	{
+			next_u_int = f2i(u)+1;
+			next_u = i2f(next_u_int);
 		}
 	}
 }
 
-static void scale_bitmap_c_rle(const grs_bitmap &source_bmp, grs_bitmap &dest_bmp, int x0, int y0, int x1, int y1, fix u0, fix v0,  fix u1, fix v1, int orientation  )
+static void scale_bitmap_c(scale_source_rows &source_rows, grs_bitmap &dest_bmp, int x0, int y0, int x1, int y1, fix u0, fix v0,  fix u1, fix v1, int orientation, const bool rle)
 {
-	fix du, dv, v;
-	int last_row=-1;
+	fix v, du, dv;
 
 //	Rotation doesn't work because explosions are not square!
 // -- 	if (orientation & 4) {
@@ -321,18 +283,22 @@ static void scale_bitmap_c_rle(const grs_bitmap &source_bmp, grs_bitmap &dest_bm
 
 	v = v0;
 
-	if (v<0) {	//was: Assert(v >= 0);
-		//Int3();   //this should be checked in higher-level routine
-		return;
+	if (rle)
+	{
+		if (v<0) {	//was: Assert(v >= 0);
+			//Int3();   //this should be checked in higher-level routine
+			return;
+		}
+		if (du < F1_0)
+			scale_columns_transparent_up(u0, du, x1-x0+1);
+		else
+			scale_columns_stepped(u0, du, x1-x0+1);
 	}
+	else
+		scale_columns_stepped(u0, du, x1-x0+1);
 
-	std::array<ubyte, 640> scale_rle_data;
 	for (int y=y0; y<=y1; y++ ) {
-		if ( f2i(v) != last_row )	{
-			last_row = f2i(v);
-			decode_row(source_bmp, scale_rle_data, last_row );
-		}
-		scale_row_transparent( scale_rle_data, &dest_bmp.get_bitmap_data()[dest_bmp.bm_rowsize*y+x0], x1-x0+1, u0, du );
+		scale_row(source_rows.row(f2i(v)), &dest_bmp.get_bitmap_data()[dest_bmp.bm_rowsize*y+x0], scale_columns);
 		v += dv;
 	}
 }
@@ -405,18 +371,12 @@ void scale_bitmap(const grs_bitmap &bp, const std::array<grs_point, 3> &vertbuf,
 
 	dtemp = f2i(clipped_u1)-f2i(clipped_u0);
 
-	if (bp.get_flag_mask(BM_FLAG_RLE))
-	{
-		if ( (dtemp < (f2i(clipped_x1)-f2i(clipped_x0))) && (dtemp>0) )
-			scale_up_bitmap_rle(bp, dbp, dx0, dy0, dx1, dy1, clipped_u0, clipped_v0, clipped_u1, clipped_v1, orientation  );
-		else
-			scale_bitmap_c_rle(bp, dbp, dx0, dy0, dx1, dy1, clipped_u0, clipped_v0, clipped_u1, clipped_v1, orientation  );
-	} else {
-		if ( (dtemp < (f2i(clipped_x1)-f2i(clipped_x0))) && (dtemp>0) )
-			scale_up_bitmap(bp, dbp, dx0, dy0, dx1, dy1, clipped_u0, clipped_v0, clipped_u1, clipped_v1, orientation  );
-		else
-			scale_bitmap_c(bp, dbp, dx0, dy0, dx1, dy1, clipped_u0, clipped_v0, clipped_u1, clipped_v1, orientation  );
-	}
+	const bool rle = bp.get_flag_mask(BM_FLAG_RLE);
+	scale_source_rows source(bp);
+	if ( (dtemp < (f2i(clipped_x1)-f2i(clipped_x0))) && (dtemp>0) )
+		scale_up_bitmap(source, dbp, dx0, dy0, dx1, dy1, clipped_u0, clipped_v0, clipped_u1, clipped_v1, orientation  );
+	else
+		scale_bitmap_c(source, dbp, dx0, dy0, dx1, dy1, clipped_u0, clipped_v0, clipped_u1, clipped_v1, orientation, rle);
 }
 
 }
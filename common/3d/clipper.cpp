@@ -10,27 +10,24 @@
 #include "clipper.h"
 #include "dxxerror.h"
 
-#include "compiler-range_for.h"
+#include <algorithm>
 #include <stdexcept>
 
 namespace dcx {
 
 #if !DXX_USE_OGL
-temporary_points_t::temporary_points_t() :
-	free_point_num(0)
-{
-	auto p = &temp_points.front();
-	range_for (auto &f, free_points)
-		f = p++;
-}
-
 namespace {
 
 static g3s_point &get_temp_point(temporary_points_t &t)
 {
-	if (t.free_point_num >= t.free_points.size())
+	g3s_point *pp;
+	if (t.free_point_num)
+		pp = t.free_points[--t.free_point_num];
+	else if (t.used_point_num >= t.temp_points.size())
 		throw std::out_of_range("not enough free points");
-	auto &p = *t.free_points[t.free_point_num++];
+	else
+		pp = &t.temp_points[t.used_point_num++];
+	auto &p = *pp;
 	p.p3_flags = projection_flag::temp_point;
 	return p;
 }
@@ -41,9 +38,9 @@ void temporary_points_t::free_temp_point(g3s_point &p)
 {
 	if (!(p.p3_flags & projection_flag::temp_point))
 		throw std::invalid_argument("freeing non-temporary point");
-	if (--free_point_num >= free_points.size())
+	if (free_point_num >= used_point_num)
 		throw std::out_of_range("too many free points");
-	free_points[free_point_num] = &p;
+	free_points[free_point_num++] = &p;
 	p.p3_flags &= ~projection_flag::temp_point;
 }
 
@@ -204,6 +201,42 @@ const polygon_clip_points &clip_polygon(polygon_clip_points &rsrc,polygon_clip_p
 
 	return *src;		//we swapped after we copied
 }
+
+std::size_t polygon_clip_batch::add(const std::span<g3s_point *const> pointlist, const g3s_codes &cc)
+{
+	if (count == polygons.size())
+		polygons.emplace_back();
+	auto &p = polygons[count];
+	std::copy(pointlist.begin(), pointlist.end(), p.buffers[0].begin());
+	p.current = 0;
+	p.clipped_away = false;
+	p.nv = pointlist.size();
+	p.cc = cc;
+	p.points.clear();
+	return count++;
+}
+
+void polygon_clip_batch::clip()
+{
+	const std::span batch(polygons.data(), count);
+	for (uint8_t plane_step = 1; plane_step < 16; plane_step <<= 1)
+	{
+		const clipping_code plane_flag{plane_step};
+		for (auto &p : batch)
+		{
+			if (p.clipped_away || (p.cc.uor & plane_flag) == clipping_code::None)
+				continue;
+			auto &src = p.buffers[p.current];
+			p.current ^= 1;
+			p.nv = clip_plane(plane_flag, src, p.buffers[p.current], &p.nv, &p.cc, p.points);
+			/* As clip_polygon, leave a polygon which is clipped away in
+			 * the buffer which the last pass wrote.
+			 */
+			if (p.cc.uand != clipping_code::None)
+				p.clipped_away = true;
+		}
+	}
+}
 #endif
 
 }
@@ -24,20 +24,75 @@ struct g3s_point;
 #include "3d.h"
 #include "globvars.h"
 #include <array>
+#include <span>
+#include <vector>
 
 namespace dcx {
 
 struct polygon_clip_points : std::array<g3s_point *, MAX_POINTS_IN_POLY> {};
+/* Points made by clipping.  A freed point is reused, last freed first,
+ * before an unused one is taken from temp_points.  This hands out points
+ * in the same order as a free list filled from temp_points, so clipping
+ * output is unchanged, but clear() resets it without refilling the list.
+ */
 struct temporary_points_t
 {
-	uint_fast32_t free_point_num;
+	uint_fast32_t used_point_num = 0, free_point_num = 0;
 	std::array<g3s_point, MAX_POINTS_IN_POLY> temp_points;
 	std::array<g3s_point *, MAX_POINTS_IN_POLY> free_points;
-	temporary_points_t();
+	void clear()
+	{
+		used_point_num = free_point_num = 0;
+	}
 	void free_temp_point(g3s_point &cp);
 };
 
 const polygon_clip_points &clip_polygon(polygon_clip_points &src,polygon_clip_points &dest,int *nv,g3s_codes *cc,temporary_points_t &);
+
+/* Polygons which are clipped together.  Each plane is applied in turn to
+ * every polygon which still needs it.  Each polygon takes the points made
+ * by clipping it from its own temporary_points_t, so it is clipped
+ * exactly as clip_polygon clips it alone.  The storage for the polygons
+ * is kept from one batch to the next.
+ */
+class polygon_clip_batch
+{
+	struct polygon
+	{
+		std::array<polygon_clip_points, 2> buffers;
+		/* The buffer which holds the polygon as clipped so far */
+		uint8_t current;
+		bool clipped_away;
+		int nv;
+		g3s_codes cc;
+		temporary_points_t points;
+	};
+	std::vector<polygon> polygons;
+	std::size_t count = 0;
+public:
+	/* Start a new batch.  The points of the last batch are reused. */
+	void clear()
+	{
+		count = 0;
+	}
+	/* Add the polygon of `pointlist`, whose codes combine to `cc`.
+	 * Return its index in the batch.
+	 */
+	std::size_t add(std::span<g3s_point *const> pointlist, const g3s_codes &cc);
+	void clip();
+	/* After clip(), the points of polygon `i` and their codes, as
+	 * clip_polygon would have left them.
+	 */
+	std::span<g3s_point *const> points(const std::size_t i) const
+	{
+		auto &p = polygons[i];
+		return std::span(p.buffers[p.current]).first(p.nv);
+	}
+	const g3s_codes &codes(const std::size_t i) const
+	{
+		return polygons[i].cc;
+	}
+};
 void clip_line(g3s_point *&p0, g3s_point *&p1, clipping_code codes_or, temporary_points_t &);
 
 }
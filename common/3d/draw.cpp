@@ -22,6 +22,7 @@
 #endif
 #include "d_enumerate.h"
 #include "d_zip.h"
+#include <algorithm>
 
 namespace dcx {
 
@@ -60,6 +61,15 @@ void g3_set_special_render(tmap_drawer_type tmap_drawer)
 #if !DXX_USE_OGL
 namespace {
 
+/* Points made by clipping, shared by every face and line of the frame.
+ * Each face or line clears it before clipping, and is done with the
+ * points before the next one is drawn.
+ */
+static temporary_points_t Clip_points;
+
+/* The faces of a g3_draw_batch which must be clipped */
+static polygon_clip_batch Clip_batch;
+
 //deal with a clipped line
 static void must_clip_line(const g3_draw_line_context &context, g3s_point *p0, g3s_point *p1, const clipping_code codes_or, temporary_points_t &tp)
 {
@@ -84,8 +94,8 @@ static void must_clip_line(const g3_draw_line_context &context, g3s_point *p0, g
 //draws a line. takes two points.  returns true if drew
 void g3_draw_line(const g3_draw_line_context &context, g3s_point &p0, g3s_point &p1)
 {
-	temporary_points_t tp;
-	g3_draw_line(context, p0, p1, tp);
+	Clip_points.clear();
+	g3_draw_line(context, p0, p1, Clip_points);
 }
 
 void g3_draw_line(const g3_draw_line_context &context, g3s_point &p0, g3s_point &p1, temporary_points_t &tp)
@@ -127,8 +137,8 @@ static void must_clip_tmap_face(grs_canvas &, int nv, g3s_codes cc, grs_bitmap &
 //deal with face that must be clipped
 static void must_clip_flat_face(grs_canvas &canvas, int nv, g3s_codes cc, polygon_clip_points &Vbuf0, polygon_clip_points &Vbuf1, const uint8_t color)
 {
-	temporary_points_t tp;
-	auto &bufptr = clip_polygon(Vbuf0,Vbuf1,&nv,&cc,tp);
+	Clip_points.clear();
+	auto &bufptr = clip_polygon(Vbuf0,Vbuf1,&nv,&cc,Clip_points);
 
 	if (nv > 0 && (cc.uor & clipping_code::behind) == clipping_code::None && cc.uand == clipping_code::None)
 	{
@@ -255,8 +265,8 @@ namespace {
 
 static void must_clip_tmap_face(grs_canvas &canvas, int nv, g3s_codes cc, grs_bitmap &bm, polygon_clip_points &Vbuf0, polygon_clip_points &Vbuf1)
 {
-	temporary_points_t tp;
-	auto &bufptr = clip_polygon(Vbuf0,Vbuf1,&nv,&cc,tp);
+	Clip_points.clear();
+	auto &bufptr = clip_polygon(Vbuf0,Vbuf1,&nv,&cc,Clip_points);
 	if (nv && (cc.uor & clipping_code::behind) == clipping_code::None && cc.uand == clipping_code::None)
 	{
 		for (int i=0;i<nv;i++) {
@@ -282,6 +292,95 @@ free_points:
 
 }
 
+std::span<g3s_point> g3_draw_batch::add(const std::span<cg3s_point *const> pointlist, grs_bitmap *const bm, const uint8_t color)
+{
+	g3s_codes cc;
+	for (const auto p : pointlist)
+	{
+		cc.uand &= p->p3_codes;
+		cc.uor  |= p->p3_codes;
+	}
+	if (cc.uand != clipping_code::None)
+		return {};	//all points off screen
+	const std::size_t first_point = points.size();
+	for (const auto p : pointlist)
+		points.emplace_back(*p);
+	faces.push_back({static_cast<uint32_t>(first_point), static_cast<uint8_t>(pointlist.size()), color, cc, bm, 0});
+	return std::span(points).subspan(first_point);
+}
+
+void g3_draw_batch::add_tmap(const std::span<cg3s_point *const> pointlist, const g3s_uvl *const uvl_list, const g3s_lrgb *const light_rgb, grs_bitmap &bm)
+{
+	for (auto &&[i, p] : enumerate(add(pointlist, &bm, 0)))
+	{
+		p.p3_u = uvl_list[i].u;
+		p.p3_v = uvl_list[i].v;
+		p.p3_l = (light_rgb[i].r+light_rgb[i].g+light_rgb[i].b)/3;
+		p.p3_flags |= projection_flag::uvs | projection_flag::ls;
+	}
+}
+
+void g3_draw_batch::add_poly(const std::span<cg3s_point *const> pointlist, const uint8_t color)
+{
+	add(pointlist, nullptr, color);
+}
+
+void g3_draw_batch::draw(grs_canvas &canvas)
+{
+	auto &clip = Clip_batch;
+	clip.clear();
+	polygon_clip_points vbuf;
+	const auto face_points = [this, &vbuf](const face &f) {
+		for (uint_fast32_t i = 0; i != f.nv; ++i)
+			vbuf[i] = &points[f.first_point + i];
+		return std::span(vbuf).first(f.nv);
+	};
+	for (auto &f : faces)
+		if (f.cc.uor != clipping_code::None)
+			f.clip_index = clip.add(face_points(f), f.cc);
+	clip.clip();
+	for (auto &f : faces)
+	{
+		std::span<g3s_point *const> vertlist;
+		if (f.cc.uor != clipping_code::None)
+		{
+			const auto &cc = clip.codes(f.clip_index);
+			vertlist = clip.points(f.clip_index);
+			if (vertlist.empty() || (cc.uor & clipping_code::behind) != clipping_code::None || cc.uand != clipping_code::None)
+				continue;
+		}
+		else
+			vertlist = face_points(f);
+		/* A face which overflows is not drawn, whether or not it was
+		 * clipped.
+		 */
+		if (!std::ranges::all_of(vertlist, [](g3s_point *const p) {
+			if (!(p->p3_flags&projection_flag::projected))
+				g3_project_point(*p);
+			return !(p->p3_flags&projection_flag::overflow);
+		}))
+		{
+			if (f.bm)
+				Int3();		//should not overflow after clip
+			continue;
+		}
+		if (f.bm)
+			(*tmap_drawer_ptr)(canvas, *f.bm, vertlist);
+		else
+		{
+			std::array<fix, MAX_POINTS_IN_POLY*2> Vertex_list;
+			for (auto &&[i, p] : enumerate(vertlist))
+			{
+				Vertex_list[i*2]   = p->p3_sx;
+				Vertex_list[i*2+1] = p->p3_sy;
+			}
+			gr_upoly_tmap(canvas, vertlist.size(), Vertex_list, f.color);
+		}
+	}
+	faces.clear();
+	points.clear();
+}
+
 //draw a sortof sphere - i.e., the 2d radius is proportional to the 3d
 //radius, but not to the distance from the eye
 void g3_draw_sphere(grs_canvas &canvas, cg3s_point &pnt, const fix rad, const uint8_t color)
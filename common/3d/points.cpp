@@ -10,7 +10,7 @@
  * 
  */
 
-
+#include <algorithm>
 #include "3d.h"
 #include "globvars.h"
 
@@ -49,6 +49,27 @@ clipping_code g3_rotate_point(g3s_point &dest,const vms_vector &src)
 	return g3_code_point(dest);
 }
 
+void g3_rotate_point_list(const std::span<g3s_point> dest, const std::span<const vms_vector> src)
+{
+	/* Rotate in blocks, so that the rotation runs over contiguous arrays
+	 * and the coding runs over the results.
+	 */
+	constexpr std::size_t block_size = 16;
+	std::array<vms_vector, block_size> rotated;
+	for (std::size_t i = 0; i < src.size(); i += block_size)
+	{
+		const auto n = std::min(block_size, src.size() - i);
+		vm_vec_rotate_list(rotated, src.subspan(i, n), View_position, View_matrix);
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			auto &p = dest[i + j];
+			p.p3_vec = rotated[j];
+			p.p3_flags = {};	//no projected
+			g3_code_point(p);
+		}
+	}
+}
+
 //checks for overflow & divides if ok, fillig in r
 //returns true if div is ok, else false
 std::optional<int32_t> checkmuldiv(fix a,fix b,fix c)
@@ -30,6 +30,35 @@ PFNGLCLIENTWAITSYNCPROC glClientWaitSyncFunc = NULL;
 /* GL_EXT_texture_filter_anisotropic */
 GLfloat ogl_maxanisotropy = 0.0f;
 
+/* OpenGL 2.0 shader objects */
+bool ogl_have_shaders = false;
+PFNDXXGLCREATESHADERPROC glCreateShaderFunc = NULL;
+PFNDXXGLSHADERSOURCEPROC glShaderSourceFunc = NULL;
+PFNDXXGLCOMPILESHADERPROC glCompileShaderFunc = NULL;
+PFNDXXGLGETSHADERIVPROC glGetShaderivFunc = NULL;
+PFNDXXGLGETSHADERINFOLOGPROC glGetShaderInfoLogFunc = NULL;
+PFNDXXGLDELETESHADERPROC glDeleteShaderFunc = NULL;
+PFNDXXGLCREATEPROGRAMPROC glCreateProgramFunc = NULL;
+PFNDXXGLATTACHSHADERPROC glAttachShaderFunc = NULL;
+PFNDXXGLLINKPROGRAMPROC glLinkProgramFunc = NULL;
+PFNDXXGLGETPROGRAMIVPROC glGetProgramivFunc = NULL;
+PFNDXXGLGETPROGRAMINFOLOGPROC glGetProgramInfoLogFunc = NULL;
+PFNDXXGLDELETEPROGRAMPROC glDeleteProgramFunc = NULL;
+PFNDXXGLUSEPROGRAMPROC glUseProgramFunc = NULL;
+PFNDXXGLGETUNIFORMLOCATIONPROC glGetUniformLocationFunc = NULL;
+PFNDXXGLUNIFORM1IPROC glUniform1iFunc = NULL;
+PFNDXXGLUNIFORM1FPROC glUniform1fFunc = NULL;
+PFNDXXGLUNIFORM3FPROC glUniform3fFunc = NULL;
+PFNDXXGLUNIFORM4FVPROC glUniform4fvFunc = NULL;
+
+/* OpenGL 1.5 buffer objects */
+bool ogl_have_buffer_objects = false;
+PFNDXXGLGENBUFFERSPROC glGenBuffersFunc = NULL;
+PFNDXXGLDELETEBUFFERSPROC glDeleteBuffersFunc = NULL;
+PFNDXXGLBINDBUFFERPROC glBindBufferFunc = NULL;
+PFNDXXGLBUFFERDATAPROC glBufferDataFunc = NULL;
+PFNDXXGLBUFFERSUBDATAPROC glBufferSubDataFunc = NULL;
+
 namespace {
 
 static std::array<long, 2> parse_version_str(const char *v)
@@ -142,6 +171,55 @@ void ogl_extensions_init()
 		s = "DXX-Rebirth: OpenGL: GL_ARB_sync not available";
 	}
 	con_puts(CON_VERBOSE, s);
+
+	/* OpenGL 2.0 shader objects
+	 * GL_ARB_shader_objects exports these under different names, so only
+	 * a core 2.0 context is used.  OpenGL ES 1.x has no shaders.
+	 */
+	ogl_have_shaders = false;
+	if (is_supported(extension_str, version, "GL_ARB_shader_objects", 2, 0, -1, -1) == SUPPORT_CORE) {
+		glCreateShaderFunc = reinterpret_cast<PFNDXXGLCREATESHADERPROC>(SDL_GL_GetProcAddress("glCreateShader"));
+		glShaderSourceFunc = reinterpret_cast<PFNDXXGLSHADERSOURCEPROC>(SDL_GL_GetProcAddress("glShaderSource"));
+		glCompileShaderFunc = reinterpret_cast<PFNDXXGLCOMPILESHADERPROC>(SDL_GL_GetProcAddress("glCompileShader"));
+		glGetShaderivFunc = reinterpret_cast<PFNDXXGLGETSHADERIVPROC>(SDL_GL_GetProcAddress("glGetShaderiv"));
+		glGetShaderInfoLogFunc = reinterpret_cast<PFNDXXGLGETSHADERINFOLOGPROC>(SDL_GL_GetProcAddress("glGetShaderInfoLog"));
+		glDeleteShaderFunc = reinterpret_cast<PFNDXXGLDELETESHADERPROC>(SDL_GL_GetProcAddress("glDeleteShader"));
+		glCreateProgramFunc = reinterpret_cast<PFNDXXGLCREATEPROGRAMPROC>(SDL_GL_GetProcAddress("glCreateProgram"));
+		glAttachShaderFunc = reinterpret_cast<PFNDXXGLATTACHSHADERPROC>(SDL_GL_GetProcAddress("glAttachShader"));
+		glLinkProgramFunc = reinterpret_cast<PFNDXXGLLINKPROGRAMPROC>(SDL_GL_GetProcAddress("glLinkProgram"));
+		glGetProgramivFunc = reinterpret_cast<PFNDXXGLGETPROGRAMIVPROC>(SDL_GL_GetProcAddress("glGetProgramiv"));
+		glGetProgramInfoLogFunc = reinterpret_cast<PFNDXXGLGETPROGRAMINFOLOGPROC>(SDL_GL_GetProcAddress("glGetProgramInfoLog"));
+		glDeleteProgramFunc = reinterpret_cast<PFNDXXGLDELETEPROGRAMPROC>(SDL_GL_GetProcAddress("glDeleteProgram"));
+		glUseProgramFunc = reinterpret_cast<PFNDXXGLUSEPROGRAMPROC>(SDL_GL_GetProcAddress("glUseProgram"));
+		glGetUniformLocationFunc = reinterpret_cast<PFNDXXGLGETUNIFORMLOCATIONPROC>(SDL_GL_GetProcAddress("glGetUniformLocation"));
+		glUniform1iFunc = reinterpret_cast<PFNDXXGLUNIFORM1IPROC>(SDL_GL_GetProcAddress("glUniform1i"));
+		glUniform1fFunc = reinterpret_cast<PFNDXXGLUNIFORM1FPROC>(SDL_GL_GetProcAddress("glUniform1f"));
+		glUniform3fFunc = reinterpret_cast<PFNDXXGLUNIFORM3FPROC>(SDL_GL_GetProcAddress("glUniform3f"));
+		glUniform4fvFunc = reinterpret_cast<PFNDXXGLUNIFORM4FVPROC>(SDL_GL_GetProcAddress("glUniform4fv"));
+		ogl_have_shaders = glCreateShaderFunc && glShaderSourceFunc && glCompileShaderFunc && glGetShaderivFunc && glGetShaderInfoLogFunc && glDeleteShaderFunc &&
+			glCreateProgramFunc && glAttachShaderFunc && glLinkProgramFunc && glGetProgramivFunc && glGetProgramInfoLogFunc && glDeleteProgramFunc &&
+			glUseProgramFunc && glGetUniformLocationFunc && glUniform1iFunc && glUniform1fFunc && glUniform3fFunc && glUniform4fvFunc;
+	}
+	con_puts(CON_VERBOSE, ogl_have_shaders
+		? "DXX-Rebirth: OpenGL: shader objects available"
+		: "DXX-Rebirth: OpenGL: shader objects not available");
+
+	/* OpenGL 1.5 buffer objects
+	 * GL_ARB_vertex_buffer_object exports these with an ARB suffix, so
+	 * only core support is used.  OpenGL ES 1.1 has them in core.
+	 */
+	ogl_have_buffer_objects = false;
+	if (is_supported(extension_str, version, "GL_ARB_vertex_buffer_object", 1, 5, 1, 1) == SUPPORT_CORE) {
+		glGenBuffersFunc = reinterpret_cast<PFNDXXGLGENBUFFERSPROC>(SDL_GL_GetProcAddress("glGenBuffers"));
+		glDeleteBuffersFunc = reinterpret_cast<PFNDXXGLDELETEBUFFERSPROC>(SDL_GL_GetProcAddress("glDeleteBuffers"));
+		glBindBufferFunc = reinterpret_cast<PFNDXXGLBINDBUFFERPROC>(SDL_GL_GetProcAddress("glBindBuffer"));
+		glBufferDataFunc = reinterpret_cast<PFNDXXGLBUFFERDATAPROC>(SDL_GL_GetProcAddress("glBufferData"));
+		glBufferSubDataFunc = reinterpret_cast<PFNDXXGLBUFFERSUBDATAPROC>(SDL_GL_GetProcAddress("glBufferSubData"));
+		ogl_have_buffer_objects = glGenBuffersFunc && glDeleteBuffersFunc && glBindBufferFunc && glBufferDataFunc && glBufferSubDataFunc;
+	}
+	con_puts(CON_VERBOSE, ogl_have_buffer_objects
+		? "DXX-Rebirth: OpenGL: buffer objects available"
+		: "DXX-Rebirth: OpenGL: buffer objects not available");
 }
 
 }
@@ -0,0 +1,302 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/* OpenGL light shader:
+ * evaluate the dynamic lights of the current frame per pixel on the GPU,
+ * instead of accumulating them per vertex on the CPU.
+ */
+
+#include <array>
+#include <memory>
+
+#include "args.h"
+#include "console.h"
+#include "ogl_extensions.h"
+#include "ogl_lighting.h"
+#include "vers_id.h"
+#include "common/3d/globvars.h"
+
+namespace dcx {
+
+namespace {
+
+#define DXX_LIGHT_SHADER_MAX_LIGHTS	32
+static_assert(OGL_MAX_SHADER_LIGHTS == DXX_LIGHT_SHADER_MAX_LIGHTS);
+
+/* Points reach the fragment shader in view coordinates, with z negated,
+ * scaled by Matrix_scale as g3_rotate_point scales them.  Level mesh
+ * faces get there through the modelview matrix; everything else is
+ * submitted already transformed.  Lights are submitted in the same
+ * orientation, but unscaled, so the fragment shader undoes the scaling
+ * of the point before measuring distances.
+ *
+ * The arithmetic matches apply_light: a light adds emission / distance,
+ * with the distance at least 4, to points within its range.  Headlights
+ * reach eight times as far, add only emission / (scale * distance)
+ * outside their cone and add cos^2 * emission / 8 inside it.
+ */
+constexpr char light_vertex_shader[] =
+"#version 110\n"
+"varying vec3 position;\n"
+"void main()\n"
+"{\n"
+"	position = (gl_ModelViewMatrix * gl_Vertex).xyz;\n"
+"	gl_FrontColor = gl_Color;\n"
+"	gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;\n"
+"	gl_Position = ftransform();\n"
+"}\n";
+
+constexpr char light_fragment_shader[] =
+"#version 110\n"
+"#define MAX_LIGHTS " DXX_STRINGIZE(DXX_LIGHT_SHADER_MAX_LIGHTS) "\n"
+"uniform sampler2D texture0;\n"
+"uniform int light_count;\n"
+"uniform float light_limit;\n"
+"uniform vec3 view_unscale;\n"
+"uniform vec4 light_position[MAX_LIGHTS];\n"	/* xyz, range */
+"uniform vec4 light_color[MAX_LIGHTS];\n"	/* rgb, headlight scale */
+"uniform vec4 light_direction[MAX_LIGHTS];\n"	/* xyz, cone range */
+"varying vec3 position;\n"
+"void main()\n"
+"{\n"
+"	vec3 point = position * view_unscale;\n"
+"	vec3 dynamic_light = vec3(0.0);\n"
+"	for (int i = 0; i < MAX_LIGHTS; ++i)\n"
+"	{\n"
+"		if (i >= light_count)\n"
+"			break;\n"
+"		vec3 to_point = point - light_position[i].xyz;\n"
+"		float dist = length(to_point);\n"
+"		float headlight_scale = light_color[i].w;\n"
+"		if ((headlight_scale > 0.0 ? dist / 8.0 : dist) >= light_position[i].w)\n"
+"			continue;\n"
+"		float clamped_dist = max(dist, 4.0);\n"
+"		if (headlight_scale > 0.0)\n"
+"		{\n"
+"			float cosine = dist > 0.0 ? dot(to_point, light_direction[i].xyz) / dist : 0.0;\n"
+"			if (cosine < 0.5)\n"
+"				dynamic_light += light_color[i].rgb / (headlight_scale * clamped_dist);\n"
+"			else if (clamped_dist < light_direction[i].w)\n"
+"				dynamic_light += light_color[i].rgb * (cosine * cosine / 8.0);\n"
+"		}\n"
+"		else\n"
+"			dynamic_light += light_color[i].rgb / clamped_dist;\n"
+"	}\n"
+"	vec3 light = min(gl_Color.rgb + dynamic_light * light_limit, vec3(light_limit));\n"
+"	gl_FragColor = texture2D(texture0, gl_TexCoord[0].st) * vec4(light, gl_Color.a);\n"
+"}\n";
+
+#undef DXX_LIGHT_SHADER_MAX_LIGHTS
+
+enum class light_shader_state : uint8_t
+{
+	unbuilt,
+	built,
+	failed,
+};
+
+struct light_shader_uniforms
+{
+	GLint light_count, light_limit, view_unscale, light_position, light_color, light_direction;
+};
+
+static light_shader_state Light_shader_state;
+static GLuint Light_shader_program;
+static light_shader_uniforms Light_shader_uniforms;
+static bool Light_shader_frame_active;
+static unsigned Num_shader_lights;
+static std::array<ogl_shader_light, OGL_MAX_SHADER_LIGHTS> Shader_lights;
+
+static void report_shader_log(const char *const what, const GLuint object, const PFNDXXGLGETSHADERIVPROC get_iv, const PFNDXXGLGETSHADERINFOLOGPROC get_log)
+{
+	GLint length = 0;
+	get_iv(object, GL_INFO_LOG_LENGTH, &length);
+	if (length <= 1)
+	{
+		con_printf(CON_NORMAL, "DXX-Rebirth: OpenGL: failed to build light shader %s", what);
+		return;
+	}
+	const auto log = std::make_unique<GLchar[]>(length);
+	get_log(object, length, nullptr, log.get());
+	con_printf(CON_NORMAL, "DXX-Rebirth: OpenGL: failed to build light shader %s: %s", what, log.get());
+}
+
+static GLuint compile_shader(const GLenum type, const char *const source, const char *const what)
+{
+	const auto shader = glCreateShaderFunc(type);
+	if (!shader)
+		return 0;
+	glShaderSourceFunc(shader, 1, &source, nullptr);
+	glCompileShaderFunc(shader);
+	GLint status = GL_FALSE;
+	glGetShaderivFunc(shader, GL_COMPILE_STATUS, &status);
+	if (status != GL_TRUE)
+	{
+		report_shader_log(what, shader, glGetShaderivFunc, glGetShaderInfoLogFunc);
+		glDeleteShaderFunc(shader);
+		return 0;
+	}
+	return shader;
+}
+
+static GLuint link_program()
+{
+	const auto vertex_shader = compile_shader(GL_VERTEX_SHADER, light_vertex_shader, "vertex shader");
+	if (!vertex_shader)
+		return 0;
+	const auto fragment_shader = compile_shader(GL_FRAGMENT_SHADER, light_fragment_shader, "fragment shader");
+	if (!fragment_shader)
+	{
+		glDeleteShaderFunc(vertex_shader);
+		return 0;
+	}
+	auto program = glCreateProgramFunc();
+	if (program)
+	{
+		glAttachShaderFunc(program, vertex_shader);
+		glAttachShaderFunc(program, fragment_shader);
+		glLinkProgramFunc(program);
+		GLint status = GL_FALSE;
+		glGetProgramivFunc(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			report_shader_log("program", program, glGetProgramivFunc, glGetProgramInfoLogFunc);
+			glDeleteProgramFunc(program);
+			program = 0;
+		}
+	}
+	/* The program keeps the shaders alive as long as it needs them. */
+	glDeleteShaderFunc(vertex_shader);
+	glDeleteShaderFunc(fragment_shader);
+	return program;
+}
+
+static bool build_light_shader()
+{
+	const auto program = link_program();
+	if (!program)
+		return false;
+	const auto uniform = [program](const char *const name) {
+		return glGetUniformLocationFunc(program, name);
+	};
+	Light_shader_uniforms = {
+		uniform("light_count"),
+		uniform("light_limit"),
+		uniform("view_unscale"),
+		uniform("light_position"),
+		uniform("light_color"),
+		uniform("light_direction"),
+	};
+	glUseProgramFunc(program);
+	glUniform1iFunc(uniform("texture0"), 0);
+	glUseProgramFunc(0);
+	Light_shader_program = program;
+	return true;
+}
+
+static std::array<GLfloat, 3> view_vector(const vms_vector &v)
+{
+	return {{f2fl(v.x), f2fl(v.y), -f2fl(v.z)}};
+}
+
+}
+
+bool ogl_light_shader_enabled()
+{
+	switch (Light_shader_state)
+	{
+		case light_shader_state::built:
+			return true;
+		case light_shader_state::failed:
+			return false;
+		case light_shader_state::unbuilt:
+		default:
+			break;
+	}
+	if (!CGameArg.OglLightShader || !ogl_have_shaders || !build_light_shader())
+	{
+		if (CGameArg.OglLightShader)
+			con_puts(CON_NORMAL, "DXX-Rebirth: OpenGL: light shader not available, using per vertex lighting");
+		Light_shader_state = light_shader_state::failed;
+		return false;
+	}
+	con_puts(CON_VERBOSE, "DXX-Rebirth: OpenGL: using light shader");
+	Light_shader_state = light_shader_state::built;
+	return true;
+}
+
+void ogl_light_shader_clear_lights()
+{
+	Num_shader_lights = 0;
+}
+
+bool ogl_light_shader_add_light(const ogl_shader_light &light)
+{
+	if (Num_shader_lights >= Shader_lights.size())
+		return false;
+	Shader_lights[Num_shader_lights++] = light;
+	return true;
+}
+
+void ogl_light_shader_begin_frame(const float light_limit)
+{
+	if (!ogl_light_shader_enabled())
+		return;
+	std::array<std::array<GLfloat, 4>, OGL_MAX_SHADER_LIGHTS> position, color, direction;
+	for (unsigned i = 0; i < Num_shader_lights; ++i)
+	{
+		auto &l = Shader_lights[i];
+		const auto p = view_vector(vm_vec_rotate(vm_vec_sub(l.pos, View_position), Unscaled_matrix));
+		position[i] = {{p[0], p[1], p[2], f2fl(l.range)}};
+		color[i] = {{f2fl(l.emission.r), f2fl(l.emission.g), f2fl(l.emission.b), f2fl(l.headlight_scale)}};
+		const auto d = view_vector(vm_vec_rotate(l.fvec, Unscaled_matrix));
+		direction[i] = {{d[0], d[1], d[2], f2fl(l.cone_range)}};
+	}
+	auto &u = Light_shader_uniforms;
+	glUseProgramFunc(Light_shader_program);
+	glUniform1iFunc(u.light_count, Num_shader_lights);
+	glUniform1fFunc(u.light_limit, light_limit);
+	glUniform3fFunc(u.view_unscale, 1 / f2fl(Matrix_scale.x), 1 / f2fl(Matrix_scale.y), 1 / f2fl(Matrix_scale.z));
+	if (Num_shader_lights)
+	{
+		glUniform4fvFunc(u.light_position, Num_shader_lights, position.front().data());
+		glUniform4fvFunc(u.light_color, Num_shader_lights, color.front().data());
+		glUniform4fvFunc(u.light_direction, Num_shader_lights, direction.front().data());
+	}
+	glUseProgramFunc(0);
+	Light_shader_frame_active = true;
+}
+
+void ogl_light_shader_end_frame()
+{
+	Light_shader_frame_active = false;
+}
+
+bool ogl_light_shader_bind()
+{
+	if (!Light_shader_frame_active)
+		return false;
+	glUseProgramFunc(Light_shader_program);
+	return true;
+}
+
+void ogl_light_shader_unbind()
+{
+	glUseProgramFunc(0);
+}
+
+void ogl_smash_light_shader()
+{
+	if (Light_shader_state != light_shader_state::built)
+		return;
+	glDeleteProgramFunc(Light_shader_program);
+	Light_shader_program = 0;
+	Light_shader_frame_active = false;
+	Light_shader_state = light_shader_state::unbuilt;
+}
+
+}
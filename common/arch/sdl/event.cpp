@@ -33,9 +33,23 @@ namespace dcx {
 
 namespace {
 
+/* Static windows are still drawn this often, so that blinking cursors,
+ * scrolling list items and menus which poll the network from their draw
+ * handlers keep working while there is no input.
+ */
+constexpr fix static_window_redraw_interval = F1_0 / 10;
+/* Longest single wait for input, so that EVENT_IDLE handlers, which also
+ * poll the network, still run several times per static redraw.
+ */
+constexpr fix idle_wait_interval = F1_0 / 30;
+
+static bool Redraw_requested = true;
+static fix64 Next_static_redraw;
+
 struct event_poll_state
 {
 	uint8_t clean_uniframe = 1;
+	uint8_t received_input = 0;
 	const window *const front_window = window_get_front();
 	window_event_result highest_result = window_event_result::ignored;
 	void process_event_batch(ranges::subrange<const SDL_Event *>);
@@ -54,8 +68,12 @@ static void windowevent_handler(const SDL_WindowEvent &windowevent)
 			{
 				const d_window_size_event e{windowevent.data1, windowevent.data2};
 				event_send(e);
+				event_request_redraw();
 				break;
 			}
+		case SDL_WINDOWEVENT_EXPOSED:
+			event_request_redraw();
+			break;
 	}
 }
 #endif
@@ -100,6 +118,8 @@ window_event_result event_poll()
 		if (state.highest_result == window_event_result::deleted)
 			break;
 	}
+	if (state.received_input)
+		event_request_redraw();
 	// Send the idle event if there were no other events (or they were ignored)
 	if (state.highest_result == window_event_result::ignored)
 	{
@@ -177,6 +197,7 @@ void event_poll_state::process_event_batch(const ranges::subrange<const SDL_Even
 			default:
 				continue;
 		}
+		received_input = 1;
 		highest_result = std::max(result, highest_result);
 	}
 }
@@ -197,6 +218,45 @@ void event_flush()
 	}
 }
 
+void event_request_redraw()
+{
+	Redraw_requested = true;
+}
+
+namespace {
+
+/* Animated windows are drawn on every pass.  If all visible windows are
+ * static, they are drawn only after input, after a window is created,
+ * closed or shown, or once static_window_redraw_interval has passed.
+ */
+static bool event_redraw_due(const fix64 now)
+{
+	if (Redraw_requested || now >= Next_static_redraw)
+		return true;
+	for (auto wind = window_get_first(); wind; wind = window_get_next(*wind))
+		if (wind->is_visible() && wind->is_animated())
+			return true;
+	return false;
+}
+
+static void event_wait(const fix64 timeout)
+{
+	const auto ms = static_cast<int>((timeout * 1000) / F1_0);
+	if (ms <= 0)
+		return;
+#if SDL_MAJOR_VERSION == 1
+	/* SDL 1.2 cannot wait for an event with a timeout, so sleep in short
+	 * steps to keep input responsive.
+	 */
+	SDL_Delay(std::min(ms, 10));
+#elif SDL_MAJOR_VERSION == 2
+	// The event is left in the queue for the next event_poll
+	SDL_WaitEventTimeout(nullptr, ms);
+#endif
+}
+
+}
+
 window_event_result call_default_handler(const d_event &event)
 {
 	return standard_handler(event);
@@ -245,6 +305,19 @@ window_event_result event_process(void)
 	if ((highest_result == window_event_result::deleted) || (window_get_front() != wind))
 		return highest_result;
 
+	// Nothing on screen changed, so sleep until input arrives instead
+	// of drawing the same frame again
+	if (const auto now = timer_query(); !event_redraw_due(now))
+	{
+		event_wait(std::min<fix64>(Next_static_redraw - now, idle_wait_interval));
+		return highest_result;
+	}
+	else
+	{
+		Redraw_requested = false;
+		Next_static_redraw = now + static_window_redraw_interval;
+	}
+
 	const d_event event{EVENT_WINDOW_DRAW};	// then draw all visible windows
 	for (wind = window_get_first(); wind != nullptr;)
 	{
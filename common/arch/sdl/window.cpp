@@ -42,6 +42,7 @@ void window::send_creation_events()
 	if (FrontWindow)
 		FrontWindow->next = this;
 	FrontWindow = this;
+	event_request_redraw();
 	if (prev_front)
 		prev_front->send_event(d_event{EVENT_WINDOW_DEACTIVATED});
 	this->send_event(d_create_event{});
@@ -84,6 +85,7 @@ int window_close(window *wind)
 
 	if (result != window_event_result::deleted)	// don't attempt to re-delete
 		delete wind;
+	event_request_redraw();
 
 	if (const auto prev = window_get_front())
 		prev->send_event(d_event{EVENT_WINDOW_ACTIVATED});
@@ -123,6 +125,7 @@ void window_select(window &wind)
 	FrontWindow->next = &wind;
 	wind.next = nullptr;
 	FrontWindow = &wind;
+	event_request_redraw();
 	
 	if (wind.is_visible())
 	{
@@ -136,6 +139,7 @@ window *window::set_visible(uint8_t visible)
 {
 	window *prev = window_get_front();
 	w_visible = visible;
+	event_request_redraw();
 	auto wind = window_get_front();	// get the new front window
 	if (wind == prev)
 		return wind;
@@ -0,0 +1,76 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+#include "editor/vertex_segment_index.h"
+#include "d_enumerate.h"
+#include "d_underlying_value.h"
+
+namespace dcx {
+
+void vertex_segment_index::add(const segnum_t segnum, const segment_verts &verts)
+{
+	for (const auto &&[relvnum, v] : enumerate(verts))
+	{
+		const std::size_t vi = underlying_value(v);
+		if (vi >= by_vertex.size())
+			by_vertex.resize(vi + 1);
+		by_vertex[vi].push_back({segnum, relvnum});
+	}
+}
+
+void vertex_segment_index::remove(const segnum_t segnum, const segment_verts &verts)
+{
+	for (const auto v : verts)
+	{
+		auto &segs = by_vertex[underlying_value(v)];
+		std::erase_if(segs, [segnum](const incidence &i) { return i.segnum == segnum; });
+	}
+}
+
+void vertex_segment_index::reindex(const segnum_t segnum, const segment_verts *const verts)
+{
+	if (segnum >= indexed.size())
+		indexed.resize(static_cast<std::size_t>(segnum) + 1);
+	auto &old = indexed[segnum];
+	if (!verts)
+	{
+		if (old)
+		{
+			remove(segnum, *old);
+			old.reset();
+		}
+		return;
+	}
+	if (old)
+	{
+		if (*old == *verts)
+			return;
+		remove(segnum, *old);
+	}
+	old = *verts;
+	add(segnum, *verts);
+}
+
+void vertex_segment_index::truncate(const std::size_t segment_count)
+{
+	/* Segments past the end of the mine are no longer in use. */
+	for (std::size_t i = segment_count; i < indexed.size(); ++i)
+		if (const auto &old = indexed[i])
+			remove(static_cast<segnum_t>(i), *old);
+	if (segment_count < indexed.size())
+		indexed.resize(segment_count);
+}
+
+std::span<const vertex_segment_index::incidence> vertex_segment_index::segments_at(const vertnum_t vnum) const
+{
+	const std::size_t vi = underlying_value(vnum);
+	if (vi >= by_vertex.size())
+		return {};
+	return by_vertex[vi];
+}
+
+}
@@ -34,6 +34,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "fwd-gr.h"
 #include <array>
 #include <span>
+#include <vector>
 
 #if DXX_USE_OGL
 #if defined(__APPLE__) && defined(__MACH__)
@@ -228,6 +229,10 @@ static inline g3s_point g3_rotate_point(const vms_vector &src)
 	return g3_rotate_point(dest, src), dest;
 }
 
+//rotates each of src into the same element of dest, as g3_rotate_point
+//does.  dest must be as long as src
+void g3_rotate_point_list(std::span<g3s_point> dest, std::span<const vms_vector> src);
+
 //projects a point
 void g3_project_point(g3s_point &point);
 
@@ -322,6 +327,45 @@ static inline void g3_check_and_draw_tmap(grs_canvas &canvas, const std::array<c
 	g3_check_and_draw_tmap(canvas, N, pointlist, uvl_list, light_rgb, bm);
 }
 
+#if !DXX_USE_OGL
+/* Faces which are drawn together, in the order they were added.  The
+ * faces which must be clipped are clipped as one batch before any is
+ * drawn.  Each face keeps a copy of its points, taken when it is added,
+ * so the caller may change or rotate the points before draw().  What
+ * draw() draws is exactly what _g3_draw_tmap and _g3_draw_poly would have
+ * drawn for each face when it was added.
+ */
+class g3_draw_batch
+{
+	struct face
+	{
+		uint32_t first_point;
+		uint8_t nv;
+		/* The color of a flat face */
+		uint8_t color;
+		g3s_codes cc;
+		/* The bitmap of a texture-mapped face, or nullptr for a flat
+		 * face
+		 */
+		grs_bitmap *bm;
+		/* The index of the face among those which draw() clips */
+		uint32_t clip_index;
+	};
+	std::vector<g3s_point> points;
+	std::vector<face> faces;
+	std::span<g3s_point> add(std::span<cg3s_point *const> pointlist, grs_bitmap *bm, uint8_t color);
+public:
+	void add_tmap(std::span<cg3s_point *const> pointlist, const g3s_uvl *uvl_list, const g3s_lrgb *light_rgb, grs_bitmap &bm);
+	void add_poly(std::span<cg3s_point *const> pointlist, uint8_t color);
+	bool empty() const
+	{
+		return faces.empty();
+	}
+	/* Draw the faces and empty the batch */
+	void draw(grs_canvas &);
+};
+#endif
+
 //draws a line. takes two points.
 #if !DXX_USE_OGL
 struct temporary_points_t;
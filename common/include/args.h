@@ -45,6 +45,8 @@ enum SyncGLMethod : uint8_t {
 
 #endif
 
+#define INSET_VIEW_INTERVAL_DEFAULT	1		/* frames */
+
 // Struct that keeps all variables used by FindArg
 // Prefixes are:
 //   Sys - System Options
@@ -76,9 +78,15 @@ struct CArg : prohibit_void_ptr<CArg>
 	bool SysLowMem;
 	int8_t SysUsePlayersDir;
 	bool SysAutoRecordDemo;
+	bool SysRecordPackedDemo;
+	bool SysPackDemos;
 	bool SysWindow;
 	bool SysAutoDemo;
 	bool GfxSkipHiresFNT;
+	uint8_t GfxAdaptiveMinDetail;
+	uint8_t GfxAdaptiveMaxDetail;
+	uint16_t GfxAdaptiveFPS;
+	uint16_t SysExportDemoFPS;
 	bool SndNoSound;
 	bool SndNoMusic;
 	bool SysNoBorders;
@@ -97,6 +105,8 @@ struct CArg : prohibit_void_ptr<CArg>
 	bool OglFixedFont;
 	SyncGLMethod OglSyncMethod;
 	bool OglDarkEdges;
+	bool OglLightShader;
+	bool OglNoLevelMesh;
 	bool DbgUseOldTextureMerge;
 	bool DbgGlIntensity4Ok;
 	bool DbgGlReadPixelsOk;
@@ -108,9 +118,12 @@ struct CArg : prohibit_void_ptr<CArg>
 	uint8_t OglStereoView;
 #endif
 	unsigned OglSyncWait;
+	uint16_t OglTextureBudget;
 #else
 	bool DbgSdlHWSurface;
 	bool DbgSdlASyncBlit;
+	bool DbgSdlNoMipmap;
+	bool DbgSdlNoSpanCoverage;
 #endif
 	bool DbgNoRun;
 	bool DbgNoDoubleBuffer;
@@ -125,6 +138,8 @@ struct CArg : prohibit_void_ptr<CArg>
 	int SysMaxFPS;
 	uint16_t MplUdpHostPort;
 	uint16_t MplUdpMyPort;
+	uint16_t MplUdpInterpDelay;
+	uint8_t MplUdpSyncWindow;
 #if DXX_USE_TRACKER
 	uint16_t MplTrackerPort;
 	std::string MplTrackerAddr;
@@ -133,6 +148,8 @@ struct CArg : prohibit_void_ptr<CArg>
 	std::string SysHogDir;
 	std::string SysPilot;
 	std::string SysRecordDemoNameTemplate;
+	std::string SysExportDemo;
+	std::string SysExportDemoFile;
 	std::string MplUdpHostAddr;
 	std::string DbgAltTex;
 #if !DXX_USE_OGL
@@ -153,6 +170,9 @@ struct Arg : prohibit_void_ptr<Arg>
 	bool SysNoMovies;
 	bool GfxSkipHiresMovie;
 	bool GfxSkipHiresGFX;
+	uint8_t GfxInsetInterval;
+	uint8_t GfxInsetScale;
+	uint8_t GfxMovieThreads;
 	sound_sample_rate SndDigiSampleRate;
 	std::string EdiAutoLoad;
 	bool EdiSaveHoardData;
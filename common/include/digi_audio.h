@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <span>
 #include "maths.h"
 
 #ifdef __cplusplus
@@ -29,6 +30,14 @@ void digi_audio_set_channel_pan(sound_channel, sound_pan);
 void digi_audio_stop_sound(sound_channel);
 void digi_audio_end_sound(sound_channel);
 void digi_audio_set_digi_volume(int);
+/* Demo export mixes the sound itself, so that the audio keeps pace with
+ * game time instead of with the device.  Starting a capture pauses the
+ * device and returns the sample rate of the 8 bit stereo mix, or 0 if
+ * there is no sound to capture.
+ */
+unsigned digi_audio_start_capture();
+void digi_audio_capture(std::span<uint8_t>);
+void digi_audio_stop_capture();
 }
 #endif
 
@@ -10,6 +10,7 @@
 
 #include "segment.h"
 #include "editor/editor.h"
+#include "editor/vertex_segment_index.h"
 #include <array>
 
 #if defined(DXX_BUILD_DESCENT_I) || defined(DXX_BUILD_DESCENT_II)
@@ -45,3 +46,9 @@ extern selected_segment_array_t Selected_segs;		// List of segment numbers curre
 struct warning_segment_array_t : public count_segment_array_t {};
 
 extern warning_segment_array_t Warning_segs;		// List of warning-worthy segments
+
+namespace dcx {
+
+extern vertex_segment_index Vertex_segments;
+
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+#pragma once
+
+#include "fwd-segment.h"
+#include "d_array.h"
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace dcx {
+
+/* For each vertex, the segments which use it and where in each segment
+ * it is.  Editor operations on the neighbourhood of a vertex use this
+ * instead of searching every segment.  Editor functions which change
+ * the mine report what they changed, and refresh() must be called before
+ * the next query to apply those changes.
+ */
+class vertex_segment_index
+{
+public:
+	struct incidence
+	{
+		segnum_t segnum;
+		segment_relative_vertnum relvnum;
+	};
+	using segment_verts = enumerated_array<vertnum_t, MAX_VERTICES_PER_SEGMENT, segment_relative_vertnum>;
+	/* Bring the index up to date with the segments reported changed
+	 * since the last refresh.  After invalidate(), segments 0 to
+	 * `segment_count` - 1 are all compared against the index instead.
+	 * `verts_of(segnum)` returns the vertices of a segment, or nullptr
+	 * if the segment is not in use.
+	 */
+	template <typename F>
+		void refresh(std::size_t segment_count, F &&verts_of);
+#ifdef dsx
+	void refresh(fvcsegptridx &vcsegptridx);
+#endif
+	/* Editor functions which change the vertices of a known set of
+	 * segments report each one here.
+	 */
+	void note_segment_changed(const segnum_t segnum)
+	{
+		if (!stale)
+			changed.push_back(segnum);
+	}
+	/* Editor functions which add, delete or renumber segments, or
+	 * which change vertices throughout the mine, request a full rescan
+	 * on the next refresh.
+	 */
+	void invalidate()
+	{
+		stale = true;
+		changed.clear();
+	}
+	[[nodiscard]]
+	std::span<const incidence> segments_at(vertnum_t vnum) const;
+private:
+	std::vector<std::vector<incidence>> by_vertex;
+	/* The vertices of each segment when it was last indexed, or empty
+	 * if the segment was not in use.
+	 */
+	std::vector<std::optional<segment_verts>> indexed;
+	std::vector<segnum_t> changed;
+	bool stale = true;
+	void reindex(segnum_t segnum, const segment_verts *verts);
+	void truncate(std::size_t segment_count);
+	void add(segnum_t segnum, const segment_verts &verts);
+	void remove(segnum_t segnum, const segment_verts &verts);
+};
+
+template <typename F>
+void vertex_segment_index::refresh(const std::size_t segment_count, F &&verts_of)
+{
+	if (!stale)
+	{
+		for (const auto segnum : changed)
+			reindex(segnum, verts_of(segnum));
+		changed.clear();
+		return;
+	}
+	for (std::size_t i = 0; i < segment_count; ++i)
+	{
+		const segnum_t segnum{static_cast<uint16_t>(i)};
+		reindex(segnum, verts_of(segnum));
+	}
+	truncate(segment_count);
+	changed.clear();
+	stale = false;
+}
+
+}
@@ -142,6 +142,10 @@ struct d_event_end_loop : d_event
 fix event_get_idle_seconds();
 #endif
 
+// Draw all visible windows on the next pass of the event loop, even if
+// they are all static
+void event_request_redraw();
+
 // Process all events until the front window is deleted
 // Won't work if there's the possibility of another window on top
 // without its own event loop
@@ -411,6 +411,17 @@ void gr_palette_step_up(int r, int g, int b);
 color_palette_index gr_find_closest_color(int r, int g, int b);
 color_palette_index gr_find_closest_color_15bpp(int rgb);
 void gr_flip();
+#if !DXX_USE_OGL
+/* gr_flip presents the whole canvas, unless the frame called
+ * gr_flip_partial and then gr_flip_dirty_rect for every area it changed
+ * since the previous flip.  gr_flip_count changes at each flip and
+ * whenever the canvas is cleared by a palette load, so a caller can tell
+ * whether the canvas still holds what it drew in an earlier frame.
+ */
+void gr_flip_partial();
+void gr_flip_dirty_rect(int x, int y, unsigned w, unsigned h);
+unsigned gr_flip_count();
+#endif
 
 /*
  * must return 0 if windowed, 1 if fullscreen
@@ -33,20 +33,12 @@ void vm_vec_add2 (vms_vector &dest, const vms_vector &src);
 void vm_vec_sub2 (vms_vector &dest, const vms_vector &src);
 void vm_vec_avg (vms_vector &dest, const vms_vector &src0, const vms_vector &src1);
 vms_vector &vm_vec_scale (vms_vector &dest, fix s);
-void vm_vec_divide(vms_vector &dest, const vms_vector &src, fix d);
 
 #define vm_vec_copy_scale(A,B,...)	vm_vec_copy_scale(A, ## __VA_ARGS__, B)
 vms_vector &vm_vec_copy_scale (vms_vector &dest, const vms_vector &src, fix s);
 void vm_vec_scale_add (vms_vector &dest, const vms_vector &src1, const vms_vector &src2, fix k);
-void vm_vec_scale_add2 (vms_vector &dest, const vms_vector &src, fix k);
 void vm_vec_scale2 (vms_vector &dest, fix n, fix d);
 
-[[nodiscard]]
-vm_magnitude_squared vm_vec_mag2(const vms_vector &v);
-
-[[nodiscard]]
-vm_magnitude vm_vec_mag(const vms_vector &v);
-
 [[nodiscard]]
 vm_distance vm_vec_dist(const vms_vector &v0, const vms_vector &v1);
 
@@ -67,12 +59,8 @@ vm_magnitude vm_vec_normalize(vms_vector &v);
 vm_magnitude vm_vec_copy_normalize_quick(vms_vector &dest, const vms_vector &src);
 
 vm_magnitude vm_vec_normalize_quick(vms_vector &v);
-vm_magnitude vm_vec_normalized_dir (vms_vector &dest, const vms_vector &end, const vms_vector &start);
 vm_magnitude vm_vec_normalized_dir_quick (vms_vector &dest, const vms_vector &end, const vms_vector &start);
 
-[[nodiscard]]
-fix vm_vec_dot (const vms_vector &v0, const vms_vector &v1);
-
 void vm_vec_cross (vms_vector &dest, const vms_vector &src0, const vms_vector &src1);
 
 void vm_vec_normal (vms_vector &dest, const vms_vector &p0, const vms_vector &p1, const vms_vector &p2);
@@ -92,7 +80,6 @@ void vm_vec_ang_2_matrix (vms_matrix &m, const vms_vector &v, fixang a);
 #endif
 
 void vm_vector_2_matrix (vms_matrix &m, const vms_vector &fvec, const vms_vector *uvec, const vms_vector *rvec);
-void vm_vec_rotate (vms_vector &dest, const vms_vector &src, const vms_matrix &m);
 void _vm_matrix_x_matrix (vms_matrix &dest, const vms_matrix &src0, const vms_matrix &src1);
 void vm_extract_angles_matrix (vms_angvec &a, const vms_matrix &m);
 void vm_extract_angles_vector (vms_angvec &a, const vms_vector &v);
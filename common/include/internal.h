@@ -51,4 +51,10 @@ void ogl_swap_buffers_internal();
 #endif
 }
 
+#ifdef dsx
+namespace dsx {
+void ogl_reload_texture_list_internal();
+}
+#endif
+
 #endif
@@ -135,6 +135,7 @@
 #define glClearColor dglClearColor
 #define glColor4f dglColor4f
 #define glColorPointer dglColorPointer
+#define glCopyTexSubImage2D dglCopyTexSubImage2D
 #define glCullFace dglCullFace
 #define glDeleteTextures dglDeleteTextures
 #define glDepthFunc dglDepthFunc
@@ -180,6 +181,7 @@ typedef void (OGLFUNCCALL *glClear_fp)(GLbitfield mask);
 typedef void (OGLFUNCCALL *glClearColor_fp)(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha);
 typedef void (OGLFUNCCALL *glColor4f_fp)(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
 typedef void (OGLFUNCCALL *glColorPointer_fp)(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer);
+typedef void (OGLFUNCCALL *glCopyTexSubImage2D_fp)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
 typedef void (OGLFUNCCALL *glCullFace_fp)(GLenum mode);
 typedef void (OGLFUNCCALL *glDeleteTextures_fp)(GLsizei n, const GLuint *textures);
 typedef void (OGLFUNCCALL *glDepthFunc_fp)(GLenum func);
@@ -234,6 +236,7 @@ DEFVAR glClear_fp dglClear;
 DEFVAR glClearColor_fp dglClearColor;
 DEFVAR glColor4f_fp dglColor4f;
 DEFVAR glColorPointer_fp dglColorPointer;
+DEFVAR glCopyTexSubImage2D_fp dglCopyTexSubImage2D;
 DEFVAR glCullFace_fp dglCullFace;
 DEFVAR glDeleteTextures_fp dglDeleteTextures;
 DEFVAR glDepthFunc_fp dglDepthFunc;
@@ -371,6 +374,7 @@ bool OpenGL_LoadLibrary(bool load, const char *OglLibPath)
 		dglClearColor = reinterpret_cast<glClearColor_fp>(dll_GetSymbol(OpenGLModuleHandle,"glClearColor"));
 		dglColor4f = reinterpret_cast<glColor4f_fp>(dll_GetSymbol(OpenGLModuleHandle,"glColor4f"));
 		dglColorPointer = reinterpret_cast<glColorPointer_fp>(dll_GetSymbol(OpenGLModuleHandle,"glColorPointer"));
+		dglCopyTexSubImage2D = reinterpret_cast<glCopyTexSubImage2D_fp>(dll_GetSymbol(OpenGLModuleHandle,"glCopyTexSubImage2D"));
 		dglCullFace = reinterpret_cast<glCullFace_fp>(dll_GetSymbol(OpenGLModuleHandle,"glCullFace"));
 		dglDeleteTextures = reinterpret_cast<glDeleteTextures_fp>(dll_GetSymbol(OpenGLModuleHandle,"glDeleteTextures"));
 		dglDepthFunc = reinterpret_cast<glDepthFunc_fp>(dll_GetSymbol(OpenGLModuleHandle,"glDepthFunc"));
@@ -422,6 +426,7 @@ static void OpenGL_SetFuncsToNull(void)
 	dglClearColor = NULL;
 	dglColor4f = NULL;
 	dglColorPointer = NULL;
+	dglCopyTexSubImage2D = NULL;
 	dglCullFace = NULL;
 	dglDeleteTextures = NULL;
 	dglDepthFunc = NULL;
@@ -96,7 +96,12 @@ static constexpr int f2ir(const fix &f)
 
 //multiply two fixes, return a fix(64)
 [[nodiscard]]
-fix64 fixmul64 (fix a, fix b);
+static inline fix64 fixmul64(const fix a, const fix b)
+{
+	const fix64 a64 = a;
+	const fix64 b64 = b;
+	return (a64 * b64) / 65536;
+}
 
 /* On x86/amd64 for Windows/Linux, truncating fix64->fix is free. */
 [[nodiscard]]
@@ -107,11 +112,23 @@ static inline fix fixmul(fix a, fix b)
 
 //divide two fixes, return a fix
 [[nodiscard]]
-fix fixdiv (fix a, fix b);
+static inline fix fixdiv(const fix a, const fix b)
+{
+	if (!b)
+		return 1;
+	const fix64 a64 = a;
+	return static_cast<fix>((a64 * 65536) / b);
+}
 
 //multiply two fixes, then divide by a third, return a fix
 [[nodiscard]]
-fix fixmuldiv (fix a, fix b, fix c);
+static inline fix fixmuldiv(const fix a, const fix b, const fix c)
+{
+	if (!c)
+		return 1;
+	const fix64 a64 = a;
+	return static_cast<fix>((a64 * b) / c);
+}
 
 //multiply two fixes, and add 64-bit product to a quadint
 static inline void fixmulaccum (quadint * q, const fix &a, const fix &b)
@@ -143,17 +160,43 @@ struct fix_sincos_result
 	fix sin, cos;
 };
 
+extern const std::array<int16_t, 256> sincos_table;
+
+/* Interpolate sincos_table at entry `idx0`, `mul` 256ths of the way to
+ * the next entry.
+ */
 [[nodiscard]]
-fix_sincos_result fix_sincos(fixang);
+static inline fix fix_sincos_interpolate(const uint8_t idx0, const signed mul)
+{
+	const fix t0 = sincos_table[idx0];
+	/* `idx1` is `uint8_t` to truncate the value, since sincos_table is
+	 * only 256 elements long.
+	 */
+	const uint8_t idx1 = idx0 + 1;
+	const fix t1 = sincos_table[idx1];
+	return (t0 + (((t1 - t0) * mul) >> 8)) << 2;
+}
 
-//compute sine and cosine of an angle, filling in the variables
-//either of the pointers can be NULL
+//compute sine and cosine of an angle, with interpolation
+[[nodiscard]]
+static inline fix_sincos_result fix_sincos(const fixang a)
+{
+	const uint8_t idx = static_cast<uint8_t>(a >> 8);
+	const signed mul = static_cast<uint8_t>(a);
+	return {fix_sincos_interpolate(idx, mul), fix_sincos_interpolate(static_cast<uint8_t>(idx + 64), mul)};
+}
 
 [[nodiscard]]
-fix fix_sin(fixang a);
+static inline fix fix_sin(const fixang a)
+{
+	return fix_sincos_interpolate(static_cast<uint8_t>(a >> 8), static_cast<uint8_t>(a));
+}
 
 [[nodiscard]]
-fix fix_cos(fixang a);
+static inline fix fix_cos(const fixang a)
+{
+	return fix_sincos_interpolate(static_cast<uint8_t>((a >> 8) + 64), static_cast<uint8_t>(a));
+}
 
 [[nodiscard]]
 fix fix_fastsin(fixang a);	//no interpolation
@@ -177,7 +220,6 @@ fixang fix_atan2 (fix cos, fix sin);
 std::optional<int32_t> checkmuldiv(fix a, fix b, fix divisor);
 
 extern const std::array<uint8_t, 256> guess_table;
-extern const std::array<int16_t, 256> sincos_table;
 extern const std::array<ushort, 258> asin_table;
 extern const std::array<ushort, 258> acos_table;
 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #if defined(__APPLE__) && defined(__MACH__)
@@ -47,6 +48,65 @@ typedef void (APIENTRYP PFNGLWAITSYNCPROC) (GLsync sync, GLbitfield flags, GLuin
 #define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
 #define GL_TIMEOUT_EXPIRED                0x911B
 
+/* OpenGL 2.0 shader objects
+ * The pointer types are named separately from those in glext.h, because
+ * the constness of some parameters differs between versions of that
+ * header.
+ */
+typedef char GLchar;
+
+typedef GLuint (APIENTRYP PFNDXXGLCREATESHADERPROC) (GLenum type);
+typedef void (APIENTRYP PFNDXXGLSHADERSOURCEPROC) (GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length);
+typedef void (APIENTRYP PFNDXXGLCOMPILESHADERPROC) (GLuint shader);
+typedef void (APIENTRYP PFNDXXGLGETSHADERIVPROC) (GLuint shader, GLenum pname, GLint *params);
+typedef void (APIENTRYP PFNDXXGLGETSHADERINFOLOGPROC) (GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+typedef void (APIENTRYP PFNDXXGLDELETESHADERPROC) (GLuint shader);
+typedef GLuint (APIENTRYP PFNDXXGLCREATEPROGRAMPROC) (void);
+typedef void (APIENTRYP PFNDXXGLATTACHSHADERPROC) (GLuint program, GLuint shader);
+typedef void (APIENTRYP PFNDXXGLLINKPROGRAMPROC) (GLuint program);
+typedef void (APIENTRYP PFNDXXGLGETPROGRAMIVPROC) (GLuint program, GLenum pname, GLint *params);
+typedef void (APIENTRYP PFNDXXGLGETPROGRAMINFOLOGPROC) (GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog);
+typedef void (APIENTRYP PFNDXXGLDELETEPROGRAMPROC) (GLuint program);
+typedef void (APIENTRYP PFNDXXGLUSEPROGRAMPROC) (GLuint program);
+typedef GLint (APIENTRYP PFNDXXGLGETUNIFORMLOCATIONPROC) (GLuint program, const GLchar *name);
+typedef void (APIENTRYP PFNDXXGLUNIFORM1IPROC) (GLint location, GLint v0);
+typedef void (APIENTRYP PFNDXXGLUNIFORM1FPROC) (GLint location, GLfloat v0);
+typedef void (APIENTRYP PFNDXXGLUNIFORM3FPROC) (GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+typedef void (APIENTRYP PFNDXXGLUNIFORM4FVPROC) (GLint location, GLsizei count, const GLfloat *value);
+
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER                0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER                  0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS                 0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS                    0x8B82
+#endif
+#ifndef GL_INFO_LOG_LENGTH
+#define GL_INFO_LOG_LENGTH                0x8B84
+#endif
+
+/* OpenGL 1.5 buffer objects
+ * std::ptrdiff_t stands in for GLsizeiptr and GLintptr, which not every
+ * gl.h defines.
+ */
+typedef void (APIENTRYP PFNDXXGLGENBUFFERSPROC) (GLsizei n, GLuint *buffers);
+typedef void (APIENTRYP PFNDXXGLDELETEBUFFERSPROC) (GLsizei n, const GLuint *buffers);
+typedef void (APIENTRYP PFNDXXGLBINDBUFFERPROC) (GLenum target, GLuint buffer);
+typedef void (APIENTRYP PFNDXXGLBUFFERDATAPROC) (GLenum target, std::ptrdiff_t size, const void *data, GLenum usage);
+typedef void (APIENTRYP PFNDXXGLBUFFERSUBDATAPROC) (GLenum target, std::ptrdiff_t offset, std::ptrdiff_t size, const void *data);
+
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER                   0x8892
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW                    0x88E4
+#endif
+
 /* GL_EXT_texture */
 #ifndef GL_VERSION_1_1
 #ifdef GL_EXT_texture
@@ -71,6 +131,33 @@ extern PFNGLDELETESYNCPROC glDeleteSyncFunc;
 extern PFNGLCLIENTWAITSYNCPROC glClientWaitSyncFunc;
 extern GLfloat ogl_maxanisotropy;
 
+extern bool ogl_have_shaders;
+extern PFNDXXGLCREATESHADERPROC glCreateShaderFunc;
+extern PFNDXXGLSHADERSOURCEPROC glShaderSourceFunc;
+extern PFNDXXGLCOMPILESHADERPROC glCompileShaderFunc;
+extern PFNDXXGLGETSHADERIVPROC glGetShaderivFunc;
+extern PFNDXXGLGETSHADERINFOLOGPROC glGetShaderInfoLogFunc;
+extern PFNDXXGLDELETESHADERPROC glDeleteShaderFunc;
+extern PFNDXXGLCREATEPROGRAMPROC glCreateProgramFunc;
+extern PFNDXXGLATTACHSHADERPROC glAttachShaderFunc;
+extern PFNDXXGLLINKPROGRAMPROC glLinkProgramFunc;
+extern PFNDXXGLGETPROGRAMIVPROC glGetProgramivFunc;
+extern PFNDXXGLGETPROGRAMINFOLOGPROC glGetProgramInfoLogFunc;
+extern PFNDXXGLDELETEPROGRAMPROC glDeleteProgramFunc;
+extern PFNDXXGLUSEPROGRAMPROC glUseProgramFunc;
+extern PFNDXXGLGETUNIFORMLOCATIONPROC glGetUniformLocationFunc;
+extern PFNDXXGLUNIFORM1IPROC glUniform1iFunc;
+extern PFNDXXGLUNIFORM1FPROC glUniform1fFunc;
+extern PFNDXXGLUNIFORM3FPROC glUniform3fFunc;
+extern PFNDXXGLUNIFORM4FVPROC glUniform4fvFunc;
+
+extern bool ogl_have_buffer_objects;
+extern PFNDXXGLGENBUFFERSPROC glGenBuffersFunc;
+extern PFNDXXGLDELETEBUFFERSPROC glDeleteBuffersFunc;
+extern PFNDXXGLBINDBUFFERPROC glBindBufferFunc;
+extern PFNDXXGLBUFFERDATAPROC glBufferDataFunc;
+extern PFNDXXGLBUFFERSUBDATAPROC glBufferSubDataFunc;
+
 /* Global initialization:
  * will need an OpenGL context and intialize all function pointers.
  */
@@ -104,10 +104,42 @@ bool ogl_ubitblt(unsigned w, unsigned h, unsigned dx, unsigned dy, unsigned sx,
 void ogl_upixelc(const grs_bitmap &, unsigned x, unsigned y, color_palette_index c);
 color_palette_index ogl_ugpixel(const grs_bitmap &bitmap, unsigned x, unsigned y);
 void ogl_ulinec(grs_canvas &, int left, int top, int right, int bot, int c);
+
+/* A copy of part of the frame buffer, kept in a texture */
+struct ogl_canvas_capture
+{
+	GLuint handle = 0;
+	unsigned generation = 0;
+	unsigned w = 0, h = 0, tw = 0, th = 0;
+};
+/* Copy the w x h area at the top left of the canvas */
+void ogl_capture_canvas(const grs_canvas &, unsigned w, unsigned h, ogl_canvas_capture &);
+/* Draw the capture scaled to fill the canvas.  Returns false if there is
+ * nothing to draw, because nothing was captured or the textures were
+ * reset since then.
+ */
+bool ogl_draw_canvas_capture(grs_canvas &, const ogl_canvas_capture &);
+void ogl_free_canvas_capture(ogl_canvas_capture &);
 }
 #ifdef dsx
 namespace dsx {
 void ogl_cache_level_textures();
+
+/* Level mesh: the positions and texture coordinates of every segment
+ * side, kept in a GPU buffer so that they need not be sent each frame.
+ * It is built when the level is loaded, and each side is uploaded again
+ * if it has changed when it is next drawn.
+ */
+void ogl_build_level_mesh();
+/* Between these calls, ogl_draw_level_face draws with the view of the
+ * current frame.
+ */
+void ogl_level_mesh_begin_frame();
+void ogl_level_mesh_end_frame();
+/* Draw face `facenum` of a side, with `nv` vertices, as render_face
+ * would.  Returns false if the caller must draw it itself.
+ */
+bool ogl_draw_level_face(grs_canvas &, vcsegidx_t segnum, sidenum_t sidenum, unsigned facenum, unsigned nv, std::span<const g3s_lrgb, 4> light_rgb, grs_bitmap &bm, grs_bitmap *bm2, texture2_rotation_low orient);
 }
 #endif
 
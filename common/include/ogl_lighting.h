@@ -0,0 +1,73 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/* OpenGL light shader:
+ * evaluate the dynamic lights of the current frame per pixel on the GPU,
+ * instead of accumulating them per vertex on the CPU.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include "dxxsconf.h"
+#include "maths.h"
+#include "vecmat.h"
+#include "3d.h"
+
+namespace dcx {
+
+#if DXX_USE_OGL
+/* Upper bound on the lights handled by the shader.  Further lights in the
+ * same frame are applied per vertex, as without the shader.
+ */
+constexpr std::size_t OGL_MAX_SHADER_LIGHTS = 32;
+
+struct ogl_shader_light
+{
+	/* All in world coordinates */
+	vms_vector pos;
+	g3s_lrgb emission;
+	/* No light reaches points this far away, or for headlights, eight
+	 * times this far away.
+	 */
+	fix range;
+	/* Nonzero for headlights: the divisor applied outside the cone.  The
+	 * cone, along `fvec`, lights nothing beyond `cone_range`.
+	 */
+	fix headlight_scale;
+	vms_vector fvec;
+	fix cone_range;
+};
+
+/* True if -gl_lightshader was given and the shader is usable.  The shader
+ * is built on first use.
+ */
+bool ogl_light_shader_enabled();
+void ogl_light_shader_clear_lights();
+/* Returns false if the light could not be added, in which case the
+ * caller must apply it itself.
+ */
+bool ogl_light_shader_add_light(const ogl_shader_light &light);
+/* Upload the lights for the current view.  Until
+ * ogl_light_shader_end_frame, ogl_light_shader_bind will use them.  Total
+ * light is limited to `light_limit`, which the caller also applies to
+ * the static vertex light.
+ */
+void ogl_light_shader_begin_frame(float light_limit);
+void ogl_light_shader_end_frame();
+/* Returns true if the shader is now bound and must be released with
+ * ogl_light_shader_unbind after drawing.
+ */
+bool ogl_light_shader_bind();
+void ogl_light_shader_unbind();
+/* Delete the program before the context is changed.  It is built again
+ * on next use.
+ */
+void ogl_smash_light_shader();
+#endif
+
+}
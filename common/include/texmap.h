@@ -91,6 +91,38 @@ extern	int	Lighting_on;
 // HACK INTERFACE: how far away the current segment (& thus texture) is
 extern unsigned Current_seg_depth;
 void init_interface_vars_to_assembler();
+
+// Discard the reduced copies of a texture whose pixels have been rewritten.
+void tmap_mip_invalidate(const grs_bitmap &bmp);
+// Discard all reduced copies, such as when the palette changes.
+void tmap_mip_flush();
+
+/* Opaque faces can be drawn in two passes.  The record pass visits them
+ * nearest first and, without drawing anything, records for each face the
+ * parts of its spans which no nearer face has covered.  The replay pass
+ * then draws everything in the usual farthest first order, limiting each
+ * recorded face to its recorded spans, so that each pixel covered by an
+ * opaque face is textured only once.
+ */
+enum class tmap_coverage_face : uint32_t
+{
+	none,
+};
+void tmap_coverage_start_recording(const grs_bitmap &canvas);
+bool tmap_coverage_recording();
+// Spans drawn until the next call are recorded for the returned face.
+tmap_coverage_face tmap_coverage_record_face();
+void tmap_coverage_start_replay();
+// Spans drawn until the next call are limited to those recorded for
+// `face`.  tmap_coverage_face::none draws without restriction.
+void tmap_coverage_replay_face(tmap_coverage_face face);
+void tmap_coverage_stop();
+
+struct tmap_span_stats
+{
+	unsigned pixels_shaded, pixels_skipped;
+};
+extern tmap_span_stats Tmap_span_stats;
 #endif
 class push_interpolation_method
 {
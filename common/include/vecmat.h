@@ -27,6 +27,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #include <cassert>
 #include <cstdint>
+#include <span>
 #include <utility>
 #include "fwd-vecmat.h"
 
@@ -282,6 +283,88 @@ static inline vms_vector vm_vec_sub (const vms_vector &src0, const vms_vector &s
 	return vm_vec_sub(dest, src0, src1), dest;
 }
 
+/* The functions below are called from the inner loops of physics, AI,
+ * FVI and the renderer, so they are defined here, where the compiler can
+ * inline them and combine their arithmetic with that of the caller.
+ */
+
+//scales a vector and adds it to another
+//dest += k * src
+static inline void vm_vec_scale_add2(vms_vector &dest, const vms_vector &src, const fix k)
+{
+	dest.x += fixmul(src.x, k);
+	dest.y += fixmul(src.y, k);
+	dest.z += fixmul(src.z, k);
+}
+
+[[nodiscard]]
+static inline fix vm_vec_dot(const vms_vector &v0, const vms_vector &v1)
+{
+	const int64_t p = (int64_t{v0.x} * v1.x) + (int64_t{v0.y} * v1.y) + (int64_t{v0.z} * v1.z);
+	/* Convert back to fix and return. */
+	return p >> 16;
+}
+
+[[nodiscard]]
+static inline vm_magnitude_squared vm_vec_mag2(const vms_vector &v)
+{
+	const int64_t x = v.x;
+	const int64_t y = v.y;
+	const int64_t z = v.z;
+	return vm_magnitude_squared{static_cast<uint64_t>((x * x) + (y * y) + (z * z))};
+}
+
+[[nodiscard]]
+static inline vm_magnitude vm_vec_mag(const vms_vector &v)
+{
+	quadint q;
+	q.q = static_cast<uint64_t>(vm_vec_mag2(v));
+	return vm_magnitude{quad_sqrt(q)};
+}
+
+static inline void vm_vec_divide(vms_vector &dest, const vms_vector &src, const fix m)
+{
+	dest.x = fixdiv(src.x, m);
+	dest.y = fixdiv(src.y, m);
+	dest.z = fixdiv(src.z, m);
+}
+
+//return the normalized direction vector between two points
+//dest = normalized(end - start).  Returns mag of direction vector
+//NOTE: the order of the parameters matches the vector subtraction
+static inline vm_magnitude vm_vec_normalized_dir(vms_vector &dest, const vms_vector &end, const vms_vector &start)
+{
+	vm_vec_sub(dest, end, start);
+	const auto m = vm_vec_mag(dest);
+	if (m)
+		vm_vec_divide(dest, dest, m);
+	return m;
+}
+
+//rotates a vector through a matrix.
+//dest CANNOT equal source
+static inline void vm_vec_rotate(vms_vector &dest, const vms_vector &src, const vms_matrix &m)
+{
+	dest.x = vm_vec_dot(src, m.rvec);
+	dest.y = vm_vec_dot(src, m.uvec);
+	dest.z = vm_vec_dot(src, m.fvec);
+}
+
+/* Rotate each element of `src`, taken relative to `origin`, through `m`
+ * into the same element of `dest`.  The loop makes no calls, so the
+ * compiler can vectorise it for callers which transform many points.
+ * `dest` must be as long as `src`, and must not overlap it.
+ */
+static inline void vm_vec_rotate_list(const std::span<vms_vector> dest, const std::span<const vms_vector> src, const vms_vector &origin, const vms_matrix &m)
+{
+	assert(dest.size() >= src.size());
+	for (std::size_t i = 0; i < src.size(); ++i)
+	{
+		const vms_vector t{src[i].x - origin.x, src[i].y - origin.y, src[i].z - origin.z};
+		vm_vec_rotate(dest[i], t, m);
+	}
+}
+
 //averages two vectors. returns ptr to dest
 //dest can equal either source
 [[nodiscard]]
@@ -37,6 +37,7 @@ private:
 	class window *next = nullptr;				// the next window in the doubly linked list
 	uint8_t w_visible = 1;						// whether it's visible
 	uint8_t w_modal = 1;						// modal = accept all user input exclusively
+	uint8_t w_animated = 1;						// animated = redraw on every pass of the event loop
 public:
 	explicit window(grs_canvas &src, int x, int y, int w, int h);
 	window(const window &) = delete;
@@ -70,6 +71,19 @@ public:
 		return w_modal;
 	}
 
+	/* A static window only changes in response to events, so it need not
+	 * be redrawn while there are none.  See event_process.
+	 */
+	void set_animated(uint8_t animated)
+	{
+		w_animated = animated;
+	}
+
+	uint8_t is_animated() const
+	{
+		return w_animated;
+	}
+
 	window_event_result send_event(const d_event &event
 #if DXX_HAVE_CXX_BUILTIN_FILE_LINE
 								, const char *file = __builtin_FILE(), unsigned line = __builtin_LINE()
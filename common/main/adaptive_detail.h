@@ -0,0 +1,130 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * Frame time controller for adaptive detail.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "maths.h"
+
+namespace dcx {
+
+/* Detail levels run from 0 (cheapest) to ADAPTIVE_DETAIL_LEVELS - 1, which
+ * is the detail used when the controller is disabled.
+ */
+constexpr unsigned ADAPTIVE_DETAIL_LEVELS = 5;
+
+enum class adaptive_detail_change : uint8_t
+{
+	none,
+	lowered,
+	raised,
+};
+
+/* Choose a detail level from a stream of frame times.
+ *
+ * Frame times are smoothed with a short moving average.  The level is
+ * lowered once the average has stayed above the target by more than 1/8
+ * for half a second, and raised once it has stayed below 3/4 of the
+ * target for two seconds.  Between those bounds, nothing changes, so a
+ * level whose cost is close to the target does not oscillate.
+ *
+ * When the frame rate is capped at the target, such as by vsync, frames
+ * never appear fast enough to raise the level.  Instead, after a period
+ * without slow frames, the controller tries the next level up.  If that
+ * level is soon lowered again, the period before the next attempt is
+ * doubled, up to about a minute.
+ */
+class adaptive_detail_controller
+{
+	fix target;
+	fix average;
+	fix slow_time = 0, fast_time = 0, steady_time = 0;
+	fix since_change = 0;
+	fix probe_interval;
+	uint8_t min_level, max_level, current;
+	bool last_change_raised = false;
+	static constexpr fix initial_probe_interval = F1_0 * 4;
+	static constexpr fix maximum_probe_interval = F1_0 * 64;
+public:
+	/* Frames which take longer than this are stalls, such as loading or
+	 * a moved window, not a measure of rendering cost.
+	 */
+	static constexpr fix ignored_frame_time = F1_0 / 4;
+	adaptive_detail_controller(const fix target_frame_time, const unsigned min, const unsigned max) :
+		target(target_frame_time), average(target_frame_time), probe_interval(initial_probe_interval),
+		min_level(min < ADAPTIVE_DETAIL_LEVELS ? min : ADAPTIVE_DETAIL_LEVELS - 1),
+		max_level(max < min_level ? min_level : max < ADAPTIVE_DETAIL_LEVELS ? max : ADAPTIVE_DETAIL_LEVELS - 1),
+		current(max_level)
+	{
+	}
+	unsigned level() const
+	{
+		return current;
+	}
+	fix target_frame_time() const
+	{
+		return target;
+	}
+	fix average_frame_time() const
+	{
+		return average;
+	}
+	adaptive_detail_change update(const fix frame_time)
+	{
+		if (frame_time <= 0 || frame_time >= ignored_frame_time)
+			return adaptive_detail_change::none;
+		average += (frame_time - average) / 8;
+		since_change += frame_time;
+		if (average > target + target / 8)
+		{
+			slow_time += frame_time;
+			fast_time = steady_time = 0;
+		}
+		else
+		{
+			slow_time = 0;
+			steady_time += frame_time;
+			if (average < target - target / 4)
+				fast_time += frame_time;
+			else
+				fast_time = 0;
+		}
+		if (slow_time >= F1_0 / 2 && current > min_level)
+		{
+			/* A level which could not be held for long after it was
+			 * tried should not be tried again soon.
+			 */
+			if (last_change_raised && since_change < probe_interval)
+				probe_interval = probe_interval < maximum_probe_interval / 2 ? probe_interval * 2 : maximum_probe_interval;
+			--current;
+			last_change_raised = false;
+			return changed(adaptive_detail_change::lowered);
+		}
+		if (current < max_level && (fast_time >= F1_0 * 2 || steady_time >= probe_interval))
+		{
+			if (fast_time >= F1_0 * 2)
+				probe_interval = initial_probe_interval;
+			++current;
+			last_change_raised = true;
+			return changed(adaptive_detail_change::raised);
+		}
+		return adaptive_detail_change::none;
+	}
+private:
+	adaptive_detail_change changed(const adaptive_detail_change c)
+	{
+		slow_time = fast_time = steady_time = since_change = 0;
+		return c;
+	}
+};
+
+}
@@ -0,0 +1,36 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * Export of demo playback as uncompressed video.
+ *
+ */
+
+#pragma once
+
+#include "maths.h"
+
+namespace dcx {
+
+/* Open the video for `demo`, as named by -export-demo-file or else in the
+ * demo directory, and the audio beside it with a .wav extension.  Returns
+ * false, after reporting why, if the video could not be opened.
+ */
+bool demo_export_start(const char *demo);
+/* Close the video and audio and quit the game.  Does nothing if no video is open.
+ */
+void demo_export_finish();
+/* While a video is open, the game time of one video frame, so that
+ * playback runs as fast as frames can be drawn and written.  Otherwise 0.
+ */
+fix demo_export_frame_time();
+/* Append the screen to the video, and the sound of one frame to the
+ * audio, if they are open.
+ */
+void demo_export_frame();
+
+}
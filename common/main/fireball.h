@@ -26,6 +26,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #pragma once
 
 #include <physfs.h>
+#include <vector>
 
 #include "maths.h"
 #include "fwd-powerup.h"
@@ -36,7 +37,10 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "robot.h"
 
 namespace dcx {
-extern unsigned Num_exploding_walls;
+/* Walls with wall_flag::exploding set, in ascending order, so that
+ * process_exploding_walls need not scan every wall in the level.
+ */
+extern std::vector<wallnum_t> Exploding_walls;
 }
 
 #ifdef dsx
@@ -70,7 +74,7 @@ void do_debris_frame(const d_robot_info_array &Robot_info, vmobjptridx_t obj);
 void draw_fireball(const d_vclip_array &Vclip, grs_canvas &, vcobjptridx_t obj);
 
 void explode_wall(fvcvertptr &, vcsegptridx_t, sidenum_t sidenum, wall &);
-unsigned do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &);
+void do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &);
 void maybe_drop_net_powerup(powerup_type_t powerup_type, bool adjust_cap, bool random_player);
 void maybe_replace_powerup_with_energy(object_base &del_obj);
 }
@@ -97,7 +101,7 @@ void drop_afterburner_blobs(object &obj, int count, fix size_scale, fix lifetime
 /*
  * reads n expl_wall structs from a PHYSFS_File and swaps if specified
  */
-void expl_wall_read_n_swap(fvmwallptr &, PHYSFS_File *fp, int swap, unsigned);
+void expl_wall_read_n_swap(fvmwallptridx &, PHYSFS_File *fp, int swap, unsigned);
 void expl_wall_write(fvcwallptr &, PHYSFS_File *);
 extern fix	Flash_effect;
 #endif
@@ -89,7 +89,12 @@ void piggy_close();
 bitmap_index piggy_register_bitmap(grs_bitmap &bmp, std::span<const char> name, int in_file);
 int piggy_register_sound(digi_sound &snd, std::span<const char> name);
 bitmap_index piggy_find_bitmap(std::span<const char> name);
-void piggy_load_level_data();
+/* Page in the bitmaps of the level now loaded.  Unless
+ * `keep_paged_bitmaps`, first page out every bitmap.
+ */
+void piggy_load_level_data(bool keep_paged_bitmaps);
+/* Page out every bitmap which is read from the pig file */
+void piggy_bitmap_page_out_all();
 
 #if defined(DXX_BUILD_DESCENT_I)
 constexpr std::integral_constant<unsigned, 1800> MAX_BITMAP_FILES{};
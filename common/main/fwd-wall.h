@@ -17,6 +17,7 @@
 #include "cpp-valptridx.h"
 
 namespace dcx {
+class level_reader;
 enum class actdoornum_t : uint8_t;
 constexpr std::integral_constant<std::size_t, 255> MAX_WALLS{}; // Maximum number of walls
 constexpr std::integral_constant<std::size_t, 90> MAX_DOORS{};  // Maximum number of open doors
@@ -211,6 +212,7 @@ void wall_frame_process(const d_robot_info_array &Robot_info);
 void wall_set_tmap_num(const wclip &, vmsegptridx_t seg, sidenum_t side, vmsegptridx_t csegp, sidenum_t cside, unsigned frame_num);
 void wclip_read(PHYSFS_File *, wclip &wc);
 void wall_read(PHYSFS_File *fp, wall &w);
+void wall_read(level_reader &r, wall &w);
 void wall_write(PHYSFS_File *fp, const wall &w, short version);
 
 void wall_close_door_ref(fvmsegptridx &vmsegptridx, wall_array &Walls, const wall_animations_array &WallAnims, active_door &);
@@ -228,8 +230,8 @@ void blast_nearby_glass(const object &objp, fix damage);
 }
 #endif
 
-void v16_wall_read(PHYSFS_File *fp, v16_wall &w);
-void v19_wall_read(PHYSFS_File *fp, v19_wall &w);
+void v16_wall_read(level_reader &r, v16_wall &w);
+void v19_wall_read(level_reader &r, v19_wall &w);
 
 void active_door_read(PHYSFS_File *fp, active_door &ad);
 void active_door_write(PHYSFS_File *fp, const active_door &ad);
@@ -26,6 +26,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #pragma once
 
 #include <physfs.h>
+#include <vector>
 #include "fwd-segment.h"
 #include "maths.h"
 
@@ -135,13 +136,42 @@ extern struct me mine_editor;
 // loads from an already-open file
 // returns 0=everything ok, 1=old version, -1=error
 #ifdef dsx
+namespace dcx {
+class level_reader;
+}
+
 namespace dsx {
-int load_mine_data_compiled(PHYSFS_File *LoadFile, const char *Gamesave_current_filename);
+struct level_read_tables;
+
+// A compiled mine, read from a level without changing the level being
+// played.
+struct compiled_mine
+{
+	std::vector<vertex> vertices;
+	std::vector<shared_segment> shared_segments;
+	std::vector<unique_segment> unique_segments;
+#if defined(DXX_BUILD_DESCENT_II)
+	/* Textures of a Descent 1 level which have no Descent 2 texture.
+	 * load_mine_data_compiled reports them.
+	 */
+	std::vector<uint16_t> unknown_d1_textures;
+#endif
+};
+
+// Read the compiled mine of a level of version `version`.  Throw if the
+// mine is malformed.
+void read_compiled_mine(level_reader &r, compiled_mine &mine, int version, bool new_file_format, const level_read_tables &tables);
+
+// Load the mine of the level `Gamesave_current_filename`.  If `staged` is
+// not null, it is the mine, and nothing is read from `LoadFile`.
+int load_mine_data_compiled(PHYSFS_File *LoadFile, const char *Gamesave_current_filename, const compiled_mine *staged);
 }
 #endif
 #define TMAP_NUM_MASK 0x3FFF
 
 #if defined(DXX_BUILD_DESCENT_II)
+extern int New_file_format_load;
+
 namespace dsx {
 extern int d1_pig_present;
 
@@ -30,7 +30,20 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "pstypes.h"
 
 #ifdef __cplusplus
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 #include "fwd-segment.h"
+#include "fwd-object.h"
+#include "fwd-vclip.h"
+#include "fwd-wall.h"
+#include "gamemine.h"
+#include "gameseq.h"
+#include "physfsx.h"
+#include "polyobj.h"
 
 #define D1X_LEVEL_FILE_EXTENSION	"RDL"
 #define D2X_LEVEL_FILE_EXTENSION	"RL2"
@@ -39,9 +52,6 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #define	NUM_SHAREWARE_LEVELS	7
 #define	NUM_REGISTERED_LEVELS	23
 
-namespace dsx {
-int convert_tmap(int tmap);	// for gamemine.c
-}
 #define DXX_LEVEL_FILE_EXTENSION	D1X_LEVEL_FILE_EXTENSION
 #elif defined(DXX_BUILD_DESCENT_II)
 #define DXX_LEVEL_FILE_EXTENSION	D2X_LEVEL_FILE_EXTENSION
@@ -52,16 +62,129 @@ int get_level_name(void);
 
 #ifdef dsx
 namespace dsx {
+
+/* The game data which the level readers use to correct a level.  The
+ * readers use a copy of it, so that a level can be read on another
+ * thread while the main thread owns the game data.
+ */
+struct level_read_tables
+{
+#if defined(DXX_BUILD_DESCENT_I)
+	unsigned num_textures;
+	unsigned num_polygon_models;
+	unsigned num_wall_anims;
+	std::bitset<std::tuple_size<d_vclip_array>::value> vclip_present;
+#elif defined(DXX_BUILD_DESCENT_II)
+	/* Whether Descent 1 levels use the textures of descent.pig */
+	bool d1_pig_present;
+#endif
+	bool operator==(const level_read_tables &) const = default;
+};
+
+// Copy the tables from the game data now loaded.
+level_read_tables get_level_read_tables();
+
+#if defined(DXX_BUILD_DESCENT_I)
+int convert_tmap(const level_read_tables &tables, int tmap);	// for gamemine.c
+#endif
+
+struct staged_level;
+
 int load_level(
 #if defined(DXX_BUILD_DESCENT_II)
 	d_level_shared_destructible_light_state &LevelSharedDestructibleLightState,
 #endif
-	const char *filename);
+	const char *filename, const staged_level *staged);
 int save_level(
 #if defined(DXX_BUILD_DESCENT_II)
 	const d_level_shared_destructible_light_state &LevelSharedDestructibleLightState,
 #endif
 	const char *filename);
+
+// Read the whole of a level file, found as load_level finds it.  Return
+// an empty vector if it cannot be read.
+std::vector<uint8_t> read_level_file(const char *filename);
+}
+
+namespace dcx {
+class level_reader;
+}
+
+namespace dsx {
+#if defined(DXX_BUILD_DESCENT_I)
+using savegame_pof_names_type = enumerated_array<char[FILENAME_LEN], 167, polygon_model_index>;
+#elif defined(DXX_BUILD_DESCENT_II)
+using savegame_pof_names_type = enumerated_array<char[FILENAME_LEN], MAX_POLYGON_MODELS, polygon_model_index>;
+#endif
+
+// The counts and offsets at the start of the game data of a level.
+struct game_data_header
+{
+	int version;
+	int object_offset;
+	unsigned num_objects;
+	unsigned num_walls;
+	unsigned num_triggers;
+	unsigned num_robot_centers;
+#if defined(DXX_BUILD_DESCENT_II)
+	unsigned num_static_lights;
+	unsigned num_delta_lights;
+#endif
+};
+
+/* The part of the game data of a level which is read without changing
+ * the level being played.  load_game_data copies it into the level, and
+ * then reads the triggers and the rest of the game data, which start at
+ * triggers_offset.
+ */
+struct level_game_data
+{
+	game_data_header header;
+	PHYSFSX_gets_line_t<LEVEL_NAME_LEN> level_name;
+	unsigned N_save_pof_names;
+	savegame_pof_names_type Save_pof_names;
+	/* The objects as they are in the file.  Each must be passed to
+	 * verify_level_object once it is in its place in the level.
+	 */
+	std::vector<object> objects;
+	/* The objects which had a bogus render type, replaced by RT_NONE */
+	std::vector<unsigned> bogus_render_types;
+	std::vector<wall> walls;
+	std::size_t triggers_offset;
+};
+
+// Read the game data of a level into `g`.  Return false if this is not
+// game data which can be loaded.
+bool read_level_game_data(level_reader &r, level_game_data &g, const level_read_tables &tables);
+
+// Correct an object of a level of version `level_version` as the game
+// does, using the robots and models now loaded.
+void verify_level_object(object &obj, int level_version, const savegame_pof_names_type &Save_pof_names);
+
+/* A level read in full from a copy of its file, which load_level can
+ * use in place of reading the mine and the game data.  Only the header,
+ * the triggers and the data which follows them are then read from the
+ * file.
+ */
+struct staged_level
+{
+	std::size_t file_length;
+	int version;
+	level_read_tables tables;
+#if defined(DXX_BUILD_DESCENT_II)
+	/* The palette of the level, as load_level reads it */
+	PHYSFSX_gets_line_t<FILENAME_LEN> palette;
+#endif
+	compiled_mine mine;
+	level_game_data game_data;
+};
+
+/* Read the level `filename` from `data`, which holds the whole file.
+ * This uses neither PhysFS nor the game data, so it may be run on any
+ * thread.  Return nullptr if the level cannot be staged.  Throw on a
+ * malformed level.
+ */
+std::unique_ptr<staged_level> stage_level(std::span<const uint8_t> data, const char *filename, const level_read_tables &tables);
 }
 #endif
 
@@ -106,6 +106,14 @@ window_event_result ExitSecretLevel();
 // Secret levels are -1,-2,-3
 void LoadLevel(int level_num, int page_in_textures);
 
+// start reading a level in the background, for the next LoadLevel of
+// that level
+void preload_level(int level_num);
+// wait for and discard the level read by preload_level
+void cancel_level_preload();
+// page in some of the bitmaps of the level read by preload_level
+void page_in_preloaded_level();
+
 }
 #endif
 extern void update_player_stats();
@@ -66,6 +66,11 @@ void add_bonus_points_to_score(player_info &, unsigned points, game_mode_flags);
 void render_gauges(grs_canvas &, game_mode_flags game_mode);
 void init_gauges(void);
 void draw_hud(const d_robot_info_array &Robot_info, grs_canvas &, const object &, const control_info &Controls, game_mode_flags);     // draw all the HUD stuff
+#if !DXX_USE_OGL
+// Tell render_gauges how much of the full cockpit was redrawn this frame:
+// the rows above redrawn_height, or all of it if redrawn_height is negative.
+void cockpit_gauges_begin_frame(int redrawn_height);
+#endif
 }
 #endif
 void close_gauges(void);
@@ -129,6 +134,8 @@ enum class weapon_box_user : uint8_t
 // the top of the window.
 void do_cockpit_window_view(grs_canvas &, gauge_inset_window_view win, const object &viewer, int rear_view_flag, weapon_box_user user, const char *label, const player_info * = nullptr);
 void do_cockpit_window_view(gauge_inset_window_view win, weapon_box_user user);
+// with -renderstats, show what the inset views cost
+void show_inset_view_stats(grs_canvas &);
 }
 #endif
 
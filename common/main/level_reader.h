@@ -0,0 +1,205 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * Reader for the fields of a level file.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include "physfsx.h"
+#include "physfs-serial.h"
+#include "byteutil.h"
+#include "vecmat.h"
+
+namespace dcx {
+
+class level_file_truncated : public std::runtime_error
+{
+public:
+	level_file_truncated() :
+		runtime_error("level file is truncated")
+	{
+	}
+};
+
+/* The level loaders read through a level_reader, so that the same code
+ * can read a level from an open file or from a copy of the file held in
+ * memory.  A file reader uses the PHYSFSX helpers, which report a short
+ * read as they always have.  A memory reader does not use PhysFS, so it
+ * may be used off the main thread.  It throws level_file_truncated on a
+ * short read.
+ */
+class level_reader
+{
+	PHYSFS_File *const file = nullptr;
+	const std::span<const uint8_t> data;
+	std::size_t pos = 0;
+	const uint8_t *take(const std::size_t n)
+	{
+		if (data.size() - pos < n)
+			throw level_file_truncated();
+		const auto p = &data[pos];
+		pos += n;
+		return p;
+	}
+public:
+	explicit level_reader(PHYSFS_File *const f) :
+		file(f)
+	{
+	}
+	explicit level_reader(const std::span<const uint8_t> d) :
+		data(d)
+	{
+	}
+	int8_t read_byte()
+	{
+		if (file)
+			return PHYSFSX_readByte(file);
+		return *take(1);
+	}
+	int16_t read_short()
+	{
+		if (file)
+			return PHYSFSX_readShort(file);
+		return GET_INTEL_SHORT(take(2));
+	}
+	int32_t read_int()
+	{
+		if (file)
+			return PHYSFSX_readInt(file);
+		return GET_INTEL_INT(take(4));
+	}
+	fix read_fix()
+	{
+		return read_int();
+	}
+	fixang read_fixang()
+	{
+		return read_short();
+	}
+	void read_vector(vms_vector &v)
+	{
+		if (file)
+			return PHYSFSX_readVector(file, v);
+		v.x = read_fix();
+		v.y = read_fix();
+		v.z = read_fix();
+	}
+	void read_angvec(vms_angvec &v)
+	{
+		if (file)
+			return PHYSFSX_readAngleVec(&v, file);
+		v.p = read_fixang();
+		v.b = read_fixang();
+		v.h = read_fixang();
+	}
+	void read_matrix(vms_matrix &m)
+	{
+		read_vector(m.rvec);
+		read_vector(m.uvec);
+		read_vector(m.fvec);
+	}
+	/* Read `n` bytes.  As with PHYSFS_read, a file reader leaves the
+	 * bytes past a short read unchanged.
+	 */
+	void read_bytes(void *const p, const std::size_t n)
+	{
+		if (file)
+		{
+			(PHYSFS_read)(file, p, 1, n);
+			return;
+		}
+		std::memcpy(p, take(n), n);
+	}
+	void skip(const std::size_t n)
+	{
+		if (file)
+		{
+			PHYSFSX_fseek(file, n, SEEK_CUR);
+			return;
+		}
+		take(n);
+	}
+	/* Move to offset `p` from the start of the level.  Return false if
+	 * that is past the end.
+	 */
+	bool seek(const std::size_t p)
+	{
+		if (file)
+			return PHYSFS_seek(file, p);
+		if (p > data.size())
+			return false;
+		pos = p;
+		return true;
+	}
+	/* Return the offset of the next byte from the start of the level. */
+	std::size_t tell() const
+	{
+		if (file)
+			return PHYSFS_tell(file);
+		return pos;
+	}
+	/* Read a line as PHYSFSX_fgets reads it, consuming the same bytes.
+	 * Return nullptr at the end of the level.
+	 */
+	template <std::size_t n>
+		char *read_line(PHYSFSX_gets_line_t<n> &buf)
+		{
+			if (file)
+				return PHYSFSX_fgets(buf, file);
+			const auto line = buf.next();
+			const std::size_t r = std::min(line.size() - 1, data.size() - pos);
+			if (!r)
+				return nullptr;
+			std::copy_n(&data[pos], r, line.begin());
+			std::size_t i = 0, consumed = r;
+			for (; i != r; ++i)
+			{
+				const char c = line[i];
+				if (c == 0 || c == '\n')
+				{
+					consumed = i + 1;
+					break;
+				}
+				if (c == '\r')
+				{
+					line[i] = 0;
+					/* A '\r' which ends the bytes read takes the next
+					 * byte with it, whatever that byte is.
+					 */
+					if (i + 1 == r || line[i + 1] == '\n')
+						++i;
+					consumed = i + 1;
+					break;
+				}
+			}
+			pos = std::min(data.size(), pos + consumed);
+			line[i] = 0;
+			return &line[i];
+		}
+	/* Read a structure which has a serial message definition, as
+	 * PHYSFSX_serialize_read reads it.
+	 */
+	template <typename T>
+		void serialize_read(T &t)
+		{
+			if (file)
+				return PHYSFSX_serialize_read(file, t);
+			serial::reader::bytebuffer_t b(take(serial::message_type<T>::maximum_size));
+			serial::process_buffer(b, t);
+		}
+};
+
+}
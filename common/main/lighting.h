@@ -44,6 +44,8 @@ struct d_level_unique_light_state
 	enumerated_array<g3s_lrgb, MAX_VERTICES, vertnum_t> Dynamic_light;
 };
 
+extern fix Dynamic_light_interval;	// least time between updates of the dynamic light
+
 }
 
 #if defined(DXX_BUILD_DESCENT_I) || defined(DXX_BUILD_DESCENT_II)
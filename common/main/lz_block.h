@@ -0,0 +1,178 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * Fast LZ77 compression of independent blocks.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+namespace dcx {
+
+/* A block is a series of sequences in the layout of LZ4.  Each sequence
+ * is a token byte, whose high nibble is the count of literal bytes and
+ * whose low nibble is the match length less lz_block_min_match.  A
+ * nibble of 15 is extended by following bytes, which are added to it
+ * until one is less than 255.  The literals follow the literal count,
+ * and then a two byte little endian offset back to the match precedes
+ * the match length extension.  The last sequence has only literals.
+ *
+ * The compressor looks up one earlier position per byte, through a hash
+ * of the next four bytes, and takes the first match it finds.  This
+ * favours speed over ratio, which suits data written while the game
+ * runs.
+ */
+constexpr std::size_t lz_block_min_match = 4;
+constexpr std::size_t lz_block_max_offset = UINT16_MAX;
+
+/* The largest output of lz_block_compress for `n` bytes of input. */
+constexpr std::size_t lz_block_bound(const std::size_t n)
+{
+	return n + n / 255 + 16;
+}
+
+namespace detail {
+
+static inline uint32_t lz_block_read32(const uint8_t *const p)
+{
+	uint32_t v;
+	std::memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint8_t *lz_block_write_length(uint8_t *out, std::size_t n)
+{
+	for (; n >= 255; n -= 255)
+		*out++ = 255;
+	*out++ = static_cast<uint8_t>(n);
+	return out;
+}
+
+static inline uint8_t *lz_block_write_literals(uint8_t *out, const uint8_t *const literals, const std::size_t count, const std::size_t match_length)
+{
+	*out++ = static_cast<uint8_t>((std::min<std::size_t>(count, 15) << 4) | std::min<std::size_t>(match_length, 15));
+	if (count >= 15)
+		out = lz_block_write_length(out, count - 15);
+	if (count)
+		std::memcpy(out, literals, count);
+	return out + count;
+}
+
+static inline bool lz_block_read_length(const uint8_t *&in, const uint8_t *const end, std::size_t &n)
+{
+	uint8_t b;
+	do {
+		if (in == end)
+			return false;
+		b = *in++;
+		n += b;
+	} while (b == 255);
+	return true;
+}
+
+}
+
+/* Compress `src` into `dst`, which must have room for
+ * lz_block_bound(src.size()) bytes.  Return the size of the output.
+ */
+static inline std::size_t lz_block_compress(const std::span<const uint8_t> src, const std::span<uint8_t> dst)
+{
+	constexpr unsigned hash_bits = 12;
+	/* Position of the last occurrence of each hash, plus one, so that
+	 * zero means no occurrence.
+	 */
+	std::array<uint32_t, 1u << hash_bits> last_seen{};
+	const uint8_t *const in = src.data();
+	const std::size_t size = src.size();
+	uint8_t *out = dst.data();
+	std::size_t anchor = 0;
+	for (std::size_t i = 0; i + lz_block_min_match <= size;)
+	{
+		const uint32_t v = detail::lz_block_read32(in + i);
+		auto &seen = last_seen[(v * 2654435761u) >> (32 - hash_bits)];
+		const std::size_t candidate = seen;
+		seen = static_cast<uint32_t>(i + 1);
+		if (!candidate || i + 1 - candidate > lz_block_max_offset || detail::lz_block_read32(in + candidate - 1) != v)
+		{
+			++i;
+			continue;
+		}
+		const std::size_t match = candidate - 1;
+		std::size_t length = lz_block_min_match;
+		while (i + length < size && in[match + length] == in[i + length])
+			++length;
+		const std::size_t extra = length - lz_block_min_match;
+		out = detail::lz_block_write_literals(out, in + anchor, i - anchor, extra);
+		const std::size_t offset = i - match;
+		*out++ = static_cast<uint8_t>(offset);
+		*out++ = static_cast<uint8_t>(offset >> 8);
+		if (extra >= 15)
+			out = detail::lz_block_write_length(out, extra - 15);
+		i += length;
+		anchor = i;
+	}
+	out = detail::lz_block_write_literals(out, in + anchor, size - anchor, 0);
+	return out - dst.data();
+}
+
+/* Decompress `src` into `dst`, which must be exactly the size of the
+ * original input.  Return false if `src` is not a valid block of that
+ * size.
+ */
+static inline bool lz_block_decompress(const std::span<const uint8_t> src, const std::span<uint8_t> dst)
+{
+	const uint8_t *in = src.data();
+	const uint8_t *const in_end = in + src.size();
+	uint8_t *const out_begin = dst.data();
+	uint8_t *out = out_begin;
+	uint8_t *const out_end = out + dst.size();
+	for (;;)
+	{
+		if (in == in_end)
+			return false;
+		const unsigned token = *in++;
+		std::size_t literals = token >> 4;
+		if (literals == 15 && !detail::lz_block_read_length(in, in_end, literals))
+			return false;
+		if (literals > static_cast<std::size_t>(in_end - in) || literals > static_cast<std::size_t>(out_end - out))
+			return false;
+		if (literals)
+			std::memcpy(out, in, literals);
+		in += literals;
+		out += literals;
+		if (in == in_end)
+			/* The last sequence has no match. */
+			return out == out_end;
+		if (in_end - in < 2)
+			return false;
+		const std::size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+		if (!offset || offset > static_cast<std::size_t>(out - out_begin))
+			return false;
+		std::size_t length = token & 15;
+		if (length == 15 && !detail::lz_block_read_length(in, in_end, length))
+			return false;
+		length += lz_block_min_match;
+		if (length > static_cast<std::size_t>(out_end - out))
+			return false;
+		/* The match may overlap the bytes it produces, so copy forward
+		 * one byte at a time.
+		 */
+		for (const uint8_t *m = out - offset; length; --length)
+			*out++ = *m++;
+	}
+}
+
+}
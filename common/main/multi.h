@@ -130,7 +130,7 @@ enum class kick_player_reason : uint8_t
 #define MULTI_PROTO_UDP 1 // UDP protocol
 
 // What version of the multiplayer protocol is this? Increment each time something drastic changes in Multiplayer without the version number changes. Reset to 0 each time the version of the game changes
-#define MULTI_PROTO_VERSION	static_cast<uint16_t>(16)
+#define MULTI_PROTO_VERSION	static_cast<uint16_t>(18)
 // PROTOCOL VARIABLES AND DEFINES - END
 
 // limits for Packets (i.e. positional updates) per sec
@@ -558,7 +558,6 @@ extern network_state Network_status;
 
 // IMPORTANT: These variables needed for player rejoining done by protocol-specific code
 extern int Network_send_objects;
-extern int Network_send_object_mode;
 extern int Network_send_objnum;
 extern int Network_rejoined;
 extern int Network_sending_extras;
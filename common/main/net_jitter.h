@@ -0,0 +1,193 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * Jitter buffer for timestamped remote state updates.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include "maths.h"
+
+namespace dcx {
+
+/* Senders stamp each update with the low 32 bits of their fix64 wall
+ * clock.  The stamp wraps after ~18 hours, so all comparisons between
+ * stamps use the signed difference, which is correct as long as two
+ * stamps are less than half that range apart.
+ */
+using net_sender_time = uint32_t;
+
+enum class net_jitter_sample_kind : uint8_t
+{
+	/* The render time lies between two received states.  Blend `from`
+	 * and `to` by `fraction`.
+	 */
+	interpolate,
+	/* The render time is after the newest received state.  Advance
+	 * `from` by `extrapolate_time`, which is already clamped to the
+	 * caller's limit.
+	 */
+	extrapolate,
+	/* The render time is before the oldest retained state.  Use `from`
+	 * unchanged.
+	 */
+	hold,
+};
+
+template <typename T>
+struct net_jitter_sample
+{
+	const T &from;
+	const T &to;
+	fix fraction;
+	fix extrapolate_time;
+	net_jitter_sample_kind kind;
+};
+
+/* Fixed-size buffer of the most recent N states received from one peer,
+ * ordered by the peer's timestamp.  States which arrive out of order are
+ * inserted in their proper place; duplicates and states older than
+ * everything retained are discarded.
+ *
+ * The peer clock is mapped to the local clock by the smallest observed
+ * (arrival - stamp) difference, which is the transit time of the
+ * least-delayed packet.  Rendering at that mapping minus a playout delay
+ * means that the display always has a state on either side of it, as
+ * long as no packet is delayed by more than the playout delay less the
+ * peer's update interval.  A packet which proves the mapping too
+ * slow is adopted at once.  If the smallest difference in the retained
+ * window grows, because of clock drift or a route change, the mapping
+ * follows it gradually, so that the displayed time never steps backward
+ * by a noticeable amount.
+ */
+template <typename T, std::size_t N>
+class net_jitter_buffer
+{
+	static_assert(N >= 2);
+	struct entry
+	{
+		fix64 sender_time;
+		fix64 clock_offset;
+		T state;
+	};
+	std::array<entry, N> entries;
+	std::size_t count = 0;
+	/* Most recent stamp seen, in raw and unwrapped form, used to unwrap
+	 * the next stamp.
+	 */
+	net_sender_time last_raw_time = 0;
+	fix64 last_sender_time = 0;
+	fix64 clock_offset = 0;
+public:
+	void reset()
+	{
+		count = 0;
+	}
+	bool empty() const
+	{
+		return !count;
+	}
+	std::size_t size() const
+	{
+		return count;
+	}
+	/* Returns false if the state was discarded.
+	 */
+	bool insert(const net_sender_time raw_time, const fix64 local_time, const T &state)
+	{
+		const fix64 sender_time = count
+			? last_sender_time + static_cast<int32_t>(raw_time - last_raw_time)
+			: fix64{raw_time};
+		std::size_t i = count;
+		for (; i; --i)
+		{
+			const auto prior = entries[i - 1].sender_time;
+			if (prior == sender_time)
+				return false;
+			if (prior < sender_time)
+				break;
+		}
+		if (count == N)
+		{
+			/* Full: make room by dropping the oldest entry.  If the new
+			 * state would itself be the oldest, it is not useful.
+			 */
+			if (!i)
+				return false;
+			for (std::size_t j = 1; j < i; ++j)
+				entries[j - 1] = entries[j];
+			--i;
+		}
+		else
+		{
+			for (std::size_t j = count; j > i; --j)
+				entries[j] = entries[j - 1];
+			++count;
+		}
+		const fix64 offset = local_time - sender_time;
+		entries[i] = {sender_time, offset, state};
+		if (i == count - 1)
+		{
+			last_raw_time = raw_time;
+			last_sender_time = sender_time;
+		}
+		if (count == 1 || clock_offset > offset)
+			clock_offset = offset;
+		else
+		{
+			fix64 window_offset = entries[0].clock_offset;
+			for (std::size_t j = 1; j < count; ++j)
+				if (window_offset > entries[j].clock_offset)
+					window_offset = entries[j].clock_offset;
+			clock_offset += (window_offset - clock_offset) / 16;
+		}
+		return true;
+	}
+	/* Returns the local time at which the newest retained state arrived,
+	 * or nullopt if the buffer is empty.
+	 */
+	std::optional<fix64> newest_arrival() const
+	{
+		if (!count)
+			return std::nullopt;
+		auto &e = entries[count - 1];
+		return e.sender_time + e.clock_offset;
+	}
+	/* Choose the states to display at `local_time`, lagging the
+	 * estimated peer clock by `delay`.  When the buffer has run dry,
+	 * extrapolation is limited to `max_extrapolation`.
+	 */
+	std::optional<net_jitter_sample<T>> sample(const fix64 local_time, const fix delay, const fix max_extrapolation) const
+	{
+		if (!count)
+			return std::nullopt;
+		const fix64 target = local_time - clock_offset - delay;
+		auto &newest = entries[count - 1];
+		if (target >= newest.sender_time)
+		{
+			const fix64 ahead = target - newest.sender_time;
+			return net_jitter_sample<T>{newest.state, newest.state, 0, static_cast<fix>(ahead < max_extrapolation ? ahead : max_extrapolation), net_jitter_sample_kind::extrapolate};
+		}
+		auto &oldest = entries[0];
+		if (target <= oldest.sender_time)
+			return net_jitter_sample<T>{oldest.state, oldest.state, 0, 0, net_jitter_sample_kind::hold};
+		std::size_t i = count - 1;
+		while (entries[i - 1].sender_time > target)
+			--i;
+		auto &a = entries[i - 1];
+		auto &b = entries[i];
+		const fix fraction = static_cast<fix>(((target - a.sender_time) << 16) / (b.sender_time - a.sender_time));
+		return net_jitter_sample<T>{a.state, b.state, fraction, 0, net_jitter_sample_kind::interpolate};
+	}
+};
+
+}
@@ -62,6 +62,15 @@ window_event_result net_udp_level_sync();
 namespace dcx {
 constexpr uint16_t UDP_PORT_DEFAULT = 42424;
 #define UDP_MANUAL_ADDR_DEFAULT "localhost"
+/* Milliseconds by which remote ships trail their latest position update.
+ * Two update intervals at the default packet rate.
+ */
+constexpr uint16_t UDP_INTERP_DELAY_DEFAULT = 66;
+/* Object packets which may be awaiting acknowledgement from one joining
+ * player.
+ */
+constexpr unsigned UDP_OBJECT_WINDOW_DEFAULT = 8;
+constexpr unsigned UDP_OBJECT_WINDOW_MAX = 32;
 #if DXX_USE_TRACKER
 #ifndef TRACKER_ADDR_DEFAULT
 /* Allow an alternate default at compile time */
@@ -161,6 +161,12 @@ extern void newdemo_start_recording();
 extern void newdemo_stop_recording();
 
 extern int newdemo_swap_endian(const char *filename);
+// Rewrite a demo as a packed demo, with delta encoded objects and
+// compressed blocks
+extern int newdemo_pack(const char *filename);
+// Pack every demo in the demo directory which is not already packed, and
+// log the sizes and throughput of each and of all of them
+void newdemo_pack_all();
 
 extern int newdemo_get_percent_done();
 
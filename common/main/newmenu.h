@@ -27,6 +27,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #include "fwd-event.h"
 
+#include <climits>
 #include <cstdint>
 #include <algorithm>
 #include <memory>
@@ -35,6 +36,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 #include "varutil.h"
 #include "dxxsconf.h"
 #include "dsx-ns.h"
@@ -353,6 +355,7 @@ struct newmenu : newmenu_layout, window, mixin_trackable_window
 	newmenu(const menu_title title, const menu_subtitle subtitle, const menu_filename filename, const tiny_mode_flag tiny_mode, const tab_processing_flag tabs_flag, const adjusted_citem citem_init, grs_canvas &src, const draw_box_flag draw_box = draw_box_flag::menu_background) :
 		newmenu_layout(title, subtitle, filename, src, tiny_mode, tabs_flag, citem_init, draw_box), window(src, x, y, w, h)
 	{
+		set_animated(0);
 	}
 	std::shared_ptr<int> rval;			// Pointer to return value (for polling newmenus)
 	virtual window_event_result event_handler(const d_event &) override;
@@ -407,7 +410,7 @@ struct listbox_layout
 		{
 		}
 		fix64 lasttime; // to scroll text if string does not fit in box
-		const unsigned maxchars;
+		const unsigned maxchars;	// size of text
 		int pos = 0, scrollback = 0;
 		char text[0];	/* must be last */
 	};
@@ -417,7 +420,19 @@ struct listbox_layout
 	{
 		create_structure();
 	}
+	/* Width of an item in MEDIUM3_FONT, and how many of its characters
+	 * are shown at once if it is too wide for the box.  Each is measured
+	 * when first needed, and kept until the screen or font scale changes.
+	 */
+	struct item_metrics
+	{
+		static constexpr unsigned unmeasured = UINT_MAX;
+		unsigned width = unmeasured;
+		unsigned marquee_chars = unmeasured;
+	};
 	void create_structure();
+	const item_metrics &measure_item(unsigned i);
+	std::vector<item_metrics> metrics;
 	unsigned items_on_screen;
 	int box_x, box_y;
 	int box_w, height, title_height;
@@ -67,15 +67,33 @@ struct window_rendered_data
 
 extern int Render_depth; //how many segments deep to render
 constexpr std::integral_constant<unsigned, 8> Max_perspective_depth{}; //	Deepest segment at which perspective extern interpolation will be used.
-constexpr std::integral_constant<unsigned, 20> Max_linear_depth_objects{};
-constexpr std::integral_constant<unsigned, 50> Simple_model_threshhold_scale{}; // switch to simpler model when the object has depth greater than this value times its radius.
-constexpr std::integral_constant<unsigned, 15> Max_debris_objects{}; // How many debris objects to create
+extern unsigned Simple_model_threshhold_scale; // switch to simpler model when the object has depth greater than this value times its radius.
+extern unsigned Max_debris_objects; // How many debris objects to create
 
 #if DXX_USE_OGL
 #define DETRIANGULATION 0
 #else
 #define DETRIANGULATION 1
 extern unsigned Max_linear_depth; //	Deepest segment at which linear extern interpolation will be used.
+extern unsigned Max_linear_depth_objects;
+#endif
+
+#if DXX_USE_OGL
+/* Percentage of the window size at which the game view is rendered */
+extern unsigned Render_resolution_scale;
+#endif
+
+/* -adaptivefps: choose the values above from the recent frame times.
+ * `busy_time` is the duration of the last frame, excluding any wait for
+ * the frame rate limit.
+ */
+void adaptive_detail_frame(fix busy_time);
+void show_adaptive_detail_stats(grs_canvas &canvas);
+#if !DXX_USE_OGL
+/* -renderstats: the pixels which the span coverage pass shaded and
+ * skipped since the last call.
+ */
+void show_span_stats(grs_canvas &canvas);
 #endif
 
 extern int Clear_window;    // 1 = Clear whole background window, 2 = clear view portals into rest of world, 0 = no clear
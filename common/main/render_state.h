@@ -17,6 +17,10 @@ struct rect
 
 namespace dcx {
 
+#if !DXX_USE_OGL
+enum class tmap_coverage_face : uint32_t;
+#endif
+
 struct render_state_t
 {
 	struct per_segment_state_t
@@ -29,6 +33,10 @@ struct render_state_t
 		uint16_t Seg_depth = 0;		//depth for this seg in Render_list
 		bool processed = false;		//whether this entry has been processed
 		rect render_window;
+#if !DXX_USE_OGL
+		//coverage records of each face, indexed by side and face number
+		per_side_array<std::array<tmap_coverage_face, 2>> coverage_faces{};
+#endif
 	};
 	unsigned N_render_segs = 0;
 	std::array<segnum_t, MAX_RENDER_SEGS> Render_list;
@@ -22,45 +22,6 @@ namespace dcx {
 
 #define EPSILON (F1_0/100)
 
-namespace {
-
-class fix_sincos_input
-{
-public:
-	const uint8_t m_idx;
-	const signed m_mul;
-	fix_sincos_input(const fixang a) :
-		m_idx(static_cast<uint8_t>(a >> 8)),
-		m_mul(static_cast<uint8_t>(a))
-	{
-	}
-};
-
-}
-
-fix64 fixmul64(fix a, fix b)
-{
-	const fix64 a64 = a;
-	const fix64 b64 = b;
-	return (a64 * b64) / 65536;
-}
-
-fix fixdiv(fix a, fix b)
-{
-	if (!b)
-		return 1;
-	const fix64 a64 = a;
-	return static_cast<fix>((a64 * 65536) / b);
-}
-
-fix fixmuldiv(fix a, fix b, fix c)
-{
-	if (!c)
-		return 1;
-	const fix64 a64 = a;
-	return static_cast<fix>((a64 * b) / c);
-}
-
 //given cos & sin of an angle, return that angle.
 //parms need not be normalized, that is, the ratio of the parms cos/sin must
 //equal the ratio of the actual cos & sin for the result angle, but the parms 
@@ -218,49 +179,6 @@ fix fix_sqrt(fix a)
 	return static_cast<fix>(long_sqrt(a)) << 8;
 }
 
-[[nodiscard]]
-static fix fix_sincos(const uint8_t idx0, const signed mul)
-{
-	const fix t0 = sincos_table[idx0];
-	/* `idx1` is `uint8_t` to truncate the value, since sincos_table is
-	 * only 256 elements long.
-	 */
-	const uint8_t idx1 = idx0 + 1;
-	const fix t1 = sincos_table[idx1];
-	return (t0 + (((t1 - t0) * mul) >> 8)) << 2;
-}
-
-[[nodiscard]]
-static fix fix_sin(const fix_sincos_input sci)
-{
-	return fix_sincos(sci.m_idx, sci.m_mul);
-}
-
-[[nodiscard]]
-static fix fix_cos(const fix_sincos_input sci)
-{
-	return fix_sincos(static_cast<uint8_t>(sci.m_idx + 64), sci.m_mul);
-}
-
-//compute sine and cosine of an angle, filling in the variables
-//either of the pointers can be NULL
-//with interpolation
-fix_sincos_result fix_sincos(const fixang a)
-{
-	fix_sincos_input i(a);
-	return {fix_sin(i), fix_cos(i)};
-}
-
-fix fix_sin(const fixang a)
-{
-	return fix_sin(fix_sincos_input{a});
-}
-
-fix fix_cos(const fixang a)
-{
-	return fix_cos(fix_sincos_input{a});
-}
-
 //compute sine and cosine of an angle, filling in the variables
 //no interpolation
 fix fix_fastsin(const fixang a)
@@ -103,15 +103,6 @@ void vm_vec_scale_add(vms_vector &dest,const vms_vector &src1,const vms_vector &
 	dest.z = src1.z + fixmul(src2.z,k);
 }
 
-//scales a vector and adds it to another
-//dest += k * src
-void vm_vec_scale_add2(vms_vector &dest,const vms_vector &src,fix k)
-{
-	dest.x += fixmul(src.x,k);
-	dest.y += fixmul(src.y,k);
-	dest.z += fixmul(src.z,k);
-}
-
 //scales a vector in place, taking n/d for scale.  returns ptr to vector
 //dest *= n/d
 void vm_vec_scale2(vms_vector &dest,fix n,fix d)
@@ -155,26 +146,6 @@ static fix vm_vec_dot3(fix x,fix y,fix z,const vms_vector &v)
 #endif
 }
 
-fix vm_vec_dot(const vms_vector &v0,const vms_vector &v1)
-{
-	return vm_vec_dot3(v0.x, v0.y, v0.z, v1);
-}
-
-vm_magnitude_squared vm_vec_mag2(const vms_vector &v)
-{
-	const int64_t x = v.x;
-	const int64_t y = v.y;
-	const int64_t z = v.z;
-	return vm_magnitude_squared{static_cast<uint64_t>((x * x) + (y * y) + (z * z))};
-}
-
-vm_magnitude vm_vec_mag(const vms_vector &v)
-{
-	quadint q;
-	q.q = static_cast<uint64_t>(vm_vec_mag2(v));
-	return vm_magnitude{quad_sqrt(q)};
-}
-
 //computes the distance between two points. (does sub and mag)
 vm_distance vm_vec_dist(const vms_vector &v0,const vms_vector &v1)
 {
@@ -230,13 +201,6 @@ vm_magnitude vm_vec_copy_normalize(vms_vector &dest,const vms_vector &src)
 	return m;
 }
 
-void vm_vec_divide(vms_vector &dest,const vms_vector &src, fix m)
-{
-	dest.x = fixdiv(src.x,m);
-	dest.y = fixdiv(src.y,m);
-	dest.z = fixdiv(src.z,m);
-}
-
 //normalize a vector. returns mag of source vec
 vm_magnitude vm_vec_normalize(vms_vector &v)
 {
@@ -267,14 +231,6 @@ vm_magnitude vm_vec_normalized_dir_quick(vms_vector &dest,const vms_vector &end,
 	return vm_vec_normalize_quick(vm_vec_sub(dest,end,start));
 }
 
-//return the normalized direction vector between two points
-//dest = normalized(end - start).  Returns mag of direction vector
-//NOTE: the order of the parameters matches the vector subtraction
-vm_magnitude vm_vec_normalized_dir(vms_vector &dest,const vms_vector &end,const vms_vector &start)
-{
-	return vm_vec_normalize(vm_vec_sub(dest,end,start));
-}
-
 //computes surface normal from three points. result is normalized
 //returns ptr to dest
 //dest CANNOT equal either source
@@ -510,15 +466,6 @@ bad_vector2:
 }
 
 
-//rotates a vector through a matrix. returns ptr to dest vector
-//dest CANNOT equal source
-void vm_vec_rotate(vms_vector &dest,const vms_vector &src,const vms_matrix &m)
-{
-	dest.x = vm_vec_dot(src,m.rvec);
-	dest.y = vm_vec_dot(src,m.uvec);
-	dest.z = vm_vec_dot(src,m.fvec);
-}
-
 //mulitply 2 matrices, fill in dest.  returns ptr to dest
 //dest CANNOT equal either source
 void _vm_matrix_x_matrix(vms_matrix &dest,const vms_matrix &src0,const vms_matrix &src1)
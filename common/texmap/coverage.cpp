@@ -0,0 +1,215 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Span coverage buffer for drawing opaque faces without overdraw.
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+#include "gr.h"
+#include "texmap.h"
+#include "texmapl.h"
+
+namespace dcx {
+
+namespace {
+
+enum class tmap_coverage_phase : uint8_t
+{
+	off,
+	record,
+	replay,
+};
+
+/* Inclusive range of columns on one row.
+ */
+struct tmap_span
+{
+	int left, right;
+};
+
+struct tmap_recorded_span : tmap_span
+{
+	int y;
+};
+
+struct tmap_recorded_face
+{
+	uint32_t begin, end;
+	bool recorded;
+};
+
+static tmap_coverage_phase Coverage_phase;
+static int Coverage_width;
+/* For each row, the sorted, disjoint and non-adjacent spans covered by
+ * the faces recorded so far.
+ */
+static std::vector<std::vector<tmap_span>> Coverage_rows;
+static std::vector<tmap_recorded_span> Recorded_spans;
+static std::vector<tmap_recorded_face> Recorded_faces;
+/* In the record phase, the face which receives new spans.  In the replay
+ * phase, the face being drawn, or nullptr to draw without restriction.
+ */
+static tmap_recorded_face *Current_face;
+static uint32_t Replay_cursor;
+
+static tmap_recorded_face *get_face(const tmap_coverage_face face)
+{
+	const auto i = static_cast<uint32_t>(face);
+	return i ? &Recorded_faces[i - 1] : nullptr;
+}
+
+/* Append the parts of [left, right] on row y which are not yet covered
+ * to the current face, then mark all of [left, right] covered.
+ */
+static void record_span(const int y, int left, int right)
+{
+	if (static_cast<unsigned>(y) >= Coverage_rows.size())
+		return;
+	left = std::max(left, 0);
+	right = std::min(right, Coverage_width - 1);
+	if (left > right)
+		return;
+	auto &row = Coverage_rows[y];
+	/* First span which covers or touches a column at or after `left`.
+	 */
+	const auto first = std::lower_bound(row.begin(), row.end(), left - 1, [](const tmap_span &s, const int x) { return s.right < x; });
+	auto x = left;
+	auto last = first;
+	for (; last != row.end() && last->left <= right + 1; ++last)
+	{
+		if (last->left > x)
+			Recorded_spans.push_back({{x, std::min(last->left - 1, right)}, y});
+		x = std::max(x, last->right + 1);
+	}
+	if (x <= right)
+		Recorded_spans.push_back({{x, right}, y});
+	Current_face->end = Recorded_spans.size();
+	if (first == last)
+		row.insert(first, {left, right});
+	else
+	{
+		first->left = std::min(first->left, left);
+		first->right = std::max(std::prev(last)->right, right);
+		row.erase(std::next(first), last);
+	}
+}
+
+}
+
+tmap_span_stats Tmap_span_stats;
+
+void tmap_coverage_start_recording(const grs_bitmap &canvas)
+{
+	Coverage_phase = tmap_coverage_phase::record;
+	Coverage_width = canvas.bm_w;
+	Coverage_rows.resize(canvas.bm_h);
+	for (auto &row : Coverage_rows)
+		row.clear();
+	Recorded_spans.clear();
+	Recorded_faces.clear();
+	Current_face = nullptr;
+}
+
+tmap_coverage_face tmap_coverage_record_face()
+{
+	if (Coverage_phase != tmap_coverage_phase::record)
+		return tmap_coverage_face::none;
+	const uint32_t begin = Recorded_spans.size();
+	Current_face = &Recorded_faces.emplace_back(tmap_recorded_face{begin, begin, false});
+	return static_cast<tmap_coverage_face>(Recorded_faces.size());
+}
+
+void tmap_coverage_start_replay()
+{
+	Coverage_phase = tmap_coverage_phase::replay;
+	Current_face = nullptr;
+}
+
+void tmap_coverage_replay_face(const tmap_coverage_face face)
+{
+	if (Coverage_phase != tmap_coverage_phase::replay)
+		return;
+	Current_face = get_face(face);
+	if (Current_face)
+	{
+		if (!Current_face->recorded)
+			Current_face = nullptr;
+		else
+			Replay_cursor = Current_face->begin;
+	}
+}
+
+void tmap_coverage_stop()
+{
+	Coverage_phase = tmap_coverage_phase::off;
+	Current_face = nullptr;
+}
+
+bool tmap_coverage_recording()
+{
+	return Coverage_phase == tmap_coverage_phase::record;
+}
+
+void tmap_coverage_mark_face_recorded()
+{
+	if (Current_face)
+		Current_face->recorded = true;
+}
+
+void tmap_coverage_draw_span(void (*const scanline)(), const bool perspective)
+{
+	const int width = fx_xright - fx_xleft + 1;
+	if (width <= 0)
+		return;
+	if (Coverage_phase == tmap_coverage_phase::record)
+	{
+		if (Current_face)
+			record_span(fx_y, fx_xleft, fx_xright);
+		return;
+	}
+	if (!Current_face)
+	{
+		Tmap_span_stats.pixels_shaded += width;
+		scanline();
+		return;
+	}
+	/* Draw each recorded piece of this row.  The interface variables
+	 * describe the span from its original left edge, so advance them to
+	 * the left edge of each piece.  fx_z is only valid for perspective
+	 * spans.
+	 */
+	const auto xleft = fx_xleft;
+	const auto u = fx_u, v = fx_v, z = fx_z, l = fx_l;
+	auto &cursor = Replay_cursor;
+	const auto end = Current_face->end;
+	for (; cursor != end && Recorded_spans[cursor].y < fx_y; ++cursor)
+	{
+	}
+	int drawn = 0;
+	for (; cursor != end && Recorded_spans[cursor].y == fx_y; ++cursor)
+	{
+		auto &s = Recorded_spans[cursor];
+		const auto advance = s.left - xleft;
+		fx_u = u + fx_du_dx * advance;
+		fx_v = v + fx_dv_dx * advance;
+		if (perspective)
+			fx_z = z + fx_dz_dx * advance;
+		fx_l = l + fx_dl_dx * advance;
+		fx_xleft = s.left;
+		fx_xright = s.right;
+		drawn += s.right - s.left + 1;
+		scanline();
+	}
+	Tmap_span_stats.pixels_shaded += drawn;
+	Tmap_span_stats.pixels_skipped += width - drawn;
+}
+
+}
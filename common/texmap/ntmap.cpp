@@ -36,8 +36,11 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "scanline.h"
 #include "u_mem.h"
 #include "d_zip.h"
+#include "args.h"
 #include "dxxsconf.h"
 #include "dsx-ns.h"
+#include <algorithm>
+#include <cstdlib>
 #include <utility>
 
 namespace dcx {
@@ -100,6 +103,50 @@ void init_interface_vars_to_assembler(void)
 }
 
 static int Lighting_enabled;
+
+//	Texture being drawn and, once a span has needed them, its reduced copies.
+static const grs_bitmap *Tmap_mip_source;
+static const tmap_mip_chain *Tmap_mip_chain;
+
+// -------------------------------------------------------------------------------------
+//	Returns the absolute rate of change of a/z per pixel, given a, z and
+//	their rates of change, in the units of a.  The result saturates
+//	well above the point where the smallest reduced texture is used.
+// -------------------------------------------------------------------------------------
+static fix compute_perspective_gradient(const fix a, const fix da_dx, const fix z, const fix dz_dx)
+{
+	const int64_t q = std::abs((static_cast<int64_t>(da_dx) * z - static_cast<int64_t>(a) * dz_dx) / z);
+	if (q >= static_cast<int64_t>(z) << 8)
+		return 256 * F1_0;
+	return static_cast<fix>((q << 16) / z);
+}
+
+// -------------------------------------------------------------------------------------
+//	Point pixptr at the copy of srcb which best suits a span whose texture
+//	coordinates advance by du_dx and dv_dx texels per pixel, so that
+//	distant spans read adjacent texels instead of skipping over most of
+//	them.  Returns how many times the chosen copy was halved; the caller
+//	must scale its u and v down by the same amount.
+// -------------------------------------------------------------------------------------
+static unsigned select_mip_level(const grs_bitmap &srcb, const fix du_dx, const fix dv_dx)
+{
+	pixptr = srcb.bm_data;
+	auto rho = std::max(std::abs(du_dx), std::abs(dv_dx));
+	if (rho < F1_0 * 2 || CGameArg.DbgSdlNoMipmap || tmap_coverage_recording())
+		return 0;
+	if (Tmap_mip_source)
+	{
+		Tmap_mip_chain = tmap_mip_get(*Tmap_mip_source);
+		Tmap_mip_source = nullptr;
+	}
+	if (!Tmap_mip_chain)
+		return 0;
+	unsigned level = 0;
+	for (; rho >= F1_0 * 2 && level < Tmap_mip_chain->size(); rho >>= 1)
+		++level;
+	pixptr = (*Tmap_mip_chain)[level - 1].data();
+	return level;
+}
 // -------------------------------------------------------------------------------------
 //                             VARIABLES
 
@@ -308,7 +355,24 @@ static void ntmap_scanline_lighted(const grs_bitmap &srcb, int y, fix xleft, fix
 	fx_dv_dx = fixmul(vright - vleft,recip_dx);
 	fx_dz_dx = fixmul(zright - zleft,recip_dx);
 	fx_y = y;
-	pixptr = srcb.bm_data;
+
+	{
+		//	Measure the texel step at the middle of the span, where it is
+		//	representative of the whole span.
+		const fix half_dx = dx / 2;
+		const fix zmid = fx_z + fx_dz_dx * half_dx;
+		unsigned level = 0;
+		if (zmid > 0)
+			level = select_mip_level(srcb,
+				compute_perspective_gradient(fx_u + fx_du_dx * half_dx, fx_du_dx, zmid, fx_dz_dx),
+				compute_perspective_gradient(fx_v + fx_dv_dx * half_dx, fx_dv_dx, zmid, fx_dz_dx));
+		else
+			pixptr = srcb.bm_data;
+		fx_u >>= level;
+		fx_v >>= level;
+		fx_du_dx >>= level;
+		fx_dv_dx >>= level;
+	}
 
 	switch (Lighting_enabled) {
 		case 0:
@@ -319,7 +383,7 @@ static void ntmap_scanline_lighted(const grs_bitmap &srcb, int y, fix xleft, fix
 			if (fx_xright > Window_clip_right)
 				fx_xright = Window_clip_right;
 			
-			cur_tmap_scanline_per();
+			tmap_coverage_draw_span(cur_tmap_scanline_per, true);
 			break;
 		case 1: {
 			fix	mul_thing;
@@ -346,7 +410,7 @@ static void ntmap_scanline_lighted(const grs_bitmap &srcb, int y, fix xleft, fix
 			if (fx_xright > Window_clip_right)
 				fx_xright = Window_clip_right;
 
-			cur_tmap_scanline_per();
+			tmap_coverage_draw_span(cur_tmap_scanline_per, true);
 			break;
 		}
 		case 2:
@@ -557,14 +621,16 @@ static void ntmap_scanline_lighted_linear(const grs_bitmap &srcb, int y, fix xle
 		du_dx = fixmul(uright - uleft,recip_dx);
 		dv_dx = fixmul(vright - vleft,recip_dx);
 
-		fx_u = uleft;
-		fx_v = vleft;
-		fx_du_dx = du_dx;
-		fx_dv_dx = dv_dx;
+		{
+			const auto level = select_mip_level(srcb, du_dx, dv_dx);
+			fx_u = uleft >> level;
+			fx_v = vleft >> level;
+			fx_du_dx = du_dx >> level;
+			fx_dv_dx = dv_dx >> level;
+		}
 		fx_y = y;
 		fx_xright = f2i(xright);
 		fx_xleft = f2i(xleft);
-		pixptr = srcb.bm_data;
 
 		switch (Lighting_enabled) {
 			case 0:
@@ -573,7 +639,7 @@ static void ntmap_scanline_lighted_linear(const grs_bitmap &srcb, int y, fix xle
 					fx_xleft = 0;
 				//end addition -adb
 				
-				c_tmap_scanline_lin_nolight();
+				tmap_coverage_draw_span(c_tmap_scanline_lin_nolight, false);
 				break;
 			case 1:
 				if (lleft < F1_0/2)
@@ -608,7 +674,7 @@ static void ntmap_scanline_lighted_linear(const grs_bitmap &srcb, int y, fix xle
 				fx_l = lleft;
 				dl_dx = fixmul(lright - lleft,recip_dx);
 				fx_dl_dx = dl_dx;
-				c_tmap_scanline_lin();
+				tmap_coverage_draw_span(c_tmap_scanline_lin, false);
 				break;
 			case 2:
 #ifdef EDITOR_TMAP
@@ -800,9 +866,13 @@ void draw_tmap(grs_canvas &canvas, const grs_bitmap &rbp, const std::span<const
 	const grs_bitmap *bp = &rbp;
 	//	If no transparency and seg depth is large, render as flat shaded.
 	if ((Current_seg_depth > Max_linear_depth) && ((bp->get_flag_mask(3)) == 0)) {
-		draw_tmap_flat(canvas, rbp, vertbuf);
+		//	Flat faces are cheap enough to draw in full, so they are not recorded.
+		if (!tmap_coverage_recording())
+			draw_tmap_flat(canvas, rbp, vertbuf);
 		return;
 	}
+	if (tmap_coverage_recording())
+		tmap_coverage_mark_face_recorded();
 
 	bp = rle_expand_texture(*bp);		// Expand if rle'd
 
@@ -836,6 +906,8 @@ void draw_tmap(grs_canvas &canvas, const grs_bitmap &rbp, const std::span<const
 
 
 	Lighting_enabled = Lighting_on;
+	Tmap_mip_source = bp;
+	Tmap_mip_chain = nullptr;
 
 	// Now, call my texture mapper.
 		switch (Interpolation_method) {	// 0 = choose, 1 = linear, 2 = /8 perspective, 3 = full perspective
@@ -33,6 +33,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include <cstddef>
 #include "dxxsconf.h"
 #include "dsx-ns.h"
+#include "fwd-gr.h"
 #include <array>
 
 namespace dcx {
@@ -57,6 +58,22 @@ extern  unsigned char *write_buffer;
 
 extern uint8_t tmap_flat_color;
 
+/* Reduced copies of a 64x64 texture at 32x32, 16x16 and 8x8.  Each level
+ * is repeated to fill a 64x64 array, so that the scanline renderers can
+ * sample any level with the same coordinate masks as the full texture,
+ * given u and v scaled down to suit the level.
+ */
+using tmap_mip_chain = std::array<std::array<color_palette_index, 64 * 64>, 3>;
+/* Returns nullptr if the texture cannot be reduced.
+ */
+const tmap_mip_chain *tmap_mip_get(const grs_bitmap &bmp);
+
+/* Draw the span described by the interface variables with `scanline`,
+ * subject to the coverage buffer.  In the record phase, nothing is drawn.
+ */
+void tmap_coverage_draw_span(void (*scanline)(), bool perspective);
+void tmap_coverage_mark_face_recorded();
+
 constexpr std::integral_constant<std::size_t, 641> FIX_RECIP_TABLE_SIZE{};	//increased from 321 to 641, since this res is now quite achievable.. slight fps boost -MM
 extern const std::array<fix, FIX_RECIP_TABLE_SIZE> fix_recip_table;
 static inline fix fix_recip(unsigned i)
@@ -0,0 +1,201 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+
+/*
+ *
+ * Reduced resolution copies of textures for the software texture mapper.
+ *
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <climits>
+#include <memory>
+#include <unordered_map>
+#include "gr.h"
+#include "palette.h"
+#include "texmap.h"
+#include "texmapl.h"
+#include "d_range.h"
+
+namespace dcx {
+
+namespace {
+
+/* Texels with these values are not colors, so they must not be averaged
+ * into their neighbors, and the reduced texture must never choose them
+ * to approximate an averaged color.
+ */
+constexpr color_palette_index TMAP_MIP_SUPER_TRANSPARENCY_COLOR{254};
+
+static bool tmap_mip_is_transparent(const color_palette_index c)
+{
+	return c == TRANSPARENCY_COLOR || c == TMAP_MIP_SUPER_TRANSPARENCY_COLOR;
+}
+
+struct tmap_mip_cache_element
+{
+	const grs_bitmap *source;
+	const color_palette_index *source_data;
+	unsigned last_used;
+	std::unique_ptr<tmap_mip_chain> chain;
+};
+
+/* Enough for the textures in view in a busy level, including the merged
+ * and expanded textures, so that mips are not rebuilt every frame.  Each
+ * chain is allocated when its element is first used.
+ */
+static std::array<tmap_mip_cache_element, 512> tmap_mip_cache;
+/* Index into tmap_mip_cache of each source in it. */
+static std::unordered_map<const grs_bitmap *, unsigned> tmap_mip_cache_index;
+static unsigned tmap_mip_counter;
+
+/* The palette index closest to each 6 bit per channel color, computed
+ * when the color is first needed after the palette changes.
+ */
+constexpr std::size_t tmap_mip_color_count = 64 * 64 * 64;
+static std::array<color_palette_index, tmap_mip_color_count> tmap_mip_color_table;
+static std::bitset<tmap_mip_color_count> tmap_mip_color_known;
+
+static color_palette_index tmap_mip_search_color(const int r, const int g, const int b)
+{
+	unsigned best_distance = UINT_MAX;
+	color_palette_index best{};
+	for (const auto i : xrange(TMAP_MIP_SUPER_TRANSPARENCY_COLOR))
+	{
+		auto &p = gr_palette[i];
+		const int dr = p.r - r, dg = p.g - g, db = p.b - b;
+		const unsigned distance = dr * dr + dg * dg + db * db;
+		if (best_distance > distance)
+		{
+			best_distance = distance;
+			best = i;
+			if (!distance)
+				break;
+		}
+	}
+	return best;
+}
+
+static color_palette_index tmap_mip_closest_color(const unsigned r, const unsigned g, const unsigned b)
+{
+	const std::size_t i = (r << 12) | (g << 6) | b;
+	auto &c = tmap_mip_color_table[i];
+	if (!tmap_mip_color_known[i])
+	{
+		c = tmap_mip_search_color(r, g, b);
+		tmap_mip_color_known.set(i);
+	}
+	return c;
+}
+
+/* Reduce the `wh` x `wh` texture at `src` (rows `src_stride` apart) by
+ * half in each direction into `dest`, which is tiled to fill 64x64.  A
+ * destination texel is transparent if at least half of its source texels
+ * are transparent; otherwise, it is the average of the opaque ones.
+ */
+static void tmap_mip_reduce(const color_palette_index *const src, const unsigned src_stride, const unsigned wh, std::array<color_palette_index, 64 * 64> &dest)
+{
+	const unsigned half = wh / 2;
+	for (const auto y : xrange(half))
+		for (const auto x : xrange(half))
+		{
+			const auto s = &src[(y * 2) * src_stride + x * 2];
+			const std::array<color_palette_index, 4> quad{{s[0], s[1], s[src_stride], s[src_stride + 1]}};
+			unsigned r = 0, g = 0, b = 0, opaque = 0;
+			color_palette_index transparent = TRANSPARENCY_COLOR;
+			for (const auto c : quad)
+			{
+				if (tmap_mip_is_transparent(c))
+				{
+					transparent = c;
+					continue;
+				}
+				auto &p = gr_palette[c];
+				r += p.r;
+				g += p.g;
+				b += p.b;
+				++opaque;
+			}
+			const auto c = (opaque <= quad.size() / 2)
+				? transparent
+				: tmap_mip_closest_color((r + opaque / 2) / opaque, (g + opaque / 2) / opaque, (b + opaque / 2) / opaque);
+			for (unsigned ty = y; ty < 64; ty += half)
+				for (unsigned tx = x; tx < 64; tx += half)
+					dest[ty * 64 + tx] = c;
+		}
+}
+
+static void tmap_mip_build(const grs_bitmap &bmp, tmap_mip_chain &chain)
+{
+	tmap_mip_reduce(bmp.bm_data, bmp.bm_rowsize, 64, chain[0]);
+	/* Each further level is reduced from the top left tile of the level
+	 * above it, which holds one complete copy of that level.
+	 */
+	for (unsigned level = 1, wh = 32; level < chain.size(); ++level, wh /= 2)
+		tmap_mip_reduce(chain[level - 1].data(), 64, wh, chain[level]);
+}
+
+}
+
+const tmap_mip_chain *tmap_mip_get(const grs_bitmap &bmp)
+{
+	if (bmp.bm_w != 64 || bmp.bm_h != 64 || bmp.get_flag_mask(BM_FLAG_RLE))
+		return nullptr;
+	const auto counter = ++tmap_mip_counter;
+	tmap_mip_cache_element *e;
+	if (const auto found = tmap_mip_cache_index.find(&bmp); found != tmap_mip_cache_index.end())
+	{
+		e = &tmap_mip_cache[found->second];
+		if (e->source_data == bmp.bm_data)
+		{
+			e->last_used = counter;
+			return e->chain.get();
+		}
+		/* The bitmap has new data, so build its chain again in place. */
+	}
+	else
+	{
+		e = &*std::min_element(tmap_mip_cache.begin(), tmap_mip_cache.end(), [](const tmap_mip_cache_element &a, const tmap_mip_cache_element &b) {
+			return a.last_used < b.last_used;
+		});
+		if (e->source)
+			tmap_mip_cache_index.erase(e->source);
+		tmap_mip_cache_index.emplace(&bmp, std::distance(tmap_mip_cache.begin(), e));
+		if (!e->chain)
+			e->chain = std::make_unique<tmap_mip_chain>();
+	}
+	tmap_mip_build(bmp, *e->chain);
+	e->source = &bmp;
+	e->source_data = bmp.bm_data;
+	e->last_used = counter;
+	return e->chain.get();
+}
+
+void tmap_mip_invalidate(const grs_bitmap &bmp)
+{
+	if (const auto found = tmap_mip_cache_index.find(&bmp); found != tmap_mip_cache_index.end())
+	{
+		auto &e = tmap_mip_cache[found->second];
+		e.source = nullptr;
+		e.last_used = 0;
+		tmap_mip_cache_index.erase(found);
+	}
+}
+
+void tmap_mip_flush()
+{
+	for (auto &i : tmap_mip_cache)
+	{
+		i.source = nullptr;
+		i.last_used = 0;
+	}
+	tmap_mip_cache_index.clear();
+	tmap_mip_color_known.reset();
+}
+
+}
@@ -0,0 +1,92 @@
+#include "adaptive_detail.h"
+#include <array>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth adaptive_detail
+#include <boost/test/unit_test.hpp>
+
+using dcx::adaptive_detail_change;
+using dcx::adaptive_detail_controller;
+
+constexpr dcx::fix target = F1_0 / 60;
+
+/* Cost of a frame at each level, for a scene which can hold the target
+ * only at level 2 or below.
+ */
+constexpr std::array<dcx::fix, dcx::ADAPTIVE_DETAIL_LEVELS> scene_cost{{
+	F1_0 / 200, F1_0 / 120, F1_0 / 75, F1_0 / 45, F1_0 / 30
+}};
+
+/* Test that a controller which is always on target never changes level.
+ */
+BOOST_AUTO_TEST_CASE(adaptive_detail_steady)
+{
+	adaptive_detail_controller c(target, 0, 2);
+	for (unsigned i = 0; i < 60 * 60; ++i)
+		BOOST_TEST((c.update(target) == adaptive_detail_change::none));
+	BOOST_TEST(c.level() == 2u);
+}
+
+/* Test that the level stays within the bounds, however slow or fast the
+ * frames are.
+ */
+BOOST_AUTO_TEST_CASE(adaptive_detail_bounds)
+{
+	adaptive_detail_controller c(target, 1, 3);
+	BOOST_TEST(c.level() == 3u);
+	for (dcx::fix t = 0; t < F1_0 * 60; t += F1_0 / 10)
+		c.update(F1_0 / 10);
+	BOOST_TEST(c.level() == 1u);
+	for (dcx::fix t = 0; t < F1_0 * 60; t += F1_0 / 1000)
+		c.update(F1_0 / 1000);
+	BOOST_TEST(c.level() == 3u);
+}
+
+/* Test that stalls are not mistaken for slow frames.
+ */
+BOOST_AUTO_TEST_CASE(adaptive_detail_stall)
+{
+	adaptive_detail_controller c(target, 0, 4);
+	for (unsigned i = 0; i < 8; ++i)
+		BOOST_TEST((c.update(F1_0) == adaptive_detail_change::none));
+	BOOST_TEST(c.level() == 4u);
+}
+
+/* Simulate a scene whose cost depends on the level, with frames capped
+ * at the target as by vsync.  The controller must settle at the highest
+ * level that holds the target, and its attempts at the next level up
+ * must become less frequent over time.
+ */
+BOOST_AUTO_TEST_CASE(adaptive_detail_vsync)
+{
+	adaptive_detail_controller c(target, 0, 4);
+	unsigned early_raises = 0, late_raises = 0, lowered = 0;
+	constexpr unsigned frames = 60 * 600;
+	for (unsigned i = 0; i < frames; ++i)
+	{
+		const auto cost = scene_cost[c.level()];
+		/* Frames which miss the refresh wait for the next one. */
+		const dcx::fix frame_time = ((cost + target - 1) / target) * target;
+		switch (c.update(frame_time))
+		{
+			case adaptive_detail_change::raised:
+				if (i < frames / 2)
+					++early_raises;
+				else
+					++late_raises;
+				break;
+			case adaptive_detail_change::lowered:
+				++lowered;
+				break;
+			case adaptive_detail_change::none:
+				break;
+		}
+	}
+	BOOST_TEST(c.level() <= 2u);
+	BOOST_TEST(lowered >= 2u);
+	/* With the probe interval capped near a minute, the second five
+	 * minutes allow at most a handful of attempts.
+	 */
+	BOOST_TEST(late_raises <= 6u);
+	BOOST_TEST(late_raises <= early_raises);
+}
@@ -0,0 +1,333 @@
+#include "common/2d/blit_kernels.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth blit_kernels
+#include <boost/test/unit_test.hpp>
+
+namespace {
+
+/* The per-pixel code which the kernels replaced, copied from
+ * common/2d/bitblt.cpp and common/2d/rle.cpp before the change.
+ */
+namespace ref {
+
+void blit_row_masked(uint8_t *const dest, const uint8_t *const src, const std::size_t n)
+{
+	for (std::size_t i = 0; i < n; ++i)
+		if (src[i] != 255)
+			dest[i] = src[i];
+}
+
+constexpr uint8_t RLE_CODE = 0xe0;
+constexpr uint8_t NOT_RLE_CODE = 0x1f;
+constexpr uint8_t TRANSPARENCY_COLOR = 255;
+
+static inline bool IS_RLE_CODE(const uint8_t x)
+{
+	return (x & RLE_CODE) == RLE_CODE;
+}
+
+static inline void rle_stosb(uint8_t *const dest, const unsigned count, const uint8_t color)
+{
+	std::memset(dest, color, count);
+}
+
+void gr_rle_expand_scanline_masked(uint8_t *dest, const uint8_t *src, const uint_fast32_t x1, const uint_fast32_t x2)
+{
+	uint_fast32_t i = 0;
+	uint8_t count;
+	uint8_t color=0;
+
+	if ( x2 < x1 ) return;
+
+	count = 0;
+	while ( i < x1 )	{
+		color = *src++;
+		if ( color == RLE_CODE ) return;
+		if ( IS_RLE_CODE(color) )	{
+			count = color & NOT_RLE_CODE;
+			color = *src++;
+		} else {
+			// unique
+			count = 1;
+		}
+		i += count;
+	}
+	count = i - x1;
+	i = x1;
+	// we know have '*count' pixels of 'color'.
+
+	if ( x1+count > x2 )	{
+		count = x2-x1+1;
+		if ( color != TRANSPARENCY_COLOR )	rle_stosb( dest, count, color );
+		return;
+	}
+
+	if ( color != TRANSPARENCY_COLOR )	rle_stosb( dest, count, color );
+	dest += count;
+	i += count;
+
+	while( i <= x2 )
+	{
+		color = *src++;
+		if ( color == RLE_CODE ) return;
+		if ( IS_RLE_CODE(color) )	{
+			count = color & NOT_RLE_CODE;
+			color = *src++;
+		} else {
+			// unique
+			count = 1;
+		}
+		// we know have '*count' pixels of 'color'.
+		if ( i+count <= x2 )	{
+		} else {
+			count = x2-i+1;
+		}
+		if ( color != 255 )rle_stosb( dest, count, color );
+		i += count;
+		dest += count;
+	}
+}
+
+void gr_rle_expand_scanline(uint8_t *dest, const uint8_t *src, const uint_fast32_t x1, const uint_fast32_t x2)
+{
+	uint_fast32_t i = 0;
+	uint8_t count;
+	uint8_t color=0;
+
+	if ( x2 < x1 ) return;
+
+	count = 0;
+	while ( i < x1 )	{
+		color = *src++;
+		if ( color == RLE_CODE ) return;
+		if ( IS_RLE_CODE(color) )	{
+			count = color & NOT_RLE_CODE;
+			color = *src++;
+		} else {
+			// unique
+			count = 1;
+		}
+		i += count;
+	}
+	count = i - x1;
+	i = x1;
+	// we know have '*count' pixels of 'color'.
+
+	if ( x1+count > x2 )	{
+		count = x2-x1+1;
+		rle_stosb( dest, count, color );
+		return;
+	}
+
+	rle_stosb( dest, count, color );
+	dest += count;
+	i += count;
+
+	while( i <= x2 )		{
+		auto color = *src++;
+		if ( color == RLE_CODE ) return;
+		if ( IS_RLE_CODE(color) )	{
+			count = color & (~RLE_CODE);
+			color = *src++;
+		} else {
+			// unique
+			count = 1;
+		}
+		// we know have '*count' pixels of 'color'.
+		if ( i+count <= x2 )	{
+		} else {
+			count = x2-i+1;
+		}
+		rle_stosb(dest, count, color);
+		i += count;
+		dest += count;
+	}
+}
+
+}
+
+using masked_kernel = void(uint8_t *, const uint8_t *, std::size_t);
+
+/* Draw random rows with `kernel` and with the per-pixel loop, for every
+ * alignment and length, including the tail which is not a multiple of
+ * the word size.
+ */
+void check_blit_row_masked(masked_kernel *const kernel)
+{
+	std::mt19937 rng(1);
+	for (unsigned transparent_share : {0u, 1u, 2u, 4u})
+		for (std::size_t offset = 0; offset < 8; ++offset)
+			for (std::size_t n = 0; n < 96; ++n)
+			{
+				std::array<uint8_t, 112> src, a;
+				/* Shares of 0 and 4 in 4 make rows which are all opaque
+				 * or all transparent.
+				 */
+				for (auto &c : src)
+					c = transparent_share && rng() % 4 < transparent_share ? 255 : static_cast<uint8_t>(rng());
+				for (auto &c : a)
+					c = static_cast<uint8_t>(rng());
+				auto b = a;
+				kernel(&a[offset], &src[offset], n);
+				ref::blit_row_masked(&b[offset], &src[offset], n);
+				BOOST_TEST(a == b);
+			}
+}
+
+/* Encode a random row of `width` pixels as the RLE bitmaps do.  Runs are
+ * at most 31 pixels, pixels which look like an RLE code are always run
+ * coded, and the row ends with RLE_CODE.  About a third of the runs are
+ * transparent.
+ */
+std::vector<uint8_t> make_rle_row(std::mt19937 &rng, const unsigned width)
+{
+	std::vector<uint8_t> row;
+	for (unsigned x = 0; x < width;)
+	{
+		const unsigned left = width - x;
+		switch (rng() % 3)
+		{
+			case 0:
+			{
+				const uint8_t count = std::min<unsigned>(left, 1 + rng() % 31);
+				row.push_back(ref::RLE_CODE | count);
+				row.push_back(rng() % 2 ? ref::TRANSPARENCY_COLOR : static_cast<uint8_t>(rng()));
+				x += count;
+				break;
+			}
+			default:
+			{
+				const unsigned count = std::min<unsigned>(left, 1 + rng() % 24);
+				for (unsigned i = 0; i < count; ++i)
+				{
+					const uint8_t c = rng();
+					if (ref::IS_RLE_CODE(c))
+						row.push_back(ref::RLE_CODE | 1);
+					row.push_back(c);
+				}
+				x += count;
+				break;
+			}
+		}
+	}
+	row.push_back(ref::RLE_CODE);
+	return row;
+}
+
+using rle_kernel = void(uint8_t *, const uint8_t *, uint_fast32_t, uint_fast32_t);
+
+void check_rle_expand(rle_kernel *const expected, rle_kernel *const actual)
+{
+	std::mt19937 rng(2);
+	unsigned mismatches = 0;
+	for (unsigned row = 0; row < 300000; ++row)
+	{
+		const unsigned width = 1 + rng() % 320;
+		const auto src = make_rle_row(rng, width);
+		/* x2 may pass the end of the row, where both stop at the
+		 * terminator, and may be less than x1, where both draw nothing.
+		 */
+		const uint_fast32_t x1 = rng() % width;
+		const uint_fast32_t x2 = rng() % 8 ? x1 + rng() % (width - x1) : rng() % (width + 32);
+		std::vector<uint8_t> a(width + 64);
+		for (auto &c : a)
+			c = static_cast<uint8_t>(rng());
+		auto b = a;
+		expected(b.data(), src.data(), x1, x2);
+		actual(a.data(), src.data(), x1, x2);
+		if (a != b)
+			++mismatches;
+	}
+	BOOST_TEST(mismatches == 0u);
+}
+
+/* Expand or copy a bitmap of `width` by `height` `passes` times and report
+ * the time per row.
+ */
+template <typename F>
+void measure(const char *const name, const unsigned width, const unsigned height, F &&f)
+{
+	constexpr unsigned passes = 16;
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned p = 0; p < passes; ++p)
+		for (unsigned y = 0; y < height; ++y)
+			f(y);
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	BOOST_TEST_MESSAGE(name << " " << width << "x" << height << ": " << elapsed.count() / (passes * height) << " ns/row");
+}
+
+constexpr std::array<std::array<unsigned, 2>, 3> bitmap_sizes{{
+	{{320, 200}},
+	{{640, 480}},
+	{{1920, 1080}},
+}};
+
+}
+
+BOOST_AUTO_TEST_CASE(blit_row_masked)
+{
+	check_blit_row_masked(dcx::gr_blit_row_masked);
+}
+
+BOOST_AUTO_TEST_CASE(blit_row_masked_word)
+{
+	check_blit_row_masked(dcx::gr_blit_row_masked_word);
+}
+
+#if DXX_BLIT_KERNELS_AVX2
+BOOST_AUTO_TEST_CASE(blit_row_masked_avx2)
+{
+	__builtin_cpu_init();
+	if (!__builtin_cpu_supports("avx2"))
+	{
+		BOOST_TEST_MESSAGE("CPU does not support AVX2; skipped");
+		return;
+	}
+	check_blit_row_masked(dcx::gr_blit_row_masked_avx2);
+}
+#endif
+
+/* The expanders must draw exactly what the scalar code drew, for any row
+ * and any span of it.
+ */
+BOOST_AUTO_TEST_CASE(rle_expand_row)
+{
+	check_rle_expand(ref::gr_rle_expand_scanline, dcx::gr_rle_expand_row<false>);
+}
+
+BOOST_AUTO_TEST_CASE(rle_expand_row_masked)
+{
+	check_rle_expand(ref::gr_rle_expand_scanline_masked, dcx::gr_rle_expand_row<true>);
+}
+
+/* Not a check: report the time per row of each kernel and the code it
+ * replaced.  Run with --log_level=message to see the results.
+ */
+BOOST_AUTO_TEST_CASE(blit_kernels_benchmark)
+{
+	std::mt19937 rng(3);
+	for (const auto &[width, height] : bitmap_sizes)
+	{
+		std::vector<std::vector<uint8_t>> rle_rows(height);
+		std::vector<uint8_t> pixels(width * height), dest(width);
+		for (auto &r : rle_rows)
+			r = make_rle_row(rng, width);
+		for (auto &c : pixels)
+			c = rng() % 3 ? static_cast<uint8_t>(rng()) : 255;
+		measure("ref::blit_row_masked", width, height, [&](unsigned y) { ref::blit_row_masked(dest.data(), &pixels[y * width], width); });
+		measure("gr_blit_row_masked_word", width, height, [&](unsigned y) { dcx::gr_blit_row_masked_word(dest.data(), &pixels[y * width], width); });
+		measure("gr_blit_row_masked", width, height, [&](unsigned y) { dcx::gr_blit_row_masked(dest.data(), &pixels[y * width], width); });
+		measure("ref::gr_rle_expand_scanline", width, height, [&](unsigned y) { ref::gr_rle_expand_scanline(dest.data(), rle_rows[y].data(), 0, width - 1); });
+		measure("gr_rle_expand_row<false>", width, height, [&](unsigned y) { dcx::gr_rle_expand_row<false>(dest.data(), rle_rows[y].data(), 0, width - 1); });
+		measure("ref::gr_rle_expand_scanline_masked", width, height, [&](unsigned y) { ref::gr_rle_expand_scanline_masked(dest.data(), rle_rows[y].data(), 0, width - 1); });
+		measure("gr_rle_expand_row<true>", width, height, [&](unsigned y) { dcx::gr_rle_expand_row<true>(dest.data(), rle_rows[y].data(), 0, width - 1); });
+		BOOST_TEST(dest.size() == width);
+	}
+}
@@ -0,0 +1,348 @@
+#include "dxxsconf.h"
+#include "common/3d/clipper.h"
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth clipper_batch
+#include <boost/test/unit_test.hpp>
+
+#if !DXX_USE_OGL
+namespace dcx {
+
+namespace {
+
+/* The clipper which polygon_clip_batch replaced, copied from
+ * common/3d/clipper.cpp before the change.  Each polygon was clipped with
+ * a new temporary_points_t, as _g3_draw_tmap and _g3_draw_poly did.
+ */
+namespace ref {
+
+struct temporary_points_t
+{
+	uint_fast32_t free_point_num;
+	std::array<g3s_point, MAX_POINTS_IN_POLY> temp_points;
+	std::array<g3s_point *, MAX_POINTS_IN_POLY> free_points;
+	temporary_points_t() :
+		free_point_num(0)
+	{
+		auto p = &temp_points.front();
+		for (auto &f : free_points)
+			f = p++;
+	}
+	void free_temp_point(g3s_point &p)
+	{
+		if (!(p.p3_flags & projection_flag::temp_point))
+			throw std::invalid_argument("freeing non-temporary point");
+		if (--free_point_num >= free_points.size())
+			throw std::out_of_range("too many free points");
+		free_points[free_point_num] = &p;
+		p.p3_flags &= ~projection_flag::temp_point;
+	}
+};
+
+static g3s_point &get_temp_point(temporary_points_t &t)
+{
+	if (t.free_point_num >= t.free_points.size())
+		throw std::out_of_range("not enough free points");
+	auto &p = *t.free_points[t.free_point_num++];
+	p.p3_flags = projection_flag::temp_point;
+	return p;
+}
+
+static g3s_point &clip_edge(const clipping_code plane_flag, g3s_point *on_pnt, g3s_point *off_pnt, temporary_points_t &tp)
+{
+	fix psx_ratio;
+	fix a,b,kn,kd;
+
+	if ((plane_flag & (clipping_code::off_right | clipping_code::off_left)) != clipping_code::None)
+	{
+		a = on_pnt->p3_x;
+		b = off_pnt->p3_x;
+	}
+	else {
+		a = on_pnt->p3_y;
+		b = off_pnt->p3_y;
+	}
+
+	if ((plane_flag & (clipping_code::off_left | clipping_code::off_bot)) != clipping_code::None)
+	{
+		a = -a;
+		b = -b;
+	}
+
+	kn = a - on_pnt->p3_z;
+	kd = kn - b + off_pnt->p3_z;
+
+	auto &tmp = get_temp_point(tp);
+
+	psx_ratio = fixdiv( kn, kd );
+	tmp.p3_x = on_pnt->p3_x + fixmul( (off_pnt->p3_x-on_pnt->p3_x), psx_ratio);
+	tmp.p3_y = on_pnt->p3_y + fixmul( (off_pnt->p3_y-on_pnt->p3_y), psx_ratio);
+
+	if ((plane_flag & (clipping_code::off_top | clipping_code::off_bot)) != clipping_code::None)
+		tmp.p3_z = tmp.p3_y;
+	else
+		tmp.p3_z = tmp.p3_x;
+
+	if ((plane_flag & (clipping_code::off_left | clipping_code::off_bot)) != clipping_code::None)
+		tmp.p3_z = -tmp.p3_z;
+
+	if (on_pnt->p3_flags & projection_flag::uvs) {
+		tmp.p3_u = on_pnt->p3_u + fixmul((off_pnt->p3_u-on_pnt->p3_u), psx_ratio);
+		tmp.p3_v = on_pnt->p3_v + fixmul((off_pnt->p3_v-on_pnt->p3_v), psx_ratio);
+		tmp.p3_flags |= projection_flag::uvs;
+	}
+
+	if (on_pnt->p3_flags & projection_flag::ls) {
+		tmp.p3_l = on_pnt->p3_l + fixmul((off_pnt->p3_l-on_pnt->p3_l), psx_ratio);
+		tmp.p3_flags |= projection_flag::ls;
+	}
+	g3_code_point(tmp);
+	return tmp;
+}
+
+static int clip_plane(const clipping_code plane_flag, polygon_clip_points &src, polygon_clip_points &dest, int *nv, g3s_codes *const cc, temporary_points_t &tp)
+{
+	src[*nv] = src[0];
+	src[*nv+1] = src[1];
+
+	*cc = {};
+
+	uint_fast32_t j = 0;
+	for (int i=1;i<=*nv;i++) {
+
+		if ((src[i]->p3_codes & plane_flag) != clipping_code::None)
+		{
+			if ((src[i-1]->p3_codes & plane_flag) == clipping_code::None)
+			{
+				dest[j] = &clip_edge(plane_flag,src[i-1],src[i],tp);
+				cc->uor  |= dest[j]->p3_codes;
+				cc->uand &= dest[j]->p3_codes;
+				++j;
+			}
+
+			if ((src[i+1]->p3_codes & plane_flag) == clipping_code::None)
+			{
+				dest[j] = &clip_edge(plane_flag,src[i+1],src[i],tp);
+				cc->uor  |= dest[j]->p3_codes;
+				cc->uand &= dest[j]->p3_codes;
+				++j;
+			}
+
+			if (src[i]->p3_flags & projection_flag::temp_point)
+				tp.free_temp_point(*src[i]);
+		}
+		else {
+			dest[j++] = src[i];
+
+			cc->uor  |= src[i]->p3_codes;
+			cc->uand &= src[i]->p3_codes;
+		}
+	}
+	return j;
+}
+
+const polygon_clip_points &clip_polygon(polygon_clip_points &rsrc,polygon_clip_points &rdest,int *nv,g3s_codes *cc, temporary_points_t &tp)
+{
+	polygon_clip_points *src = &rsrc, *dest = &rdest;
+	for (uint8_t plane_step = 1; plane_step < 16; plane_step <<= 1)
+	{
+		const clipping_code plane_flag{plane_step};
+		if ((cc->uor & plane_flag) != clipping_code::None)
+		{
+			*nv = clip_plane(plane_flag,*src,*dest,nv,cc,tp);
+			if (cc->uand != clipping_code::None)
+				return *dest;
+
+			std::swap(src, dest);
+		}
+	}
+
+	return *src;
+}
+
+}
+
+/* A polygon as a draw call passes it to the clipper: its own copy of its
+ * points, coded, and the codes of the points combined.
+ */
+struct polygon
+{
+	std::vector<g3s_point> points;
+	g3s_codes cc;
+};
+
+/* Make a polygon of 3 to 12 points around the view axis, so that some
+ * polygons are inside the view, some cross one or more planes and some
+ * are behind the viewer.  Textured polygons carry u, v and l, which
+ * clipping interpolates.
+ */
+polygon make_polygon(std::mt19937 &rng)
+{
+	polygon r;
+	const unsigned nv = 3 + rng() % 10;
+	const bool textured = rng() % 4;
+	const fix spread = F1_0 / 16 + rng() % (4 * F1_0);
+	std::uniform_int_distribution<fix> z_dist(-F1_0 / 4, 4 * F1_0);
+	std::uniform_int_distribution<fix> xy_dist(-spread, spread);
+	std::uniform_int_distribution<fix> uvl_dist(0, 4 * F1_0);
+	const fix cz = z_dist(rng), cx = xy_dist(rng), cy = xy_dist(rng);
+	std::uniform_int_distribution<fix> jitter(-spread / 2, spread / 2);
+	r.points.resize(nv);
+	for (auto &p : r.points)
+	{
+		p = {};
+		p.p3_x = cx + jitter(rng);
+		p.p3_y = cy + jitter(rng);
+		p.p3_z = cz + jitter(rng) / 2;
+		if (textured)
+		{
+			p.p3_u = uvl_dist(rng);
+			p.p3_v = uvl_dist(rng);
+			p.p3_l = uvl_dist(rng);
+			p.p3_flags = projection_flag::uvs | projection_flag::ls;
+		}
+		const auto c = g3_code_point(p);
+		r.cc.uor |= c;
+		r.cc.uand &= c;
+	}
+	return r;
+}
+
+/* What the clipper left for one polygon, by value, so that results from
+ * different point pools compare equal.  u, v and l are only compared
+ * where the flags say they were set.
+ */
+struct clipped_point
+{
+	fix x, y, z, u, v, l;
+	clipping_code codes;
+	projection_flag flags;
+	constexpr bool operator==(const clipped_point &) const = default;
+};
+
+struct clipped_polygon
+{
+	int nv;
+	clipping_code uor, uand;
+	std::vector<clipped_point> points;
+	constexpr bool operator==(const clipped_polygon &) const = default;
+};
+
+clipped_polygon record(const std::span<g3s_point *const> points, const g3s_codes &cc)
+{
+	clipped_polygon r{static_cast<int>(points.size()), cc.uor, cc.uand, {}};
+	for (const auto p : points)
+	{
+		const bool uvs = p->p3_flags & projection_flag::uvs, ls = p->p3_flags & projection_flag::ls;
+		r.points.push_back({p->p3_x, p->p3_y, p->p3_z, uvs ? p->p3_u : 0, uvs ? p->p3_v : 0, ls ? p->p3_l : 0, p->p3_codes, p->p3_flags});
+	}
+	return r;
+}
+
+clipped_polygon ref_clip(polygon &poly)
+{
+	ref::temporary_points_t tp;
+	polygon_clip_points vbuf0, vbuf1;
+	int nv = poly.points.size();
+	for (int i = 0; i < nv; ++i)
+		vbuf0[i] = &poly.points[i];
+	auto cc = poly.cc;
+	auto &bufptr = ref::clip_polygon(vbuf0, vbuf1, &nv, &cc, tp);
+	return record(std::span(bufptr).first(nv), cc);
+}
+
+void add(polygon_clip_batch &batch, polygon &poly)
+{
+	polygon_clip_points pointlist;
+	const std::size_t nv = poly.points.size();
+	for (std::size_t i = 0; i < nv; ++i)
+		pointlist[i] = &poly.points[i];
+	batch.add(std::span(pointlist).first(nv), poly.cc);
+}
+
+}
+
+/* Every polygon of a batch must be clipped to exactly the points, the
+ * interpolated values and the codes which the old clipper made for it
+ * alone.
+ */
+BOOST_AUTO_TEST_CASE(batch_matches_clip_polygon)
+{
+	std::mt19937 rng(1);
+	polygon_clip_batch batch;
+	unsigned polygons = 0, mismatches = 0, clipped = 0;
+	for (unsigned round = 0; round < 4000; ++round)
+	{
+		std::vector<polygon> faces(1 + rng() % 64);
+		for (auto &f : faces)
+			f = make_polygon(rng);
+		batch.clear();
+		for (auto &f : faces)
+			add(batch, f);
+		batch.clip();
+		for (std::size_t i = 0; i < faces.size(); ++i)
+		{
+			const auto expected = ref_clip(faces[i]);
+			if (expected.points.size() != faces[i].points.size() || expected.uor != faces[i].cc.uor)
+				++clipped;
+			if (record(batch.points(i), batch.codes(i)) != expected)
+				++mismatches;
+			++polygons;
+		}
+	}
+	BOOST_TEST(mismatches == 0u);
+	/* Most of the polygons must have been clipped for the test to mean
+	 * anything.
+	 */
+	BOOST_TEST(clipped > polygons / 2);
+	BOOST_TEST_MESSAGE(polygons << " polygons, " << clipped << " clipped");
+}
+
+/* Not a check: report the time per polygon of clipping one at a time with
+ * a new pool, as the old code did, and of clipping a batch.  Run with
+ * --log_level=message to see the results.
+ */
+BOOST_AUTO_TEST_CASE(clipper_batch_benchmark)
+{
+	std::mt19937 rng(2);
+	std::vector<polygon> faces(64);
+	for (auto &f : faces)
+		f = make_polygon(rng);
+	constexpr unsigned passes = 2000;
+	polygon_clip_batch batch;
+	unsigned sink = 0;
+	const auto t0 = std::chrono::steady_clock::now();
+	for (unsigned p = 0; p < passes; ++p)
+		for (auto &f : faces)
+			sink += ref_clip(f).nv;
+	const auto t1 = std::chrono::steady_clock::now();
+	for (unsigned p = 0; p < passes; ++p)
+	{
+		batch.clear();
+		for (auto &f : faces)
+			add(batch, f);
+		batch.clip();
+		for (std::size_t i = 0; i < faces.size(); ++i)
+			sink -= batch.points(i).size();
+	}
+	const auto t2 = std::chrono::steady_clock::now();
+	const std::chrono::duration<double, std::nano> one_at_a_time = t1 - t0, batched = t2 - t1;
+	const auto n = passes * faces.size();
+	BOOST_TEST_MESSAGE("ref::clip_polygon: " << one_at_a_time.count() / n << " ns/polygon");
+	BOOST_TEST_MESSAGE("polygon_clip_batch: " << batched.count() / n << " ns/polygon");
+	BOOST_TEST(sink == 0u);
+}
+
+}
+#else
+/* With OpenGL, the clipper is not built. */
+BOOST_AUTO_TEST_CASE(clipper_batch)
+{
+	BOOST_TEST_MESSAGE("built with OpenGL; clipper not used");
+}
+#endif
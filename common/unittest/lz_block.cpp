@@ -0,0 +1,108 @@
+#include "lz_block.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth lz_block
+#include <boost/test/unit_test.hpp>
+
+static std::vector<uint8_t> compress(const std::vector<uint8_t> &src)
+{
+	std::vector<uint8_t> packed(dcx::lz_block_bound(src.size()));
+	packed.resize(dcx::lz_block_compress(src, packed));
+	return packed;
+}
+
+static void check_round_trip(const std::vector<uint8_t> &src)
+{
+	const auto packed = compress(src);
+	BOOST_TEST(packed.size() <= dcx::lz_block_bound(src.size()));
+	std::vector<uint8_t> unpacked(src.size());
+	BOOST_TEST(dcx::lz_block_decompress(packed, unpacked));
+	BOOST_TEST(unpacked == src);
+}
+
+/* Demo frames repeat most of the previous frame with small changes.
+ */
+static std::vector<uint8_t> make_frames(std::minstd_rand &rng, const std::size_t frames)
+{
+	std::vector<uint8_t> frame(200);
+	for (auto &b : frame)
+		b = rng();
+	std::vector<uint8_t> r;
+	for (std::size_t f = 0; f < frames; ++f)
+	{
+		for (unsigned i = 0; i < 8; ++i)
+			frame[rng() % frame.size()] = rng();
+		r.insert(r.end(), frame.begin(), frame.end());
+	}
+	return r;
+}
+
+BOOST_AUTO_TEST_CASE(lz_block_empty)
+{
+	check_round_trip({});
+}
+
+BOOST_AUTO_TEST_CASE(lz_block_short)
+{
+	for (std::size_t n = 1; n < 40; ++n)
+	{
+		std::vector<uint8_t> src(n);
+		for (std::size_t i = 0; i < n; ++i)
+			src[i] = i % 3;
+		check_round_trip(src);
+	}
+}
+
+/* Test that a long run, which is a match overlapping its own output,
+ * compresses well and decodes correctly.
+ */
+BOOST_AUTO_TEST_CASE(lz_block_run)
+{
+	const std::vector<uint8_t> src(65536, 0x5a);
+	check_round_trip(src);
+	BOOST_TEST(compress(src).size() < 300u);
+}
+
+/* Test that random input, which has no matches, stays within the bound.
+ */
+BOOST_AUTO_TEST_CASE(lz_block_random)
+{
+	std::minstd_rand rng(1);
+	std::vector<uint8_t> src(65536);
+	for (auto &b : src)
+		b = rng();
+	check_round_trip(src);
+}
+
+BOOST_AUTO_TEST_CASE(lz_block_frames)
+{
+	std::minstd_rand rng(2);
+	const auto src = make_frames(rng, 300);
+	check_round_trip(src);
+	BOOST_TEST(compress(src).size() < src.size() / 3);
+}
+
+/* Test that truncated or altered input is rejected instead of being
+ * decoded past either buffer.
+ */
+BOOST_AUTO_TEST_CASE(lz_block_corrupt)
+{
+	std::minstd_rand rng(3);
+	const auto src = make_frames(rng, 50);
+	const auto packed = compress(src);
+	std::vector<uint8_t> unpacked(src.size());
+	for (std::size_t n = 0; n < packed.size(); n += 7)
+		BOOST_TEST(!dcx::lz_block_decompress(std::span(packed).first(n), unpacked));
+	std::vector<uint8_t> small(src.size() - 1);
+	BOOST_TEST(!dcx::lz_block_decompress(packed, small));
+	for (std::size_t i = 0; i < 1000; ++i)
+	{
+		auto altered = packed;
+		altered[rng() % altered.size()] ^= 1 + rng() % 255;
+		/* Altered input may still decode, but never out of bounds. */
+		(void)dcx::lz_block_decompress(altered, unpacked);
+	}
+}
@@ -0,0 +1,165 @@
+#include "d2x-rebirth/libmve/decoder_kernels.h"
+#include <array>
+#include <cstdint>
+#include <random>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth mve_kernels
+#include <boost/test/unit_test.hpp>
+
+/* The kernels must draw exactly what the per-pixel loops they replaced
+ * drew.  The reference functions below are those loops, drawing into a
+ * block of `width` pixels per row.
+ */
+constexpr std::size_t width = 16;
+
+template <typename pixel_t>
+using frame = std::array<pixel_t, width * 9>;
+
+template <typename pixel_t>
+static void refRow2Pixels(pixel_t *f, const unsigned pat, const mve::pixel_colors<pixel_t> &p)
+{
+	for (unsigned i = 0; i < 8; ++i)
+		f[i] = p[(pat >> i) & 1];
+}
+
+template <typename pixel_t>
+static void refRow2Pixels2(pixel_t *f, const unsigned pat, const mve::pixel_colors<pixel_t> &p)
+{
+	for (unsigned i = 0; i < 4; ++i)
+		f[2 * i] = f[2 * i + 1] = f[width + 2 * i] = f[width + 2 * i + 1] = p[(pat >> i) & 1];
+}
+
+template <typename pixel_t>
+static void refQuadrant2Pixels(pixel_t *f, const unsigned pat0, const unsigned pat1, const mve::pixel_colors<pixel_t> &p)
+{
+	const unsigned pat = (pat1 << 8) | pat0;
+	for (unsigned i = 0; i < 16; ++i)
+		f[(i / 4) * width + i % 4] = p[(pat >> i) & 1];
+}
+
+template <typename pixel_t>
+static void refRow4Pixels(pixel_t *f, const unsigned pat0, const unsigned pat1, const mve::pixel_colors<pixel_t> &p)
+{
+	const unsigned pat = (pat1 << 8) | pat0;
+	for (unsigned i = 0; i < 8; ++i)
+		f[i] = p[(pat >> (2 * i)) & 3];
+}
+
+template <typename pixel_t>
+static void refRow4Pixels2(pixel_t *f, const unsigned pat, const mve::pixel_colors<pixel_t> &p)
+{
+	for (unsigned i = 0; i < 4; ++i)
+		f[2 * i] = f[2 * i + 1] = f[width + 2 * i] = f[width + 2 * i + 1] = p[(pat >> (2 * i)) & 3];
+}
+
+template <typename pixel_t>
+static void refRow4Pixels2x1(pixel_t *f, const unsigned pat, const mve::pixel_colors<pixel_t> &p)
+{
+	for (unsigned i = 0; i < 4; ++i)
+		f[2 * i] = f[2 * i + 1] = p[(pat >> (2 * i)) & 3];
+}
+
+template <typename pixel_t>
+static void refQuadrant4Pixels(pixel_t *f, const uint32_t pat, const mve::pixel_colors<pixel_t> &p)
+{
+	for (unsigned i = 0; i < 16; ++i)
+		f[(i / 4) * width + i % 4] = p[(pat >> (2 * i)) & 3];
+}
+
+template <typename pixel_t>
+static mve::pixel_colors<pixel_t> random_colors(std::mt19937 &rng)
+{
+	mve::pixel_colors<pixel_t> p;
+	for (auto &c : p)
+		c = static_cast<pixel_t>(rng());
+	return p;
+}
+
+/* Draw with `kernel` and `reference` on frames filled with the same
+ * background, and require the same result.
+ */
+template <typename pixel_t, typename K, typename R>
+static void check(std::mt19937 &rng, K &&kernel, R &&reference)
+{
+	frame<pixel_t> a, b;
+	for (auto &c : a)
+		c = static_cast<pixel_t>(rng());
+	b = a;
+	kernel(a.data());
+	reference(b.data());
+	BOOST_TEST(a == b);
+}
+
+template <typename pixel_t>
+static void test_two_colour_patterns()
+{
+	std::mt19937 rng(1);
+	for (unsigned pat = 0; pat < 256; ++pat)
+	{
+		const auto p = random_colors<pixel_t>(rng);
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternRow2Pixels<pixel_t>(f, pat, p); }, [&](pixel_t *f) { refRow2Pixels(f, pat, p); });
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternRow2Pixels2<pixel_t>(f, width, pat, p); }, [&](pixel_t *f) { refRow2Pixels2(f, pat, p); });
+		const unsigned pat1 = rng() & 0xff;
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternQuadrant2Pixels<pixel_t>(f, width, pat, pat1, p); }, [&](pixel_t *f) { refQuadrant2Pixels(f, pat, pat1, p); });
+	}
+}
+
+template <typename pixel_t>
+static void test_four_colour_patterns()
+{
+	std::mt19937 rng(2);
+	for (unsigned pat = 0; pat < 0x10000; ++pat)
+	{
+		const auto p = random_colors<pixel_t>(rng);
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternRow4Pixels<pixel_t>(f, pat & 0xff, pat >> 8, p); }, [&](pixel_t *f) { refRow4Pixels(f, pat & 0xff, pat >> 8, p); });
+	}
+	for (unsigned pat = 0; pat < 256; ++pat)
+	{
+		const auto p = random_colors<pixel_t>(rng);
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternRow4Pixels2<pixel_t>(f, width, pat, p); }, [&](pixel_t *f) { refRow4Pixels2(f, pat, p); });
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternRow4Pixels2x1<pixel_t>(f, pat, p); }, [&](pixel_t *f) { refRow4Pixels2x1(f, pat, p); });
+		const uint32_t quad = rng();
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternQuadrant4Pixels<pixel_t>(f, width, quad, quad >> 8, quad >> 16, quad >> 24, p); }, [&](pixel_t *f) { refQuadrant4Pixels(f, quad, p); });
+	}
+}
+
+/* Fills write all 64 pixels of the block and nothing outside it. */
+template <typename pixel_t>
+static void test_fills()
+{
+	std::mt19937 rng(3);
+	for (unsigned i = 0; i < 64; ++i)
+	{
+		const auto p = random_colors<pixel_t>(rng);
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::fillBlock<pixel_t>(f, width, p[0]); }, [&](pixel_t *f) {
+			for (unsigned y = 0; y < 8; ++y)
+				for (unsigned x = 0; x < 8; ++x)
+					f[y * width + x] = p[0];
+		});
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::ditherBlock<pixel_t>(f, width, p); }, [&](pixel_t *f) {
+			for (unsigned y = 0; y < 8; ++y)
+				for (unsigned x = 0; x < 8; ++x)
+					f[y * width + x] = p[(x + y) & 1];
+		});
+		check<pixel_t>(rng, [&](pixel_t *f) { mve::patternHalves<pixel_t>(f, width, p); }, [&](pixel_t *f) {
+			for (unsigned y = 0; y < 4; ++y)
+				for (unsigned x = 0; x < 8; ++x)
+					f[y * width + x] = p[x >= 4];
+		});
+	}
+}
+
+BOOST_AUTO_TEST_CASE(mve_kernels_8)
+{
+	test_two_colour_patterns<uint8_t>();
+	test_four_colour_patterns<uint8_t>();
+	test_fills<uint8_t>();
+}
+
+BOOST_AUTO_TEST_CASE(mve_kernels_16)
+{
+	test_two_colour_patterns<uint16_t>();
+	test_four_colour_patterns<uint16_t>();
+	test_fills<uint16_t>();
+}
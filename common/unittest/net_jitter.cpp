@@ -0,0 +1,157 @@
+#include "net_jitter.h"
+#include <algorithm>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth net_jitter
+#include <boost/test/unit_test.hpp>
+
+using buffer_type = dcx::net_jitter_buffer<dcx::fix, 16>;
+
+static dcx::fix blend(const dcx::net_jitter_sample<dcx::fix> &s, const dcx::fix speed)
+{
+	switch (s.kind)
+	{
+		case dcx::net_jitter_sample_kind::interpolate:
+			return s.from + static_cast<dcx::fix>((static_cast<int64_t>(s.to - s.from) * s.fraction) >> 16);
+		case dcx::net_jitter_sample_kind::extrapolate:
+			return s.from + static_cast<dcx::fix>((static_cast<int64_t>(speed) * s.extrapolate_time) >> 16);
+		case dcx::net_jitter_sample_kind::hold:
+		default:
+			return s.from;
+	}
+}
+
+/* Deterministic source of link delay, so that failures are reproducible.
+ */
+struct lcg
+{
+	uint32_t state = 12345;
+	uint32_t operator()()
+	{
+		state = state * 1103515245u + 12345u;
+		return state >> 16;
+	}
+};
+
+struct packet
+{
+	dcx::fix64 arrival;
+	dcx::net_sender_time stamp;
+	dcx::fix position;
+};
+
+/* Test that the buffer rejects a state it already holds.
+ */
+BOOST_AUTO_TEST_CASE(net_jitter_duplicate)
+{
+	buffer_type b;
+	BOOST_TEST(b.insert(100, 1000, 1));
+	BOOST_TEST(!b.insert(100, 1010, 2));
+	BOOST_TEST(b.size() == 1u);
+}
+
+/* Test that a state received out of order is placed by its stamp, not by
+ * its arrival.
+ */
+BOOST_AUTO_TEST_CASE(net_jitter_reorder)
+{
+	buffer_type b;
+	b.insert(0, 0, 0);
+	b.insert(F1_0, F1_0, 100);
+	b.insert(F1_0 / 2, F1_0, 50);
+	BOOST_TEST(b.size() == 3u);
+	const auto s = b.sample(F1_0 * 3 / 4, 0, 0);
+	BOOST_REQUIRE(s);
+	BOOST_TEST((s->kind == dcx::net_jitter_sample_kind::interpolate));
+	BOOST_TEST(s->from == 50);
+	BOOST_TEST(s->to == 100);
+	BOOST_TEST(s->fraction == F1_0 / 2);
+}
+
+/* Test that ordering survives the sender clock wrapping.
+ */
+BOOST_AUTO_TEST_CASE(net_jitter_wrap)
+{
+	buffer_type b;
+	const dcx::net_sender_time before = 0xffffffffu - F1_0 / 4;
+	b.insert(before, 0, 10);
+	b.insert(before + F1_0 / 2, F1_0 / 2, 20);
+	BOOST_TEST(b.size() == 2u);
+	const auto s = b.sample(F1_0 / 4, 0, 0);
+	BOOST_REQUIRE(s);
+	BOOST_TEST((s->kind == dcx::net_jitter_sample_kind::interpolate));
+	BOOST_TEST(s->from == 10);
+	BOOST_TEST(s->to == 20);
+}
+
+/* Test that extrapolation past the newest state is clamped.
+ */
+BOOST_AUTO_TEST_CASE(net_jitter_extrapolate_limit)
+{
+	buffer_type b;
+	b.insert(0, 0, 0);
+	const auto s = b.sample(F1_0 * 10, 0, F1_0 / 4);
+	BOOST_REQUIRE(s);
+	BOOST_TEST((s->kind == dcx::net_jitter_sample_kind::extrapolate));
+	BOOST_TEST(s->extrapolate_time == F1_0 / 4);
+}
+
+/* Simulate a loopback link: a sender reports a position moving at
+ * constant speed 30 times per second, each report is delayed by a fixed
+ * 20ms plus up to 30ms of random jitter (so reports routinely arrive out
+ * of order), and the receiver samples the buffer at 200 frames per
+ * second with a 66ms playout delay.  Once the buffer has filled, every
+ * frame must interpolate, and the displayed position must advance
+ * smoothly.  Applying each report on arrival would instead leave the
+ * position unchanged for most frames and then jump by a whole report
+ * interval.
+ */
+BOOST_AUTO_TEST_CASE(net_jitter_loopback)
+{
+	constexpr dcx::fix speed = F1_0 * 40;
+	constexpr dcx::fix64 send_interval = F1_0 / 30;
+	constexpr dcx::fix64 frame_interval = F1_0 / 200;
+	constexpr dcx::fix delay = (66 * F1_0) / 1000;
+	constexpr dcx::fix64 duration = F1_0 * 10;
+	lcg rng;
+	std::vector<packet> link;
+	/* The sender clock is deliberately far from the receiver clock.
+	 */
+	constexpr dcx::fix64 sender_epoch = F1_0 * 5000;
+	for (dcx::fix64 t = 0; t < duration; t += send_interval)
+	{
+		const dcx::fix64 jitter = (static_cast<dcx::fix64>(rng() % 30) * F1_0) / 1000;
+		link.push_back({t + (20 * F1_0) / 1000 + jitter, static_cast<dcx::net_sender_time>(sender_epoch + t), static_cast<dcx::fix>((static_cast<int64_t>(speed) * t) >> 16)});
+	}
+	std::stable_sort(link.begin(), link.end(), [](const packet &a, const packet &b) { return a.arrival < b.arrival; });
+	buffer_type b;
+	auto next = link.begin();
+	std::optional<dcx::fix> previous;
+	const dcx::fix expected_step = static_cast<dcx::fix>((static_cast<int64_t>(speed) * frame_interval) >> 16);
+	unsigned frames = 0, interpolated = 0;
+	dcx::fix largest_step = 0;
+	for (dcx::fix64 now = 0; now < duration - F1_0 / 4; now += frame_interval)
+	{
+		for (; next != link.end() && next->arrival <= now; ++next)
+			b.insert(next->stamp, now, next->position);
+		const auto s = b.sample(now, delay, F1_0 / 4);
+		if (!s)
+			continue;
+		const auto position = blend(*s, speed);
+		if (now >= F1_0)
+		{
+			++frames;
+			if (s->kind == dcx::net_jitter_sample_kind::interpolate)
+				++interpolated;
+			BOOST_REQUIRE(previous);
+			const auto step = position - *previous;
+			BOOST_TEST(step >= 0);
+			largest_step = std::max(largest_step, step);
+		}
+		previous = position;
+	}
+	BOOST_TEST(frames > 0u);
+	BOOST_TEST(interpolated == frames);
+	BOOST_TEST(largest_step < expected_step * 2);
+}
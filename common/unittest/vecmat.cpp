@@ -0,0 +1,269 @@
+#include "vecmat.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth vecmat
+#include <boost/test/unit_test.hpp>
+
+using namespace dcx;
+
+/* The header versions must return exactly what the out-of-line versions
+ * they replaced returned.  The reference functions below are those
+ * versions.  They are kept out of line, as the originals were, so that
+ * the timings compare a call with an inlined body.
+ */
+namespace ref {
+
+[[gnu::noinline]]
+static fix fixdiv(const fix a, const fix b)
+{
+	if (!b)
+		return 1;
+	const fix64 a64 = a;
+	return static_cast<fix>((a64 * 65536) / b);
+}
+
+[[gnu::noinline]]
+static fix fixmuldiv(const fix a, const fix b, const fix c)
+{
+	if (!c)
+		return 1;
+	const fix64 a64 = a;
+	return static_cast<fix>((a64 * b) / c);
+}
+
+[[gnu::noinline]]
+static fix_sincos_result fix_sincos(const fixang a)
+{
+	const auto interpolate = [](const uint8_t idx0, const signed mul) -> fix {
+		const fix t0 = sincos_table[idx0];
+		const uint8_t idx1 = idx0 + 1;
+		const fix t1 = sincos_table[idx1];
+		return (t0 + (((t1 - t0) * mul) >> 8)) << 2;
+	};
+	const uint8_t idx = static_cast<uint8_t>(a >> 8);
+	const signed mul = static_cast<uint8_t>(a);
+	return {interpolate(idx, mul), interpolate(static_cast<uint8_t>(idx + 64), mul)};
+}
+
+[[gnu::noinline]]
+static fix vm_vec_dot(const vms_vector &v0, const vms_vector &v1)
+{
+	int64_t x0 = v0.x;
+	int64_t x1 = v1.x;
+	int64_t y0 = v0.y;
+	int64_t y1 = v1.y;
+	int64_t z0 = v0.z;
+	int64_t z1 = v1.z;
+	int64_t p = (x0 * x1) + (y0 * y1) + (z0 * z1);
+	return p >> 16;
+}
+
+[[gnu::noinline]]
+static void vm_vec_scale_add2(vms_vector &dest, const vms_vector &src, const fix k)
+{
+	dest.x += fixmul(src.x, k);
+	dest.y += fixmul(src.y, k);
+	dest.z += fixmul(src.z, k);
+}
+
+[[gnu::noinline]]
+static void vm_vec_rotate(vms_vector &dest, const vms_vector &src, const vms_matrix &m)
+{
+	dest.x = ref::vm_vec_dot(src, m.rvec);
+	dest.y = ref::vm_vec_dot(src, m.uvec);
+	dest.z = ref::vm_vec_dot(src, m.fvec);
+}
+
+[[gnu::noinline]]
+static fix vm_vec_mag(const vms_vector &v)
+{
+	const int64_t x = v.x;
+	const int64_t y = v.y;
+	const int64_t z = v.z;
+	quadint q;
+	q.q = static_cast<uint64_t>((x * x) + (y * y) + (z * z));
+	return quad_sqrt(q);
+}
+
+[[gnu::noinline]]
+static fix vm_vec_normalized_dir(vms_vector &dest, const vms_vector &end, const vms_vector &start)
+{
+	dest = {end.x - start.x, end.y - start.y, end.z - start.z};
+	const auto m = ref::vm_vec_mag(dest);
+	if (m)
+	{
+		dest.x = ref::fixdiv(dest.x, m);
+		dest.y = ref::fixdiv(dest.y, m);
+		dest.z = ref::fixdiv(dest.z, m);
+	}
+	return m;
+}
+
+}
+
+namespace {
+
+constexpr std::size_t sample_count = 4096;
+
+/* Components are kept within the range of level coordinates, so that
+ * the sums of products do not overflow, as they would not in the game.
+ */
+struct samples
+{
+	std::vector<vms_vector> a, b;
+	std::vector<fix> s;
+	vms_matrix m;
+	samples()
+	{
+		std::minstd_rand r(1);
+		std::uniform_int_distribution<fix> coord(-F1_0 * 8192, F1_0 * 8192);
+		std::uniform_int_distribution<fix> scale(-F1_0 * 4, F1_0 * 4);
+		std::uniform_int_distribution<fix> unit(-F1_0, F1_0);
+		const auto vector = [&r](auto &d) {
+			return vms_vector{d(r), d(r), d(r)};
+		};
+		for (std::size_t i = 0; i < sample_count; ++i)
+		{
+			a.emplace_back(vector(coord));
+			b.emplace_back(vector(coord));
+			s.emplace_back(scale(r));
+		}
+		/* Include the degenerate inputs which the originals handled
+		 * specially.
+		 */
+		a[0] = b[0];
+		s[1] = 0;
+		m = {vector(unit), vector(unit), vector(unit)};
+	}
+};
+
+const samples &get_samples()
+{
+	static const samples s;
+	return s;
+}
+
+/* Run `f` over every sample `passes` times and report the time per call.
+ * The result is accumulated into a volatile sink, so that the loop is not
+ * discarded.
+ */
+template <typename F>
+void measure(const char *const name, F &&f)
+{
+	constexpr unsigned passes = 256;
+	volatile fix sink = 0;
+	const auto start = std::chrono::steady_clock::now();
+	fix acc = 0;
+	for (unsigned p = 0; p < passes; ++p)
+		for (std::size_t i = 0; i < sample_count; ++i)
+			acc += f(i);
+	sink = acc;
+	(void)sink;
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	BOOST_TEST_MESSAGE(name << ": " << elapsed.count() / (passes * sample_count) << " ns/call");
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(fixdiv_exact)
+{
+	const auto &s = get_samples();
+	for (std::size_t i = 0; i < sample_count; ++i)
+	{
+		BOOST_TEST(fixdiv(s.a[i].x, s.s[i]) == ref::fixdiv(s.a[i].x, s.s[i]));
+		BOOST_TEST(fixmuldiv(s.a[i].x, s.s[i], s.b[i].y) == ref::fixmuldiv(s.a[i].x, s.s[i], s.b[i].y));
+	}
+	BOOST_TEST(fixdiv(F1_0, 0) == 1);
+	BOOST_TEST(fixmuldiv(F1_0, F1_0, 0) == 1);
+}
+
+BOOST_AUTO_TEST_CASE(fix_sincos_exact)
+{
+	for (unsigned a = 0; a <= UINT16_MAX; ++a)
+	{
+		const auto r = ref::fix_sincos(a);
+		const auto t = fix_sincos(a);
+		BOOST_TEST(t.sin == r.sin);
+		BOOST_TEST(t.cos == r.cos);
+		BOOST_TEST(fix_sin(a) == r.sin);
+		BOOST_TEST(fix_cos(a) == r.cos);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(vm_vec_exact)
+{
+	const auto &s = get_samples();
+	for (std::size_t i = 0; i < sample_count; ++i)
+	{
+		BOOST_TEST(vm_vec_dot(s.a[i], s.b[i]) == ref::vm_vec_dot(s.a[i], s.b[i]));
+		BOOST_TEST(static_cast<fix>(vm_vec_mag(s.a[i])) == ref::vm_vec_mag(s.a[i]));
+		{
+			auto t = s.a[i], r = s.a[i];
+			vm_vec_scale_add2(t, s.b[i], s.s[i]);
+			ref::vm_vec_scale_add2(r, s.b[i], s.s[i]);
+			BOOST_TEST((t == r));
+		}
+		{
+			vms_vector t, r;
+			vm_vec_rotate(t, s.a[i], s.m);
+			ref::vm_vec_rotate(r, s.a[i], s.m);
+			BOOST_TEST((t == r));
+		}
+		{
+			vms_vector t, r;
+			BOOST_TEST(static_cast<fix>(vm_vec_normalized_dir(t, s.a[i], s.b[i])) == ref::vm_vec_normalized_dir(r, s.a[i], s.b[i]));
+			BOOST_TEST((t == r));
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(vm_vec_rotate_list_exact)
+{
+	const auto &s = get_samples();
+	const vms_vector &origin = s.b[0];
+	std::vector<vms_vector> t(sample_count);
+	vm_vec_rotate_list(t, s.a, origin, s.m);
+	for (std::size_t i = 0; i < sample_count; ++i)
+	{
+		vms_vector r;
+		ref::vm_vec_rotate(r, vms_vector{s.a[i].x - origin.x, s.a[i].y - origin.y, s.a[i].z - origin.z}, s.m);
+		BOOST_TEST((t[i] == r));
+	}
+}
+
+/* The timings are informational.  Run with --log_level=message to see
+ * them.
+ */
+BOOST_AUTO_TEST_CASE(benchmark)
+{
+	const auto &s = get_samples();
+	measure("ref::fixdiv", [&s](std::size_t i) { return ref::fixdiv(s.a[i].x, s.s[i]); });
+	measure("fixdiv", [&s](std::size_t i) { return fixdiv(s.a[i].x, s.s[i]); });
+	measure("ref::fixmuldiv", [&s](std::size_t i) { return ref::fixmuldiv(s.a[i].x, s.s[i], s.b[i].y); });
+	measure("fixmuldiv", [&s](std::size_t i) { return fixmuldiv(s.a[i].x, s.s[i], s.b[i].y); });
+	measure("ref::fix_sincos", [](std::size_t i) { const auto r = ref::fix_sincos(i * 16); return r.sin + r.cos; });
+	measure("fix_sincos", [](std::size_t i) { const auto r = fix_sincos(i * 16); return r.sin + r.cos; });
+	measure("ref::vm_vec_dot", [&s](std::size_t i) { return ref::vm_vec_dot(s.a[i], s.b[i]); });
+	measure("vm_vec_dot", [&s](std::size_t i) { return vm_vec_dot(s.a[i], s.b[i]); });
+	measure("ref::vm_vec_mag", [&s](std::size_t i) { return ref::vm_vec_mag(s.a[i]); });
+	measure("vm_vec_mag", [&s](std::size_t i) { return static_cast<fix>(vm_vec_mag(s.a[i])); });
+	measure("ref::vm_vec_scale_add2", [&s](std::size_t i) { auto t = s.a[i]; ref::vm_vec_scale_add2(t, s.b[i], s.s[i]); return t.x; });
+	measure("vm_vec_scale_add2", [&s](std::size_t i) { auto t = s.a[i]; vm_vec_scale_add2(t, s.b[i], s.s[i]); return t.x; });
+	measure("ref::vm_vec_rotate", [&s](std::size_t i) { vms_vector t; ref::vm_vec_rotate(t, s.a[i], s.m); return t.x; });
+	measure("vm_vec_rotate", [&s](std::size_t i) { vms_vector t; vm_vec_rotate(t, s.a[i], s.m); return t.x; });
+	measure("ref::vm_vec_normalized_dir", [&s](std::size_t i) { vms_vector t; return ref::vm_vec_normalized_dir(t, s.a[i], s.b[i]); });
+	measure("vm_vec_normalized_dir", [&s](std::size_t i) { vms_vector t; return static_cast<fix>(vm_vec_normalized_dir(t, s.a[i], s.b[i])); });
+	{
+		std::vector<vms_vector> t(sample_count);
+		measure("vm_vec_rotate_list", [&s, &t](std::size_t i) {
+			if (!i)
+				vm_vec_rotate_list(t, s.a, s.b[0], s.m);
+			return t[i].x;
+		});
+	}
+}
@@ -0,0 +1,195 @@
+#include "editor/vertex_segment_index.h"
+#include "d_underlying_value.h"
+#include <algorithm>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE Rebirth vertex_segment_index
+#include <boost/test/unit_test.hpp>
+
+namespace dcx {
+
+namespace {
+
+using segment_verts = vertex_segment_index::segment_verts;
+
+/* A mine reduced to what the index reads: the vertices of each segment,
+ * or nothing if that segment number is free.
+ */
+struct mine
+{
+	std::vector<std::optional<segment_verts>> segments;
+	void refresh(vertex_segment_index &index) const
+	{
+		index.refresh(segments.size(), [this](const segnum_t segnum) -> const segment_verts * {
+			auto &s = segments[segnum];
+			return s ? &*s : nullptr;
+		});
+	}
+	segment_verts &operator[](const unsigned segnum)
+	{
+		if (segnum >= segments.size())
+			segments.resize(segnum + 1);
+		auto &s = segments[segnum];
+		if (!s)
+			s.emplace();
+		return *s;
+	}
+};
+
+/* Segment `k` of a corridor uses vertices 4k to 4k + 7, so that it shares
+ * its back side with the front side of segment `k` + 1.
+ */
+segment_verts corridor_segment(const unsigned first_vertex)
+{
+	segment_verts v;
+	for (uint8_t i = 0; i < 8; ++i)
+		v[segment_relative_vertnum{i}] = vertnum_t{first_vertex + i};
+	return v;
+}
+
+using sorted_incidences = std::vector<std::tuple<unsigned, unsigned>>;
+
+sorted_incidences segments_at(const vertex_segment_index &index, const unsigned vnum)
+{
+	sorted_incidences r;
+	for (const auto &i : index.segments_at(vertnum_t{vnum}))
+		r.emplace_back(underlying_value(i.segnum), underlying_value(i.relvnum));
+	std::sort(r.begin(), r.end());
+	return r;
+}
+
+/* Compare `index` with an index built from nothing, for every vertex
+ * which could be in use.
+ */
+bool same_as_rebuild(const vertex_segment_index &index, const mine &m)
+{
+	vertex_segment_index rebuilt;
+	m.refresh(rebuilt);
+	for (unsigned v = 0; v < 512; ++v)
+		if (segments_at(index, v) != segments_at(rebuilt, v))
+			return false;
+	return true;
+}
+
+/* As med_form_bridge_segment does, copy the back side of `seg1` and the
+ * front side of `seg2` into a new segment `bs`.
+ */
+void form_bridge(mine &m, const unsigned bs, const unsigned seg1, const unsigned seg2)
+{
+	const segment_verts v1 = m[seg1], v2 = m[seg2];
+	auto &b = m[bs];
+	for (uint8_t i = 0; i < 4; ++i)
+	{
+		b[segment_relative_vertnum{i}] = v1[segment_relative_vertnum{static_cast<uint8_t>(i + 4)}];
+		b[segment_relative_vertnum{static_cast<uint8_t>(i + 4)}] = v2[segment_relative_vertnum{i}];
+	}
+}
+
+/* As med_move_group does, give each segment in `group` its own copy of
+ * the vertices which it shares with segments outside the group.  Report
+ * each segment changed if `note`.
+ */
+void detach_group(mine &m, vertex_segment_index &index, const std::vector<unsigned> &group, unsigned next_vertex, const bool note)
+{
+	std::vector<vertnum_t> outside;
+	for (unsigned s = 0; s < m.segments.size(); ++s)
+		if (m.segments[s] && std::find(group.begin(), group.end(), s) == group.end())
+			outside.insert(outside.end(), m.segments[s]->begin(), m.segments[s]->end());
+	for (const auto v : outside)
+	{
+		const vertnum_t new_vertex_id{next_vertex};
+		bool used = false;
+		for (const auto gs : group)
+			for (auto &vv : m[gs])
+				if (vv == v)
+				{
+					vv = new_vertex_id;
+					used = true;
+					if (note)
+						index.note_segment_changed(segnum_t{static_cast<uint16_t>(gs)});
+				}
+		if (used)
+			++next_vertex;
+	}
+}
+
+mine make_corridor(const unsigned length)
+{
+	mine m;
+	for (unsigned k = 0; k < length; ++k)
+		m[k] = corridor_segment(4 * k);
+	return m;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(form_bridge_then_move_group)
+{
+	/* Segments 0 to 5 are a corridor.  Segment 7 stands apart, and
+	 * segment 6 is free until the bridge fills it.
+	 */
+	auto m = make_corridor(6);
+	m[7] = corridor_segment(100);
+	m.segments[6].reset();
+	vertex_segment_index index;
+	m.refresh(index);
+	BOOST_TEST(same_as_rebuild(index, m));
+
+	form_bridge(m, 6, 5, 7);
+	index.note_segment_changed(segnum_t{6});
+	m.refresh(index);
+	BOOST_TEST(same_as_rebuild(index, m));
+	BOOST_TEST(segments_at(index, 24).size() == 2u);
+
+	/* Move segments 5 to 7 away from the corridor.  Segment 5 shares its
+	 * front side with segment 4, so those vertices are copied.
+	 */
+	detach_group(m, index, {5, 6, 7}, 200, true);
+	m.refresh(index);
+	BOOST_TEST(same_as_rebuild(index, m));
+	BOOST_TEST(segments_at(index, 20).size() == 1u);
+	BOOST_TEST(segments_at(index, 200).size() == 1u);
+}
+
+/* Without the reports, the index keeps the old vertices, which is what
+ * the test above guards against.
+ */
+BOOST_AUTO_TEST_CASE(unreported_changes_are_missed)
+{
+	auto m = make_corridor(6);
+	m[7] = corridor_segment(100);
+	m.segments[6].reset();
+	vertex_segment_index index;
+	m.refresh(index);
+	form_bridge(m, 6, 5, 7);
+	m.refresh(index);
+	BOOST_TEST(!same_as_rebuild(index, m));
+
+	auto m2 = make_corridor(6);
+	vertex_segment_index index2;
+	m2.refresh(index2);
+	detach_group(m2, index2, {4, 5}, 200, false);
+	m2.refresh(index2);
+	BOOST_TEST(!same_as_rebuild(index2, m2));
+}
+
+/* After invalidate(), segments which are deleted or past the end of the
+ * mine are dropped.
+ */
+BOOST_AUTO_TEST_CASE(invalidate_rescans)
+{
+	auto m = make_corridor(8);
+	vertex_segment_index index;
+	m.refresh(index);
+	m.segments[3].reset();
+	m.segments.resize(6);
+	index.invalidate();
+	m.refresh(index);
+	BOOST_TEST(same_as_rebuild(index, m));
+	BOOST_TEST(segments_at(index, 28).empty());
+}
+
+}
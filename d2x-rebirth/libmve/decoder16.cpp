@@ -12,6 +12,7 @@
 #include <cstdint>
 
 #include "decoders.h"
+#include "decoder_kernels.h"
 #include "console.h"
 
 #include "dxxsconf.h"
@@ -28,67 +29,6 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 
 }
 
-void decodeFrame16(unsigned char *pFrame, std::span<const uint8_t> pMap, const unsigned char *pData, int dataRemain)
-{
-    unsigned short offset;
-	auto FramePtr = reinterpret_cast<uint16_t *>(pFrame);
-    int length;
-    int op;
-    int i, j;
-    int xb, yb;
-
-	backBuf1 = reinterpret_cast<uint16_t *>(g_vBackBuf1);
-	backBuf2 = reinterpret_cast<uint16_t *>(g_vBackBuf2);
-
-    xb = g_width >> 3;
-    yb = g_height >> 3;
-
-    offset = pData[0]|(pData[1]<<8);
-
-	auto pOffData = pData + offset;
-
-    pData += 2;
-
-	auto pOrig = pData;
-    length = offset - 2; /*dataRemain-2;*/
-
-    for (j=0; j<yb; j++)
-    {
-        for (i=0; i<xb/2; i++)
-        {
-			const auto m = pMap.front();
-			op = m & 0xf;
-            dispatchDecoder16(&FramePtr, op, &pData, &pOffData, &dataRemain, &i, &j);
-
-			/*
-			  if (FramePtr < backBuf1)
-			  con_printf(CON_CRITICAL, "danger!  pointing out of bounds below after dispatch decoder: %d, %d (1) [%x]", i, j, (*pMap) & 0xf);
-			  else if (FramePtr >= backBuf1 + g_width*g_height)
-			  con_printf(CON_CRITICAL, "danger!  pointing out of bounds above after dispatch decoder: %d, %d (1) [%x]", i, j, (*pMap) & 0xf);
-			*/
-
-			op = (m >> 4) & 0xf;
-            dispatchDecoder16(&FramePtr, op, &pData, &pOffData, &dataRemain, &i, &j);
-
-			/*
-			  if (FramePtr < backBuf1)
-			  con_printf(CON_CRITICAL, "danger!  pointing out of bounds below after dispatch decoder: %d, %d (2) [%x]", i, j, (*pMap) >> 4);
-			  else if (FramePtr >= backBuf1 + g_width*g_height)
-			  con_printf(CON_CRITICAL, "danger!  pointing out of bounds above after dispatch decoder: %d, %d (2) [%x]", i, j, (*pMap) >> 4);
-			*/
-
-			pMap = pMap.subspan<1>();
-        }
-        FramePtr += 7*g_width;
-    }
-
-	const std::ptrdiff_t remaining = (pData - pOrig);
-	if (const std::ptrdiff_t difference = length - remaining)
-	{
-		con_printf(CON_CRITICAL, "DEBUG: junk left over: %d,%d,%d", DXX_ptrdiff_cast_int(remaining), length, DXX_ptrdiff_cast_int(difference));
-    }
-}
-
 namespace {
 
 static uint16_t GETPIXEL(const unsigned char **buf, int off)
@@ -152,173 +92,6 @@ static constexpr lookup_table_t genLoopkupTable(std::index_sequence<N...>)
 
 constexpr lookup_table_t lookup_table = genLoopkupTable(std::make_index_sequence<256>());
 
-static void copyFrame(unsigned short *pDest, unsigned short *pSrc)
-{
-    int i;
-
-    for (i=0; i<8; i++)
-    {
-        memcpy(pDest, pSrc, 16);
-        pDest += g_width;
-        pSrc += g_width;
-    }
-}
-
-static void patternRow4Pixels(unsigned short *pFrame,
-                              unsigned char pat0, unsigned char pat1,
-                              const std::array<uint16_t, 4> &p)
-{
-    unsigned short mask=0x0003;
-    unsigned short shift=0;
-    unsigned short pattern = (pat1 << 8) | pat0;
-
-    while (mask != 0)
-    {
-        *pFrame++ = p[(mask & pattern) >> shift];
-        mask <<= 2;
-        shift += 2;
-    }
-}
-
-static void patternRow4Pixels2(unsigned short *pFrame,
-                               unsigned char pat0,
-                               const std::array<uint16_t, 4> &p)
-{
-    unsigned char mask=0x03;
-    unsigned char shift=0;
-    unsigned short pel;
-	/* ORIGINAL VERSION IS BUGGY
-	   int skip=1;
-
-	   while (mask != 0)
-	   {
-	   pel = p[(mask & pat0) >> shift];
-	   pFrame[0] = pel;
-	   pFrame[2] = pel;
-	   pFrame[g_width + 0] = pel;
-	   pFrame[g_width + 2] = pel;
-	   pFrame += skip;
-	   skip = 4 - skip;
-	   mask <<= 2;
-	   shift += 2;
-	   }
-	*/
-    while (mask != 0)
-    {
-        pel = p[(mask & pat0) >> shift];
-        pFrame[0] = pel;
-        pFrame[1] = pel;
-        pFrame[g_width + 0] = pel;
-        pFrame[g_width + 1] = pel;
-        pFrame += 2;
-        mask <<= 2;
-        shift += 2;
-    }
-}
-
-static void patternRow4Pixels2x1(unsigned short *pFrame, unsigned char pat,
-								 const std::array<uint16_t, 4> &p)
-{
-    unsigned char mask=0x03;
-    unsigned char shift=0;
-    unsigned short pel;
-
-    while (mask != 0)
-    {
-        pel = p[(mask & pat) >> shift];
-        pFrame[0] = pel;
-        pFrame[1] = pel;
-        pFrame += 2;
-        mask <<= 2;
-        shift += 2;
-    }
-}
-
-static void patternQuadrant4Pixels(unsigned short *pFrame,
-								   unsigned char pat0, unsigned char pat1, unsigned char pat2,
-								   unsigned char pat3, const std::array<uint16_t, 4> &p)
-{
-    unsigned long mask = 0x00000003UL;
-    int shift=0;
-    int i;
-    unsigned long pat = (pat3 << 24) | (pat2 << 16) | (pat1 << 8) | pat0;
-
-    for (i=0; i<16; i++)
-    {
-        pFrame[i&3] = p[(pat & mask) >> shift];
-
-        if ((i&3) == 3)
-            pFrame += g_width;
-
-        mask <<= 2;
-        shift += 2;
-    }
-}
-
-
-static void patternRow2Pixels(unsigned short *pFrame, unsigned char pat,
-							  const std::array<uint16_t, 4> &p)
-{
-    unsigned char mask=0x01;
-
-    while (mask != 0)
-    {
-        *pFrame++ = p[(mask & pat) ? 1 : 0];
-        mask <<= 1;
-    }
-}
-
-static void patternRow2Pixels2(unsigned short *pFrame, unsigned char pat,
-							   const std::array<uint16_t, 4> &p)
-{
-    unsigned short pel;
-    unsigned char mask=0x1;
-
-	/* ORIGINAL VERSION IS BUGGY
-	   int skip=1;
-	   while (mask != 0x10)
-	   {
-	   pel = p[(mask & pat) ? 1 : 0];
-	   pFrame[0] = pel;
-	   pFrame[2] = pel;
-	   pFrame[g_width + 0] = pel;
-	   pFrame[g_width + 2] = pel;
-	   pFrame += skip;
-	   skip = 4 - skip;
-	   mask <<= 1;
-	   }
-	*/
-	while (mask != 0x10) {
-		pel = p[(mask & pat) ? 1 : 0];
-
-		pFrame[0] = pel;
-		pFrame[1] = pel;
-		pFrame[g_width + 0] = pel;
-		pFrame[g_width + 1] = pel;
-		pFrame += 2;
-
-		mask <<= 1;
-	}
-}
-
-static void patternQuadrant2Pixels(unsigned short *pFrame, unsigned char pat0,
-								   unsigned char pat1, const std::array<uint16_t, 4> &p)
-{
-    unsigned short mask = 0x0001;
-    int i;
-    unsigned short pat = (pat1 << 8) | pat0;
-
-    for (i=0; i<16; i++)
-    {
-        pFrame[i&3] = p[(pat & mask) ? 1 : 0];
-
-        if ((i&3) == 3)
-            pFrame += g_width;
-
-        mask <<= 1;
-    }
-}
-
 static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, const unsigned char **pData, const unsigned char **pOffData, int *pDataRemain, int *curXb, int *curYb)
 {
 	std::array<uint16_t, 4> p;
@@ -332,7 +105,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
     switch(codeType)
     {
 	case 0x0:
-		copyFrame(*pFrame, *pFrame + (backBuf2 - backBuf1));
+		mve::copyBlock(*pFrame, *pFrame + (backBuf2 - backBuf1), g_width);
 	case 0x1:
 		break;
 	case 0x2: /*
@@ -343,7 +116,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 		x = lookup_table.far_p[k].x;
 		y = lookup_table.far_p[k].y;
 
-		copyFrame(*pFrame, *pFrame + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + x + y*g_width, g_width);
 		--*pDataRemain;
 		break;
 	case 0x3: /*
@@ -354,7 +127,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 		x = lookup_table.far_n[k].x;
 		y = lookup_table.far_n[k].y;
 
-		copyFrame(*pFrame, *pFrame + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + x + y*g_width, g_width);
 		--*pDataRemain;
 		break;
 	case 0x4: /*
@@ -365,13 +138,13 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 		x = lookup_table.close[k].x;
 		y = lookup_table.close[k].y;
 
-		copyFrame(*pFrame, *pFrame + (backBuf2 - backBuf1) + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + (backBuf2 - backBuf1) + x + y*g_width, g_width);
 		--*pDataRemain;
 		break;
 	case 0x5:
 		x = static_cast<char>(*(*pData)++);
 		y = static_cast<char>(*(*pData)++);
-		copyFrame(*pFrame, *pFrame + (backBuf2 - backBuf1) + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + (backBuf2 - backBuf1) + x + y*g_width, g_width);
 		*pDataRemain -= 2;
 		break;
 	case 0x6:
@@ -397,7 +170,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 		{
 			for (i=0; i<8; i++)
 			{
-				patternRow2Pixels(*pFrame, *(*pData), p);
+				mve::patternRow2Pixels(*pFrame, *(*pData), p);
 				(*pData)++;
 
 				*pFrame += g_width;
@@ -407,9 +180,9 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 		{
 			for (i=0; i<2; i++)
 			{
-				patternRow2Pixels2(*pFrame, *(*pData) & 0xf, p);
+				mve::patternRow2Pixels2(*pFrame, g_width, *(*pData) & 0xf, p);
 				*pFrame += 2*g_width;
-				patternRow2Pixels2(*pFrame, *(*pData) >> 4, p);
+				mve::patternRow2Pixels2(*pFrame, g_width, *(*pData) >> 4, p);
 				(*pData)++;
 
 				*pFrame += 2*g_width;
@@ -431,7 +204,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 				pat[1] = (*pData)[1];
 				(*pData) += 2;
 
-				patternQuadrant2Pixels(*pFrame, pat[0], pat[1], p);
+				mve::patternQuadrant2Pixels(*pFrame, g_width, pat[0], pat[1], p);
 
 				if (i & 1)
 					*pFrame -= (4*g_width - 4);
@@ -453,7 +226,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 					}
 					pat[0] = *(*pData)++;
 					pat[1] = *(*pData)++;
-					patternQuadrant2Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternQuadrant2Pixels(*pFrame, g_width, pat[0], pat[1], p);
 
 					if (i & 1)
 						*pFrame -= (4*g_width - 4);
@@ -468,7 +241,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 						p[0] = GETPIXELI(pData, 0);
 						p[1] = GETPIXELI(pData, 0);
 					}
-					patternRow2Pixels(*pFrame, *(*pData), p);
+					mve::patternRow2Pixels(*pFrame, *(*pData), p);
 					(*pData)++;
 
 					*pFrame += g_width;
@@ -495,7 +268,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 					pat[0] = (*pData)[0];
 					pat[1] = (*pData)[1];
 					(*pData) += 2;
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += g_width;
 				}
 				*pDataRemain -= 16;
@@ -503,13 +276,13 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 			}
 			else
 			{
-				patternRow4Pixels2(*pFrame, (*pData)[0], p);
+				mve::patternRow4Pixels2(*pFrame, g_width, (*pData)[0], p);
 				*pFrame += 2*g_width;
-				patternRow4Pixels2(*pFrame, (*pData)[1], p);
+				mve::patternRow4Pixels2(*pFrame, g_width, (*pData)[1], p);
 				*pFrame += 2*g_width;
-				patternRow4Pixels2(*pFrame, (*pData)[2], p);
+				mve::patternRow4Pixels2(*pFrame, g_width, (*pData)[2], p);
 				*pFrame += 2*g_width;
-				patternRow4Pixels2(*pFrame, (*pData)[3], p);
+				mve::patternRow4Pixels2(*pFrame, g_width, (*pData)[3], p);
 
 				(*pData) += 4;
 				*pDataRemain -= 4;
@@ -524,7 +297,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 				{
 					pat[0] = (*pData)[0];
 					(*pData) += 1;
-					patternRow4Pixels2x1(*pFrame, pat[0], p);
+					mve::patternRow4Pixels2x1(*pFrame, pat[0], p);
 					*pFrame += g_width;
 				}
 				*pDataRemain -= 8;
@@ -538,9 +311,9 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 
 					(*pData) += 2;
 
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += g_width;
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += g_width;
 				}
 				*pDataRemain -= 8;
@@ -566,7 +339,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 
 				(*pData) += 4;
 
-				patternQuadrant4Pixels(*pFrame, pat[0], pat[1], pat[2], pat[3], p);
+				mve::patternQuadrant4Pixels(*pFrame, g_width, pat[0], pat[1], pat[2], pat[3], p);
 
 				if (i & 1)
 					*pFrame -= (4*g_width - 4);
@@ -597,7 +370,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 
 					(*pData) += 4;
 
-					patternQuadrant4Pixels(*pFrame, pat[0], pat[1], pat[2], pat[3], p);
+					mve::patternQuadrant4Pixels(*pFrame, g_width, pat[0], pat[1], pat[2], pat[3], p);
 
 					if (i & 1)
 						*pFrame -= (4*g_width - 4);
@@ -619,7 +392,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 
 					pat[0] = (*pData)[0];
 					pat[1] = (*pData)[1];
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += g_width;
 
 					(*pData) += 2;
@@ -666,14 +439,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 			p[0] = GETPIXEL(pData, 0);
 			p[1] = GETPIXEL(pData, 2);
 
-			for (j=0; j<4; j++)
-			{
-				for (k=0; k<4; k++)
-				{
-					(*pFrame)[k*g_width+j] = p[0];
-					(*pFrame)[k*g_width+j+4] = p[1];
-				}
-			}
+			mve::patternHalves(*pFrame, g_width, p);
 
 			*pFrame += 4*g_width;
 
@@ -685,13 +451,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 	case 0xe:
 		p[0] = GETPIXEL(pData, 0);
 
-		for (i = 0; i < 8; i++) {
-			for (j = 0; j < 8; j++) {
-				(*pFrame)[j] = p[0];
-			}
-
-			*pFrame += g_width;
-		}
+		mve::fillBlock(*pFrame, g_width, p[0]);
 
 		*pData += 2;
 		*pDataRemain -= 2;
@@ -702,14 +462,7 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 		p[0] = GETPIXEL(pData, 0);
 		p[1] = GETPIXEL(pData, 1);
 
-		for (i=0; i<8; i++)
-		{
-			for (j=0; j<8; j++)
-			{
-				(*pFrame)[j] = p[(i+j)&1];
-			}
-			*pFrame += g_width;
-		}
+		mve::ditherBlock(*pFrame, g_width, p);
 
 		*pData += 4;
 		*pDataRemain -= 4;
@@ -723,3 +476,165 @@ static void dispatchDecoder16(unsigned short **pFrame, unsigned char codeType, c
 }
 
 }
+
+namespace {
+
+/* Decode block rows row_begin to row_end - 1, with FramePtr, pMap, pData
+ * and pOffData at the start of row_begin.  pData and pOffData are left at
+ * the end of the data used.
+ */
+static void decodeRows16(uint16_t *FramePtr, std::span<const uint8_t> pMap, const unsigned char *&pData, const unsigned char *&pOffData, int dataRemain, const int row_begin, const int row_end)
+{
+	const int xb = g_width >> 3;
+	for (int j=row_begin; j<row_end; j++)
+	{
+		for (int i=0; i<xb/2; i++)
+		{
+			const auto m = pMap.front();
+			dispatchDecoder16(&FramePtr, m & 0xf, &pData, &pOffData, &dataRemain, &i, &j);
+			dispatchDecoder16(&FramePtr, m >> 4, &pData, &pOffData, &dataRemain, &i, &j);
+			pMap = pMap.subspan<1>();
+		}
+		FramePtr += 7*g_width;
+	}
+}
+
+/* Bytes of pixel data used by a block of type `codeType` whose data starts
+ * at `d`, or -1 if that cannot be found from the `remain` bytes available.
+ * Types 0x2 to 0x4 use one byte of offset data instead.  Type 0x6 is
+ * reported as -1 too, since it moves the frame pointer.
+ */
+static int blockDataLength16(const unsigned codeType, const unsigned char *const d, const std::ptrdiff_t remain)
+{
+	/* Pixels with the top bit set select an alternate encoding. */
+	const auto high_bit = [d](const unsigned offset) {
+		return d[offset + 1] & 0x80;
+	};
+	switch (codeType)
+	{
+		case 0x0:
+		case 0x1:
+		case 0x2:
+		case 0x3:
+		case 0x4:
+			return 0;
+		case 0x5:
+		case 0xe:
+			return 2;
+		case 0x7:
+			return remain < 2 ? -1 : high_bit(0) ? 6 : 12;
+		case 0x8:
+			return remain < 2 ? -1 : high_bit(0) ? 16 : 24;
+		case 0x9:
+			return remain < 6 ? -1 : high_bit(0) ? 16 : high_bit(4) ? 12 : 24;
+		case 0xa:
+			return remain < 2 ? -1 : high_bit(0) ? 32 : 48;
+		case 0xb:
+			return 128;
+		case 0xc:
+			return 32;
+		case 0xd:
+			return 8;
+		case 0xf:
+			return 4;
+		default:
+			return -1;
+	}
+}
+
+/* Split the frame into bands which can be decoded independently: blocks
+ * copied from elsewhere in the new frame must copy from their own band,
+ * and type 0xc, which writes one row below its block, must not be in the
+ * last row of a band.  Returns the number of bands, or 1 if the frame
+ * must be decoded in one piece.
+ */
+static unsigned planBands16(const std::span<const uint8_t> pMap, const unsigned char *pData, const unsigned char *pOffData, const unsigned char *const pEnd, decode_band_plan &plan)
+{
+	const unsigned width = g_width, xb = width >> 3, yb = g_height >> 3;
+	const unsigned bands = decodeBandCount(yb);
+	if (bands < 2 || pMap.size() < yb * (xb / 2))
+		return 1;
+	for (unsigned band = 0; band < bands; ++band)
+	{
+		const unsigned row_begin = yb * band / bands, row_end = yb * (band + 1) / bands;
+		plan[band] = {row_begin, pData, pOffData};
+		/* Pixels of the band, as offsets from the start of the frame */
+		const std::ptrdiff_t lo = row_begin * 8 * width, hi = row_end * 8 * width;
+		for (unsigned j = row_begin; j < row_end; ++j)
+			for (unsigned i = 0; i < xb; ++i)
+			{
+				const auto m = pMap[j * (xb / 2) + i / 2];
+				const unsigned codeType = (i & 1) ? m >> 4 : m & 0xf;
+				if (codeType >= 0x2 && codeType <= 0x4)
+				{
+					if (pOffData >= pEnd)
+						return 1;
+					const auto k = *pOffData++;
+					if (codeType == 0x4)
+						continue;
+					const auto &pos = (codeType == 0x2 ? lookup_table.far_p : lookup_table.far_n)[k];
+					const std::ptrdiff_t src = std::ptrdiff_t{static_cast<int>(j * 8) + pos.y} * width + i * 8 + pos.x;
+					if (src < lo || src + 7 * width + 8 > hi)
+						return 1;
+					continue;
+				}
+				if (codeType == 0xc && j + 1 == row_end && band + 1 < bands)
+					return 1;
+				if (pData >= pEnd && codeType > 0x1)
+					return 1;
+				const auto length = blockDataLength16(codeType, pData, pEnd - pData);
+				if (length < 0)
+					return 1;
+				pData += length;
+			}
+	}
+	plan[bands] = {yb, pData, pOffData};
+	return bands;
+}
+
+}
+
+void decodeFrame16(unsigned char *pFrame, std::span<const uint8_t> pMap, const unsigned char *pData, int dataRemain)
+{
+	const auto FramePtr = reinterpret_cast<uint16_t *>(pFrame);
+
+	backBuf1 = reinterpret_cast<uint16_t *>(g_vBackBuf1);
+	backBuf2 = reinterpret_cast<uint16_t *>(g_vBackBuf2);
+
+	const unsigned short offset = pData[0]|(pData[1]<<8);
+	const auto pEnd = pData + dataRemain;
+
+	auto pOffData = pData + offset;
+
+	pData += 2;
+
+	const auto pOrig = pData;
+	const int length = offset - 2; /*dataRemain-2;*/
+
+	decode_band_plan plan;
+	const auto bands = planBands16(pMap, pData, pOffData, pEnd, plan);
+	if (bands < 2)
+		decodeRows16(FramePtr, pMap, pData, pOffData, dataRemain, 0, g_height >> 3);
+	else
+	{
+		const unsigned width = g_width, half_xb = (width >> 3) / 2;
+		std::array<std::pair<const unsigned char *, const unsigned char *>, MVE_MAX_DECODE_BANDS> ends;
+		decodeBands(bands, [&](const unsigned band) {
+			const auto &b = plan[band];
+			auto &[band_data, band_offdata] = ends[band];
+			band_data = b.data;
+			band_offdata = b.offData;
+			decodeRows16(FramePtr + b.row * 8 * width, pMap.subspan(b.row * half_xb), band_data, band_offdata, dataRemain - (b.data - pOrig), b.row, plan[band + 1].row);
+		});
+		for (unsigned band = 0; band < bands; ++band)
+			if (ends[band] != std::pair(plan[band + 1].data, plan[band + 1].offData))
+				con_printf(CON_URGENT, "libmve: band %u of frame ended at data offset %td, expected %td", band, ends[band].first - pOrig, plan[band + 1].data - pOrig);
+		pData = plan[bands].data;
+	}
+
+	const std::ptrdiff_t remaining = (pData - pOrig);
+	if (const std::ptrdiff_t difference = length - remaining)
+	{
+		con_printf(CON_CRITICAL, "DEBUG: junk left over: %d,%d,%d", DXX_ptrdiff_cast_int(remaining), length, DXX_ptrdiff_cast_int(difference));
+	}
+}
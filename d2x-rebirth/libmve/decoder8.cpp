@@ -11,6 +11,7 @@
 #include <string.h>
 
 #include "decoders.h"
+#include "decoder_kernels.h"
 #include "console.h"
 
 #include "dxxsconf.h"
@@ -22,13 +23,13 @@ using namespace dcx;
 
 static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, const unsigned char **pData, int *pDataRemain, int *curXb, int *curYb);
 
-void decodeFrame8(unsigned char *pFrame, std::span<const uint8_t> pMap, const unsigned char *pData, int dataRemain)
+/* Decode block rows row_begin to row_end - 1, with pFrame, pMap and pData
+ * at the start of row_begin.  Returns the end of the data used.
+ */
+static const unsigned char *decodeRows8(unsigned char *pFrame, std::span<const uint8_t> pMap, const unsigned char *pData, int dataRemain, const int row_begin, const int row_end)
 {
-	int xb, yb;
-
-	xb = g_width >> 3;
-	yb = g_height >> 3;
-	for (int j=0; j<yb; j++)
+	const int xb = g_width >> 3;
+	for (int j=row_begin; j<row_end; j++)
 	{
 		for (int i=0; i<xb/2; i++)
 		{
@@ -48,6 +49,7 @@ void decodeFrame8(unsigned char *pFrame, std::span<const uint8_t> pMap, const un
 		}
 		pFrame += 7*g_width;
 	}
+	return pData;
 }
 
 static void relClose(int i, int *x, int *y)
@@ -75,154 +77,105 @@ static void relFar(int i, int sign, int *x, int *y)
 	}
 }
 
-/* copies an 8x8 block from pSrc to pDest.
-   pDest and pSrc are both g_width bytes wide */
-static void copyFrame(uint8_t *pDest, const uint8_t *pSrc)
-{
-	const auto width = g_width;
-	range_for (const int i, xrange(8u))
-	{
-		(void)i;
-		memcpy(pDest, pSrc, 8);
-		pDest += width;
-		pSrc += width;
-	}
-}
-
-// Fill in the next eight bytes with p[0], p[1], p[2], or p[3],
-// depending on the corresponding two-bit value in pat0 and pat1
-static void patternRow4Pixels(unsigned char *pFrame,
-							  unsigned char pat0, unsigned char pat1,
-							  const std::array<uint8_t, 4> &p)
-{
-	unsigned short mask=0x0003;
-	unsigned short shift=0;
-	unsigned short pattern = (pat1 << 8) | pat0;
-
-	while (mask != 0)
-	{
-		*pFrame++ = p[(mask & pattern) >> shift];
-		mask <<= 2;
-		shift += 2;
-	}
-}
-
-// Fill in the next four 2x2 pixel blocks with p[0], p[1], p[2], or p[3],
-// depending on the corresponding two-bit value in pat0.
-static void patternRow4Pixels2(unsigned char *pFrame,
-							   unsigned char pat0,
-							   const std::array<uint8_t, 4> &p)
-{
-	unsigned char mask=0x03;
-	unsigned char shift=0;
-	unsigned char pel;
-
-	const auto width = g_width;
-	while (mask != 0)
-	{
-		pel = p[(mask & pat0) >> shift];
-		pFrame[0] = pel;
-		pFrame[1] = pel;
-		pFrame[width + 0] = pel;
-		pFrame[width + 1] = pel;
-		pFrame += 2;
-		mask <<= 2;
-		shift += 2;
-	}
-}
-
-// Fill in the next four 2x1 pixel blocks with p[0], p[1], p[2], or p[3],
-// depending on the corresponding two-bit value in pat.
-static void patternRow4Pixels2x1(unsigned char *pFrame, unsigned char pat, const std::array<uint8_t, 4> &p)
-{
-	unsigned char mask=0x03;
-	unsigned char shift=0;
-	unsigned char pel;
-
-	while (mask != 0)
-	{
-		pel = p[(mask & pat) >> shift];
-		pFrame[0] = pel;
-		pFrame[1] = pel;
-		pFrame += 2;
-		mask <<= 2;
-		shift += 2;
-	}
-}
-
-// Fill in the next 4x4 pixel block with p[0], p[1], p[2], or p[3],
-// depending on the corresponding two-bit value in pat0, pat1, pat2, and pat3.
-static void patternQuadrant4Pixels(unsigned char *pFrame, unsigned char pat0, unsigned char pat1, unsigned char pat2, unsigned char pat3, const std::array<uint8_t, 4> &p)
-{
-	unsigned long mask = 0x00000003UL;
-	int shift=0;
-	unsigned long pat = (pat3 << 24) | (pat2 << 16) | (pat1 << 8) | pat0;
-
-	const auto width = g_width;
-	range_for (const int i, xrange(16u))
-	{
-		pFrame[i&3] = p[(pat & mask) >> shift];
-
-		if ((i&3) == 3)
-			pFrame += width;
-
-		mask <<= 2;
-		shift += 2;
-	}
-}
-
-// fills the next 8 pixels with either p[0] or p[1], depending on pattern
-static void patternRow2Pixels(unsigned char *pFrame, unsigned char pat, const std::array<uint8_t, 4> &p)
+/* Bytes of data used by a block of type `codeType` whose data starts at
+ * `d`, or -1 if that cannot be found from the `remain` bytes available.
+ * Type 0x6 is reported as -1 too, since it moves the frame pointer.
+ */
+static int blockDataLength8(const unsigned codeType, const unsigned char *const d, const std::ptrdiff_t remain)
 {
-	unsigned char mask=0x01;
-
-	while (mask != 0)
+	switch (codeType)
 	{
-		*pFrame++ = p[(mask & pat) ? 1 : 0];
-		mask <<= 1;
+		case 0x0:
+		case 0x1:
+			return 0;
+		case 0x2:
+		case 0x3:
+		case 0x4:
+		case 0xe:
+			return 1;
+		case 0x5:
+		case 0xf:
+			return 2;
+		case 0x7:
+			return remain < 2 ? -1 : d[0] <= d[1] ? 10 : 4;
+		case 0x8:
+			return remain < 2 ? -1 : d[0] <= d[1] ? 16 : 12;
+		case 0x9:
+			return remain < 4 ? -1 : d[0] <= d[1] ? (d[2] <= d[3] ? 20 : 8) : 12;
+		case 0xa:
+			return remain < 2 ? -1 : d[0] <= d[1] ? 32 : 24;
+		case 0xb:
+			return 64;
+		case 0xc:
+			return 16;
+		case 0xd:
+			return 4;
+		default:
+			return -1;
 	}
 }
 
-// fills the next four 2 x 2 pixel boxes with either p[0] or p[1], depending on pattern
-static void patternRow2Pixels2(unsigned char *pFrame, unsigned char pat, const std::array<uint8_t, 4> &p)
+/* Split the frame into bands which can be decoded independently: blocks
+ * copied from elsewhere in the new frame must copy from their own band.
+ * Returns the number of bands, or 1 if the frame must be decoded in one
+ * piece.
+ */
+static unsigned planBands8(const std::span<const uint8_t> pMap, const unsigned char *pData, const int dataRemain, decode_band_plan &plan)
 {
-	unsigned char pel;
-	unsigned char mask=0x1;
-
-	const auto width = g_width;
-	while (mask != 0x10)
+	const unsigned width = g_width, xb = width >> 3, yb = g_height >> 3;
+	const unsigned bands = decodeBandCount(yb);
+	if (bands < 2 || pMap.size() < yb * (xb / 2))
+		return 1;
+	const auto pEnd = pData + dataRemain;
+	for (unsigned band = 0; band < bands; ++band)
 	{
-		pel = p[(mask & pat) ? 1 : 0];
-
-		pFrame[0] = pel;              // upper-left
-		pFrame[1] = pel;              // upper-right
-		pFrame[width + 0] = pel;    // lower-left
-		pFrame[width + 1] = pel;    // lower-right
-		pFrame += 2;
-
-		mask <<= 1;
+		const unsigned row_begin = yb * band / bands, row_end = yb * (band + 1) / bands;
+		plan[band] = {row_begin, pData, nullptr};
+		/* Pixels of the band, as offsets from the start of the frame */
+		const std::ptrdiff_t lo = row_begin * 8 * width, hi = row_end * 8 * width;
+		for (unsigned j = row_begin; j < row_end; ++j)
+			for (unsigned i = 0; i < xb; ++i)
+			{
+				const auto m = pMap[j * (xb / 2) + i / 2];
+				const unsigned codeType = (i & 1) ? m >> 4 : m & 0xf;
+				if (pData >= pEnd && codeType > 0x1)
+					return 1;
+				if (codeType == 0x2 || codeType == 0x3)
+				{
+					int x, y;
+					relFar(*pData, codeType == 0x2 ? 1 : -1, &x, &y);
+					const std::ptrdiff_t src = std::ptrdiff_t{j * 8 + y} * width + i * 8 + x;
+					if (src < lo || src + 7 * width + 8 > hi)
+						return 1;
+				}
+				const auto length = blockDataLength8(codeType, pData, pEnd - pData);
+				if (length < 0)
+					return 1;
+				pData += length;
+			}
 	}
+	plan[bands] = {yb, pData, nullptr};
+	return bands;
 }
 
-// fills pixels in the next 4 x 4 pixel boxes with either p[0] or p[1], depending on pat0 and pat1.
-static void patternQuadrant2Pixels(unsigned char *pFrame, unsigned char pat0, unsigned char pat1, const std::array<uint8_t, 4> &p)
+void decodeFrame8(unsigned char *pFrame, std::span<const uint8_t> pMap, const unsigned char *pData, int dataRemain)
 {
-	unsigned char pel;
-	unsigned short mask = 0x0001;
-	unsigned short pat = (pat1 << 8) | pat0;
-
-	const auto width = g_width;
-	range_for (const int i, xrange(4u))
+	decode_band_plan plan;
+	const auto bands = planBands8(pMap, pData, dataRemain, plan);
+	if (bands < 2)
 	{
-		range_for (const int j, xrange(4u))
-		{
-			pel = p[(pat & mask) ? 1 : 0];
-
-			pFrame[j + i * width] = pel;
-
-			mask <<= 1;
-		}
+		decodeRows8(pFrame, pMap, pData, dataRemain, 0, g_height >> 3);
+		return;
 	}
+	const unsigned width = g_width, half_xb = (width >> 3) / 2;
+	std::array<const unsigned char *, MVE_MAX_DECODE_BANDS> ends;
+	decodeBands(bands, [&](const unsigned band) {
+		const auto &b = plan[band];
+		ends[band] = decodeRows8(pFrame + b.row * 8 * width, pMap.subspan(b.row * half_xb), b.data, dataRemain - (b.data - pData), b.row, plan[band + 1].row);
+	});
+	for (unsigned band = 0; band < bands; ++band)
+		if (ends[band] != plan[band + 1].data)
+			con_printf(CON_URGENT, "libmve: band %u of frame ended at data offset %td, expected %td", band, ends[band] - pData, plan[band + 1].data - pData);
 }
 
 static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, const unsigned char **pData, int *pDataRemain, int *curXb, int *curYb)
@@ -238,7 +191,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 	{
 	case 0x0:
 		/* block is copied from block in current frame */
-		copyFrame(*pFrame, *pFrame + (g_vBackBuf2 - g_vBackBuf1));
+		mve::copyBlock(*pFrame, *pFrame + (g_vBackBuf2 - g_vBackBuf1), g_width);
 		[[fallthrough]];
 	case 0x1:
 		/* block is unchanged from two frames ago */
@@ -260,7 +213,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 		   y =   8 + ((B - 56) / 29)
 		*/
 		relFar(*(*pData)++, 1, &x, &y);
-		copyFrame(*pFrame, *pFrame + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + x + y*g_width, g_width);
 		*pFrame += 8;
 		--*pDataRemain;
 		break;
@@ -277,7 +230,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 		   y = -(  8 + ((B - 56) / 29))
 		*/
 		relFar(*(*pData)++, -1, &x, &y);
-		copyFrame(*pFrame, *pFrame + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + x + y*g_width, g_width);
 		*pFrame += 8;
 		--*pDataRemain;
 		break;
@@ -297,7 +250,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 		   y = -8 + BH
 		*/
 		relClose(*(*pData)++, &x, &y);
-		copyFrame(*pFrame, *pFrame + (g_vBackBuf2 - g_vBackBuf1) + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + (g_vBackBuf2 - g_vBackBuf1) + x + y*g_width, g_width);
 		*pFrame += 8;
 		--*pDataRemain;
 		break;
@@ -310,7 +263,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 		*/
 		x = static_cast<int8_t>(*(*pData)++);
 		y = static_cast<int8_t>(*(*pData)++);
-		copyFrame(*pFrame, *pFrame + (g_vBackBuf2 - g_vBackBuf1) + x + y*g_width);
+		mve::copyBlock(*pFrame, *pFrame + (g_vBackBuf2 - g_vBackBuf1) + x + y*g_width, g_width);
 		*pFrame += 8;
 		*pDataRemain -= 2;
 		break;
@@ -416,7 +369,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 			range_for (const int i, xrange(8u))
 			{
 				(void)i;
-				patternRow2Pixels(*pFrame, *(*pData)++, p);
+				mve::patternRow2Pixels(*pFrame, *(*pData)++, p);
 				*pFrame += width;
 			}
 		}
@@ -426,9 +379,9 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 			range_for (const int i, xrange(2u))
 			{
 				(void)i;
-				patternRow2Pixels2(*pFrame, *(*pData) & 0xf, p);
+				mve::patternRow2Pixels2(*pFrame, g_width, *(*pData) & 0xf, p);
 				*pFrame += width2;
-				patternRow2Pixels2(*pFrame, *(*pData)++ >> 4, p);
+				mve::patternRow2Pixels2(*pFrame, g_width, *(*pData)++ >> 4, p);
 				*pFrame += width2;
 			}
 		}
@@ -536,7 +489,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 				p[1] = *(*pData)++;
 				pat[0] = *(*pData)++;
 				pat[1] = *(*pData)++;
-				patternQuadrant2Pixels(*pFrame, pat[0], pat[1], p);
+				mve::patternQuadrant2Pixels(*pFrame, g_width, pat[0], pat[1], p);
 
 				// alternate between moving down and moving up and right
 				if (i & 1)
@@ -557,7 +510,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 				}
 				pat[0] = *(*pData)++;
 				pat[1] = *(*pData)++;
-				patternQuadrant2Pixels(*pFrame, pat[0], pat[1], p);
+				mve::patternQuadrant2Pixels(*pFrame, g_width, pat[0], pat[1], p);
 
 				if (i & 1)
 					*pFrame -= (4 * width - 4);
@@ -575,7 +528,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 					p[0] = *(*pData)++;
 					p[1] = *(*pData)++;
 				}
-				patternRow2Pixels(*pFrame, *(*pData)++, p);
+				mve::patternRow2Pixels(*pFrame, *(*pData)++, p);
 				*pFrame += width;
 			}
 			*pFrame -= (8 * width - 8);
@@ -625,7 +578,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 					(void)i;
 					pat[0] = *(*pData)++;
 					pat[1] = *(*pData)++;
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += width;
 				}
 
@@ -638,13 +591,13 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 				p[2] = *(*pData)++;
 				p[3] = *(*pData)++;
 
-				patternRow4Pixels2(*pFrame, *(*pData)++, p);
+				mve::patternRow4Pixels2(*pFrame, g_width, *(*pData)++, p);
 				*pFrame += 2 * width;
-				patternRow4Pixels2(*pFrame, *(*pData)++, p);
+				mve::patternRow4Pixels2(*pFrame, g_width, *(*pData)++, p);
 				*pFrame += 2 * width;
-				patternRow4Pixels2(*pFrame, *(*pData)++, p);
+				mve::patternRow4Pixels2(*pFrame, g_width, *(*pData)++, p);
 				*pFrame += 2 * width;
-				patternRow4Pixels2(*pFrame, *(*pData)++, p);
+				mve::patternRow4Pixels2(*pFrame, g_width, *(*pData)++, p);
 				*pFrame -= (6 * width - 8);
 			}
 		}
@@ -662,7 +615,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 				{
 					(void)i;
 					pat[0] = *(*pData)++;
-					patternRow4Pixels2x1(*pFrame, pat[0], p);
+					mve::patternRow4Pixels2x1(*pFrame, pat[0], p);
 					*pFrame += width;
 				}
 			}
@@ -679,9 +632,9 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 					(void)i;
 					pat[0] = *(*pData)++;
 					pat[1] = *(*pData)++;
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += width;
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += width;
 				}
 			}
@@ -739,7 +692,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 				pat[2] = *(*pData)++;
 				pat[3] = *(*pData)++;
 
-				patternQuadrant4Pixels(*pFrame, pat[0], pat[1], pat[2], pat[3], p);
+				mve::patternQuadrant4Pixels(*pFrame, g_width, pat[0], pat[1], pat[2], pat[3], p);
 
 				if (i & 1)
 					*pFrame -= (4 * width - 4);
@@ -767,7 +720,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 					pat[2] = *(*pData)++;
 					pat[3] = *(*pData)++;
 
-					patternQuadrant4Pixels(*pFrame, pat[0], pat[1], pat[2], pat[3], p);
+					mve::patternQuadrant4Pixels(*pFrame, g_width, pat[0], pat[1], pat[2], pat[3], p);
 
 					if (i & 1)
 						*pFrame -= (4 * width - 4);
@@ -790,7 +743,7 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 
 					pat[0] = *(*pData)++;
 					pat[1] = *(*pData)++;
-					patternRow4Pixels(*pFrame, pat[0], pat[1], p);
+					mve::patternRow4Pixels(*pFrame, pat[0], pat[1], p);
 					*pFrame += width;
 				}
 
@@ -855,20 +808,11 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 			const auto width = g_width;
 		range_for (const int i, xrange(2u))
 		{
-			(void)i;
-			range_for (const int j, xrange(4u))
-			{
-				range_for (const int k, xrange(4u))
-				{
-					(*pFrame)[k * width+j] = (*pData)[0];
-					(*pFrame)[k * width+j+4] = (*pData)[1];
-				}
-			}
-			*pFrame += 4 * width;
+			mve::patternHalves(*pFrame + i * 4 * width, width, {{(*pData)[0], (*pData)[1]}});
 			*pData += 2;
 			*pDataRemain -= 2;
 		}
-		*pFrame -= (8 * width - 8);
+		*pFrame += 8;
 		}
 		break;
 
@@ -876,18 +820,10 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 		/* This encoding represents a solid 8x8 frame.  We get 1 byte of pixel
 		   data from the data stream.
 		*/
-		{
-			const auto width = g_width;
-		range_for (const int i, xrange(8u))
-		{
-			(void)i;
-			memset(*pFrame, **pData, 8);
-			*pFrame += width;
-		}
+		mve::fillBlock(*pFrame, g_width, **pData);
 		++*pData;
 		--*pDataRemain;
-		*pFrame -= (8 * width - 8);
-		}
+		*pFrame += 8;
 		break;
 
 	case 0xf:
@@ -902,20 +838,10 @@ static void dispatchDecoder(unsigned char **pFrame, unsigned char codeType, cons
 		   P0 P1 P0 P1 P0 P1 P0 P1
 		   P1 P0 P1 P0 P1 P0 P1 P0
 		*/
-		{
-			const auto width = g_width;
-		range_for (const int i, xrange(8u))
-		{
-			range_for (const int j, xrange(8u))
-			{
-				(*pFrame)[j] = (*pData)[(i+j)&1];
-			}
-			*pFrame += width;
-		}
+		mve::ditherBlock(*pFrame, g_width, {{(*pData)[0], (*pData)[1]}});
 		*pData += 2;
 		*pDataRemain -= 2;
-		*pFrame -= (8 * width - 8);
-		}
+		*pFrame += 8;
 		break;
 
 	default:
@@ -0,0 +1,264 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * INTERNAL header - not to be included outside of libmve
+ *
+ * Block kernels shared by the 8 bit and 16 bit decoders.
+ *
+ * A row of 8 pixels is built in 64-bit words, one word for 8 bit pixels
+ * and two for 16 bit pixels, then stored with a single copy.  Pattern
+ * bits are turned into lane masks by table lookup, so choosing between
+ * colours is a bitwise select instead of a branch or an indexed load per
+ * pixel.  Lanes are defined by memory order, so the results do not depend
+ * on the byte order of the host.
+ *
+ */
+
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace mve {
+
+template <typename pixel_t>
+using pixel_row = std::array<uint64_t, sizeof(pixel_t)>;
+
+template <typename pixel_t>
+using pixel_colors = std::array<pixel_t, 4>;
+
+namespace detail {
+
+template <typename pixel_t>
+inline constexpr unsigned lanes_per_word = 8 / sizeof(pixel_t);
+
+/* Entry `bits` has lane i all ones if bit i of `bits` is set. */
+template <typename pixel_t>
+constexpr auto make_lane_masks()
+{
+	constexpr unsigned lanes = lanes_per_word<pixel_t>;
+	std::array<uint64_t, 1u << lanes> table{};
+	for (unsigned bits = 0; bits < table.size(); ++bits)
+	{
+		std::array<pixel_t, lanes> word{};
+		for (unsigned i = 0; i < lanes; ++i)
+			word[i] = ((bits >> i) & 1) ? static_cast<pixel_t>(~pixel_t{}) : pixel_t{};
+		table[bits] = std::bit_cast<uint64_t>(word);
+	}
+	return table;
+}
+
+template <typename pixel_t>
+inline constexpr auto lane_masks = make_lane_masks<pixel_t>();
+
+/* Gather bits 0, 2, 4 and 6 (or 1, 3, 5 and 7, for shift 1) of a byte
+ * into bits 0 to 3.  This splits a byte of four 2-bit colour numbers
+ * into their low and high bits.
+ */
+constexpr auto make_gather_table(const unsigned shift)
+{
+	std::array<uint8_t, 256> table{};
+	for (unsigned b = 0; b < table.size(); ++b)
+		for (unsigned i = 0; i < 4; ++i)
+			table[b] |= ((b >> (2 * i + shift)) & 1) << i;
+	return table;
+}
+
+inline constexpr auto even_bits = make_gather_table(0);
+inline constexpr auto odd_bits = make_gather_table(1);
+
+/* Spread bit i of a nibble to bits 2i and 2i+1, for pixels drawn two
+ * wide.
+ */
+constexpr auto make_double_table()
+{
+	std::array<uint8_t, 16> table{};
+	for (unsigned b = 0; b < table.size(); ++b)
+		for (unsigned i = 0; i < 4; ++i)
+			table[b] |= ((b >> i) & 1) * (3u << (2 * i));
+	return table;
+}
+
+inline constexpr auto double_bits = make_double_table();
+
+}
+
+/* Lane i of the result is all ones if bit i of `bits` is set. */
+template <typename pixel_t>
+static inline pixel_row<pixel_t> row_mask(const unsigned bits)
+{
+	constexpr unsigned lanes = detail::lanes_per_word<pixel_t>;
+	constexpr unsigned lane_bits = (1u << lanes) - 1;
+	pixel_row<pixel_t> r;
+	for (std::size_t k = 0; k < r.size(); ++k)
+		r[k] = detail::lane_masks<pixel_t>[(bits >> (k * lanes)) & lane_bits];
+	return r;
+}
+
+template <typename pixel_t>
+static inline pixel_row<pixel_t> row_broadcast(const pixel_t v)
+{
+	/* 0x0101... for 8 bit pixels, 0x00010001... for 16 bit pixels */
+	constexpr uint64_t ones = ~uint64_t{0} / ((uint64_t{1} << (8 * sizeof(pixel_t))) - 1);
+	pixel_row<pixel_t> r;
+	r.fill(uint64_t{v} * ones);
+	return r;
+}
+
+/* Take `b` in the lanes set in `m`, and `a` elsewhere. */
+template <typename pixel_t>
+static inline pixel_row<pixel_t> row_select(const pixel_row<pixel_t> &a, const pixel_row<pixel_t> &b, const pixel_row<pixel_t> &m)
+{
+	pixel_row<pixel_t> r;
+	for (std::size_t k = 0; k < r.size(); ++k)
+		r[k] = a[k] ^ ((a[k] ^ b[k]) & m[k]);
+	return r;
+}
+
+/* Pixel i is p[1] if bit i of `bits` is set, else p[0]. */
+template <typename pixel_t>
+static inline pixel_row<pixel_t> row2(const pixel_colors<pixel_t> &p, const unsigned bits)
+{
+	return row_select<pixel_t>(row_broadcast(p[0]), row_broadcast(p[1]), row_mask<pixel_t>(bits));
+}
+
+/* Pixel i is p[n], where n has bit i of `lo` as its low bit and bit i of
+ * `hi` as its high bit.
+ */
+template <typename pixel_t>
+static inline pixel_row<pixel_t> row4(const pixel_colors<pixel_t> &p, const unsigned lo, const unsigned hi)
+{
+	const auto mlo = row_mask<pixel_t>(lo);
+	return row_select<pixel_t>(
+		row_select<pixel_t>(row_broadcast(p[0]), row_broadcast(p[1]), mlo),
+		row_select<pixel_t>(row_broadcast(p[2]), row_broadcast(p[3]), mlo),
+		row_mask<pixel_t>(hi));
+}
+
+template <typename pixel_t>
+static inline void store_row(pixel_t *const dst, const pixel_row<pixel_t> &r)
+{
+	std::memcpy(dst, r.data(), 8 * sizeof(pixel_t));
+}
+
+/* Store the first four pixels of the row. */
+template <typename pixel_t>
+static inline void store_half_row(pixel_t *const dst, const pixel_row<pixel_t> &r)
+{
+	std::memcpy(dst, r.data(), 4 * sizeof(pixel_t));
+}
+
+/* Copy an 8x8 block.  Rows of `dst` and `src` are `stride` pixels apart. */
+template <typename pixel_t>
+static inline void copyBlock(pixel_t *dst, const pixel_t *src, const std::size_t stride)
+{
+	for (unsigned i = 0; i < 8; ++i, dst += stride, src += stride)
+		std::memcpy(dst, src, 8 * sizeof(pixel_t));
+}
+
+/* Fill an 8x8 block with one colour. */
+template <typename pixel_t>
+static inline void fillBlock(pixel_t *dst, const std::size_t stride, const pixel_t v)
+{
+	const auto r = row_broadcast(v);
+	for (unsigned i = 0; i < 8; ++i, dst += stride)
+		store_row(dst, r);
+}
+
+/* Fill an 8x8 block with a checkerboard of p[0] and p[1], starting with
+ * p[0] at the top left.
+ */
+template <typename pixel_t>
+static inline void ditherBlock(pixel_t *dst, const std::size_t stride, const pixel_colors<pixel_t> &p)
+{
+	const auto even = row2(p, 0xaa), odd = row2(p, 0x55);
+	for (unsigned i = 0; i < 8; i += 2, dst += 2 * stride)
+	{
+		store_row(dst, even);
+		store_row(dst + stride, odd);
+	}
+}
+
+/* Fill 4 rows, each with four pixels of p[0] then four of p[1]. */
+template <typename pixel_t>
+static inline void patternHalves(pixel_t *dst, const std::size_t stride, const pixel_colors<pixel_t> &p)
+{
+	const auto r = row2(p, 0xf0);
+	for (unsigned i = 0; i < 4; ++i, dst += stride)
+		store_row(dst, r);
+}
+
+/* Pixel i of the row is p[1] if bit i of `pat` is set, else p[0]. */
+template <typename pixel_t>
+static inline void patternRow2Pixels(pixel_t *const dst, const uint8_t pat, const pixel_colors<pixel_t> &p)
+{
+	store_row(dst, row2(p, pat));
+}
+
+/* Four 2x2 boxes, from the low nibble of `pat`. */
+template <typename pixel_t>
+static inline void patternRow2Pixels2(pixel_t *const dst, const std::size_t stride, const uint8_t pat, const pixel_colors<pixel_t> &p)
+{
+	const auto r = row2(p, detail::double_bits[pat & 0xf]);
+	store_row(dst, r);
+	store_row(dst + stride, r);
+}
+
+/* A 4x4 box, one nibble of pat0 then pat1 per row. */
+template <typename pixel_t>
+static inline void patternQuadrant2Pixels(pixel_t *dst, const std::size_t stride, const uint8_t pat0, const uint8_t pat1, const pixel_colors<pixel_t> &p)
+{
+	store_half_row(dst, row2(p, pat0 & 0xf));
+	store_half_row(dst += stride, row2(p, pat0 >> 4));
+	store_half_row(dst += stride, row2(p, pat1 & 0xf));
+	store_half_row(dst + stride, row2(p, pat1 >> 4));
+}
+
+/* Eight pixels, two bits of colour number each, four from pat0 then four
+ * from pat1.
+ */
+template <typename pixel_t>
+static inline void patternRow4Pixels(pixel_t *const dst, const uint8_t pat0, const uint8_t pat1, const pixel_colors<pixel_t> &p)
+{
+	using namespace detail;
+	store_row(dst, row4(p, even_bits[pat0] | (even_bits[pat1] << 4), odd_bits[pat0] | (odd_bits[pat1] << 4)));
+}
+
+/* Four 2x2 boxes, two bits of colour number each. */
+template <typename pixel_t>
+static inline void patternRow4Pixels2(pixel_t *const dst, const std::size_t stride, const uint8_t pat, const pixel_colors<pixel_t> &p)
+{
+	using namespace detail;
+	const auto r = row4(p, double_bits[even_bits[pat]], double_bits[odd_bits[pat]]);
+	store_row(dst, r);
+	store_row(dst + stride, r);
+}
+
+/* Four 2x1 boxes, two bits of colour number each. */
+template <typename pixel_t>
+static inline void patternRow4Pixels2x1(pixel_t *const dst, const uint8_t pat, const pixel_colors<pixel_t> &p)
+{
+	using namespace detail;
+	store_row(dst, row4(p, double_bits[even_bits[pat]], double_bits[odd_bits[pat]]));
+}
+
+/* A 4x4 box, two bits of colour number per pixel, one byte per row. */
+template <typename pixel_t>
+static inline void patternQuadrant4Pixels(pixel_t *dst, const std::size_t stride, const uint8_t pat0, const uint8_t pat1, const uint8_t pat2, const uint8_t pat3, const pixel_colors<pixel_t> &p)
+{
+	using namespace detail;
+	for (const uint8_t pat : {pat0, pat1, pat2, pat3})
+	{
+		store_half_row(dst, row4(p, even_bits[pat], odd_bits[pat]));
+		dst += stride;
+	}
+}
+
+}
@@ -11,11 +11,44 @@
  */
 
 #pragma once
+#include <array>
 #include <cstdint>
+#include <functional>
 #include <span>
 
 extern int g_width, g_height;
 extern unsigned char *g_vBackBuf1, *g_vBackBuf2;
 
+/* A frame may be split into bands of block rows, each decoded on its own
+ * thread.  The decoders split a frame only after checking that no block
+ * reads pixels which another band writes, so the result is the same as
+ * decoding the frame in one piece.
+ */
+constexpr unsigned MVE_MAX_DECODE_BANDS = 8;
+/* Bands shorter than this are not worth a thread. */
+constexpr unsigned MVE_MIN_DECODE_BAND_ROWS = 4;
+
+struct decode_band
+{
+	/* First block row of the band */
+	unsigned row;
+	/* Where the data of the band starts.  offData is used only by the 16
+	 * bit decoder.
+	 */
+	const unsigned char *data, *offData;
+};
+
+/* Entry `bands` holds the end of the last band. */
+using decode_band_plan = std::array<decode_band, MVE_MAX_DECODE_BANDS + 1>;
+
+/* Number of bands to try for a frame of `block_rows` rows; less than 2
+ * means the frame is decoded in one piece.
+ */
+unsigned decodeBandCount(unsigned block_rows);
+/* Call decode_band for bands 0 to bands - 1, all but band 0 on worker
+ * threads which last until MVE_rmEndMovie, and wait for all of them.
+ */
+void decodeBands(unsigned bands, const std::function<void(unsigned band)> &decode_band);
+
 void decodeFrame8(unsigned char *pFrame, std::span<const uint8_t> pMap, const unsigned char *pData, int dataRemain);
 void decodeFrame16(unsigned char *pFrame, std::span<const uint8_t> pMap, const unsigned char *pData, int dataRemain);
@@ -7,7 +7,12 @@
 //#define DEBUG
 
 #include "dxxsconf.h"
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <span>
+#include <system_error>
+#include <thread>
 #include <vector>
 #include <string.h>
 #include <time.h>
@@ -532,12 +537,128 @@ static int video_initialized = 0;
 int g_width, g_height;
 static std::vector<unsigned char> g_vBuffers;
 unsigned char *g_vBackBuf1, *g_vBackBuf2;
+static unsigned g_decodeThreads = 1;
 
 static int g_destX, g_destY;
 static int g_screenWidth, g_screenHeight;
 static std::span<const uint8_t> g_pCurMap;
 static int g_truecolor;
 
+unsigned decodeBandCount(const unsigned block_rows)
+{
+	return std::min({g_decodeThreads, MVE_MAX_DECODE_BANDS, block_rows / MVE_MIN_DECODE_BAND_ROWS});
+}
+
+namespace {
+
+/* Threads for bands 1 and up.  They are started as bands first need them
+ * and kept until the movie ends, so that a frame costs a wakeup per band
+ * instead of a thread.
+ */
+class decode_band_pool
+{
+	std::mutex mutex;
+	std::condition_variable work_ready, work_done;
+	std::array<std::thread, MVE_MAX_DECODE_BANDS> workers;
+	/* workers[1] to workers[started - 1] are running. */
+	unsigned started = 1;
+	const std::function<void(unsigned band)> *task = nullptr;
+	/* Bands of the current frame which have a worker, including band 0. */
+	unsigned task_bands = 0;
+	/* Incremented for each frame, so that a worker can tell a new frame
+	 * from a spurious wakeup.
+	 */
+	unsigned generation = 0;
+	/* Workers which have not yet finished the current frame. */
+	unsigned pending = 0;
+	bool stopping = false;
+	void run(unsigned band, unsigned seen);
+public:
+	~decode_band_pool()
+	{
+		stop();
+	}
+	void decode(unsigned bands, const std::function<void(unsigned band)> &decode_band);
+	void stop();
+};
+
+void decode_band_pool::run(const unsigned band, unsigned seen)
+{
+	for (;;)
+	{
+		const std::function<void(unsigned band)> *t;
+		{
+			std::unique_lock lock(mutex);
+			work_ready.wait(lock, [&] { return stopping || generation != seen; });
+			if (stopping)
+				return;
+			seen = generation;
+			if (band >= task_bands)
+				continue;
+			t = task;
+		}
+		(*t)(band);
+		std::lock_guard lock(mutex);
+		if (!--pending)
+			work_done.notify_one();
+	}
+}
+
+void decode_band_pool::decode(const unsigned bands, const std::function<void(unsigned band)> &decode_band)
+{
+	try {
+		for (; started < bands; ++started)
+			workers[started] = std::thread(&decode_band_pool::run, this, started, generation);
+	} catch (const std::system_error &) {
+		/* Bands without a thread are decoded here, after band 0. */
+	}
+	const unsigned threaded = std::min(bands, started);
+	if (threaded > 1)
+	{
+		{
+			std::lock_guard lock(mutex);
+			task = &decode_band;
+			task_bands = threaded;
+			pending = threaded - 1;
+			++generation;
+		}
+		work_ready.notify_all();
+	}
+	decode_band(0);
+	for (unsigned band = threaded; band < bands; ++band)
+		decode_band(band);
+	if (threaded > 1)
+	{
+		std::unique_lock lock(mutex);
+		work_done.wait(lock, [this] { return !pending; });
+		task = nullptr;
+	}
+}
+
+void decode_band_pool::stop()
+{
+	if (started == 1)
+		return;
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	work_ready.notify_all();
+	for (unsigned band = 1; band < started; ++band)
+		workers[band].join();
+	started = 1;
+	stopping = false;
+}
+
+static decode_band_pool g_decodeBandPool;
+
+}
+
+void decodeBands(const unsigned bands, const std::function<void(unsigned band)> &decode_band)
+{
+	g_decodeBandPool.decode(bands, decode_band);
+}
+
 static int create_videobuf_handler(unsigned char, unsigned char minor, const unsigned char *data, int, void *)
 {
 	short w, h,
@@ -767,6 +888,7 @@ void MVE_rmEndMovie(std::unique_ptr<MVESTREAM>)
 	mve_audio_playing=0;
 	mve_audio_flags = 0;
 
+	g_decodeBandPool.stop();
 	g_vBuffers.clear();
 	g_pCurMap = {};
 	videobuf_created = 0;
@@ -784,3 +906,8 @@ void MVE_sndInit(int x)
 {
 	mve_audio_enabled = (x == -1 ? 0 : 1);
 }
+
+void MVE_setDecodeThreads(const unsigned threads)
+{
+	g_decodeThreads = threads;
+}
@@ -33,6 +33,10 @@ void MVE_rmEndMovie(std::unique_ptr<MVESTREAM> mve);
 void MVE_getVideoSpec(MVE_videoSpec *vSpec);
 
 void MVE_sndInit(int x);
+/* Decode frames on up to `threads` threads.  1 decodes on the calling
+ * thread only.
+ */
+void MVE_setDecodeThreads(unsigned threads);
 
 void MovieShowFrame(const uint8_t *buf, int dstx, int dsty, int bufw, int bufh, int sw, int sh);
 void MovieSetPalette(const unsigned char *p, unsigned start, unsigned count);
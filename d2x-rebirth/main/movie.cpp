@@ -145,6 +145,7 @@ movie_play_status PlayMovie(const std::span<const char> subtitles, const char *c
 
 	// Start sound
 	MVE_sndInit(!CGameArg.SndNoSound ? 1 : -1);
+	MVE_setDecodeThreads(GameArg.GfxMovieThreads);
 
 	const auto ret = RunMovie(name, subtitles, !GameArg.GfxSkipHiresMovie, must_have, -1, -1);
 
@@ -448,6 +449,7 @@ RWops_ptr InitRobotMovie(const char *filename, MVESTREAM_ptr_t &pMovie)
 	con_printf(CON_DEBUG, "RoboFile=%s", filename);
 
 	MVE_sndInit(-1);        //tell movies to play no sound for robots
+	MVE_setDecodeThreads(GameArg.GfxMovieThreads);
 
 	auto &&[RoboFile, physfserr] = PHYSFSRWOPS_openRead(filename);
 	if (!RoboFile)
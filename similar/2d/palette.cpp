@@ -35,6 +35,9 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "dxxerror.h"
 #include "maths.h"
 #include "palette.h"
+#if !DXX_USE_OGL
+#include "texmap.h"
+#endif
 
 #include "d_enumerate.h"
 #include "dxxsconf.h"
@@ -153,6 +156,9 @@ void gr_copy_palette(palette_array_t &gr_palette, const palette_array_t &pal)
 	gr_palette = pal;
 
 	        Num_computed_colors = 0;
+#if !DXX_USE_OGL
+	tmap_mip_flush();
+#endif
 }
 #endif
 
@@ -187,6 +193,9 @@ void gr_use_palette_table(const char * filename )
 	// This is the TRANSPARENCY COLOR
 	range_for (auto &i, gr_fade_table)
 		i[255] = 255;
+#if !DXX_USE_OGL
+	tmap_mip_flush();
+#endif
 #if defined(DXX_BUILD_DESCENT_II)
 	Num_computed_colors = 0;	//	Flush palette cache.
 // swap colors 0 and 255 of the palette along with fade table entries
@@ -219,6 +219,15 @@ public:
 	}
 };
 
+#if !DXX_USE_OGL
+/* The faces of the polygon model being drawn.  Submodels add to the same
+ * batch, which is drawn before a rod is drawn and when the outermost
+ * g3_draw_polygon_model returns.
+ */
+static g3_draw_batch Model_faces;
+static unsigned Model_faces_depth;
+#endif
+
 class g3_interpreter_draw_base
 {
 protected:
@@ -230,8 +239,8 @@ protected:
 private:
 	void rotate(uint_fast32_t i, const vms_vector *const src, const uint_fast32_t n)
 	{
-		for (auto &&[dest, src] : zip(partial_range(Interp_point_list, i, i + n), unchecked_partial_range(src, n)))
-			g3_rotate_point(dest, src);
+		const auto &&dest = partial_range(Interp_point_list, i, i + n);
+		g3_rotate_point_list(std::span(dest.begin(), dest.end()), std::span(src, n));
 	}
 	void set_color_by_model_light(fix g3s_lrgb::*const c, g3s_lrgb &o, const fix color) const
 	{
@@ -285,6 +294,10 @@ protected:
 		const g3s_lrgb rodbm_light{
 			f1_0, f1_0, f1_0
 		};
+#if !DXX_USE_OGL
+		if (!Model_faces.empty())
+			Model_faces.draw(canvas);
+#endif
 		g3_draw_rod_tmap(canvas, *model_bitmaps[w(p + 2)], rod_bot_p, w(p + 16), rod_top_p, w(p + 32), rodbm_light);
 	}
 	void op_subcall(const uint8_t *const p, const glow_values_t *const glow_values)
@@ -341,7 +354,11 @@ public:
 					: gr_find_closest_color_15bpp(w(p + 28));
 #endif
 				const auto point_list = prepare_point_list<MAX_POINTS_PER_POLY>(nv, p);
+#if DXX_USE_OGL
 				g3_draw_poly(canvas, nv, point_list, color);
+#else
+				Model_faces.add_poly(std::span(point_list).first(nv), color);
+#endif
 		}
 	}
 	static g3s_lrgb get_glow_light(const fix c)
@@ -369,7 +386,11 @@ public:
 			uvl_list[i].l = average_light;
 		}
 		const auto point_list = prepare_point_list<MAX_POINTS_PER_POLY>(nv, p);
+#if DXX_USE_OGL
 		g3_draw_tmap(canvas, nv, point_list, uvl_list, lrgb_list, *model_bitmaps[w(p + 28)]);
+#else
+		Model_faces.add_tmap(std::span(point_list).first(nv), uvl_list.data(), lrgb_list.data(), *model_bitmaps[w(p + 28)]);
+#endif
 	}
 	void op_sortnorm(const uint8_t *const p)
 	{
@@ -920,7 +941,14 @@ int g3_poly_get_color(const uint8_t *p)
 void g3_draw_polygon_model(grs_bitmap *const *const model_bitmaps, polygon_model_points &Interp_point_list, grs_canvas &canvas, const submodel_angles anim_angles, const g3s_lrgb model_light, const glow_values_t *const glow_values, const uint8_t *const p)
 {
 	g3_draw_polygon_model_state state(model_bitmaps, Interp_point_list, canvas, anim_angles, model_light, glow_values);
+#if DXX_USE_OGL
 	iterate_polymodel(p, state);
+#else
+	++Model_faces_depth;
+	iterate_polymodel(p, state);
+	if (!--Model_faces_depth)
+		Model_faces.draw(canvas);
+#endif
 }
 
 #ifndef NDEBUG
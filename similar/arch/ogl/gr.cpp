@@ -64,6 +64,7 @@
 
 #include "ogl_sync.h"
 #include <memory>
+#include <utility>
 
 using std::min;
 using std::max;
@@ -546,6 +547,7 @@ void gr_toggle_fullscreen()
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		ogl_smash_texture_list_internal();//if we are or were fullscreen, changing vid mode will invalidate current textures
+		dsx::ogl_reload_texture_list_internal();
 	}
 	CGameCfg.WindowMode = !(local_sdl_video_flags & SDL_FULLSCREEN);
 #elif SDL_MAJOR_VERSION == 2
@@ -733,6 +735,7 @@ int gr_set_mode(screen_mode mode)
 	ogl_init_state();
 	gamefont_choose_game_font(w,h);
 	gr_remap_color_fonts();
+	ogl_reload_texture_list_internal();
 
 	return 0;
 }
@@ -800,7 +803,13 @@ void gr_set_attributes(void)
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 0);
 #endif
 #endif
-	ogl_smash_texture_list_internal();
+	/* The attributes above only apply to a context created later, and
+	 * gr_set_mode reloads whatever a new context loses.  Only a change of
+	 * filtering needs the resident textures uploaded again now.
+	 */
+	static std::pair<opengl_texture_filter, bool> uploaded_filter{CGameCfg.TexFilt, CGameCfg.TexAnisotropy};
+	if (const std::pair filter{CGameCfg.TexFilt, CGameCfg.TexAnisotropy}; std::exchange(uploaded_filter, filter) != filter)
+		ogl_smash_texture_list_internal();
 	gr_remap_color_fonts();
 }
 
@@ -58,15 +58,20 @@
 #include "gauges.h"
 #include "object.h"
 #include "args.h"
+#include "ogl_extensions.h"
+#include "ogl_lighting.h"
+#include "gameseg.h"
 
 #include "compiler-range_for.h"
 #include "d_levelstate.h"
+#include "d_range.h"
 #include "d_zip.h"
 #include "partial_range.h"
 
 #include <algorithm>
 #include <memory>
 #include <utility>
+#include <vector>
 using std::max;
 
 //change to 1 for lots of spew.
@@ -131,13 +136,63 @@ static int ogl_rgb_internalformat = GL_RGB8;
 static std::unique_ptr<GLfloat[]> sphere_va, circle_va, disk_va;
 static std::array<std::unique_ptr<GLfloat[]>, 3> secondary_lva;
 static int r_polyc,r_tpolyc,r_bitmapc,r_ubitbltc;
+/* Incremented whenever the textures are smashed, so that canvas captures
+ * made before then are known to be lost.
+ */
+static unsigned ogl_capture_generation = 1;
+/* Static level geometry, built by ogl_build_level_mesh */
+static GLuint Level_mesh_buffer;
+static bool Level_mesh_frame_active;
 #define f2glf(x) (f2fl(x))
 
 #define OGL_BINDTEXTURE(a) glBindTexture(GL_TEXTURE_2D, a);
 
 /* I assume this ought to be >= MAX_BITMAP_FILES in piggy.h? */
 static std::array<ogl_texture, 20000> ogl_texture_list;
-static int ogl_texture_list_cur;
+
+/* Residency of the textures in ogl_texture_list.
+ *
+ * Unallocated slots are kept on Free_textures.  Resident bitmap textures
+ * which were not cached for the current level are kept in least recently
+ * used order.  When the resident textures exceed -gl_texturebudget, the
+ * least recently used are deleted, but never one drawn in the current
+ * frame.  An evicted texture keeps its slot, so that the bitmap still
+ * points at it, and is uploaded again by ogl_bindbmtex when next drawn.
+ */
+constexpr uint16_t ogl_texture_none = UINT16_MAX;
+static_assert(ogl_texture_list.size() < ogl_texture_none);
+
+struct ogl_texture_residency
+{
+	uint16_t lru_prev, lru_next;
+	uint32_t last_used_frame;
+	bool allocated;
+	bool in_lru;
+	/* How the texture was last uploaded from its bitmap */
+	bool edgepad;
+	/* Set by ogl_smash_texture_list_internal for textures which were
+	 * resident, so that ogl_reload_texture_list_internal can upload them
+	 * again.
+	 */
+	bool reload;
+	bool reload_in_lru;
+};
+
+static std::array<ogl_texture_residency, ogl_texture_list.size()> Texture_residency;
+static std::vector<uint16_t> Free_textures;
+static uint16_t Texture_lru_head = ogl_texture_none, Texture_lru_tail = ogl_texture_none;
+/* Incremented by gr_flip */
+static uint32_t Texture_frame;
+static std::size_t Resident_texture_bytes;
+static unsigned Textures_evicted;
+/* Set while ogl_cache_level_textures runs, so that the textures it loads
+ * are kept out of the eviction order.
+ */
+static bool Caching_level_textures;
+/* Set when ogl_smash_texture_list_internal deleted any texture which
+ * ogl_reload_texture_list_internal may restore.
+ */
+static bool Texture_reload_pending;
 
 /* some function prototypes */
 
@@ -150,6 +205,16 @@ static void ogl_loadbmtexture(grs_bitmap &bm, bool edgepad)
 	ogl_loadbmtexture_f(bm, CGameCfg.TexFilt, CGameCfg.TexAnisotropy, edgepad);
 }
 
+static void ogl_smash_level_mesh()
+{
+	if (Level_mesh_buffer)
+	{
+		glDeleteBuffersFunc(1, &Level_mesh_buffer);
+		Level_mesh_buffer = 0;
+	}
+	Level_mesh_frame_active = false;
+}
+
 }
 
 #if DXX_USE_OGLES
@@ -245,6 +310,113 @@ static void ogl_reset_texture(ogl_texture &t)
 	ogl_init_texture(t, 0, 0, 0);
 }
 
+static uint16_t ogl_texture_index(const ogl_texture &t)
+{
+	const std::size_t i = &t - ogl_texture_list.data();
+	return i < ogl_texture_list.size() ? i : ogl_texture_none;
+}
+
+static void ogl_texture_lru_unlink(const uint16_t i)
+{
+	auto &r = Texture_residency[i];
+	if (!r.in_lru)
+		return;
+	(r.lru_prev == ogl_texture_none ? Texture_lru_head : Texture_residency[r.lru_prev].lru_next) = r.lru_next;
+	(r.lru_next == ogl_texture_none ? Texture_lru_tail : Texture_residency[r.lru_next].lru_prev) = r.lru_prev;
+	r.in_lru = false;
+}
+
+static void ogl_texture_lru_link(const uint16_t i, const bool most_recent)
+{
+	auto &r = Texture_residency[i];
+	r.in_lru = true;
+	if (most_recent)
+	{
+		r.lru_prev = Texture_lru_tail;
+		r.lru_next = ogl_texture_none;
+		(Texture_lru_tail == ogl_texture_none ? Texture_lru_head : Texture_residency[Texture_lru_tail].lru_next) = i;
+		Texture_lru_tail = i;
+	}
+	else
+	{
+		r.lru_prev = ogl_texture_none;
+		r.lru_next = Texture_lru_head;
+		(Texture_lru_head == ogl_texture_none ? Texture_lru_tail : Texture_residency[Texture_lru_head].lru_prev) = i;
+		Texture_lru_head = i;
+	}
+}
+
+static void ogl_reset_texture_residency()
+{
+	Texture_residency = {};
+	Texture_lru_head = Texture_lru_tail = ogl_texture_none;
+	Resident_texture_bytes = 0;
+}
+
+static void ogl_evict_textures()
+{
+	const std::size_t budget = static_cast<std::size_t>(CGameArg.OglTextureBudget) << 20;
+	if (!budget)
+		return;
+	while (Resident_texture_bytes > budget && Texture_lru_head != ogl_texture_none)
+	{
+		const auto i = Texture_lru_head;
+		if (Texture_residency[i].last_used_frame == Texture_frame)
+			break;
+		ogl_texture_lru_unlink(i);
+		auto &t = ogl_texture_list[i];
+		glDeleteTextures(1, &t.handle);
+		t.handle = 0;
+		t.wrapstate = -1;
+		--r_texcount;
+		Resident_texture_bytes -= t.bytes;
+		++Textures_evicted;
+	}
+}
+
+/* Record that `t` was just uploaded from its bitmap.
+ */
+static void ogl_texture_loaded(const ogl_texture &t)
+{
+	const auto i = ogl_texture_index(t);
+	if (i == ogl_texture_none)
+		return;
+	Resident_texture_bytes += t.bytes;
+	Texture_residency[i].last_used_frame = Texture_frame;
+	if (!Caching_level_textures)
+		ogl_texture_lru_link(i, true);
+	ogl_evict_textures();
+}
+
+static void ogl_texture_used(const ogl_texture &t)
+{
+	const auto i = ogl_texture_index(t);
+	if (i == ogl_texture_none)
+		return;
+	auto &r = Texture_residency[i];
+	if (r.last_used_frame == Texture_frame)
+		return;
+	r.last_used_frame = Texture_frame;
+	if (r.in_lru)
+	{
+		ogl_texture_lru_unlink(i);
+		ogl_texture_lru_link(i, true);
+	}
+}
+
+static void ogl_release_texture_slot(const ogl_texture &t)
+{
+	const auto i = ogl_texture_index(t);
+	if (i == ogl_texture_none)
+		return;
+	auto &r = Texture_residency[i];
+	if (!r.allocated)
+		return;
+	ogl_texture_lru_unlink(i);
+	r.allocated = false;
+	Free_textures.emplace_back(i);
+}
+
 static void ogl_reset_texture_stats_internal(void){
 	range_for (auto &i, ogl_texture_list)
 		if (i.handle>0)
@@ -252,35 +424,56 @@ static void ogl_reset_texture_stats_internal(void){
 }
 
 void ogl_init_texture_list_internal(void){
-	ogl_texture_list_cur=0;
 	range_for (auto &i, ogl_texture_list)
 		ogl_reset_texture(i);
+	ogl_reset_texture_residency();
+	/* Hand out the lowest slots first */
+	Free_textures.clear();
+	Free_textures.reserve(ogl_texture_list.size());
+	for (auto i = ogl_texture_list.size(); i--;)
+		Free_textures.emplace_back(i);
 }
 
 void ogl_smash_texture_list_internal(void){
+	ogl_smash_light_shader();
+	ogl_smash_level_mesh();
+	++ogl_capture_generation;
 	sphere_va.reset();
 	circle_va.reset();
 	disk_va.reset();
 	secondary_lva = {};
-	range_for (auto &i, ogl_texture_list)
+	for (auto &&[i, r] : zip(ogl_texture_list, Texture_residency))
 	{
 		if (i.handle>0){
 			glDeleteTextures( 1, &i.handle );
 			i.handle=0;
+			if (r.allocated)
+			{
+				/* A second smash before the reload must not forget
+				 * what the first one deleted.
+				 */
+				r.reload = true;
+				r.reload_in_lru = r.in_lru;
+				Texture_reload_pending = true;
+			}
 		}
 		i.wrapstate = -1;
+		/* Slots stay allocated to their bitmaps, but nothing is resident. */
+		r.in_lru = false;
 	}
+	Texture_lru_head = Texture_lru_tail = ogl_texture_none;
+	Resident_texture_bytes = 0;
 }
 
 ogl_texture* ogl_get_free_texture(void){
-	for (unsigned i = ogl_texture_list.size(); i--;)
-	{
-		if (ogl_texture_list[ogl_texture_list_cur].handle<=0 && ogl_texture_list[ogl_texture_list_cur].w==0)
-			return &ogl_texture_list[ogl_texture_list_cur];
-		if (++ogl_texture_list_cur >= ogl_texture_list.size())
-			ogl_texture_list_cur=0;
-	}
-	Error("OGL: texture list full!\n");
+	if (Free_textures.empty())
+		Error("OGL: texture list full!\n");
+	const auto i = Free_textures.back();
+	Free_textures.pop_back();
+	auto &r = Texture_residency[i];
+	r = {};
+	r.allocated = true;
+	return &ogl_texture_list[i];
 }
 
 static void ogl_texture_stats(grs_canvas &canvas)
@@ -342,6 +535,7 @@ static void ogl_texture_stats(grs_canvas &canvas)
 	gr_printf(canvas, game_font, fspacx2, fspacy1 + line_spacing, "%i(%i,%i,%i,%i) %iK(%iK wasted) (%i postcachedtex)", used, usedrgba, usedrgb, usedidx, usedother, truebytes / 1024, (truebytes - databytes) / 1024, r_texcount - r_cachedtexcount);
 	gr_printf(canvas, game_font, fspacx2, fspacy1 + (line_spacing * 2), "%ibpp(r%i,g%i,b%i,a%i)x%i=%iK depth%i=%iK", idx, r, g, b, a, dbl, colorsize / 1024, depth, depthsize / 1024);
 	gr_printf(canvas, game_font, fspacx2, fspacy1 + (line_spacing * 3), "total=%iK", (colorsize + depthsize + truebytes) / 1024);
+	gr_printf(canvas, game_font, fspacx2, fspacy1 + (line_spacing * 4), "resident %zuK of %uK budget, %u evicted, %zu free slots", Resident_texture_bytes / 1024, CGameArg.OglTextureBudget * 1024u, Textures_evicted, Free_textures.size());
 }
 
 }
@@ -351,6 +545,7 @@ static void ogl_bindbmtex(grs_bitmap &bm, bool edgepad){
 		ogl_loadbmtexture(bm, edgepad);
 	OGL_BINDTEXTURE(bm.gltexture->handle);
 	bm.gltexture->numrend++;
+	ogl_texture_used(*bm.gltexture);
 }
 
 //gltexture MUST be bound first
@@ -432,6 +627,13 @@ void ogl_cache_level_textures(void)
 	int max_efx=0,ef;
 	
 	ogl_reset_texture_stats_internal();//loading a new lev should reset textures
+	/* The textures of the previous level may be evicted first, unless
+	 * this level uses them too.
+	 */
+	for (const auto i : xrange(ogl_texture_list.size()))
+		if (ogl_texture_list[i].handle > 0 && Texture_residency[i].allocated && !Texture_residency[i].in_lru)
+			ogl_texture_lru_link(i, false);
+	Caching_level_textures = true;
 	
 	range_for (auto &ec, partial_const_range(Effects, Num_effects))
 	{
@@ -484,6 +686,7 @@ void ogl_cache_level_textures(void)
 	}
 	reset_special_effects();
 	init_special_effects();
+	ogl_build_level_mesh();
 	{
 		auto &Robot_info = LevelSharedRobotInfoState.Robot_info;
 		// always have lasers, concs, flares.  Always shows player appearance, and at least concs are always available to disappear.
@@ -547,7 +750,45 @@ void ogl_cache_level_textures(void)
 		}
 	}
 	glmprintf((CON_DEBUG, "finished caching"));
+	Caching_level_textures = false;
 	r_cachedtexcount = r_texcount;
+	ogl_evict_textures();
+}
+
+/* Upload again, in one pass, the game bitmaps which were resident when
+ * the textures were last smashed, so that a video mode change which
+ * needed a new context does not leave the next frames to reload them one
+ * at a time.  Other textures are still reloaded when next drawn.
+ */
+void ogl_reload_texture_list_internal()
+{
+	if (!std::exchange(Texture_reload_pending, false))
+		return;
+	unsigned reloaded = 0;
+	for (auto &bm : GameBitmaps)
+	{
+		if (!bm.gltexture || bm.gltexture->handle > 0 || bm.bm_parent)
+			continue;
+		const auto i = ogl_texture_index(*bm.gltexture);
+		if (i == ogl_texture_none)
+			continue;
+		auto &r = Texture_residency[i];
+		if (!r.allocated || !r.reload)
+			continue;
+		if (bm.get_flag_mask(BM_FLAG_PAGED_OUT) || !bm.bm_data)
+			continue;
+		const auto in_lru = r.reload_in_lru;
+		ogl_loadbmtexture(bm, r.edgepad);
+		/* Textures cached for the current level stay out of the
+		 * eviction order, as they were before the smash.
+		 */
+		if (!in_lru)
+			ogl_texture_lru_unlink(i);
+		++reloaded;
+	}
+	for (auto &r : Texture_residency)
+		r.reload = false;
+	con_printf(CON_DEBUG, "OGL: reloaded %u textures", reloaded);
 }
 
 }
@@ -962,7 +1203,10 @@ void _g3_draw_tmap(grs_canvas &canvas, const std::span<cg3s_point *const> pointl
 		glTexCoordPointer(2, GL_FLOAT, 0, texcoord_array.flat.data());
 	}
 	
+	const auto light_shader = tmap_drawer_ptr == draw_tmap && !bm.get_flag_mask(BM_FLAG_NO_LIGHTING) && ogl_light_shader_bind();
 	glDrawArrays(GL_TRIANGLE_FAN, 0, nv);
+	if (light_shader)
+		ogl_light_shader_unbind();
 	
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
@@ -1052,7 +1296,251 @@ void _g3_draw_tmap_2(grs_canvas &canvas, const std::span<const g3s_point *const>
 	glVertexPointer(3, GL_FLOAT, 0, vertices.flat.data());
 	glColorPointer(4, GL_FLOAT, 0, color_array.flat.data());
 	glTexCoordPointer(2, GL_FLOAT, 0, texcoord_array.flat.data());
+	const auto light_shader = !bm.get_flag_mask(BM_FLAG_NO_LIGHTING) && ogl_light_shader_bind();
 	glDrawArrays(GL_TRIANGLE_FAN, 0, nv);
+	if (light_shader)
+		ogl_light_shader_unbind();
+}
+
+namespace dsx {
+
+namespace {
+
+struct level_mesh_vertex
+{
+	GLfloat x, y, z, u, v;
+};
+
+/* Each side has room for two triangles.  A quad uses the first four
+ * vertices as its only face.  The faces are those which render_side
+ * passes to render_face.
+ */
+constexpr unsigned level_mesh_side_vertices = 6;
+
+/* What was last uploaded for a side */
+struct level_mesh_side
+{
+	std::array<vms_vector, 4> positions;
+	std::array<std::array<fix, 2>, 4> uv;
+	side_type type;
+	bool uploaded;
+};
+
+static std::array<GLfloat, 16> Level_mesh_view;
+static std::vector<level_mesh_side> Level_mesh_sides;
+/* Vertex colors are computed each frame, so they are supplied from
+ * client memory rather than from the buffer.
+ */
+static std::vector<std::array<GLfloat, 4>> Level_mesh_colors;
+
+/* Texture matrices which apply texture2_rotation_low to the overlay, as
+ * _g3_draw_tmap_2 does to its coordinates.
+ */
+constexpr std::array<std::array<GLfloat, 16>, 3> level_mesh_overlay_rotation{{
+	{{0, 1, 0, 0, -1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 0, 1}},
+	{{-1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1, 0, 1, 1, 0, 1}},
+	{{0, -1, 0, 0, 1, 0, 0, 0, 0, 0, 1, 0, 0, 1, 0, 1}},
+}};
+
+static std::size_t level_mesh_side_index(const segnum_t segnum, const sidenum_t sidenum)
+{
+	return static_cast<std::size_t>(segnum) * underlying_value(MAX_SIDES_PER_SEGMENT.value) + underlying_value(sidenum);
+}
+
+/* Refresh the record of a side, and fill `out` from it.  Returns false
+ * if nothing changed since the last upload.
+ */
+static bool level_mesh_update_side(fvcvertptr &vcvertptr, const shared_segment &sseg, const unique_segment &useg, const sidenum_t sidenum, level_mesh_side &ms, std::array<level_mesh_vertex, level_mesh_side_vertices> &out)
+{
+	const auto &sside = sseg.sides[sidenum];
+	const auto &uside = useg.sides[sidenum];
+	const auto vertnum_list = get_side_verts(sseg, sidenum);
+	std::array<vms_vector, 4> positions;
+	std::array<std::array<fix, 2>, 4> uv;
+	for (auto &&[p, t, vertnum, uvl] : zip(positions, uv, vertnum_list, uside.uvls))
+	{
+		p = *vcvertptr(vertnum);
+		t = {{uvl.u, uvl.v}};
+	}
+	const auto type = sside.get_type();
+	if (ms.uploaded && ms.type == type && ms.positions == positions && ms.uv == uv)
+		return false;
+	ms.positions = positions;
+	ms.uv = uv;
+	ms.type = type;
+	ms.uploaded = true;
+	std::array<uint8_t, level_mesh_side_vertices> order;
+	switch (type)
+	{
+		case side_type::quad:
+		default:
+			order = {{0, 1, 2, 3, 3, 3}};
+			break;
+		case side_type::tri_02:
+			order = {{0, 1, 2, 0, 2, 3}};
+			break;
+		case side_type::tri_13:
+			order = {{0, 1, 3, 1, 2, 3}};
+			break;
+	}
+	for (auto &&[o, v] : zip(order, out))
+	{
+		auto &p = positions[o];
+		v = {f2glf(p.x), f2glf(p.y), f2glf(p.z), f2glf(uv[o][0]), f2glf(uv[o][1])};
+	}
+	return true;
+}
+
+static void level_mesh_draw(grs_canvas &canvas, const unsigned first, const unsigned nv, const std::span<const g3s_lrgb, 4> light_rgb, grs_bitmap &bm, const bool overlay, const GLfloat *const texture_matrix)
+{
+	r_tpolyc++;
+	OGL_ENABLE(TEXTURE_2D);
+	ogl_bindbmtex(bm, overlay);
+	ogl_texwrap(bm.gltexture, GL_REPEAT);
+	const GLfloat alpha = (canvas.cv_fade_level >= GR_FADE_OFF)
+		? 1.0
+		: (1.0 - static_cast<float>(canvas.cv_fade_level) / (static_cast<float>(GR_FADE_LEVELS) - 1.0));
+	const auto no_lighting = bm.get_flag_mask(BM_FLAG_NO_LIGHTING);
+	for (auto &&[c, l] : zip(unchecked_partial_range(&Level_mesh_colors[first], nv), unchecked_partial_range(light_rgb.data(), nv)))
+	{
+		if (no_lighting)
+			c[0] = c[1] = c[2] = 1.0;
+		else
+		{
+			c[0] = f2glf(l.r);
+			c[1] = f2glf(l.g);
+			c[2] = f2glf(l.b);
+		}
+		c[3] = alpha;
+	}
+	if (texture_matrix)
+	{
+		glMatrixMode(GL_TEXTURE);
+		glLoadMatrixf(texture_matrix);
+		glMatrixMode(GL_MODELVIEW);
+	}
+	const auto light_shader = !no_lighting && ogl_light_shader_bind();
+	glDrawArrays(GL_TRIANGLE_FAN, first, nv);
+	if (light_shader)
+		ogl_light_shader_unbind();
+	if (texture_matrix)
+	{
+		glMatrixMode(GL_TEXTURE);
+		glLoadIdentity();
+		glMatrixMode(GL_MODELVIEW);
+	}
+}
+
+}
+
+void ogl_build_level_mesh()
+{
+	ogl_smash_level_mesh();
+	Level_mesh_sides.clear();
+	Level_mesh_colors.clear();
+	if (CGameArg.OglNoLevelMesh || !ogl_have_buffer_objects)
+		return;
+	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
+	auto &vcvertptr = LevelSharedVertexState.get_vertices().vcptr;
+	const std::size_t side_count = Segments.get_count() * underlying_value(MAX_SIDES_PER_SEGMENT.value);
+	const std::size_t vertex_count = side_count * level_mesh_side_vertices;
+	Level_mesh_sides.assign(side_count, {});
+	std::vector<level_mesh_vertex> vertices(vertex_count);
+	range_for (const auto &&seg, vcsegptridx)
+	{
+		for (const auto sidenum : MAX_SIDES_PER_SEGMENT)
+		{
+			const auto i = level_mesh_side_index(seg, sidenum);
+			std::array<level_mesh_vertex, level_mesh_side_vertices> side_vertices;
+			level_mesh_update_side(vcvertptr, seg, seg, sidenum, Level_mesh_sides[i], side_vertices);
+			std::copy(side_vertices.begin(), side_vertices.end(), &vertices[i * level_mesh_side_vertices]);
+		}
+	}
+	glGenBuffersFunc(1, &Level_mesh_buffer);
+	glBindBufferFunc(GL_ARRAY_BUFFER, Level_mesh_buffer);
+	glBufferDataFunc(GL_ARRAY_BUFFER, vertices.size() * sizeof(level_mesh_vertex), vertices.data(), GL_STATIC_DRAW);
+	glBindBufferFunc(GL_ARRAY_BUFFER, 0);
+	Level_mesh_colors.resize(vertex_count);
+	con_printf(CON_VERBOSE, "DXX-Rebirth: OpenGL: level mesh of %u segments uploaded (%lu bytes)", Segments.get_count(), static_cast<unsigned long>(vertices.size() * sizeof(level_mesh_vertex)));
+}
+
+void ogl_level_mesh_begin_frame()
+{
+	if (!Level_mesh_buffer)
+	{
+		/* Rebuild after the context was reset */
+		if (Level_mesh_sides.empty())
+			return;
+		ogl_build_level_mesh();
+		if (!Level_mesh_buffer)
+			return;
+	}
+	/* The modelview matrix does what g3_rotate_point does, then negates
+	 * z, as _g3_draw_tmap does.
+	 */
+	const auto &m = View_matrix;
+	const auto &p = View_position;
+	const auto row = [&p](const vms_vector &r, GLfloat *const out, const GLfloat sign) {
+		out[0] = sign * f2glf(r.x);
+		out[4] = sign * f2glf(r.y);
+		out[8] = sign * f2glf(r.z);
+		out[12] = -sign * (static_cast<double>(f2fl(r.x)) * f2fl(p.x) + static_cast<double>(f2fl(r.y)) * f2fl(p.y) + static_cast<double>(f2fl(r.z)) * f2fl(p.z));
+	};
+	auto &v = Level_mesh_view;
+	row(m.rvec, &v[0], 1);
+	row(m.uvec, &v[1], 1);
+	row(m.fvec, &v[2], -1);
+	v[3] = v[7] = v[11] = 0;
+	v[15] = 1;
+	Level_mesh_frame_active = true;
+}
+
+void ogl_level_mesh_end_frame()
+{
+	Level_mesh_frame_active = false;
+}
+
+bool ogl_draw_level_face(grs_canvas &canvas, const vcsegidx_t segnum, const sidenum_t sidenum, const unsigned facenum, const unsigned nv, const std::span<const g3s_lrgb, 4> light_rgb, grs_bitmap &bm, grs_bitmap *const bm2, const texture2_rotation_low orient)
+{
+	if (!Level_mesh_frame_active || tmap_drawer_ptr != draw_tmap)
+		return false;
+	const auto side_index = level_mesh_side_index(segnum, sidenum);
+	if (side_index >= Level_mesh_sides.size())
+		return false;
+	auto &ms = Level_mesh_sides[side_index];
+	{
+		auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
+		auto &vcvertptr = LevelSharedVertexState.get_vertices().vcptr;
+		const auto &&seg = vcsegptr(segnum);
+		std::array<level_mesh_vertex, level_mesh_side_vertices> side_vertices;
+		if (level_mesh_update_side(vcvertptr, seg, seg, sidenum, ms, side_vertices))
+		{
+			glBindBufferFunc(GL_ARRAY_BUFFER, Level_mesh_buffer);
+			glBufferSubDataFunc(GL_ARRAY_BUFFER, side_index * level_mesh_side_vertices * sizeof(level_mesh_vertex), sizeof(side_vertices), side_vertices.data());
+		}
+	}
+	const unsigned face_vertices = (ms.type == side_type::quad) ? (facenum ? 0 : 4) : 3;
+	if (nv != face_vertices)
+		return false;
+	const unsigned first = side_index * level_mesh_side_vertices + (facenum ? 3 : 0);
+	ogl_client_states<int, GL_VERTEX_ARRAY, GL_COLOR_ARRAY, GL_TEXTURE_COORD_ARRAY> cs;
+	(void)cs;
+	glBindBufferFunc(GL_ARRAY_BUFFER, Level_mesh_buffer);
+	glVertexPointer(3, GL_FLOAT, sizeof(level_mesh_vertex), reinterpret_cast<const GLvoid *>(offsetof(level_mesh_vertex, x)));
+	glTexCoordPointer(2, GL_FLOAT, sizeof(level_mesh_vertex), reinterpret_cast<const GLvoid *>(offsetof(level_mesh_vertex, u)));
+	glBindBufferFunc(GL_ARRAY_BUFFER, 0);
+	glColorPointer(4, GL_FLOAT, 0, Level_mesh_colors.data());
+	glLoadMatrixf(Level_mesh_view.data());
+	level_mesh_draw(canvas, first, nv, light_rgb, bm, false, nullptr);
+	if (bm2)
+	{
+		const auto rotation = underlying_value(orient);
+		level_mesh_draw(canvas, first, nv, light_rgb, *bm2, true, rotation ? level_mesh_overlay_rotation[rotation - 1].data() : nullptr);
+	}
+	glLoadIdentity();
+	return true;
+}
+
 }
 
 namespace dcx {
@@ -1216,6 +1704,77 @@ bool ogl_ubitblt(unsigned w,unsigned h,unsigned dx,unsigned dy, unsigned sx, uns
 	return ogl_ubitblt_i(w, h, dx, dy, w, h, sx, sy, src, dest, opengl_texture_filter::classic);
 }
 
+void ogl_capture_canvas(const grs_canvas &canvas, const unsigned w, const unsigned h, ogl_canvas_capture &capture)
+{
+	const auto tw = pow2ize(w), th = pow2ize(h);
+	OGL_ENABLE(TEXTURE_2D);
+	if (capture.generation != ogl_capture_generation || !capture.handle)
+	{
+		capture.handle = 0;
+		glGenTextures(1, &capture.handle);
+		capture.generation = ogl_capture_generation;
+		capture.tw = capture.th = 0;
+	}
+	OGL_BINDTEXTURE(capture.handle);
+	if (capture.tw != tw || capture.th != th)
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, ogl_rgb_internalformat, tw, th, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		capture.tw = tw;
+		capture.th = th;
+	}
+	//the frame buffer has its origin at the bottom left
+	glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, canvas.cv_bitmap.bm_x, last_height - canvas.cv_bitmap.bm_y - h, w, h);
+	capture.w = w;
+	capture.h = h;
+}
+
+bool ogl_draw_canvas_capture(grs_canvas &canvas, const ogl_canvas_capture &capture)
+{
+	if (capture.generation != ogl_capture_generation || !capture.handle)
+		return false;
+	ogl_client_states<int, GL_VERTEX_ARRAY, GL_COLOR_ARRAY, GL_TEXTURE_COORD_ARRAY> cs;
+	(void)cs;
+	const auto &bm = canvas.cv_bitmap;
+	const GLfloat xo = bm.bm_x / static_cast<float>(last_width);
+	const GLfloat xf = (bm.bm_x + bm.bm_w) / static_cast<float>(last_width);
+	const GLfloat yo = 1.0 - bm.bm_y / static_cast<float>(last_height);
+	const GLfloat yf = 1.0 - (bm.bm_y + bm.bm_h) / static_cast<float>(last_height);
+	const GLfloat u = capture.w / static_cast<float>(capture.tw);
+	const GLfloat v = capture.h / static_cast<float>(capture.th);
+
+	OGL_ENABLE(TEXTURE_2D);
+	OGL_BINDTEXTURE(capture.handle);
+	const std::array<GLfloat, 8> vertices{{
+		xo, yo,
+		xf, yo,
+		xf, yf,
+		xo, yf,
+	}};
+	//texture row 0 is the bottom of the captured area
+	const std::array<GLfloat, 8> texcoord_array{{
+		0, v,
+		u, v,
+		u, 0,
+		0, 0,
+	}};
+	glVertexPointer(2, GL_FLOAT, 0, vertices.data());
+	glColorPointer(4, GL_FLOAT, 0, ogl_colors::white.data());
+	glTexCoordPointer(2, GL_FLOAT, 0, texcoord_array.data());
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	return true;
+}
+
+void ogl_free_canvas_capture(ogl_canvas_capture &capture)
+{
+	if (capture.generation == ogl_capture_generation && capture.handle)
+		glDeleteTextures(1, &capture.handle);
+	capture = {};
+}
+
 /*
  * set depth testing on or off
  */
@@ -1398,6 +1957,7 @@ void gr_flip(void)
 	ogl_do_palfx();
 	ogl_swap_buffers_internal();
 	glClear(GL_COLOR_BUFFER_BIT);
+	++Texture_frame;
 }
 
 //little hack to find the nearest bigger power of 2 for a given number
@@ -1864,7 +2424,15 @@ void ogl_loadbmtexture_f(grs_bitmap &rbm, const opengl_texture_filter texfilt, b
 	while (const auto bm_parent = bm->bm_parent)
 		bm = bm_parent;
 	if (bm->gltexture && bm->gltexture->handle > 0)
+	{
+		/* Already resident, perhaps from an earlier level, but now
+		 * needed for this one.
+		 */
+		if (Caching_level_textures)
+			if (const auto i = ogl_texture_index(*bm->gltexture); i != ogl_texture_none)
+				ogl_texture_lru_unlink(i);
 		return;
+	}
 	auto buf=bm->get_bitmap_data();
 	const unsigned bm_w = bm->bm_w;
 	if (bm->gltexture == NULL){
@@ -1913,11 +2481,22 @@ void ogl_loadbmtexture_f(grs_bitmap &rbm, const opengl_texture_filter texfilt, b
 		}
 	}
 	ogl_loadtexture(gr_palette, buf, 0, 0, *bm->gltexture, bm->get_flags(), 0, texfilt, texanis, edgepad);
+	if (const auto i = ogl_texture_index(*bm->gltexture); i != ogl_texture_none)
+	{
+		auto &r = Texture_residency[i];
+		r.edgepad = edgepad;
+		r.reload = false;
+	}
+	ogl_texture_loaded(*bm->gltexture);
 }
 
 static void ogl_freetexture(ogl_texture &gltexture)
 {
-	if (gltexture.handle>0) {
+	const auto resident = gltexture.handle > 0;
+	if (resident && ogl_texture_index(gltexture) != ogl_texture_none)
+		Resident_texture_bytes -= gltexture.bytes;
+	ogl_release_texture_slot(gltexture);
+	if (resident) {
 		r_texcount--;
 		glmprintf((CON_DEBUG, "ogl_freetexture(%p):%i (%i left)", &gltexture, gltexture.handle, r_texcount));
 		glDeleteTextures( 1, &gltexture.handle );
@@ -197,7 +197,10 @@ const sound_function_table_t *sound_function_pointers_t::operator->()
 void digi_select_system()
 {
 #if DXX_USE_SDLMIXER
-	if (!CGameArg.SndDisableSdlMixer)
+	/* Demo export captures the mix of the plain SDL audio mixer.
+	 * SDL_mixer only mixes when the device asks for more sound.
+	 */
+	if (!CGameArg.SndDisableSdlMixer && CGameArg.SysExportDemo.empty())
 	{
 		const auto vl = Mix_Linked_Version();
 		con_printf(CON_NORMAL, "Using SDL_mixer library v%u.%u.%u", vl->major, vl->minor, vl->patch);
@@ -240,6 +240,25 @@ void digi_audio_close()
 	SDL_CloseAudio();
 }
 
+unsigned digi_audio_start_capture()
+{
+	if (!digi_initialised)
+		return 0;
+	SDL_PauseAudio(1);
+	return WaveSpec.freq;
+}
+
+void digi_audio_capture(const std::span<uint8_t> stream)
+{
+	audio_mixcallback(nullptr, stream.data(), stream.size());
+}
+
+void digi_audio_stop_capture()
+{
+	if (digi_initialised)
+		SDL_PauseAudio(0);
+}
+
 void digi_audio_stop_all_channels()
 {
 	range_for (auto &i, SoundSlots)
@@ -32,6 +32,7 @@
 #include "compiler-range_for.h"
 #include "d_range.h"
 #include <memory>
+#include <vector>
 
 using std::min;
 
@@ -41,10 +42,51 @@ static int sdl_video_flags = SDL_SWSURFACE | SDL_HWPALETTE | SDL_DOUBLEBUF;
 static SDL_Surface *screen, *canvas;
 static int gr_installed;
 
+/* State of the frame to be presented by the next gr_flip. */
+static bool flip_partial, flip_palette_changed;
+static std::vector<SDL_Rect> flip_rects;
+static unsigned flip_count;
+
 void gr_flip()
 {
-	SDL_BlitSurface(canvas, nullptr, screen, nullptr);
-	SDL_Flip(screen);
+	/* Only a software screen keeps its contents between flips.  A
+	 * palette change alters every pixel of a screen which is not
+	 * palettised.
+	 */
+	if (flip_partial && !flip_palette_changed && !(screen->flags & (SDL_HWSURFACE | SDL_DOUBLEBUF)))
+	{
+		for (auto &r : flip_rects)
+		{
+			SDL_Rect src = r;
+			SDL_BlitSurface(canvas, &src, screen, &r);
+		}
+		SDL_UpdateRects(screen, flip_rects.size(), flip_rects.data());
+	}
+	else
+	{
+		SDL_BlitSurface(canvas, nullptr, screen, nullptr);
+		SDL_Flip(screen);
+	}
+	flip_partial = flip_palette_changed = false;
+	flip_rects.clear();
+	++flip_count;
+}
+
+void gr_flip_partial()
+{
+	flip_partial = true;
+}
+
+void gr_flip_dirty_rect(const int x, const int y, const unsigned w, const unsigned h)
+{
+	if (!w || !h)
+		return;
+	flip_rects.push_back({static_cast<Sint16>(x), static_cast<Sint16>(y), static_cast<Uint16>(w), static_cast<Uint16>(h)});
+}
+
+unsigned gr_flip_count()
+{
+	return flip_count;
 }
 
 // returns possible (fullscreen) resolutions if any.
@@ -225,6 +267,7 @@ void gr_palette_step_up( int r, int g, int b )
 	last_r = r;
 	last_g = g;
 	last_b = b;
+	flip_palette_changed = true;
 
 	palette = canvas->format->palette;
 
@@ -251,6 +294,8 @@ void gr_palette_load( palette_array_t &pal )
 
 	if (pal != gr_current_pal)
 		SDL_FillRect(canvas, NULL, SDL_MapRGB(canvas->format, 0, 0, 0));
+	flip_palette_changed = true;
+	++flip_count;
 
 	copy_bound_palette(gr_current_pal, pal);
 
@@ -731,7 +731,10 @@ static int med_move_group(int delta_flag, const vmsegptridx_t base_seg, const si
 					auto &sp = *vmsegptr(gs);
 					range_for (auto &vv, sp.verts)
 						if (vv == v)
+						{
 							vv = new_vertex_id;
+							Vertex_segments.note_segment_changed(gs);
+						}
 				}
 			}
 
@@ -815,6 +818,7 @@ static segnum_t place_new_segment_in_world(void)
 	const auto &&segnum = Segments.vmptridx(get_free_segment_number(Segments));
 	auto &seg = *segnum;
 	seg = New_segment;
+	Vertex_segments.note_segment_changed(segnum);
 
 	auto &vcvertptr = Vertices.vcptr;
 	for (auto &&[w, r] : zip(seg.verts, New_segment.verts))
@@ -1268,6 +1272,7 @@ static int med_load_group( const char *filename, group::vertex_array_type_t &ver
 			const auto &&segp = vmsegptridx(s);
 			*segp = tseg; 
 			segp->objects = object_none;
+			Vertex_segments.note_segment_changed(s);
 
 			fuelcen_activate(segp);
 			}
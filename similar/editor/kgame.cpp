@@ -171,7 +171,7 @@ if (SafetyCheck())  {
 #if defined(DXX_BUILD_DESCENT_II)
 				LevelSharedSegmentState.DestructibleLights,
 #endif
-				game_filename.data()))
+				game_filename.data(), nullptr))
 			return 0;
 		Current_level_num = 1;			// assume level 1
 		gamestate = editor_gamestate::none;
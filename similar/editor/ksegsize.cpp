@@ -54,27 +54,21 @@ static void validate_modified_segments(void)
 	auto &Vertices = LevelSharedVertexState.get_vertices();
 	visited_segment_bitarray_t modified_segments;
 	auto &vcvertptr = Vertices.vcptr;
+	Vertex_segments.refresh(vcsegptridx);
 	for (int v=0; v<Modified_vertex_index; v++) {
 		const auto v0 = Modified_vertices[v];
 
-		range_for (const auto &&segp, vmsegptridx)
+		for (const auto &i : Vertex_segments.segments_at(v0))
 		{
-			if (segp->segnum != segment_none)
+			if (modified_segments[i.segnum])
+				continue;
+			modified_segments[i.segnum] = true;
+			const auto &&segp = vmsegptridx(i.segnum);
+			validate_segment(vcvertptr, segp);
+			for (const auto s : MAX_SIDES_PER_SEGMENT)
 			{
-				if (modified_segments[segp])
-					continue;
-				range_for (const auto w, segp->verts)
-					if (w == v0)
-					{
-						modified_segments[segp] = true;
-						validate_segment(vcvertptr, segp);
-						for (const auto s : MAX_SIDES_PER_SEGMENT)
-						{
-							Num_tilings = 1;
-							assign_default_uvs_to_side(segp, s);
-						}
-						break;
-					}
+				Num_tilings = 1;
+				assign_default_uvs_to_side(segp, s);
 			}
 		}
 	}
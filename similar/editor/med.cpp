@@ -1039,6 +1039,11 @@ window_event_result editor_dialog::callback_handler(const d_event &event)
 		gr_set_default_canvas();
 		gr_rect(*grd_curcanv, STATUS_X,STATUS_Y,STATUS_X+STATUS_W-1,STATUS_Y+STATUS_H-1, CGREY);
 		
+#if defined(DXX_BUILD_DESCENT_II)
+		// Segments or textures changed, so find the sliding sides again
+		if (Update_flags & UF_WORLD_CHANGED)
+			compute_slide_segs();
+#endif
 		medlisp_update_screen();
 		calc_frame_time();
 		texpage_do(event);
@@ -23,6 +23,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  *
  */
 
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -48,6 +49,7 @@ COPYRIGHT 1993-1998 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "compiler-range_for.h"
 #include "d_levelstate.h"
 #include "d_range.h"
+#include "d_underlying_value.h"
 #include "d_enumerate.h"
 #include "d_zip.h"
 #include "partial_range.h"
@@ -65,6 +67,23 @@ int ToggleBottom(void)
 
 namespace dcx {
 
+vertex_segment_index Vertex_segments;
+
+void vertex_segment_index::refresh(fvcsegptridx &vcsegptridx)
+{
+	std::size_t count = 0;
+	if (stale)
+		for (const auto &&segp : vcsegptridx)
+		{
+			const segnum_t segnum = segp;
+			count = static_cast<std::size_t>(segnum) + 1;
+		}
+	refresh(count, [&vcsegptridx](const segnum_t segnum) -> const segment_verts * {
+		const shared_segment &seg = vcsegptridx(segnum);
+		return seg.segnum == segment_none ? nullptr : &seg.verts;
+	});
+}
+
 // -------------------------------------------------------------------------------
 //	This function can be used to determine whether a vertex is used exactly once in
 //	all segments, in which case it can be freely moved because it is not connected
@@ -196,6 +215,7 @@ segnum_t med_create_duplicate_segment(segment_array &Segments, const segment &sp
 	nsp = sp;
 	unique_segment &unsp = nsp;
 	unsp.objects = object_none;
+	Vertex_segments.note_segment_changed(segnum);
 
 	return segnum;
 }
@@ -429,6 +449,7 @@ static void change_vertex_occurrences(fvmsegptr &vmsegptr, const vertnum_t dest,
 		g.vertices.replace(src, dest);
 
 	// now scan all segments, changing occurrences of src to dest
+	Vertex_segments.invalidate();
 	for (shared_segment &segp : vmsegptr)
 		if (segp.segnum != segment_none)
 		{
@@ -490,6 +511,7 @@ static void compress_segments(void)
 	auto &RobotCenters = LevelSharedRobotcenterState.RobotCenters;
 	auto &Walls = LevelUniqueWallSubsystemState.Walls;
 	auto &vmwallptr = Walls.vmptr;
+	Vertex_segments.invalidate();
 	auto holep = Segments.vmptridx.begin();
 	auto segp = Segments.vmptridx.end();
 	for (; holep != segp; ++holep)
@@ -677,6 +699,7 @@ static int med_attach_segment_rotated(const vmsegptridx_t destseg, const csmuseg
 	const auto &&nsp = destseg.absolute_sibling(segnum);
 
 	nsp->segnum = segnum;
+	Vertex_segments.note_segment_changed(segnum);
 	static_cast<unique_segment &>(nsp).objects = object_none;
 	nsp->matcen_num = materialization_center_number::None;
 
@@ -919,6 +942,7 @@ int med_delete_segment(const vmsegptridx_t sp)
 		}
 
 	sp->segnum = segment_none;										// Mark segment as inactive.
+	Vertex_segments.note_segment_changed(segnum);
 
 	// If deleted segment = marked segment, then say there is no marked segment
 	if (sp == Markedsegp)
@@ -1173,6 +1197,9 @@ int med_form_joint(const vmsegptridx_t seg1, const sidenum_t side1, const vmsegp
 					}
 		}
 
+	range_for (auto &s, partial_const_range(validation_list, nv))
+		Vertex_segments.note_segment_changed(s);
+
 	//	Form new connections.
 	seg1->children[side1] = seg2;
 	seg2->children[side2] = seg1;
@@ -1229,6 +1256,7 @@ int med_form_bridge_segment(const vmsegptridx_t seg1, const sidenum_t side1, con
 		for (const auto v : MAX_VERTICES_PER_SIDE)
 			bs->verts[(segment_relative_vertnum{static_cast<uint8_t>((underlying_value(v) + bfi) % 4)})] = seg1->verts[sv[v]];
 	}
+	Vertex_segments.note_segment_changed(bs);
 
 	// Form connections to children, first initialize all to unconnected.
 	for (auto &&[child, side] : zip(sbs.children, sbs.sides))
@@ -1284,6 +1312,7 @@ void med_create_segment(const vmsegptridx_t sp,fix cx, fix cy, fix cz, fix lengt
 	++ LevelSharedSegmentState.Num_segments;
 
 	sp->segnum = segnum_t{1};						// What to put here?  I don't know.
+	Vertex_segments.note_segment_changed(sp);
 
 	// Form connections to children, of which it has none.
 	for (auto &&[child, side] : zip(sp->children, sp->shared_segment::sides))
@@ -1532,43 +1561,43 @@ std::optional<std::pair<vmsegptridx_t, sidenum_t>> med_find_adjacent_segment_sid
 	for (const auto v : MAX_VERTICES_PER_SIDE)
 		abs_verts[v] = sp->verts[Side_to_verts[side][v]];
 
-	//	Scan all segments, looking for a segment which contains the four abs_verts
-	range_for (const auto &&segp, vmsegptridx)
+	//	Scan the segments which use the first vertex, looking for the lowest
+	//	numbered segment which contains all four abs_verts
+	Vertex_segments.refresh(vcsegptridx);
+	std::optional<segnum_t> found;
+	for (const auto &i : Vertex_segments.segments_at(abs_verts[side_relative_vertnum::_0]))
 	{
-		if (segp != sp)
+		if (i.segnum == sp || (found && *found < i.segnum))
+			continue;
+		auto &verts = vcsegptr(i.segnum)->verts;
+		if (std::all_of(std::next(abs_verts.begin()), abs_verts.end(), [&verts](const vertnum_t v) {
+			return std::find(verts.begin(), verts.end(), v) != verts.end();
+		}))
+			found = i.segnum;
+	}
+	if (!found)
+		return std::nullopt;
+	const auto &&segp = sp.absolute_sibling(*found);
+
+	//	All four vertices in sp:side are present in segment seg.
+	//	Determine side and return
+	for (const auto &&[idx, value] : enumerate(Side_to_verts))
+	{
+		for (const auto v : value)
 		{
-			range_for (auto &v, abs_verts)
-			{												// do for each vertex in abs_verts
-				range_for (auto &vv, segp->verts) // do for each vertex in segment
-					if (v == vv)
-						goto fass_found1;											// Current vertex (indexed by v) is present in segment, try next
-				goto fass_next_seg;												// This segment doesn't contain the vertex indexed by v
-			fass_found1: ;
-			}		// end for v
-
-			//	All four vertices in sp:side are present in segment seg.
-			//	Determine side and return
-			for (const auto &&[idx, value] : enumerate(Side_to_verts))
+			range_for (auto &vv, abs_verts)
 			{
-				for (const auto v : value)
-				{
-					range_for (auto &vv, abs_verts)
-					{
-						if (segp->verts[v] == vv)
-							goto fass_found2;
-					}
-					goto fass_next_side;											// Couldn't find vertex v in current side, so try next side.
-				fass_found2: ;
-				}
-				// Found all four vertices in current side.  We are done!
-				return std::pair(segp, static_cast<sidenum_t>(idx));
-			fass_next_side: ;
+				if (segp->verts[v] == vv)
+					goto fass_found2;
 			}
-			Assert(0);	// Impossible -- we identified this segment as containing all 4 vertices of side "side", but we couldn't find them.
-			return std::nullopt;
-		fass_next_seg: ;
+			goto fass_next_side;											// Couldn't find vertex v in current side, so try next side.
+		fass_found2: ;
 		}
+		// Found all four vertices in current side.  We are done!
+		return std::pair(segp, static_cast<sidenum_t>(idx));
+	fass_next_side: ;
 	}
+	Assert(0);	// Impossible -- we identified this segment as containing all 4 vertices of side "side", but we couldn't find them.
 	return std::nullopt;
 }
 
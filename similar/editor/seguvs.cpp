@@ -54,58 +54,37 @@ static void cast_all_light_in_mine(int quick_flag);
 }
 //--rotate_uvs-- vms_vector Rightvec;
 
-#define	MAX_LIGHT_SEGS 16
-
 namespace {
 
 //	---------------------------------------------------------------------------------------------
-//	Scan all polys in all segments, return average light value for vnum.
-//	segs = output array for segments containing vertex, terminated by -1.
-static fix get_average_light_at_vertex(const vertnum_t vnum, segnum_t *segs)
+//	Scan all polys in the segments which use vnum, return average light value for vnum.
+static fix get_average_light_at_vertex(const vertnum_t vnum)
 {
 	fix	total_light;
 	int	num_occurrences;
-//	#ifndef NDEBUG //Removed this ifdef because the version of Assert that I used to get it to compile doesn't work without this symbol. -KRB
-        segnum_t   *original_segs;
-
-        original_segs = segs;
-//	#endif
-
 
 	num_occurrences = 0;
 	total_light = 0;
 
-	range_for (const auto &&segp, vcsegptridx)
+	for (const auto &i : Vertex_segments.segments_at(vnum))
 	{
-		auto e = end(segp->verts);
-		auto it = std::find(begin(segp->verts), e, vnum);
-		if (it == e)
-			continue;
-		auto relvnum = static_cast<segment_relative_vertnum>(std::distance(it, e));
+		const auto &&segp = vcsegptr(i.segnum);
+		for (const auto &&[child_segnum, uside, vp] : zip(segp->children, segp->unique_segment::sides, Side_to_verts))
 		{
-			*segs++ = segp;
-			Assert(segs - original_segs < MAX_LIGHT_SEGS);
-			(void)original_segs;
-
-			for (const auto &&[child_segnum, uside, vp] : zip(segp->children, segp->unique_segment::sides, Side_to_verts))
+			if (!IS_CHILD(child_segnum))
 			{
-				if (!IS_CHILD(child_segnum))
+				const auto vb = begin(vp);
+				const auto ve = end(vp);
+				const auto vi = std::find(vb, ve, i.relvnum);
+				if (vi != ve)
 				{
-					const auto vb = begin(vp);
-					const auto ve = end(vp);
-					const auto vi = std::find(vb, ve, relvnum);
-					if (vi != ve)
-					{
-						const auto v = static_cast<side_relative_vertnum>(std::distance(vb, vi));
-						total_light += uside.uvls[v].l;
-							num_occurrences++;
-						}
-				}	// end if
-			}	// end sidenum
-		}
-	}	// end segnum
-
-	*segs = segment_none;
+					const auto v = static_cast<side_relative_vertnum>(std::distance(vb, vi));
+					total_light += uside.uvls[v].l;
+					num_occurrences++;
+				}
+			}	// end if
+		}	// end sidenum
+	}
 
 	if (num_occurrences)
 		return total_light/num_occurrences;
@@ -114,51 +93,41 @@ static fix get_average_light_at_vertex(const vertnum_t vnum, segnum_t *segs)
 
 }
 
+//	Vertex_segments must be up to date.
 static void set_average_light_at_vertex(vertnum_t vnum)
 {
-	segnum_t	Segment_indices[MAX_LIGHT_SEGS];
-	int	segind;
-
-	fix average_light;
-
-	average_light = get_average_light_at_vertex(vnum, Segment_indices);
+	const auto average_light = get_average_light_at_vertex(vnum);
 
 	if (!average_light)
 		return;
 
-	segind = 0;
-	while (Segment_indices[segind] != segment_none) {
-		auto segnum = Segment_indices[segind++];
-
-		auto &ssegp = *vcsegptr(segnum);
-		unique_segment &usegp = *vmsegptr(segnum);
+	for (const auto &i : Vertex_segments.segments_at(vnum))
+	{
+		auto &ssegp = *vcsegptr(i.segnum);
+		unique_segment &usegp = *vmsegptr(i.segnum);
 
-		for (const auto &&[relvnum, vert] : enumerate(ssegp.verts))
-			if (vert == vnum)
-			{
-			for (const auto &&[child_segnum, sidep, vp] : zip(ssegp.children, usegp.sides, Side_to_verts))
+		for (const auto &&[child_segnum, sidep, vp] : zip(ssegp.children, usegp.sides, Side_to_verts))
+		{
+			if (!IS_CHILD(child_segnum))
 			{
-				if (!IS_CHILD(child_segnum))
+				const auto vb = begin(vp);
+				const auto ve = end(vp);
+				const auto vi = std::find(vb, ve, i.relvnum);
+				if (vi != ve)
 				{
-					const auto vb = begin(vp);
-					const auto ve = end(vp);
-					const auto vi = std::find(vb, ve, relvnum);
-					if (vi != ve)
-					{
-						const auto v = static_cast<side_relative_vertnum>(std::distance(vb, vi));
-						sidep.uvls[v].l = average_light;
-					}
-				}	// end if
-			}	// end sidenum
-				break;
+					const auto v = static_cast<side_relative_vertnum>(std::distance(vb, vi));
+					sidep.uvls[v].l = average_light;
+				}
 			}	// end if
-	}	// end while
+		}	// end sidenum
+	}
 
 	Update_flags |= UF_WORLD_CHANGED;
 }
 
 static void set_average_light_on_side(const shared_segment &segp, const sidenum_t sidenum)
 {
+	Vertex_segments.refresh(vcsegptridx);
 	if (!IS_CHILD(segp.children[sidenum]))
 		range_for (const auto v, Side_to_verts[sidenum])
 		{
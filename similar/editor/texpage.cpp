@@ -307,7 +307,7 @@ void do_replacements_all(void)
 #if defined(DXX_BUILD_DESCENT_II)
 			LevelSharedSegmentState.DestructibleLights,
 #endif
-			Current_mission->level_names[i]);
+			Current_mission->level_names[i], nullptr);
 		do_replacements();
 		save_level(
 #if defined(DXX_BUILD_DESCENT_II)
@@ -322,7 +322,7 @@ void do_replacements_all(void)
 #if defined(DXX_BUILD_DESCENT_II)
 			LevelSharedSegmentState.DestructibleLights,
 #endif
-			Current_mission->secret_level_names[i]);
+			Current_mission->secret_level_names[i], nullptr);
 		do_replacements();
 		save_level(
 #if defined(DXX_BUILD_DESCENT_II)
@@ -0,0 +1,335 @@
+/*
+ * This file is part of the DXX-Rebirth project <https://www.dxx-rebirth.com/>.
+ * It is copyright by its individual contributors, as recorded in the
+ * project's Git history.  See COPYING.txt at the top level for license
+ * terms and a link to the Git history.
+ */
+/*
+ *
+ * Export of demo playback as uncompressed video.
+ *
+ * Frames are written as YUV4MPEG2 (.y4m), which needs no encoder and
+ * which common tools, such as ffmpeg, can read directly or from a pipe.
+ * The game audio is mixed one video frame at a time and written beside
+ * the video as 8 bit stereo WAV.
+ *
+ */
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <SDL.h>
+#include <physfs.h>
+
+#include "demoexport.h"
+#include "args.h"
+#include "byteutil.h"
+#include "console.h"
+#include "digi_audio.h"
+#include "gr.h"
+#include "newdemo.h"
+#include "palette.h"
+#include "timer.h"
+#if DXX_USE_OGL
+#include "ogl_init.h"
+#endif
+
+namespace dcx {
+
+namespace {
+
+struct export_file_deleter
+{
+	void operator()(std::FILE *const f) const
+	{
+		if (f == stdout)
+			std::fflush(f);
+		else
+			std::fclose(f);
+	}
+};
+
+struct demo_export_state
+{
+	std::unique_ptr<std::FILE, export_file_deleter> file;
+	std::string path;
+	fix frame_time;
+	unsigned fps;
+	unsigned width = 0, height = 0;
+	unsigned frames = 0;
+	bool failed = false;
+	fix64 start_time;
+	/* Packed RGB of the current frame, top row first. */
+	std::vector<uint8_t> rgb;
+	/* Y, then U, then V, each width * height. */
+	std::vector<uint8_t> yuv;
+	std::unique_ptr<std::FILE, export_file_deleter> audio_file;
+	std::string audio_path;
+	/* 0 if no audio is written. */
+	unsigned sample_rate = 0;
+	uint64_t samples = 0;
+	std::vector<uint8_t> audio;
+};
+
+/* The mixer writes unsigned 8 bit samples, left then right. */
+constexpr unsigned wav_channels = 2;
+constexpr std::size_t wav_header_size = 44;
+
+static std::unique_ptr<demo_export_state> Demo_export;
+
+static std::string default_export_path(const char *const demo, const char *const extension)
+{
+	std::string path;
+	if (const auto write_dir = PHYSFS_getWriteDir())
+	{
+		path = write_dir;
+		if (!path.empty() && path.back() != '/' && path.back() != *PHYSFS_getDirSeparator())
+			path += PHYSFS_getDirSeparator();
+	}
+	path += DEMO_DIR;
+	const auto dot = std::strrchr(demo, '.');
+	path.append(demo, dot ? dot - demo : std::strlen(demo));
+	path += extension;
+	return path;
+}
+
+/* The audio goes beside the video, as the same name with .wav in place of
+ * .y4m.  Audio of video written to stdout goes in the demo directory.
+ */
+static std::string audio_export_path(const char *const demo, const demo_export_state &e)
+{
+	if (e.file.get() == stdout)
+		return default_export_path(demo, ".wav");
+	const std::string_view video{e.path};
+	constexpr std::string_view y4m{".y4m"};
+	std::string path{video.ends_with(y4m) ? video.substr(0, video.size() - y4m.size()) : video};
+	path += ".wav";
+	return path;
+}
+
+/* Write the header of a WAV file with `data_size` bytes of samples.
+ */
+static bool write_wav_header(std::FILE *const f, const unsigned sample_rate, const uint32_t data_size)
+{
+	std::array<uint8_t, wav_header_size> h;
+	std::memcpy(&h[0], "RIFF", 4);
+	PUT_INTEL_INT(&h[4], static_cast<uint32_t>(wav_header_size - 8 + data_size));
+	std::memcpy(&h[8], "WAVEfmt ", 8);
+	PUT_INTEL_INT(&h[16], uint32_t{16});
+	/* PCM */
+	PUT_INTEL_SHORT(&h[20], uint16_t{1});
+	PUT_INTEL_SHORT(&h[22], static_cast<uint16_t>(wav_channels));
+	PUT_INTEL_INT(&h[24], static_cast<uint32_t>(sample_rate));
+	PUT_INTEL_INT(&h[28], static_cast<uint32_t>(sample_rate * wav_channels));
+	PUT_INTEL_SHORT(&h[32], static_cast<uint16_t>(wav_channels));
+	PUT_INTEL_SHORT(&h[34], uint16_t{8});
+	std::memcpy(&h[36], "data", 4);
+	PUT_INTEL_INT(&h[40], data_size);
+	return std::fwrite(h.data(), 1, h.size(), f) == h.size();
+}
+
+static void stop_audio_export(demo_export_state &e)
+{
+	digi_audio_stop_capture();
+	e.audio_file.reset();
+	e.sample_rate = 0;
+}
+
+/* Mix the sound of one video frame.  The frame ends at sample
+ * rate * (frames + 1) / fps, so that the audio never drifts from the video
+ * however the rate divides.
+ */
+static void write_frame_audio(demo_export_state &e)
+{
+	const uint64_t end = static_cast<uint64_t>(e.sample_rate) * (e.frames + 1) / e.fps;
+	const std::size_t count = end - e.samples;
+	e.samples = end;
+	e.audio.resize(count * wav_channels);
+	digi_audio_capture(e.audio);
+	if (std::fwrite(e.audio.data(), 1, e.audio.size(), e.audio_file.get()) != e.audio.size())
+	{
+		con_printf(CON_URGENT, "DXX-Rebirth: demo audio export stopped: cannot write to \"%s\": %s", e.audio_path.c_str(), std::strerror(errno));
+		stop_audio_export(e);
+	}
+}
+
+static void start_audio_export(demo_export_state &e, const char *const demo)
+{
+	const auto sample_rate = digi_audio_start_capture();
+	if (!sample_rate)
+	{
+		con_puts(CON_NORMAL, "DXX-Rebirth: sound is off, so the demo is exported without audio");
+		return;
+	}
+	e.audio_path = audio_export_path(demo, e);
+	e.audio_file.reset(std::fopen(e.audio_path.c_str(), "wb"));
+	/* The sizes are written when the export finishes. */
+	if (!e.audio_file || !write_wav_header(e.audio_file.get(), sample_rate, 0))
+	{
+		con_printf(CON_URGENT, "DXX-Rebirth: cannot export demo audio to \"%s\": %s", e.audio_path.c_str(), std::strerror(errno));
+		stop_audio_export(e);
+		return;
+	}
+	e.sample_rate = sample_rate;
+}
+
+/* ITU-R BT.601, limited range, in 8 bit fixed point.
+ */
+static void convert_rgb_to_yuv(const uint8_t *const rgb, const std::size_t pixels, uint8_t *const y, uint8_t *const u, uint8_t *const v)
+{
+	for (std::size_t i = 0; i != pixels; ++i)
+	{
+		const int r = rgb[i * 3], g = rgb[i * 3 + 1], b = rgb[i * 3 + 2];
+		y[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+		u[i] = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+		v[i] = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+	}
+}
+
+/* Fill `rgb` from the frame just drawn, before it is flipped.
+ */
+static void read_screen_rgb(std::vector<uint8_t> &rgb, const unsigned width, const unsigned height)
+{
+	const std::size_t stride = width * 3;
+#if DXX_USE_OGL
+	/* glReadPixels returns the bottom row first.  Read into the back half
+	 * of a buffer twice the size, then copy the rows into the front half
+	 * from the top down.
+	 */
+	rgb.resize(stride * height * 2);
+	const auto raw = &rgb[stride * height];
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, raw);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	for (unsigned row = 0; row != height; ++row)
+		std::memcpy(&rgb[row * stride], raw + (height - 1 - row) * stride, stride);
+#else
+	rgb.resize(stride * height);
+	palette_array_t pal;
+	gr_palette_read(pal);
+	const auto &bm = grd_curscreen->sc_canvas.cv_bitmap;
+	const auto data = bm.get_bitmap_data();
+	auto o = rgb.data();
+	for (unsigned row = 0; row != height; ++row)
+	{
+		const auto src = &data[row * bm.bm_rowsize];
+		for (unsigned x = 0; x != width; ++x)
+		{
+			auto &c = pal[src[x]];
+			*o++ = c.r << 2;
+			*o++ = c.g << 2;
+			*o++ = c.b << 2;
+		}
+	}
+#endif
+}
+
+}
+
+bool demo_export_start(const char *const demo)
+{
+#if DXX_USE_OGL
+	if (!CGameArg.DbgGlReadPixelsOk)
+	{
+		con_puts(CON_URGENT, "DXX-Rebirth: cannot export demo: glReadPixels not supported on your configuration");
+		return false;
+	}
+#endif
+	auto e = std::make_unique<demo_export_state>();
+	const auto &file = CGameArg.SysExportDemoFile;
+	if (file == "-")
+	{
+		e->path = "stdout";
+		e->file.reset(stdout);
+	}
+	else
+	{
+		e->path = file.empty() ? default_export_path(demo, ".y4m") : file;
+		e->file.reset(std::fopen(e->path.c_str(), "wb"));
+	}
+	if (!e->file)
+	{
+		con_printf(CON_URGENT, "DXX-Rebirth: cannot export demo to \"%s\": %s", e->path.c_str(), std::strerror(errno));
+		return false;
+	}
+	e->fps = CGameArg.SysExportDemoFPS;
+	e->frame_time = F1_0 / e->fps;
+	e->start_time = timer_query();
+	con_printf(CON_NORMAL, "DXX-Rebirth: exporting demo \"%s\" to \"%s\" at %u frames per second", demo, e->path.c_str(), e->fps);
+	start_audio_export(*e, demo);
+	if (e->sample_rate)
+		con_printf(CON_NORMAL, "DXX-Rebirth: exporting demo audio to \"%s\" at %u samples per second", e->audio_path.c_str(), e->sample_rate);
+	Demo_export = std::move(e);
+	return true;
+}
+
+void demo_export_finish()
+{
+	if (!Demo_export)
+		return;
+	const auto e = std::move(Demo_export);
+	const auto elapsed = f2fl(timer_query() - e->start_time);
+	if (e->sample_rate)
+	{
+		const auto f = e->audio_file.get();
+		const auto data_size = static_cast<uint32_t>(std::min<uint64_t>(e->samples * wav_channels, UINT32_MAX - wav_header_size));
+		if (std::fseek(f, 0, SEEK_SET) || !write_wav_header(f, e->sample_rate, data_size))
+			con_printf(CON_URGENT, "DXX-Rebirth: cannot finish demo audio \"%s\": %s", e->audio_path.c_str(), std::strerror(errno));
+		stop_audio_export(*e);
+	}
+	con_printf(CON_NORMAL, "DXX-Rebirth: exported %u frames (%.1f seconds of video) to \"%s\" in %.1f seconds, %.1f frames per second", e->frames, static_cast<double>(e->frames) / e->fps, e->path.c_str(), elapsed, elapsed > 0 ? e->frames / elapsed : 0.);
+	/* Export is for unattended use, so quit when it is done. */
+	SDL_Event quit{};
+	quit.type = SDL_QUIT;
+	SDL_PushEvent(&quit);
+}
+
+fix demo_export_frame_time()
+{
+	return Demo_export && !Demo_export->failed ? Demo_export->frame_time : 0;
+}
+
+void demo_export_frame()
+{
+	if (!Demo_export || Demo_export->failed)
+		return;
+	auto &e = *Demo_export;
+	const unsigned width = grd_curscreen->get_screen_width(), height = grd_curscreen->get_screen_height();
+	const auto f = e.file.get();
+	if (!e.frames)
+	{
+		e.width = width;
+		e.height = height;
+		std::fprintf(f, "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C444\n", width, height, e.fps);
+	}
+	else if (width != e.width || height != e.height)
+	{
+		con_printf(CON_URGENT, "DXX-Rebirth: demo export stopped: screen changed from %ux%u to %ux%u", e.width, e.height, width, height);
+		e.failed = true;
+		return;
+	}
+	read_screen_rgb(e.rgb, width, height);
+	const std::size_t pixels = width * height;
+	e.yuv.resize(pixels * 3);
+	const auto y = e.yuv.data();
+	convert_rgb_to_yuv(e.rgb.data(), pixels, y, y + pixels, y + pixels * 2);
+	std::fputs("FRAME\n", f);
+	if (std::fwrite(y, 1, e.yuv.size(), f) != e.yuv.size())
+	{
+		con_printf(CON_URGENT, "DXX-Rebirth: demo export stopped: cannot write to \"%s\": %s", e.path.c_str(), std::strerror(errno));
+		e.failed = true;
+		return;
+	}
+	if (e.sample_rate)
+		write_frame_audio(e);
+	++e.frames;
+}
+
+}
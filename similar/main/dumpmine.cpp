@@ -25,12 +25,18 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  *
  */
 
+#include <atomic>
 #include <bitset>
 #include <stdio.h>
 #include <cinttypes>
+#include <span>
+#include <stdexcept>
 #include <string.h>
 #include <stdarg.h>
 #include <errno.h>
+#include <system_error>
+#include <thread>
+#include <vector>
 
 #include "pstypes.h"
 #include "console.h"
@@ -54,7 +60,12 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "powerup.h"
 #include "polyobj.h"
 #include "gamesave.h"
+#include "gamemine.h"
+#include "level_reader.h"
 #include "piggy.h"
+#include "mission.h"
+#include "gameseq.h"
+#include "makesig.h"
 
 #include "compiler-range_for.h"
 #include "d_enumerate.h"
@@ -76,6 +87,37 @@ using perm_tmap_buffer_type = enumerated_array<int, MAX_BITMAP_FILES, bitmap_ind
 using level_tmap_buffer_type = enumerated_array<int8_t, MAX_BITMAP_FILES, bitmap_index>;
 using wall_buffer_type = std::array<int, MAX_BITMAP_FILES>;
 #endif
+
+/* The parts of a level which the texture and object dumps report on.
+ * These are copied from the level being edited, or read straight from a
+ * level file without touching the level being edited, so that the
+ * levels of a whole mission can be read at once.
+ */
+struct mine_side
+{
+	wallnum_t wall_num;
+	bool has_child;
+	texture1_value tmap_num;
+	texture2_value tmap_num2;
+};
+
+struct mine_object
+{
+	object_type_t type;
+	uint8_t id;
+	render_type_t render_type;
+	polygon_model_index model_num;
+};
+
+struct mine_summary
+{
+	/* MAX_SIDES_PER_SEGMENT sides for each segment */
+	std::vector<mine_side> sides;
+	/* The clip_num of each wall */
+	std::vector<int8_t> wall_clips;
+	/* Objects which are not OBJ_NONE */
+	std::vector<mine_object> objects;
+};
 }
 }
 
@@ -91,9 +133,12 @@ const std::array<char[10], 7> Wall_names{{
 }};
 }
 
+namespace dsx {
 namespace {
-static void dump_used_textures_level(PHYSFS_File *my_file, int level_num, const char *Gamesave_current_filename);
-static void say_totals(fvcobjptridx &vcobjptridx, PHYSFS_File *my_file, const char *level_name);
+static mine_summary current_mine_summary();
+static void dump_used_textures_level(PHYSFS_File *my_file, const mine_summary &mine, const char *Gamesave_current_filename);
+static void say_totals(std::span<const mine_object> objects, PHYSFS_File *my_file, const char *level_name);
+}
 }
 
 namespace dsx {
@@ -120,31 +165,40 @@ const std::array<char[9], MAX_OBJECT_TYPES> Object_type_names{{
 }};
 
 // ----------------------------------------------------------------------------
-static const char *object_types(const object_base &objp)
+static const char *object_types(const object_type_t type)
 {
-	const auto type = objp.type;
 	assert(type == OBJ_NONE || type < MAX_OBJECT_TYPES);
 	return &Object_type_names[type][0];
 }
+
+static const char *object_types(const object_base &objp)
+{
+	return object_types(objp.type);
+}
 }
 }
 
 namespace {
 
 // ----------------------------------------------------------------------------
-static const char *object_ids(const object_base &objp)
+static const char *object_ids(const object_type_t type, const uint8_t id)
 {
-	switch (objp.type)
+	switch (type)
 	{
 		case OBJ_ROBOT:
-			return Robot_names[get_robot_id(objp)].data();
+			return Robot_names[id].data();
 		case OBJ_POWERUP:
-			return Powerup_names[get_powerup_id(objp)].data();
+			return Powerup_names[static_cast<powerup_type_t>(id)].data();
 		default:
 			return nullptr;
 	}
 }
 
+static const char *object_ids(const object_base &objp)
+{
+	return object_ids(objp.type, objp.id);
+}
+
 static void err_puts(PHYSFS_File *f, const std::span<const char> str)
 {
 	++Errors_in_mine;
@@ -654,8 +708,11 @@ void write_game_text_file(const char *filename)
 		return;
 	}
 
-	dump_used_textures_level(my_file, 0, filename);
-	say_totals(vcobjptridx, my_file, filename);
+	{
+		const auto mine = current_mine_summary();
+		dump_used_textures_level(my_file, mine, filename);
+		say_totals(mine.objects, my_file, filename);
+	}
 
 	PHYSFSX_printf(my_file, "\nNumber of segments:   %4i\n", Highest_segment_index+1);
 	PHYSFSX_printf(my_file, "Number of objects:    %4i\n", Objects.get_count());
@@ -732,167 +789,193 @@ const char Registered_level_names[NUM_REGISTERED_LEVELS][12] = {
 };
 #endif
 
-#if defined(DXX_BUILD_DESCENT_II)
-static int Ignore_tmap_num2_error;
-#endif
-
 // ----------------------------------------------------------------------------
-#if defined(DXX_BUILD_DESCENT_I)
-#define determine_used_textures_level(load_level_flag,shareware_flag,level_num,tmap_buf,wall_buffer_type,level_tmap_buf,max_tmap)	determine_used_textures_level(load_level_flag,shareware_flag,level_num,tmap_buf,wall_buffer_type,level_tmap_buf,max_tmap)
-#endif
-static void determine_used_textures_level(int load_level_flag, int shareware_flag, int level_num, perm_tmap_buffer_type &tmap_buf, wall_buffer_type &wall_buf, level_tmap_buffer_type &level_tmap_buf, int max_tmap)
+static mine_summary current_mine_summary()
 {
-#if defined(DXX_BUILD_DESCENT_II)
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vcobjptr = Objects.vcptr;
-#endif
-	int	j;
-
 	auto &Walls = LevelUniqueWallSubsystemState.Walls;
-	auto &WallAnims = GameSharedState.WallAnims;
-#if defined(DXX_BUILD_DESCENT_I)
-	tmap_buf = {};
+	mine_summary mine;
+	mine.sides.reserve(Segments.get_count() * static_cast<std::size_t>(MAX_SIDES_PER_SEGMENT.value));
+	range_for (const cscusegment segp, vcsegptr)
+	{
+		for (auto &&[sside, uside, child] : zip(segp.s.sides, segp.u.sides, segp.s.children))
+			mine.sides.push_back({sside.wall_num, child != segment_none, uside.tmap_num, uside.tmap_num2});
+	}
+	range_for (const auto &&w, Walls.vcptr)
+		mine.wall_clips.push_back(w->clip_num);
+	range_for (const auto &&objp, vcobjptr)
+	{
+		if (objp->type == OBJ_NONE)
+			continue;
+		mine.objects.push_back({objp->type, objp->id, objp->render_type,
+			objp->render_type == RT_POLYOBJ ? objp->rtype.pobj_info.model_num : polygon_model_index::None});
+	}
+	return mine;
+}
 
-	if (load_level_flag) {
-		load_level(shareware_flag ? Shareware_level_names[level_num] : Registered_level_names[level_num]);
+/* Read a level file without loading it, through the readers which
+ * load_level uses.  Descent 1 levels in Descent 2 need
+ * convert_d1_tmap_num, which may report unknown textures and depends on
+ * New_file_format_load, so they are only read if `convert_d1_level` is
+ * set, and the caller must then be the main thread.
+ */
+static std::optional<mine_summary> read_mine_summary(const std::span<const uint8_t> data, const char *const filename, [[maybe_unused]] const bool convert_d1_level)
+{
+	level_reader r(data);
+	if (r.read_int() != MAKE_SIG('P','L','V','L'))
+		throw std::runtime_error("not a level file");
+	const int version = r.read_int();
+	const auto ext = strrchr(filename, '.');
+	const bool new_file_format = !(ext && !d_stricmp(ext, ".sdl"));
+#if defined(DXX_BUILD_DESCENT_II)
+	if (version <= 1)
+	{
+		if (!convert_d1_level)
+			return std::nullopt;
+		/* load_mine_data_compiled sets this again for each level it
+		 * loads.
+		 */
+		New_file_format_load = new_file_format;
 	}
+#endif
+	const int minedata_offset = r.read_int();
+	const int gamedata_offset = r.read_int();
+	const auto tables = get_level_read_tables();
+	mine_summary mine;
 
-	range_for (const cscusegment segp, vcsegptr)
+	if (!r.seek(minedata_offset))
+		throw level_file_truncated();
 	{
-		range_for (const auto &&z, zip(segp.s.sides, segp.u.sides))
-		{
-			auto &sside = std::get<0>(z);
-			if (sside.wall_num != wall_none)
-			{
-				const auto clip_num = Walls.vcptr(sside.wall_num)->clip_num;
-				if (clip_num != -1) {
+		compiled_mine m;
+		read_compiled_mine(r, m, version, new_file_format, tables);
+		mine.sides.reserve(m.shared_segments.size() * static_cast<std::size_t>(MAX_SIDES_PER_SEGMENT.value));
+		for (auto &&[sseg, useg] : zip(m.shared_segments, m.unique_segments))
+			for (auto &&[sside, uside, child] : zip(sseg.sides, useg.sides, sseg.children))
+				mine.sides.push_back({sside.wall_num, child != segment_none, uside.tmap_num, uside.tmap_num2});
+	}
 
-					const auto num_frames = WallAnims[clip_num].num_frames;
+	if (!r.seek(gamedata_offset))
+		throw level_file_truncated();
+	level_game_data g;
+	if (!read_level_game_data(r, g, tables))
+		throw std::runtime_error("level game data cannot be loaded");
+	mine.objects.reserve(g.objects.size());
+	for (auto &obj : g.objects)
+	{
+		verify_level_object(obj, version, g.Save_pof_names);
+		if (obj.type == OBJ_NONE)
+			continue;
+		mine.objects.push_back({obj.type, obj.id, obj.render_type,
+			obj.render_type == RT_POLYOBJ ? obj.rtype.pobj_info.model_num : polygon_model_index::None});
+	}
+	mine.wall_clips.reserve(g.walls.size());
+	for (auto &w : g.walls)
+		mine.wall_clips.push_back(w.clip_num);
+	return mine;
+}
 
-					wall_buf[clip_num] = 1;
+// ----------------------------------------------------------------------------
+static void determine_used_textures_level(const mine_summary &mine, perm_tmap_buffer_type &tmap_buf, wall_buffer_type &wall_buf)
+{
+	auto &WallAnims = GameSharedState.WallAnims;
+	tmap_buf = {};
+	/* Look up the clip of the wall on a side, if the wall exists */
+	const auto wall_clip = [&mine, &wall_buf](const wallnum_t wall_num) -> int {
+		if (wall_num == wall_none || underlying_value(wall_num) >= mine.wall_clips.size())
+			return -1;
+		const int clip_num = mine.wall_clips[underlying_value(wall_num)];
+		if (clip_num < 0 || clip_num >= std::size(wall_buf))
+			return -1;
+		wall_buf[clip_num] = 1;
+		return clip_num;
+	};
+#if defined(DXX_BUILD_DESCENT_I)
+	const unsigned max_tmap = tmap_buf.size();
+	for (auto &side : mine.sides)
+	{
+		if (const auto clip_num = wall_clip(side.wall_num); clip_num != -1)
+		{
+			auto &anim = WallAnims[clip_num];
+			for (const auto frame : partial_const_range(anim.frames, std::min<unsigned>(anim.num_frames, anim.frames.size())))
+				tmap_buf[bitmap_index{frame}]++;
+		}
 
-					for (j=0; j<num_frames; j++) {
-						const bitmap_index tmap_num{WallAnims[clip_num].frames[j]};
-						tmap_buf[tmap_num]++;
-						if (level_tmap_buf[tmap_num] == -1)
-							level_tmap_buf[tmap_num] = level_num + (!shareware_flag) * NUM_SHAREWARE_LEVELS;
-					}
-				}
-			}
+		if (const bitmap_index tmap1idx{get_texture_index(side.tmap_num)}; underlying_value(tmap1idx) < max_tmap)
+			++ tmap_buf[tmap1idx];
+		else
+		{
+			Int3(); //	Error, bogus texture map.  Should not be greater than max_tmap.
+		}
 
-			auto &uside = std::get<1>(z);
-			if (const bitmap_index tmap1idx{get_texture_index(uside.tmap_num)}; underlying_value(tmap1idx) < max_tmap)
-			{
-				++ tmap_buf[tmap1idx];
-				if (auto &t = level_tmap_buf[tmap1idx]; t == -1)
-					t = level_num + (!shareware_flag) * NUM_SHAREWARE_LEVELS;
-			}
-                                else
-                                 {
-					Int3(); //	Error, bogus texture map.  Should not be greater than max_tmap.
-                                 }
-
-			if (const bitmap_index tmap_num2{get_texture_index(uside.tmap_num2)}; tmap_num2 != bitmap_index{})
-                         {
-				if (underlying_value(tmap_num2) < max_tmap) {
-					++tmap_buf[tmap_num2];
-					if (level_tmap_buf[tmap_num2] == -1)
-						level_tmap_buf[tmap_num2] = level_num + (!shareware_flag) * NUM_SHAREWARE_LEVELS;
-				} else
-					Int3();	//	Error, bogus texture map.  Should not be greater than max_tmap.
-                         }
-                 }
-         }
+		if (const bitmap_index tmap_num2{get_texture_index(side.tmap_num2)}; tmap_num2 != bitmap_index{})
+		{
+			if (underlying_value(tmap_num2) < max_tmap)
+				++tmap_buf[tmap_num2];
+			else
+				Int3();	//	Error, bogus texture map.  Should not be greater than max_tmap.
+		}
+	}
 #elif defined(DXX_BUILD_DESCENT_II)
-	(void)load_level_flag;
-	(void)max_tmap;
-	(void)shareware_flag;
-
-	tmap_buf = {};
-
 	auto &Polygon_models = LevelSharedPolygonModelState.Polygon_models;
 	//	Process robots.
-	range_for (const auto &&objp, vcobjptr)
+	for (auto &obj : mine.objects)
 	{
-		if (objp->render_type == RT_POLYOBJ) {
-			polymodel *po = &Polygon_models[objp->rtype.pobj_info.model_num];
-
-			for (unsigned i = 0; i < po->n_textures; ++i)
-			{
-				const auto tli = ObjBitmaps[ObjBitmapPtrs[po->first_texture + i]];
-				if (tmap_buf.valid_index(tli))
-				{
-					tmap_buf[tli]++;
-					if (auto &ltb = level_tmap_buf[tli]; ltb == -1)
-						ltb = level_num;
-				} else
-					Int3();	//	Hmm, It seems this texture is bogus!
-			}
-
+		if (obj.render_type != RT_POLYOBJ || obj.model_num == polygon_model_index::None)
+			continue;
+		const polymodel *const po = &Polygon_models[obj.model_num];
+		for (unsigned i = 0; i < po->n_textures; ++i)
+		{
+			const auto tli = ObjBitmaps[ObjBitmapPtrs[po->first_texture + i]];
+			if (tmap_buf.valid_index(tli))
+				tmap_buf[tli]++;
+			else
+				Int3();	//	Hmm, It seems this texture is bogus!
 		}
 	}
 
-
-	Ignore_tmap_num2_error = 0;
-
 	//	Process walls and segment sides.
-	range_for (const csmusegment segp, vmsegptr)
+	for (auto &side : mine.sides)
 	{
-		range_for (const auto &&z, zip(segp.s.sides, segp.u.sides, segp.s.children))
+		if (side.wall_num != wall_none)
 		{
-			auto &sside = std::get<0>(z);
-			auto &uside = std::get<1>(z);
-			const auto child = std::get<2>(z);
-			if (sside.wall_num != wall_none) {
-				const auto clip_num = Walls.vcptr(sside.wall_num)->clip_num;
-				if (clip_num != -1) {
-
-					// -- int num_frames = WallAnims[clip_num].num_frames;
-
-					wall_buf[clip_num] = 1;
-
-					for (j=0; j<1; j++) {	//	Used to do through num_frames, but don't really want all the door01#3 stuff.
-						const auto tmap_num = Textures[WallAnims[clip_num].frames[j]];
-						assert(tmap_buf.valid_index(tmap_num));
-						tmap_buf[tmap_num]++;
-						if (auto &ltb = level_tmap_buf[tmap_num]; ltb == -1)
-							ltb = level_num;
-					}
-				}
-			} else if (child == segment_none) {
-				{
-					const auto tmap1idx = get_texture_index(uside.tmap_num);
-					if (tmap1idx < Textures.size()) {
-						const auto ti = Textures[tmap1idx];
-						assert(tmap_buf.valid_index(ti));
-						++tmap_buf[ti];
-						if (auto &ltb = level_tmap_buf[ti]; ltb == -1)
-							ltb = level_num;
-					} else
-						Int3();	//	Error, bogus texture map.  Should not be greater than max_tmap.
-				}
+			//	Used to do through num_frames, but don't really want all the door01#3 stuff.
+			if (const auto clip_num = wall_clip(side.wall_num); clip_num != -1)
+				if (const auto tmap_num = Textures[WallAnims[clip_num].frames[0]]; tmap_buf.valid_index(tmap_num))
+					tmap_buf[tmap_num]++;
+		}
+		else if (!side.has_child)
+		{
+			if (const auto tmap1idx = get_texture_index(side.tmap_num); tmap1idx < Textures.size())
+			{
+				const auto ti = Textures[tmap1idx];
+				if (tmap_buf.valid_index(ti))
+					++tmap_buf[ti];
+			}
+			else
+				Int3();	//	Error, bogus texture map.  Should not be greater than max_tmap.
 
-				if (const auto masked_tmap_num2 = get_texture_index(uside.tmap_num2))
-				{
-					if (masked_tmap_num2 < Textures.size())
-					{
-						const auto ti = Textures[masked_tmap_num2];
-						assert(tmap_buf.valid_index(ti));
+			if (const auto masked_tmap_num2 = get_texture_index(side.tmap_num2))
+			{
+				/* Bogus overlays are ignored, as the loader clears them. */
+				if (masked_tmap_num2 < Textures.size())
+					if (const auto ti = Textures[masked_tmap_num2]; tmap_buf.valid_index(ti))
 						++tmap_buf[ti];
-						if (level_tmap_buf[ti] == -1)
-							level_tmap_buf[ti] = level_num;
-					} else {
-						if (!Ignore_tmap_num2_error)
-							Int3();	//	Error, bogus texture map.  Should not be greater than max_tmap.
-						Ignore_tmap_num2_error = 1;
-						uside.tmap_num2 = texture2_value::None;
-					}
-				}
 			}
 		}
 	}
 #endif
 }
+
+/* Record `level_num` as the first level to use each texture which `tb`
+ * counts and no earlier level used.
+ */
+static void note_first_use(level_tmap_buffer_type &level_tmap_buf, const perm_tmap_buffer_type &tb, const int level_num)
+{
+	for (auto &&[l, t] : zip(level_tmap_buf, tb))
+		if (t && l == -1)
+			l = level_num;
+}
 }
 }
 
@@ -1005,116 +1088,187 @@ static void say_unused_walls(PHYSFS_File *my_file, const wall_buffer_type &tb)
 }
 }
 
+namespace dsx {
 namespace {
 
-static void say_totals(fvcobjptridx &vcobjptridx, PHYSFS_File *my_file, const char *level_name)
+static void say_totals(const std::span<const mine_object> objects, PHYSFS_File *my_file, const char *level_name)
 {
-	auto &Objects = LevelUniqueObjectState.Objects;
 	int	total_robots = 0;
-	int	objects_processed = 0;
 
 	PHYSFSX_printf(my_file, "\nLevel %s\n", level_name);
-	std::bitset<MAX_OBJECTS> used_objects;
-	while (objects_processed < Highest_object_index+1) {
-		int	objtype, objid, objcount, min_obj_val;
-
+	std::vector<bool> used_objects(objects.size());
+	for (;;)
+	{
 		//	Find new min objnum.
-		min_obj_val = 0x7fff0000;
-		const object_base *min_objp = nullptr;
+		int min_obj_val = 0x7fff0000;
+		const mine_object *min_objp = nullptr;
 
-		range_for (const auto &&objp, vcobjptridx)
+		for (auto &&[objp, used] : zip(objects, used_objects))
 		{
-			if (!used_objects[objp] && objp->type != OBJ_NONE)
+			if (!used)
 			{
-				const auto cur_obj_val = (objp->type << 10) + objp->id;
+				const auto cur_obj_val = (objp.type << 10) + objp.id;
 				if (cur_obj_val < min_obj_val) {
-					min_objp = &*objp;
+					min_objp = &objp;
 					min_obj_val = cur_obj_val;
 				}
 			}
 		}
-		if (!min_objp || min_objp->type == OBJ_NONE)
+		if (!min_objp)
 			break;
 
-		objcount = 0;
+		int objcount = 0;
 
-		objtype = min_objp->type;
-		objid = min_objp->id;
+		const auto objtype = min_objp->type;
+		const auto objid = min_objp->id;
 
-		range_for (const auto &&objp, vcobjptridx)
+		for (auto &&[objp, used] : zip(objects, used_objects))
 		{
-			if (auto &&uo = used_objects[objp])
-			{
-			}
-			else
-			{
-				if ((objp->type == objtype && objp->id == objid) ||
-						(objp->type == objtype && objtype == OBJ_PLAYER) ||
-						(objp->type == objtype && objtype == OBJ_COOP) ||
-						(objp->type == objtype && objtype == OBJ_HOSTAGE)) {
-					if (objp->type == OBJ_ROBOT)
-						total_robots++;
-					uo = true;
-					objcount++;
-					objects_processed++;
-				}
+			if (used)
+				continue;
+			if ((objp.type == objtype && objp.id == objid) ||
+					(objp.type == objtype && objtype == OBJ_PLAYER) ||
+					(objp.type == objtype && objtype == OBJ_COOP) ||
+					(objp.type == objtype && objtype == OBJ_HOSTAGE)) {
+				if (objp.type == OBJ_ROBOT)
+					total_robots++;
+				used = true;
+				objcount++;
 			}
 		}
 
 		if (objcount) {
-			PHYSFSX_printf(my_file, "Object: %8s %8s %3i\n", object_types(*min_objp), object_ids(*min_objp), objcount);
+			PHYSFSX_printf(my_file, "Object: %8s %8s %3i\n", object_types(objtype), object_ids(objtype, objid), objcount);
 		}
 	}
 
 	PHYSFSX_printf(my_file, "Total robots = %3i\n", total_robots);
 }
 
+static void dump_used_textures_level(PHYSFS_File *my_file, const mine_summary &mine, const char *const Gamesave_current_filename)
+{
+	perm_tmap_buffer_type temp_tmap_buf;
+	wall_buffer_type temp_wall_buf{};
+	determine_used_textures_level(mine, temp_tmap_buf, temp_wall_buf);
+	PHYSFSX_printf(my_file, "\nTextures used in [%s]\n", Gamesave_current_filename);
+	say_used_tmaps(my_file, temp_tmap_buf);
 }
 
-namespace dsx {
-namespace {
-
 // ----------------------------------------------------------------------------
-static void say_totals_all(void)
+/* The result of reading one level of the mission and counting what it
+ * uses.
+ */
+struct level_analysis
 {
-	auto &&[my_file, physfserr] = PHYSFSX_openWriteBuffered("levels.all");
-	if (!my_file)	{
-		gr_palette_load(gr_palette);
-		nm_messagebox(menu_title{nullptr}, {TXT_OK}, "ERROR: Unable to open levels.all\n%s", PHYSFS_getErrorByCode(physfserr));
-		return;
-	}
+	const char *filename;
+	std::vector<uint8_t> file;
+	mine_summary mine;
+	perm_tmap_buffer_type tmap_buf;
+	wall_buffer_type wall_buf;
+	/* Why the level could not be read, or empty if it was read */
+	std::string error;
+	/* Set if the level must be read by the main thread */
+	bool deferred = false;
+	bool analyse(bool convert_d1_level);
+};
 
-#if defined(DXX_BUILD_DESCENT_I)
-	auto &Objects = LevelUniqueObjectState.Objects;
-	auto &vcobjptridx = Objects.vcptridx;
-	for (unsigned i = 0; i < NUM_SHAREWARE_LEVELS; ++i)
-	{
-		load_level(Shareware_level_names[i]);
-		say_totals(vcobjptridx, my_file, Shareware_level_names[i]);
+bool level_analysis::analyse(const bool convert_d1_level)
+{
+	if (!error.empty())
+		return true;
+	try {
+		auto m = read_mine_summary(file, filename, convert_d1_level);
+		if (!m)
+			return false;
+		mine = std::move(*m);
+		wall_buf = {};
+		determine_used_textures_level(mine, tmap_buf, wall_buf);
+	} catch (const std::exception &e) {
+		error = e.what();
 	}
+	file = {};
+	return true;
+}
 
-	for (unsigned i = 0; i < NUM_REGISTERED_LEVELS; ++i)
+/* Read and count the levels named in `level_names`, several at a time.
+ * Files are read by this thread, so that PhysFS is only used from one
+ * thread, and the levels are parsed and counted by worker threads.  The
+ * level being edited is not disturbed.
+ */
+static std::vector<level_analysis> analyse_levels(const std::span<const char *const> level_names)
+{
+	std::vector<level_analysis> levels(level_names.size());
+	for (auto &&[level, filename] : zip(levels, level_names))
 	{
-		load_level(Registered_level_names[i]);
-		say_totals(vcobjptridx, my_file, Registered_level_names[i]);
+		level.filename = filename;
+		level.file = read_level_file(filename);
+		if (level.file.empty())
+			level.error = "unable to read level file";
 	}
-#endif
-}
+	std::atomic<std::size_t> next_level{0};
+	const auto analyse_next_levels = [&levels, &next_level]() {
+		for (std::size_t i; (i = next_level++) < levels.size();)
+			if (!levels[i].analyse(false))
+				levels[i].deferred = true;
+	};
+	std::vector<std::thread> workers;
+	const unsigned thread_count = std::min<std::size_t>(std::thread::hardware_concurrency(), levels.size());
+	try {
+		for (unsigned i = 1; i < thread_count; ++i)
+			workers.emplace_back(analyse_next_levels);
+	} catch (const std::system_error &) {
+		/* Levels without a thread are read by this one. */
+	}
+	analyse_next_levels();
+	for (auto &w : workers)
+		w.join();
+	for (auto &level : levels)
+		if (level.deferred)
+			level.analyse(true);
+	return levels;
 }
+
+static void say_level_error(PHYSFS_File *my_file, const level_analysis &level)
+{
+	PHYSFSX_printf(my_file, "\nUnable to analyse level %s: %s\n", level.filename, level.error.c_str());
 }
 
-namespace {
-static void dump_used_textures_level(PHYSFS_File *my_file, int level_num, const char *const Gamesave_current_filename)
+/* The levels which the whole-mission dumps cover. */
+static std::vector<const char *> mission_level_names()
 {
-	perm_tmap_buffer_type temp_tmap_buf;
-	level_tmap_buffer_type level_tmap_buf;
+	std::vector<const char *> names;
+#if defined(DXX_BUILD_DESCENT_I)
+	for (auto &n : Shareware_level_names)
+		names.emplace_back(n);
+	for (auto &n : Registered_level_names)
+		names.emplace_back(n);
+#elif defined(DXX_BUILD_DESCENT_II)
+	for (auto &n : std::span(Current_mission->level_names.get(), Current_mission->last_level))
+		names.emplace_back(n.data());
+	for (auto &n : std::span(Current_mission->secret_level_names.get(), Current_mission->n_secret_levels))
+		names.emplace_back(n.data());
+#endif
+	return names;
+}
 
-	level_tmap_buf.fill(-1);
+// ----------------------------------------------------------------------------
+static void say_totals_all(const std::span<const level_analysis> levels)
+{
+	auto &&[my_file, physfserr] = PHYSFSX_openWriteBuffered("levels.all");
+	if (!my_file)	{
+		gr_palette_load(gr_palette);
+		nm_messagebox(menu_title{nullptr}, {TXT_OK}, "ERROR: Unable to open levels.all\n%s", PHYSFS_getErrorByCode(physfserr));
+		return;
+	}
 
-	wall_buffer_type temp_wall_buf;
-	determine_used_textures_level(0, 1, level_num, temp_tmap_buf, temp_wall_buf, level_tmap_buf, level_tmap_buf.size());
-	PHYSFSX_printf(my_file, "\nTextures used in [%s]\n", Gamesave_current_filename);
-	say_used_tmaps(my_file, temp_tmap_buf);
+	for (auto &level : levels)
+	{
+		if (!level.error.empty())
+			say_level_error(my_file, level);
+		else
+			say_totals(level.mine.objects, my_file, level.filename);
+	}
+}
 }
 }
 
@@ -1122,7 +1276,9 @@ static void dump_used_textures_level(PHYSFS_File *my_file, int level_num, const
 namespace dsx {
 void dump_used_textures_all(void)
 {
-say_totals_all();
+	const auto level_names = mission_level_names();
+	const auto levels = analyse_levels(level_names);
+	say_totals_all(levels);
 
 	auto &&[my_file, physfserr] = PHYSFSX_openWriteBuffered("textures.dmp");
 	if (!my_file)	{
@@ -1135,18 +1291,27 @@ say_totals_all();
 	level_tmap_buffer_type level_tmap_buf;
 	level_tmap_buf.fill(-1);
 
+	const auto say_level = [&my_file, &perm_tmap_buf, &level_tmap_buf](const level_analysis &level, const int level_num) {
+		if (!level.error.empty())
+		{
+			say_level_error(my_file, level);
+			return false;
+		}
+		PHYSFSX_printf(my_file, "\nTextures used in [%s]\n", level.filename);
+		say_used_tmaps(my_file, level.tmap_buf);
+		merge_buffers(perm_tmap_buf, level.tmap_buf);
+		note_first_use(level_tmap_buf, level.tmap_buf, level_num);
+		return true;
+	};
+
 #if defined(DXX_BUILD_DESCENT_I)
-	perm_tmap_buffer_type temp_tmap_buf;
 	wall_buffer_type perm_wall_buf{};
 
 	for (unsigned i = 0; i < NUM_SHAREWARE_LEVELS; ++i)
 	{
-		wall_buffer_type temp_wall_buf;
-		determine_used_textures_level(1, 1, i, temp_tmap_buf, temp_wall_buf, level_tmap_buf, level_tmap_buf.size());
-		PHYSFSX_printf(my_file, "\nTextures used in [%s]\n", Shareware_level_names[i]);
-		say_used_tmaps(my_file, temp_tmap_buf);
-		merge_buffers(perm_tmap_buf, temp_tmap_buf);
-		merge_buffers(perm_wall_buf, temp_wall_buf);
+		auto &level = levels[i];
+		if (say_level(level, i))
+			merge_buffers(perm_wall_buf, level.wall_buf);
 	}
 
 	PHYSFSX_puts_literal(my_file, "\n\nUsed textures in all shareware mines:\n");
@@ -1162,13 +1327,10 @@ say_totals_all();
 	say_unused_walls(my_file, perm_wall_buf);
 
 	for (unsigned i = 0; i < NUM_REGISTERED_LEVELS; ++i)
-	{
-		wall_buffer_type temp_wall_buf;
-		determine_used_textures_level(1, 0, i, temp_tmap_buf, temp_wall_buf, level_tmap_buf, level_tmap_buf.size());
-		PHYSFSX_printf(my_file, "\nTextures used in [%s]\n", Registered_level_names[i]);
-		say_used_tmaps(my_file, temp_tmap_buf);
-		merge_buffers(perm_tmap_buf, temp_tmap_buf);
-	}
+		say_level(levels[NUM_SHAREWARE_LEVELS + i], NUM_SHAREWARE_LEVELS + i);
+#elif defined(DXX_BUILD_DESCENT_II)
+	for (auto &&[i, level] : enumerate(levels))
+		say_level(level, i);
 #endif
 
 	PHYSFSX_puts_literal(my_file, "\n\nUsed textures in all (including registered) mines:\n");
@@ -24,10 +24,12 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  *
  */
 
+#include <algorithm>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
+#include <vector>
 
 #include "gr.h"
 #include "inferno.h"
@@ -43,16 +45,46 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "object.h"
 
 #include "compiler-range_for.h"
+#include "d_enumerate.h"
 #include "d_levelstate.h"
 #include "partial_range.h"
 
 unsigned Num_effects;
 
+namespace {
+
+/* Indices, in ascending order, of the clips which do_special_effects
+ * animates.  Most clips either have no frame time, replace no texture,
+ * or are stopped, and are never visited.
+ */
+static std::vector<uint8_t> Active_effects;
+static_assert(MAX_EFFECTS <= UINT8_MAX + 1);
+
+static bool effect_is_active(const eclip &ec)
+{
+	if (!ec.vc.frame_time)
+		return false;
+	if (ec.changing_wall_texture == -1 && ec.changing_object_texture == object_bitmap_index::None)
+		return false;
+	return !(ec.flags & EF_STOPPED);
+}
+
+static void build_active_effects(const d_eclip_array &Effects)
+{
+	Active_effects.clear();
+	for (auto &&[i, ec] : enumerate(partial_const_range(Effects, Num_effects)))
+		if (effect_is_active(ec))
+			Active_effects.emplace_back(i);
+}
+
+}
+
 void init_special_effects()
 {
 	auto &Effects = LevelUniqueEffectsClipState.Effects;
 	range_for (eclip &ec, partial_range(Effects, Num_effects))
 		ec.time_left = ec.vc.frame_time;
+	build_active_effects(Effects);
 }
 
 void reset_special_effects()
@@ -71,23 +103,17 @@ void reset_special_effects()
 			ObjBitmaps[changing_object_texture] = ec.vc.frames[ec.frame_count];
 
 	}
+	build_active_effects(Effects);
 }
 
 void do_special_effects()
 {
 	auto &LevelUniqueControlCenterState = LevelUniqueObjectState.ControlCenterState;
 	auto &Effects = LevelUniqueEffectsClipState.Effects;
-	range_for (eclip &ec, partial_range(Effects, Num_effects))
+	for (const auto effect_num : Active_effects)
 	{
+		eclip &ec = Effects[effect_num];
 		const auto vc_frame_time = ec.vc.frame_time;
-		if (!vc_frame_time)
-			continue;
-		if (ec.changing_wall_texture == -1 && ec.changing_object_texture == object_bitmap_index::None)
-			continue;
-
-		if (ec.flags & EF_STOPPED)
-			continue;
-
 		ec.time_left -= FrameTime;
 
 		while (ec.time_left < 0) {
@@ -159,6 +185,8 @@ void stop_effect(int effect_num)
 	//Assert(ec->bm_ptr != -1);
 
 	ec->flags |= EF_STOPPED;
+	if (const auto i = std::lower_bound(Active_effects.begin(), Active_effects.end(), effect_num); i != Active_effects.end() && *i == effect_num)
+		Active_effects.erase(i);
 
 	ec->frame_count = 0;
 	//*ec->bm_ptr = &GameBitmaps[ec->vc.frames[0].index];
@@ -174,9 +202,14 @@ void stop_effect(int effect_num)
 void restart_effect(int effect_num)
 {
 	auto &Effects = LevelUniqueEffectsClipState.Effects;
-	Effects[effect_num].flags &= ~EF_STOPPED;
+	auto &ec = Effects[effect_num];
+	ec.flags &= ~EF_STOPPED;
 
 	//Assert(Effects[effect_num].bm_ptr != -1);
+	if (!effect_is_active(ec))
+		return;
+	if (const auto i = std::lower_bound(Active_effects.begin(), Active_effects.end(), effect_num); i == Active_effects.end() || *i != effect_num)
+		Active_effects.insert(i, static_cast<uint8_t>(effect_num));
 }
 
 DEFINE_VCLIP_SERIAL_UDT();
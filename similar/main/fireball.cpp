@@ -196,11 +196,11 @@ struct connected_segment_raw_distances
 
 }
 
-unsigned Num_exploding_walls;
+std::vector<wallnum_t> Exploding_walls;
 
 void init_exploding_walls()
 {
-	Num_exploding_walls = 0;
+	Exploding_walls.clear();
 }
 
 connected_segment_raw_distances::connected_segment_raw_distances(fvcsegptr &vcsegptr, fvcwallptr &vcwallptr, segment_distance_count_type max_depth, vcsegidx_t current_segment_idx)
@@ -1547,14 +1547,17 @@ void explode_wall(fvcvertptr &vcvertptr, const vcsegptridx_t segnum, const siden
 		return;
 	w.explode_time_elapsed = 0;
 	w.flags |= wall_flag::exploding;
-	++ Num_exploding_walls;
+	/* This may run from inside process_exploding_walls, so append now and
+	 * let it restore the order once it has finished walking the list.
+	 */
+	Exploding_walls.emplace_back(segnum->shared_segment::sides[sidenum].wall_num);
 
 	//play one long sound for whole door wall explosion
 	const auto &&pos = compute_center_point_on_side(vcvertptr, segnum, sidenum);
 	digi_link_sound_to_pos( SOUND_EXPLODING_WALL,segnum, sidenum, pos, 0, F1_0 );
 }
 
-unsigned do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &w1)
+void do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &w1)
 {
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Vertices = LevelSharedVertexState.get_vertices();
@@ -1570,7 +1573,6 @@ unsigned do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &w1)
 
 	const auto w1sidenum = w1.sidenum;
 	const auto &&seg = vmsegptridx(w1.segnum);
-	unsigned walls_updated = 0;
 	if (w1_explode_time_elapsed > (EXPL_WALL_TIME * 3) / 4)
 	{
 		const auto &&csegp = seg.absolute_sibling(seg->shared_segment::children[w1sidenum]);
@@ -1591,23 +1593,15 @@ unsigned do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &w1)
 			assert(&w1 != &w2);
 			w2.flags |= wall_flag::blasted;
 			assert((w1.flags & wall_flag::exploding) || (w2.flags & wall_flag::exploding));
-			if (w1_explode_time_elapsed >= EXPL_WALL_TIME && w2.flags & wall_flag::exploding)
-			{
+			if (w1_explode_time_elapsed >= EXPL_WALL_TIME)
 				w2.flags &= ~wall_flag::exploding;
-				++ walls_updated;
-			}
 		}
 		else
 			assert(w1.flags & wall_flag::exploding);
 
 		w1.flags |= wall_flag::blasted;
-		if (w1_explode_time_elapsed >= EXPL_WALL_TIME && w1.flags & wall_flag::exploding)
-		{
+		if (w1_explode_time_elapsed >= EXPL_WALL_TIME)
 			w1.flags &= ~wall_flag::exploding;
-			++ walls_updated;
-		}
-
-		Num_exploding_walls -= walls_updated;
 	}
 
 	const fix newfrac = fixdiv(w1_explode_time_elapsed, EXPL_WALL_TIME);
@@ -1618,7 +1612,7 @@ unsigned do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &w1)
 		/* for loop would exit with zero iterations if this `if` is
 		 * true.  Skip the setup for the loop in that case.
 		 */
-		return walls_updated;
+		return;
 
 	const auto vertnum_list = get_side_verts(seg, w1sidenum);
 
@@ -1657,7 +1651,6 @@ unsigned do_exploding_wall_frame(const d_robot_info_array &Robot_info, wall &w1)
 										   object_none		//	parent id
 			);
 	}
-	return walls_updated;
 }
 
 #if defined(DXX_BUILD_DESCENT_II)
@@ -1691,10 +1684,9 @@ void drop_afterburner_blobs(object &obj, int count, fix size_scale, fix lifetime
 /*
  * reads n expl_wall structs from a PHYSFS_File and swaps if specified
  */
-void expl_wall_read_n_swap(fvmwallptr &vmwallptr, PHYSFS_File *const fp, const int swap, const unsigned count)
+void expl_wall_read_n_swap(fvmwallptridx &vmwallptridx, PHYSFS_File *const fp, const int swap, const unsigned count)
 {
-	assert(!Num_exploding_walls);
-	unsigned num_exploding_walls = 0;
+	assert(Exploding_walls.empty());
 	/* Legacy versions of Descent always write a fixed number of
 	 * entries, even if some or all of those entries are empty.  This
 	 * loop needs to count how many entries were valid, as well as load
@@ -1716,31 +1708,32 @@ void expl_wall_read_n_swap(fvmwallptr &vmwallptr, PHYSFS_File *const fp, const i
 		const icsegidx_t dseg = s;
 		if (dseg == segment_none)
 			continue;
-		range_for (auto &&wp, vmwallptr)
+		range_for (auto &&wp, vmwallptridx)
 		{
 			auto &w = *wp;
 			if (w.segnum != dseg)
 				continue;
 			if (underlying_value(w.sidenum) != d.sidenum)
 				continue;
-			w.flags |= wall_flag::exploding;
+			if (!(w.flags & wall_flag::exploding))
+			{
+				w.flags |= wall_flag::exploding;
+				Exploding_walls.emplace_back(wp);
+			}
 			w.explode_time_elapsed = d.time;
-			++ num_exploding_walls;
 			break;
 		}
 	}
-	Num_exploding_walls = num_exploding_walls;
+	std::sort(Exploding_walls.begin(), Exploding_walls.end());
 }
 
 void expl_wall_write(fvcwallptr &vcwallptr, PHYSFS_File *const fp)
 {
-	const unsigned num_exploding_walls = Num_exploding_walls;
+	const unsigned num_exploding_walls = Exploding_walls.size();
 	PHYSFS_write(fp, &num_exploding_walls, sizeof(unsigned), 1);
-	range_for (auto &&wp, vcwallptr)
+	for (const auto wn : Exploding_walls)
 	{
-		auto &e = *wp;
-		if (!(e.flags & wall_flag::exploding))
-			continue;
+		auto &e = *vcwallptr(wn);
 		disk_expl_wall d;
 		d.segnum = e.segnum;
 		d.sidenum = underlying_value(e.sidenum);
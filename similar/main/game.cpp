@@ -70,6 +70,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "morph.h"
 #include "lighting.h"
 #include "newdemo.h"
+#include "demoexport.h"
 #include "collide.h"
 #include "weapon.h"
 #include "sounds.h"
@@ -100,6 +101,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "hudmsg.h"
 #if defined(DXX_BUILD_DESCENT_II)
 #include <climits>
+#include <vector>
 #include "gamepal.h"
 #include "movie.h"
 #endif
@@ -167,6 +169,12 @@ static void powerup_grab_cheat_all();
 #if defined(DXX_BUILD_DESCENT_II)
 d_flickering_light_state Flickering_light_state;
 namespace {
+/* Segments with a nonzero slide_textures mask, built by
+ * compute_slide_segs, so that slide_textures need not visit every
+ * segment each frame.  The editor builds it again whenever it changes
+ * the mine.
+ */
+static std::vector<segnum_t> Slide_segments;
 static void slide_textures(void);
 static void flicker_lights(const d_level_shared_destructible_light_state &LevelSharedDestructibleLightState, d_flickering_light_state &fls, fvmsegptridx &vmsegptridx);
 }
@@ -633,11 +641,27 @@ void reset_time()
 
 void calc_frame_time()
 {
+	if (const auto export_frame_time = demo_export_frame_time())
+	{
+		/* Each exported frame advances the demo by the same time, however
+		 * long it took to draw and write.
+		 */
+		last_timer_value = sync_timer_value = timer_update();
+		FrameTime = export_frame_time;
+		GameTime64 += FrameTime;
+		calc_d_tick();
+#ifdef NEWHOMER
+		calc_d_homer_tick();
+#endif
+		return;
+	}
 	fix last_frametime = FrameTime;
 
 	const auto vsync = CGameCfg.VSync;
 	const auto bound = f1_0 / (likely(vsync) ? MAXIMUM_FPS : CGameArg.SysMaxFPS);
 	const auto may_sleep = !CGameArg.SysNoNiceFPS && !vsync;
+	// time spent on the last frame, before waiting for the frame rate limit
+	const fix busy_time = timer_update() - last_timer_value;
 	for (;;)
 	{
 		const auto timer_value = timer_update();
@@ -666,6 +690,7 @@ void calc_frame_time()
 
 	GameTime64 += FrameTime;
 
+	adaptive_detail_frame(busy_time);
 	calc_d_tick();
 #ifdef NEWHOMER
         calc_d_homer_tick();
@@ -1782,6 +1807,7 @@ window_event_result game_window::event_handler(const d_event &event)
 
 			if (time_paused)
 				start_time();
+			set_animated(1);
 
 			if (!((Game_mode & GM_MULTI) && (Newdemo_state != ND_STATE_PLAYBACK)))
 				digi_resume_digi_sounds();
@@ -1795,6 +1821,8 @@ window_event_result game_window::event_handler(const d_event &event)
 		case EVENT_WINDOW_DEACTIVATED:
 			if (!(((Game_mode & GM_MULTI) && (Newdemo_state != ND_STATE_PLAYBACK)) && (!Endlevel_sequence)) )
 				stop_time();
+			// While the game is stopped, only the windows on top of it change
+			set_animated(!time_paused);
 
 			if (!((Game_mode & GM_MULTI) && (Newdemo_state != ND_STATE_PLAYBACK)))
 				digi_pause_digi_sounds();
@@ -1835,6 +1863,8 @@ window_event_result game_window::event_handler(const d_event &event)
 					force_cockpit_redraw=0;
 				}
 				game_render_frame(LevelSharedRobotInfoState.Robot_info, Controls);
+				if (Newdemo_state == ND_STATE_PLAYBACK)
+					demo_export_frame();
 			}
 			break;
 
@@ -2151,8 +2181,10 @@ window_event_result GameProcessFrame(const d_level_shared_robot_info_state &Leve
 void compute_slide_segs()
 {
 	auto &TmapInfo = LevelUniqueTmapInfoState.TmapInfo;
-	for (const csmusegment suseg : vmsegptr)
+	Slide_segments.clear();
+	for (auto &&segp : vmsegptridx)
 	{
+		const csmusegment suseg = *segp;
 		sidemask_t slide_textures{};
 		for (const auto sidenum : MAX_SIDES_PER_SEGMENT)
 		{
@@ -2170,6 +2202,8 @@ void compute_slide_segs()
 			slide_textures |= build_sidemask(sidenum);
 		}
 		suseg.u.slide_textures = slide_textures;
+		if (slide_textures != sidemask_t{})
+			Slide_segments.emplace_back(segp);
 	}
 }
 
@@ -2193,8 +2227,9 @@ static void update_uv(std::array<uvl, 4> &uvls, uvl &i, fix a)
 static void slide_textures(void)
 {
 	auto &TmapInfo = LevelUniqueTmapInfoState.TmapInfo;
-	for (unique_segment &useg : vmsegptr)
+	for (const auto segnum : Slide_segments)
 	{
+		unique_segment &useg = *vmsegptr(segnum);
 		if (const auto slide_seg = useg.slide_textures; slide_seg != sidemask_t{})
 		{
 			for (const auto sidenum : MAX_SIDES_PER_SEGMENT)
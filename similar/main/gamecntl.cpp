@@ -497,6 +497,7 @@ static void do_game_pause()
 	}
 
 	auto p = window_create<pause_window>(grd_curscreen->sc_canvas, 0, 0, SWIDTH, SHEIGHT);
+	p->set_animated(0);
 	songs_pause();
 
 	auto &plr = get_local_player();
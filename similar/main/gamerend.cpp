@@ -63,6 +63,10 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #if DXX_USE_OGL
 #include "ogl_init.h"
+#else
+#include <climits>
+#include <utility>
+#include "window.h"
 #endif
 
 namespace dcx {
@@ -88,6 +92,58 @@ static void game_draw_marker_message(grs_canvas &canvas)
 }
 #endif
 
+#if DXX_USE_OGL
+static ogl_canvas_capture Game_view_capture;
+#endif
+
+/* Render the game view.  If -adaptivefps has reduced the render
+ * resolution, render into the top left of the canvas, then draw that
+ * over the whole canvas.
+ */
+static void render_game_view(grs_canvas &canvas, window_rendered_data &window)
+{
+#if DXX_USE_OGL
+	if (const auto scale = Render_resolution_scale; scale < 100)
+	{
+		const uint16_t w = std::max(canvas.cv_bitmap.bm_w * scale / 100, 1u);
+		const uint16_t h = std::max(canvas.cv_bitmap.bm_h * scale / 100, 1u);
+		grs_subcanvas render_canv;
+		gr_init_sub_canvas(render_canv, canvas, 0, 0, w, h);
+		gr_set_current_canvas(render_canv);
+		render_frame(render_canv, 0, window);
+		ogl_capture_canvas(render_canv, w, h, Game_view_capture);
+		gr_set_current_canvas(canvas);
+		if (ogl_draw_canvas_capture(canvas, Game_view_capture))
+			return;
+	}
+#endif
+	render_frame(canvas, 0, window);
+}
+
+#if !DXX_USE_OGL
+/* The flip count at which the canvas still holds the full cockpit drawn by
+ * the previous frame, or UINT_MAX if it may not.
+ */
+static unsigned Cockpit_kept_flip = UINT_MAX;
+
+/* The previous frame can only be reused if nothing drew over it outside
+ * of the 3D window, and the next flip will show nothing but this frame.
+ */
+static bool cockpit_frame_can_be_partial()
+{
+	if (PlayerCfg.CockpitMode[1] != cockpit_mode_t::full_cockpit)
+		return false;
+	if (CGameArg.DbgRenderStats)
+		return false;
+	if (netplayerinfo_on && (Game_mode & GM_MULTI))
+		return false;
+	for (auto wind = window_get_first(); wind; wind = window_get_next(*wind))
+		if (wind != Game_wind && wind->is_visible())
+			return false;
+	return true;
+}
+#endif
+
 static void update_cockpits(grs_canvas &);
 }
 }
@@ -811,7 +867,7 @@ void game_render_frame_mono(const d_robot_info_array &Robot_info, const control_
 		else
 #endif
 		{
-			render_frame(canvas, 0, window);
+			render_game_view(canvas, window);
 		}
 
 		wake_up_rendered_objects(*Viewer, window);
@@ -853,7 +909,7 @@ void game_render_frame_mono(const d_robot_info_array &Robot_info, const control_
 		else
 #endif
 		{
-			render_frame(canvas, 0, window);
+			render_game_view(canvas, window);
 		}
 	}
 	}
@@ -883,13 +939,31 @@ void game_render_frame_mono(const d_robot_info_array &Robot_info, const control_
 #if defined(DXX_BUILD_DESCENT_II)
 	gr_set_default_canvas();
 	show_extra_views(*grd_curcanv);		//missile view, buddy bot, etc.
+	if (CGameArg.DbgRenderStats)
+		show_inset_view_stats(*grd_curcanv);
 #endif
 
+	if (CGameArg.DbgRenderStats)
+	{
+		gr_set_default_canvas();
+		show_adaptive_detail_stats(*grd_curcanv);
+#if !DXX_USE_OGL
+		show_span_stats(*grd_curcanv);
+#endif
+	}
+
 	if (netplayerinfo_on && Game_mode & GM_MULTI)
 	{
 		gr_set_default_canvas();
 		show_netplayerinfo(*grd_curcanv);
 	}
+#if !DXX_USE_OGL
+	/* The event loop flips once after this frame, unless another window
+	 * draws over it first, which cockpit_frame_can_be_partial rules out.
+	 */
+	if (cockpit_frame_can_be_partial())
+		Cockpit_kept_flip = gr_flip_count() + 1;
+#endif
 }
 
 }
@@ -952,7 +1026,28 @@ static void update_cockpits(grs_canvas &canvas)
 #if DXX_USE_OGL
 			ogl_ubitmapm_cs(canvas, 0, 0, opengl_bitmap_use_dst_canvas, opengl_bitmap_use_dst_canvas, *bm, 255);
 #else
-			gr_ubitmapm(canvas, 0, 0, *bm);
+			const auto kept_flip = std::exchange(Cockpit_kept_flip, UINT_MAX);
+			if (kept_flip == gr_flip_count() && last_drawn_cockpit == cockpit_mode_t::full_cockpit && cockpit_frame_can_be_partial())
+			{
+				/* Everything below the 3D window is still on the canvas.
+				 * Put back only the rows which the 3D view and the HUD
+				 * drew over, and let render_gauges update the rest.
+				 */
+				const auto w = canvas.cv_bitmap.bm_w;
+				const auto h = std::min<unsigned>(Screen_3d_window.cv_bitmap.bm_y + Screen_3d_window.cv_bitmap.bm_h, canvas.cv_bitmap.bm_h);
+				grs_subcanvas band;
+				gr_init_sub_canvas(band, canvas, 0, 0, w, h);
+				gr_bitmapm(band, 0, 0, *bm);
+				gr_flip_partial();
+				gr_flip_dirty_rect(0, 0, w, h);
+				cockpit_gauges_begin_frame(h);
+			}
+			else
+			{
+				gr_ubitmapm(canvas, 0, 0, *bm);
+				if (PlayerCfg.CockpitMode[1] == cockpit_mode_t::full_cockpit)
+					cockpit_gauges_begin_frame(-1);
+			}
 #endif
 			}
 			break;
@@ -23,6 +23,8 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  *
  */
 
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
 #include <stdio.h>
 #include <string.h>
@@ -59,6 +61,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "text.h"
 #include "gamefont.h"
 #include "gamesave.h"
+#include "level_reader.h"
 #include "gamepal.h"
 #include "physics.h"
 #include "laser.h"
@@ -122,26 +125,26 @@ namespace dsx {
 #if defined(DXX_BUILD_DESCENT_I)
 namespace {
 
-using savegame_pof_names_type = enumerated_array<char[FILENAME_LEN], 167, polygon_model_index>;
-
-static int convert_vclip(const d_vclip_array &Vclip, int vc)
+static int convert_vclip(const level_read_tables &tables, int vc)
 {
 	if (vc < 0)
 		return vc;
-	if (vc < Vclip.size() && (Vclip[vc].num_frames != ~0u))
+	if (vc < tables.vclip_present.size() && tables.vclip_present[vc])
 		return vc;
 	return 0;
 }
-static int convert_wclip(int wc) {
+static int convert_wclip(const level_read_tables &tables, int wc) {
+	const int Num_wall_anims = tables.num_wall_anims;
 	return (wc < Num_wall_anims) ? wc : wc % Num_wall_anims;
 }
 
 }
 
-int convert_tmap(int tmap)
+int convert_tmap(const level_read_tables &tables, int tmap)
 {
 	if (tmap == -1)
 		return tmap;
+	const int NumTextures = tables.num_textures;
     return (tmap >= NumTextures) ? tmap % NumTextures : tmap;
 }
 
@@ -151,24 +154,34 @@ static unsigned convert_polymod(const unsigned N_polygon_models, const unsigned
     return (polymod >= N_polygon_models) ? polymod % N_polygon_models : polymod;
 }
 }
-#elif defined(DXX_BUILD_DESCENT_II)
-namespace {
-using savegame_pof_names_type = enumerated_array<char[FILENAME_LEN], MAX_POLYGON_MODELS, polygon_model_index>;
-}
 #endif
 
 namespace {
 
-static void verify_object(const d_level_shared_robot_info_state &LevelSharedRobotInfoState, const d_vclip_array &Vclip, object &obj, const savegame_pof_names_type &Save_pof_names)
+static void verify_object(const d_level_shared_robot_info_state &LevelSharedRobotInfoState, const d_vclip_array &Vclip, object &obj, const savegame_pof_names_type &Save_pof_names, [[maybe_unused]] const int level_version)
 {
 	auto &Robot_info = LevelSharedRobotInfoState.Robot_info;
 	obj.lifeleft = IMMORTAL_TIME;		//all loaded object are immortal, for now
 
+#if DXX_USE_EDITOR
+	if (obj.render_type == RT_POLYOBJ || obj.render_type == RT_MORPH)
+	{
+		auto &tmap_override = obj.rtype.pobj_info.tmap_override;
+		if (tmap_override != -1)
+		{
+			int xlated_tmo = tmap_xlate_table[tmap_override];
+			if (xlated_tmo < 0)	{
+				Int3();
+				xlated_tmo = 0;
+			}
+			tmap_override = xlated_tmo;
+		}
+	}
+#endif
+
 	auto &Polygon_models = LevelSharedPolygonModelState.Polygon_models;
 	if (obj.type == OBJ_ROBOT)
 	{
-		Gamesave_num_org_robots++;
-
 		// Make sure valid id...
 		const auto N_robot_types = LevelSharedRobotInfoState.N_robot_types;
 		if (get_robot_id(obj) >= N_robot_types )
@@ -281,7 +294,7 @@ static void verify_object(const d_level_shared_robot_info_state &LevelSharedRobo
 				break;		
 			}
 #elif defined(DXX_BUILD_DESCENT_II)
-		if (Gamesave_current_version <= 1) { // descent 1 reactor
+		if (level_version <= 1) { // descent 1 reactor
 			set_reactor_id(obj, 0);                         // used to be only one kind of reactor
 			obj.rtype.pobj_info.model_num = Reactors[0].model_num;// descent 1 reactor
 		}
@@ -305,8 +318,6 @@ static void verify_object(const d_level_shared_robot_info_state &LevelSharedRobo
 
 		//Make sure orient matrix is orthogonal
 		check_and_fix_matrix(obj.orient);
-
-		set_player_id(obj, Gamesave_num_players++);
 	}
 
 	if (obj.type == OBJ_HOSTAGE)
@@ -323,24 +334,25 @@ static void verify_object(const d_level_shared_robot_info_state &LevelSharedRobo
 //}
 
 //reads one object of the given version from the given file
-static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
+//returns false if the object had a bogus render type
+static bool read_object(object &obj, level_reader &f, const int version, [[maybe_unused]] const level_read_tables &tables)
 {
-	DXX_POISON_MEMORY(std::span<object>(&*obj, 1), 0xfd);
-	obj->signature = object_signature_t{0};
-	set_object_type(*obj, PHYSFSX_readByte(f));
-	obj->id             = PHYSFSX_readByte(f);
+	DXX_POISON_MEMORY(std::span<object>(&obj, 1), 0xfd);
+	obj.signature = object_signature_t{0};
+	set_object_type(obj, f.read_byte());
+	obj.id             = f.read_byte();
 
-	if (obj->type == OBJ_ROBOT)
+	if (obj.type == OBJ_ROBOT)
 	{
 #if defined(DXX_BUILD_DESCENT_I)
 		const auto id = get_robot_id(obj);
 		if (id > 23)
 			set_robot_id(obj, id % 24);
 #endif
-		obj->matcen_creator = 0;
+		obj.matcen_creator = 0;
 	}
 	{
-		uint8_t ctype = PHYSFSX_readByte(f);
+		uint8_t ctype = f.read_byte();
 		switch (typename object::control_type{ctype})
 		{
 			case object::control_type::None:
@@ -362,10 +374,10 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 				ctype = static_cast<uint8_t>(object::control_type::None);
 				break;
 		}
-		obj->control_source = typename object::control_type{ctype};
+		obj.control_source = typename object::control_type{ctype};
 	}
 	{
-		uint8_t mtype = PHYSFSX_readByte(f);
+		uint8_t mtype = f.read_byte();
 		switch (typename object::movement_type{mtype})
 		{
 			case object::movement_type::None:
@@ -376,61 +388,56 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 				mtype = static_cast<uint8_t>(object::movement_type::None);
 				break;
 		}
-		obj->movement_source = typename object::movement_type{mtype};
-	}
-	const uint8_t render_type = PHYSFSX_readByte(f);
-	if (valid_render_type(render_type))
-		obj->render_type = render_type_t{render_type};
-	else
-	{
-		LevelError("Level contains bogus render type %#x for object %p; using none instead", render_type, &*obj);
-		obj->render_type = RT_NONE;
+		obj.movement_source = typename object::movement_type{mtype};
 	}
-	obj->flags          = PHYSFSX_readByte(f);
+	const uint8_t render_type = f.read_byte();
+	const bool bogus_render_type = !valid_render_type(render_type);
+	obj.render_type = bogus_render_type ? RT_NONE : render_type_t{render_type};
+	obj.flags          = f.read_byte();
 
 	{
-		const auto s = segnum_t{static_cast<uint16_t>(PHYSFSX_readShort(f))};
-		obj->segnum = vmsegidx_t::check_nothrow_index(s) ? s : segment_none;
+		const auto s = segnum_t{static_cast<uint16_t>(f.read_short())};
+		obj.segnum = vmsegidx_t::check_nothrow_index(s) ? s : segment_none;
 	}
-	obj->attached_obj   = object_none;
+	obj.attached_obj   = object_none;
 
-	PHYSFSX_readVector(f, obj->pos);
-	PHYSFSX_readMatrix(&obj->orient,f);
+	f.read_vector(obj.pos);
+	f.read_matrix(obj.orient);
 
-	obj->size           = PHYSFSX_readFix(f);
-	obj->shields        = PHYSFSX_readFix(f);
+	obj.size           = f.read_fix();
+	obj.shields        = f.read_fix();
 
 	{
 		vms_vector last_pos;
-		PHYSFSX_readVector(f, last_pos);
+		f.read_vector(last_pos);
 	}
 
-	obj->contains_type  = PHYSFSX_readByte(f);
-	obj->contains_id    = PHYSFSX_readByte(f);
-	obj->contains_count = PHYSFSX_readByte(f);
+	obj.contains_type  = f.read_byte();
+	obj.contains_id    = f.read_byte();
+	obj.contains_count = f.read_byte();
 
-	switch (obj->movement_source) {
+	switch (obj.movement_source) {
 
 		case object::movement_type::physics:
 
-			PHYSFSX_readVector(f, obj->mtype.phys_info.velocity);
-			PHYSFSX_readVector(f, obj->mtype.phys_info.thrust);
+			f.read_vector(obj.mtype.phys_info.velocity);
+			f.read_vector(obj.mtype.phys_info.thrust);
 
-			obj->mtype.phys_info.mass		= PHYSFSX_readFix(f);
-			obj->mtype.phys_info.drag		= PHYSFSX_readFix(f);
-			PHYSFSX_readFix(f);	/* brakes */
+			obj.mtype.phys_info.mass		= f.read_fix();
+			obj.mtype.phys_info.drag		= f.read_fix();
+			f.read_fix();	/* brakes */
 
-			PHYSFSX_readVector(f, obj->mtype.phys_info.rotvel);
-			PHYSFSX_readVector(f, obj->mtype.phys_info.rotthrust);
+			f.read_vector(obj.mtype.phys_info.rotvel);
+			f.read_vector(obj.mtype.phys_info.rotthrust);
 
-			obj->mtype.phys_info.turnroll	= PHYSFSX_readFixAng(f);
-			obj->mtype.phys_info.flags		= PHYSFSX_readShort(f);
+			obj.mtype.phys_info.turnroll	= f.read_fixang();
+			obj.mtype.phys_info.flags		= f.read_short();
 
 			break;
 
 		case object::movement_type::spinning:
 
-			PHYSFSX_readVector(f, obj->mtype.spin_rate);
+			f.read_vector(obj.mtype.spin_rate);
 			break;
 
 		case object::movement_type::None:
@@ -440,41 +447,41 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 			Int3();
 	}
 
-	switch (obj->control_source) {
+	switch (obj.control_source) {
 
 		case object::control_type::ai: {
-			obj->ctype.ai_info.behavior				= static_cast<ai_behavior>(PHYSFSX_readByte(f));
+			obj.ctype.ai_info.behavior				= static_cast<ai_behavior>(f.read_byte());
 
 			std::array<int8_t, 11> ai_info_flags{};
-			PHYSFS_read(f, &ai_info_flags[0], 1, 11);
+			f.read_bytes(&ai_info_flags[0], 11);
 			{
 				const uint8_t gun_num = ai_info_flags[0];
-				obj->ctype.ai_info.CURRENT_GUN = (gun_num < MAX_GUNS) ? robot_gun_number{gun_num} : robot_gun_number{};
+				obj.ctype.ai_info.CURRENT_GUN = (gun_num < MAX_GUNS) ? robot_gun_number{gun_num} : robot_gun_number{};
 			}
-			obj->ctype.ai_info.CURRENT_STATE = build_ai_state_from_untrusted(ai_info_flags[1]).value();
-			obj->ctype.ai_info.GOAL_STATE = build_ai_state_from_untrusted(ai_info_flags[2]).value();
-			obj->ctype.ai_info.PATH_DIR = ai_info_flags[3];
+			obj.ctype.ai_info.CURRENT_STATE = build_ai_state_from_untrusted(ai_info_flags[1]).value();
+			obj.ctype.ai_info.GOAL_STATE = build_ai_state_from_untrusted(ai_info_flags[2]).value();
+			obj.ctype.ai_info.PATH_DIR = ai_info_flags[3];
 #if defined(DXX_BUILD_DESCENT_I)
-			obj->ctype.ai_info.SUBMODE = ai_info_flags[4];
+			obj.ctype.ai_info.SUBMODE = ai_info_flags[4];
 #elif defined(DXX_BUILD_DESCENT_II)
-			obj->ctype.ai_info.SUB_FLAGS = ai_info_flags[4];
+			obj.ctype.ai_info.SUB_FLAGS = ai_info_flags[4];
 #endif
-			obj->ctype.ai_info.GOALSIDE = build_sidenum_from_untrusted(ai_info_flags[5]).value();
-			obj->ctype.ai_info.CLOAKED = ai_info_flags[6];
-			obj->ctype.ai_info.SKIP_AI_COUNT = ai_info_flags[7];
-			obj->ctype.ai_info.REMOTE_OWNER = ai_info_flags[8];
-			obj->ctype.ai_info.REMOTE_SLOT_NUM = ai_info_flags[9];
+			obj.ctype.ai_info.GOALSIDE = build_sidenum_from_untrusted(ai_info_flags[5]).value();
+			obj.ctype.ai_info.CLOAKED = ai_info_flags[6];
+			obj.ctype.ai_info.SKIP_AI_COUNT = ai_info_flags[7];
+			obj.ctype.ai_info.REMOTE_OWNER = ai_info_flags[8];
+			obj.ctype.ai_info.REMOTE_SLOT_NUM = ai_info_flags[9];
 			{
-				const auto s = segnum_t{static_cast<uint16_t>(PHYSFSX_readShort(f))};
-				obj->ctype.ai_info.hide_segment = imsegidx_t::check_nothrow_index(s) ? s : segment_none;
+				const auto s = segnum_t{static_cast<uint16_t>(f.read_short())};
+				obj.ctype.ai_info.hide_segment = imsegidx_t::check_nothrow_index(s) ? s : segment_none;
 			}
-			obj->ctype.ai_info.hide_index			= PHYSFSX_readShort(f);
-			obj->ctype.ai_info.path_length			= PHYSFSX_readShort(f);
-			obj->ctype.ai_info.cur_path_index		= PHYSFSX_readShort(f);
+			obj.ctype.ai_info.hide_index			= f.read_short();
+			obj.ctype.ai_info.path_length			= f.read_short();
+			obj.ctype.ai_info.cur_path_index		= f.read_short();
 
 			if (version <= 25) {
-				PHYSFSX_readShort(f);	//				obj->ctype.ai_info.follow_path_start_seg	= 
-				PHYSFSX_readShort(f);	//				obj->ctype.ai_info.follow_path_end_seg		= 
+				f.read_short();	//				obj.ctype.ai_info.follow_path_start_seg	= 
+				f.read_short();	//				obj.ctype.ai_info.follow_path_end_seg		= 
 			}
 
 			break;
@@ -482,10 +489,10 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 
 		case object::control_type::explosion:
 
-			obj->ctype.expl_info.spawn_time		= PHYSFSX_readFix(f);
-			obj->ctype.expl_info.delete_time		= PHYSFSX_readFix(f);
-			obj->ctype.expl_info.delete_objnum	= PHYSFSX_readShort(f);
-			obj->ctype.expl_info.next_attach = obj->ctype.expl_info.prev_attach = obj->ctype.expl_info.attach_parent = object_none;
+			obj.ctype.expl_info.spawn_time		= f.read_fix();
+			obj.ctype.expl_info.delete_time		= f.read_fix();
+			obj.ctype.expl_info.delete_objnum	= f.read_short();
+			obj.ctype.expl_info.next_attach = obj.ctype.expl_info.prev_attach = obj.ctype.expl_info.attach_parent = object_none;
 
 			break;
 
@@ -493,47 +500,47 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 
 			//do I really need to read these?  Are they even saved to disk?
 
-			obj->ctype.laser_info.parent_type		= PHYSFSX_readShort(f);
-			obj->ctype.laser_info.parent_num		= PHYSFSX_readShort(f);
-			obj->ctype.laser_info.parent_signature	= object_signature_t{static_cast<uint16_t>(PHYSFSX_readInt(f))};
+			obj.ctype.laser_info.parent_type		= f.read_short();
+			obj.ctype.laser_info.parent_num		= f.read_short();
+			obj.ctype.laser_info.parent_signature	= object_signature_t{static_cast<uint16_t>(f.read_int())};
 #if defined(DXX_BUILD_DESCENT_II)
-			obj->ctype.laser_info.last_afterburner_time = 0;
+			obj.ctype.laser_info.last_afterburner_time = 0;
 #endif
-			obj->ctype.laser_info.clear_hitobj();
+			obj.ctype.laser_info.clear_hitobj();
 
 			break;
 
 		case object::control_type::light:
 
-			obj->ctype.light_info.intensity = PHYSFSX_readFix(f);
+			obj.ctype.light_info.intensity = f.read_fix();
 			break;
 
 		case object::control_type::powerup:
 
 			if (version >= 25)
-				obj->ctype.powerup_info.count = PHYSFSX_readInt(f);
+				obj.ctype.powerup_info.count = f.read_int();
 			else
-				obj->ctype.powerup_info.count = 1;
+				obj.ctype.powerup_info.count = 1;
 
-			if (obj->type == OBJ_POWERUP)
+			if (obj.type == OBJ_POWERUP)
 			{
 				/* Objects loaded from a level file were not ejected by
 				 * the player.
 				 */
-				obj->ctype.powerup_info.flags = 0;
+				obj.ctype.powerup_info.flags = 0;
 				/* Hostages have control type object::control_type::powerup, but object
 				 * type OBJ_HOSTAGE.  Hostages are never weapons, so
 				 * prevent checking their IDs.
 				 */
 			if (get_powerup_id(obj) == POW_VULCAN_WEAPON)
-					obj->ctype.powerup_info.count = VULCAN_WEAPON_AMMO_AMOUNT;
+					obj.ctype.powerup_info.count = VULCAN_WEAPON_AMMO_AMOUNT;
 
 #if defined(DXX_BUILD_DESCENT_II)
 			else if (get_powerup_id(obj) == POW_GAUSS_WEAPON)
-					obj->ctype.powerup_info.count = VULCAN_WEAPON_AMMO_AMOUNT;
+					obj.ctype.powerup_info.count = VULCAN_WEAPON_AMMO_AMOUNT;
 
 			else if (get_powerup_id(obj) == POW_OMEGA_WEAPON)
-					obj->ctype.powerup_info.count = MAX_OMEGA_CHARGE;
+					obj.ctype.powerup_info.count = MAX_OMEGA_CHARGE;
 #endif
 			}
 
@@ -559,7 +566,7 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 	
 	}
 
-	switch (obj->render_type) {
+	switch (obj.render_type) {
 
 		case RT_NONE:
 			break;
@@ -568,41 +575,29 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 		case RT_POLYOBJ: {
 			int tmo;
 
-			obj->rtype.pobj_info.model_num = build_polygon_model_index_from_untrusted(
+			obj.rtype.pobj_info.model_num = build_polygon_model_index_from_untrusted(
 #if defined(DXX_BUILD_DESCENT_I)
-				convert_polymod(LevelSharedPolygonModelState.N_polygon_models, PHYSFSX_readInt(f))
+				convert_polymod(tables.num_polygon_models, f.read_int())
 #elif defined(DXX_BUILD_DESCENT_II)
-				PHYSFSX_readInt(f)
+				f.read_int()
 #endif
 			);
 
-			range_for (auto &i, obj->rtype.pobj_info.anim_angles)
-				PHYSFSX_readAngleVec(&i, f);
+			range_for (auto &i, obj.rtype.pobj_info.anim_angles)
+				f.read_angvec(i);
 
-			obj->rtype.pobj_info.subobj_flags	= PHYSFSX_readInt(f);
+			obj.rtype.pobj_info.subobj_flags	= f.read_int();
 
-			tmo = PHYSFSX_readInt(f);
+			tmo = f.read_int();
 
-#if !DXX_USE_EDITOR
-#if defined(DXX_BUILD_DESCENT_I)
-			obj->rtype.pobj_info.tmap_override	= convert_tmap(tmo);
-#elif defined(DXX_BUILD_DESCENT_II)
-			obj->rtype.pobj_info.tmap_override	= tmo;
+#if !DXX_USE_EDITOR && defined(DXX_BUILD_DESCENT_I)
+			obj.rtype.pobj_info.tmap_override	= convert_tmap(tables, tmo);
+#else
+			/* The editor translates this in verify_object */
+			obj.rtype.pobj_info.tmap_override	= tmo;
 #endif
-			#else
-			if (tmo==-1)
-				obj->rtype.pobj_info.tmap_override	= -1;
-			else {
-				int xlated_tmo = tmap_xlate_table[tmo];
-				if (xlated_tmo < 0)	{
-					Int3();
-					xlated_tmo = 0;
-				}
-				obj->rtype.pobj_info.tmap_override	= xlated_tmo;
-			}
-			#endif
 
-			obj->rtype.pobj_info.alt_textures	= 0;
+			obj.rtype.pobj_info.alt_textures	= 0;
 
 			break;
 		}
@@ -613,12 +608,12 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 		case RT_FIREBALL:
 
 #if defined(DXX_BUILD_DESCENT_I)
-			obj->rtype.vclip_info.vclip_num	= convert_vclip(Vclip, PHYSFSX_readInt(f));
+			obj.rtype.vclip_info.vclip_num	= convert_vclip(tables, f.read_int());
 #elif defined(DXX_BUILD_DESCENT_II)
-			obj->rtype.vclip_info.vclip_num	= PHYSFSX_readInt(f);
+			obj.rtype.vclip_info.vclip_num	= f.read_int();
 #endif
-			obj->rtype.vclip_info.frametime	= PHYSFSX_readFix(f);
-			obj->rtype.vclip_info.framenum	= PHYSFSX_readByte(f);
+			obj.rtype.vclip_info.frametime	= f.read_fix();
+			obj.rtype.vclip_info.framenum	= f.read_byte();
 
 			break;
 
@@ -629,9 +624,181 @@ static void read_object(const vmobjptr_t obj,PHYSFS_File *f,int version)
 			Int3();
 
 	}
+	return !bogus_render_type;
+}
+
+// Read the header, or return nullopt if this is not game data which can
+// be loaded.
+static std::optional<game_data_header> read_game_data_header(level_reader &r)
+{
+	game_data_header h;
+
+	// Check signature
+	if (r.read_short() != 0x6705)
+		return std::nullopt;
+
+	// Read and check version number
+	h.version = r.read_short();
+	if (h.version < GAME_COMPATIBLE_VERSION)
+		return std::nullopt;
 
+	// We skip some parts of the former game_top_fileinfo
+	r.skip(31);
+
+	h.object_offset = r.read_int();
+	h.num_objects = r.read_int();
+	r.skip(8);
+
+	h.num_walls = r.read_int();
+	r.skip(20);
+
+	h.num_triggers = r.read_int();
+	r.skip(24);
+
+	if (r.read_int() != sizeof(v1_control_center_triggers))
+		throw std::runtime_error("wrong size for v1_control_center_triggers");
+	r.skip(4);
+
+	h.num_robot_centers = r.read_int();
+	r.skip(4);
+
+#if defined(DXX_BUILD_DESCENT_II)
+	if (h.version >= 29) {
+		r.skip(4);
+		h.num_static_lights = r.read_int();
+		r.skip(8);
+		h.num_delta_lights = r.read_int();
+		r.skip(4);
+	} else {
+		h.num_static_lights = 0;
+		h.num_delta_lights = 0;
+	}
+#endif
+	return h;
 }
+
+// Read the level name and the names of the models which objects use.
+// Return the number of model names in the level.  If that is not less
+// than MAX_POLYGON_MODELS, the names are bogus and were not read.
+static unsigned read_game_data_names(level_reader &r, const int version, PHYSFSX_gets_line_t<LEVEL_NAME_LEN> &level_name, savegame_pof_names_type &Save_pof_names)
+{
+	if (version >= 14) //load mine filename
+	{
+		// read newline-terminated string, not sure what version this changed.
+		if (!r.read_line(level_name))
+			*level_name = 0;
+	}
+	else
+		level_name.next()[0]=0;
+
+	if (version < 19)
+		return 0;
+	//load pof names
+	const unsigned N_save_pof_names = r.read_short();
+	if (N_save_pof_names < MAX_POLYGON_MODELS)
+		r.read_bytes(Save_pof_names.data(), N_save_pof_names * FILENAME_LEN);
+	return N_save_pof_names;
+}
+
+static void read_level_wall(level_reader &r, wall &nw, const int version, [[maybe_unused]] const level_read_tables &tables)
+{
+	if (version >= 20)
+		wall_read(r, nw); // v20 walls and up.
+	else if (version >= 17) {
+		v19_wall w;
+		v19_wall_read(r, w);
+		nw.segnum	        = w.segnum;
+		nw.sidenum	= build_sidenum_from_untrusted(w.sidenum).value();
+		nw.linked_wall	= w.linked_wall;
+		nw.type		= w.type;
+		auto wf = static_cast<wall_flags>(w.flags);
+		wf &= ~wall_flag::exploding;
+		nw.flags = wf;
+		nw.hps		= w.hps;
+		nw.trigger	= static_cast<trgnum_t>(w.trigger);
+#if defined(DXX_BUILD_DESCENT_I)
+		nw.clip_num	= convert_wclip(tables, w.clip_num);
+#elif defined(DXX_BUILD_DESCENT_II)
+		nw.clip_num	= w.clip_num;
+#endif
+		nw.keys		= static_cast<wall_key>(w.keys);
+		nw.state		= wall_state::closed;
+	} else {
+		v16_wall w;
+		v16_wall_read(r, w);
+		nw.segnum = segment_none;
+		nw.sidenum = {};
+		nw.linked_wall = wall_none;
+		nw.type		= w.type;
+		auto wf = static_cast<wall_flags>(w.flags);
+		wf &= ~wall_flag::exploding;
+		nw.flags = wf;
+		nw.hps		= w.hps;
+		nw.trigger	= static_cast<trgnum_t>(w.trigger);
+#if defined(DXX_BUILD_DESCENT_I)
+		nw.clip_num	= convert_wclip(tables, w.clip_num);
+#elif defined(DXX_BUILD_DESCENT_II)
+		nw.clip_num	= w.clip_num;
+#endif
+		nw.keys		= static_cast<wall_key>(w.keys);
+	}
 }
+
+}
+
+#if defined(DXX_BUILD_DESCENT_I)
+level_read_tables get_level_read_tables()
+{
+	level_read_tables tables;
+	tables.num_textures = NumTextures;
+	tables.num_polygon_models = LevelSharedPolygonModelState.N_polygon_models;
+	tables.num_wall_anims = Num_wall_anims;
+	for (auto &&[i, vc] : enumerate(Vclip))
+		tables.vclip_present[i] = (vc.num_frames != ~0u);
+	return tables;
+}
+#elif defined(DXX_BUILD_DESCENT_II)
+level_read_tables get_level_read_tables()
+{
+	level_read_tables tables;
+	tables.d1_pig_present = PHYSFSX_exists(D1_PIGFILE, 1);
+	return tables;
+}
+#endif
+
+bool read_level_game_data(level_reader &r, level_game_data &g, const level_read_tables &tables)
+{
+	const auto header = read_game_data_header(r);
+	if (!header)
+		return false;
+	g.header = *header;
+	if (g.header.num_objects > MAX_OBJECTS || g.header.num_walls > MAX_WALLS)
+		throw std::runtime_error("too many objects or walls");
+	g.N_save_pof_names = read_game_data_names(r, g.header.version, g.level_name, g.Save_pof_names);
+
+	g.objects.clear();
+	g.bogus_render_types.clear();
+	if (g.header.object_offset > -1) {
+		if (!r.seek(g.header.object_offset))
+			throw level_file_truncated();
+		g.objects.resize(g.header.num_objects);
+		for (auto &&[objnum, i] : enumerate(g.objects))
+			if (!read_object(i, r, g.header.version, tables))
+				g.bogus_render_types.emplace_back(objnum);
+	}
+
+	g.walls.resize(g.header.num_walls);
+	range_for (auto &w, g.walls)
+		read_level_wall(r, w, g.header.version, tables);
+	g.triggers_offset = r.tell();
+	return true;
+}
+
+void verify_level_object(object &obj, const int level_version, const savegame_pof_names_type &Save_pof_names)
+{
+	verify_object(LevelSharedRobotInfoState, Vclip, obj, Save_pof_names, level_version);
+}
+
 }
 
 #if DXX_USE_EDITOR
@@ -904,87 +1071,47 @@ static int load_game_data(
 #if defined(DXX_BUILD_DESCENT_II)
 	d_level_shared_destructible_light_state &LevelSharedDestructibleLightState,
 #endif
-	fvmobjptridx &vmobjptridx, fvmsegptridx &vmsegptridx, PHYSFS_File *LoadFile)
+	fvmobjptridx &vmobjptridx, fvmsegptridx &vmsegptridx, PHYSFS_File *LoadFile, const level_game_data *staged)
 {
 	auto &Objects = LevelUniqueObjectState.Objects;
-	auto &vmobjptr = Objects.vmptr;
 	auto &WallAnims = GameSharedState.WallAnims;
 	auto &RobotCenters = LevelSharedRobotcenterState.RobotCenters;
 	const auto &vcsegptridx = vmsegptridx;
-	short game_top_fileinfo_version;
-	int object_offset;
-	unsigned gs_num_objects;
-	int trig_size;
 
 	//===================== READ FILE INFO ========================
 
-	// Check signature
-	if (PHYSFSX_readShort(LoadFile) != 0x6705)
-		return -1;
-
-	// Read and check version number
-	game_top_fileinfo_version = PHYSFSX_readShort(LoadFile);
-	if (game_top_fileinfo_version < GAME_COMPATIBLE_VERSION )
-		return -1;
-
-	// We skip some parts of the former game_top_fileinfo
-	PHYSFSX_fseek(LoadFile, 31, SEEK_CUR);
-
-	object_offset = PHYSFSX_readInt(LoadFile);
-	gs_num_objects = PHYSFSX_readInt(LoadFile);
-	PHYSFSX_fseek(LoadFile, 8, SEEK_CUR);
+	level_game_data read_game_data;
+	if (!staged)
+	{
+		level_reader r(LoadFile);
+		if (!read_level_game_data(r, read_game_data, get_level_read_tables()))
+			return -1;
+		staged = &read_game_data;
+	}
+	else
+		PHYSFS_seek(LoadFile, staged->triggers_offset);
+	const auto &game_data = *staged;
+	const auto &header = game_data.header;
+	const short game_top_fileinfo_version = header.version;
 
 	init_exploding_walls();
 	auto &Walls = LevelUniqueWallSubsystemState.Walls;
-	Walls.set_count(PHYSFSX_readInt(LoadFile));
-	PHYSFSX_fseek(LoadFile, 20, SEEK_CUR);
+	Walls.set_count(header.num_walls);
 
 	auto &Triggers = LevelUniqueWallSubsystemState.Triggers;
-	Triggers.set_count(PHYSFSX_readInt(LoadFile));
-	PHYSFSX_fseek(LoadFile, 24, SEEK_CUR);
+	Triggers.set_count(header.num_triggers);
 
-	trig_size = PHYSFSX_readInt(LoadFile);
-	if (trig_size != sizeof(v1_control_center_triggers))
-		throw std::runtime_error("wrong size for v1_control_center_triggers");
-	PHYSFSX_fseek(LoadFile, 4, SEEK_CUR);
-
-	const unsigned Num_robot_centers = PHYSFSX_readInt(LoadFile);
+	const unsigned Num_robot_centers = header.num_robot_centers;
 	LevelSharedRobotcenterState.Num_robot_centers = Num_robot_centers;
-	PHYSFSX_fseek(LoadFile, 4, SEEK_CUR);
 
-#if defined(DXX_BUILD_DESCENT_I)
-#elif defined(DXX_BUILD_DESCENT_II)
-	unsigned num_delta_lights;
-	unsigned Num_static_lights;
-	if (game_top_fileinfo_version >= 29) {
-		PHYSFSX_fseek(LoadFile, 4, SEEK_CUR);
-		Num_static_lights = PHYSFSX_readInt(LoadFile);
-		PHYSFSX_fseek(LoadFile, 8, SEEK_CUR);
-		num_delta_lights = PHYSFSX_readInt(LoadFile);
-		PHYSFSX_fseek(LoadFile, 4, SEEK_CUR);
-	} else {
-		Num_static_lights = 0;
-		num_delta_lights = 0;
-	}
+#if defined(DXX_BUILD_DESCENT_II)
+	const unsigned num_delta_lights = header.num_delta_lights;
+	const unsigned Num_static_lights = header.num_static_lights;
 #endif
 
-	if (game_top_fileinfo_version >= 14) //load mine filename
-	{
-		// read newline-terminated string, not sure what version this changed.
-		if (!PHYSFSX_fgets(Current_level_name, LoadFile))
-			*Current_level_name = 0;
-	}
-	else
-		Current_level_name.next()[0]=0;
-
-	savegame_pof_names_type Save_pof_names;
-	if (game_top_fileinfo_version >= 19) {	//load pof names
-		const unsigned N_save_pof_names = PHYSFSX_readShort(LoadFile);
-		if (N_save_pof_names < MAX_POLYGON_MODELS)
-			PHYSFS_read(LoadFile,Save_pof_names,N_save_pof_names,FILENAME_LEN);
-		else
-			LevelError("Level contains bogus N_save_pof_names %#x; ignoring", N_save_pof_names);
-	}
+	std::ranges::copy(game_data.level_name.line(), Current_level_name.next().begin());
+	if (game_data.N_save_pof_names >= MAX_POLYGON_MODELS)
+		LevelError("Level contains bogus N_save_pof_names %#x; ignoring", game_data.N_save_pof_names);
 
 	//===================== READ PLAYER INFO ==========================
 
@@ -994,65 +1121,26 @@ static int load_game_data(
 	Gamesave_num_org_robots = 0;
 	Gamesave_num_players = 0;
 
-	if (object_offset > -1) {
-		if (!PHYSFS_seek(LoadFile, object_offset))
-			Error( "Error seeking to object_offset in gamesave.c" );
-
-		range_for (auto &i, partial_range(Objects, gs_num_objects))
-		{
-			const auto &&o = vmobjptr(&i);
-			read_object(o, LoadFile, game_top_fileinfo_version);
-			verify_object(LevelSharedRobotInfoState, Vclip, o, Save_pof_names);
-		}
-	}
+	for (auto &&[i, obj] : zip(partial_range(Objects, game_data.objects.size()), game_data.objects))
+	{
+		/* Verify each object in its place, so that verify_object can
+		 * tell which one is the player.
+		 */
+		i = obj;
+		verify_level_object(i, Gamesave_current_version, game_data.Save_pof_names);
+		if (i.type == OBJ_ROBOT)
+			Gamesave_num_org_robots++;
+		else if (i.type == OBJ_PLAYER)
+			set_player_id(i, Gamesave_num_players++);
+	}
+	for (const auto objnum : game_data.bogus_render_types)
+		LevelError("Level contains bogus render type for object %u; using none instead", objnum);
 
 	//===================== READ WALL INFO ============================
 
 	auto &vmwallptr = Walls.vmptr;
-	range_for (const auto &&vw, vmwallptr)
-	{
-		auto &nw = *vw;
-		if (game_top_fileinfo_version >= 20)
-			wall_read(LoadFile, nw); // v20 walls and up.
-		else if (game_top_fileinfo_version >= 17) {
-			v19_wall w;
-			v19_wall_read(LoadFile, w);
-			nw.segnum	        = w.segnum;
-			nw.sidenum	= build_sidenum_from_untrusted(w.sidenum).value();
-			nw.linked_wall	= w.linked_wall;
-			nw.type		= w.type;
-			auto wf = static_cast<wall_flags>(w.flags);
-			wf &= ~wall_flag::exploding;
-			nw.flags = wf;
-			nw.hps		= w.hps;
-			nw.trigger	= static_cast<trgnum_t>(w.trigger);
-#if defined(DXX_BUILD_DESCENT_I)
-			nw.clip_num	= convert_wclip(w.clip_num);
-#elif defined(DXX_BUILD_DESCENT_II)
-			nw.clip_num	= w.clip_num;
-#endif
-			nw.keys		= static_cast<wall_key>(w.keys);
-			nw.state		= wall_state::closed;
-		} else {
-			v16_wall w;
-			v16_wall_read(LoadFile, w);
-			nw.segnum = segment_none;
-			nw.sidenum = {};
-			nw.linked_wall = wall_none;
-			nw.type		= w.type;
-			auto wf = static_cast<wall_flags>(w.flags);
-			wf &= ~wall_flag::exploding;
-			nw.flags = wf;
-			nw.hps		= w.hps;
-			nw.trigger	= static_cast<trgnum_t>(w.trigger);
-#if defined(DXX_BUILD_DESCENT_I)
-			nw.clip_num	= convert_wclip(w.clip_num);
-#elif defined(DXX_BUILD_DESCENT_II)
-			nw.clip_num	= w.clip_num;
-#endif
-			nw.keys		= static_cast<wall_key>(w.keys);
-		}
-	}
+	for (auto &&[w, staged_wall] : zip(partial_range(Walls, game_data.walls.size()), game_data.walls))
+		w = staged_wall;
 
 	//==================== READ TRIGGER INFO ==========================
 
@@ -1141,7 +1229,7 @@ static int load_game_data(
 
 	//========================= UPDATE VARIABLES ======================
 
-	reset_objects(LevelUniqueObjectState, gs_num_objects);
+	reset_objects(LevelUniqueObjectState, header.num_objects);
 
 	range_for (auto &i, Objects)
 	{
@@ -1310,7 +1398,7 @@ int load_level(
 #if defined(DXX_BUILD_DESCENT_II)
 	d_level_shared_destructible_light_state &LevelSharedDestructibleLightState,
 #endif
-	const char * filename_passed)
+	const char * filename_passed, const staged_level *staged)
 {
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Objects = LevelUniqueObjectState.Objects;
@@ -1351,6 +1439,12 @@ int load_level(
 	Assert(sig == MAKE_SIG('P','L','V','L'));
 	(void)sig;
 
+	/* Use the staged level only if it was read from this file, with the
+	 * game data now loaded.
+	 */
+	if (staged && (staged->file_length != static_cast<std::size_t>(PHYSFS_fileLength(LoadFile)) || staged->version != Gamesave_current_version || staged->tables != get_level_read_tables()))
+		staged = nullptr;
+
 	if (Gamesave_current_version < 5)
 		PHYSFSX_readInt(LoadFile);       //was hostagetext_offset
 	init_exploding_walls();
@@ -1420,7 +1514,7 @@ int load_level(
 
 	PHYSFS_seek(LoadFile, minedata_offset);
 		//NOTE LINK TO ABOVE!!
-		mine_err = load_mine_data_compiled(LoadFile, filename);
+		mine_err = load_mine_data_compiled(LoadFile, filename, staged ? &staged->mine : nullptr);
 
 	/* !!!HACK!!!
 	 * Descent 1 - Level 19: OBERON MINE has some ugly overlapping rooms (segment 484).
@@ -1480,7 +1574,7 @@ int load_level(
 #if defined(DXX_BUILD_DESCENT_II)
 		LevelSharedDestructibleLightState,
 #endif
-		vmobjptridx, vmsegptridx, LoadFile);
+		vmobjptridx, vmsegptridx, LoadFile, staged ? &staged->game_data : nullptr);
 
 	if (game_err == -1) {   //error!!
 		return 3;
@@ -1517,6 +1611,7 @@ int load_level(
 	#endif
 
 #if DXX_USE_EDITOR
+	Vertex_segments.invalidate();
 	if (EditorWindow)
 		editor_status_fmt("Loaded NEW mine %s, \"%s\"", filename, static_cast<const char *>(Current_level_name));
 	#endif
@@ -1540,6 +1635,59 @@ int load_level(
 #endif
 	return 0;
 }
+
+std::vector<uint8_t> read_level_file(const char *const filename)
+{
+	auto fp = PHYSFSX_openReadBuffered(filename).first;
+	if (!fp)
+	{
+		std::array<char, PATH_MAX> filename_storage;
+		snprintf(filename_storage.data(), filename_storage.size(), "%.*s%s", DXX_ptrdiff_cast_int(std::distance(Current_mission->path.cbegin(), Current_mission->filename)), Current_mission->path.c_str(), filename);
+		fp = PHYSFSX_openReadBuffered(filename_storage.data()).first;
+		if (!fp)
+			return {};
+	}
+	const auto length = PHYSFS_fileLength(fp);
+	if (length <= 0)
+		return {};
+	std::vector<uint8_t> data(length);
+	if (PHYSFS_read(fp, data.data(), 1, length) != length)
+		return {};
+	return data;
+}
+
+std::unique_ptr<staged_level> stage_level(const std::span<const uint8_t> data, const char *const filename, const level_read_tables &tables)
+{
+	level_reader r(data);
+	if (r.read_int() != MAKE_SIG('P','L','V','L'))
+		return nullptr;
+	auto s = std::make_unique<staged_level>();
+	s->file_length = data.size();
+	s->version = r.read_int();
+	const std::size_t minedata_offset = r.read_int();
+	const std::size_t gamedata_offset = r.read_int();
+	s->tables = tables;
+#if defined(DXX_BUILD_DESCENT_II)
+	if (s->version < 5)
+		r.read_int();
+	if (s->version >= 8)
+	{
+		r.read_int();
+		r.read_short();
+		r.read_byte();
+	}
+	if (s->version <= 1 || !r.read_line(s->palette) || s->palette[0] == 0)
+		strcpy(s->palette.next().data(), DEFAULT_LEVEL_PALETTE);
+#endif
+	/* As load_mine_data_compiled sets New_file_format_load */
+	const bool new_file_format = strcmp(strchr(filename, '.'), ".sdl");
+	if (!r.seek(minedata_offset))
+		return nullptr;
+	read_compiled_mine(r, s->mine, s->version, new_file_format, tables);
+	if (!r.seek(gamedata_offset) || !read_level_game_data(r, s->game_data, tables))
+		return nullptr;
+	return s;
+}
 }
 
 #if DXX_USE_EDITOR
@@ -1602,6 +1750,7 @@ int create_new_mine(void)
 	Vertices.set_count(1);
 	LevelSharedSegmentState.Num_segments = 0;		// Number of segments in global array, will get increased in med_create_segment
 	Segments.set_count(1);
+	Vertex_segments.invalidate();
 	Cursegp = imsegptridx(segment_first);	// Say current segment is the only segment.
 	Curside = sidenum_t::WBACK;		// The active side is the back side
 	Markedsegp = segment_none;		// Say there is no marked segment.
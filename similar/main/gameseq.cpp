@@ -24,8 +24,14 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
  */
 
 #include "dxxsconf.h"
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <memory>
+#include <system_error>
+#include <thread>
 #include <utility>
+#include <vector>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -86,6 +92,8 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "powerup.h"
 #include "text.h"
 #include "piggy.h"
+#include "physfsx.h"
+#include "byteutil.h"
 #include "mission.h"
 #include "state.h"
 #include "songs.h"
@@ -1029,8 +1037,256 @@ void load_level_robots(const d_fname &level_name)
 }
 #endif
 
-//load a level off disk. level numbers start at 1.  Secret levels are -1,-2,-3
 namespace dsx {
+namespace {
+
+/* The next level is read while the score and briefing screens are
+ * shown, so that LoadLevel does not wait to parse it.  The level file and
+ * the files which replace bitmaps and robots for that level are copied
+ * into memory through PhysFS by the main thread, and a worker thread
+ * parses the level file into a staged_level.  The worker uses neither
+ * PhysFS nor the game state, so it does not race the main thread.  Once
+ * the level is staged, the main thread pages in the bitmaps of its sides
+ * and wall animations a few at a time while it is idle.  LoadLevel takes
+ * the staged level, mounts the copied files ahead of the mission, and
+ * load_level commits the level to the level state on the main thread.
+ */
+class level_preload
+{
+	std::thread worker;
+	d_fname level_name;
+	/* The level file, which the worker owns while it runs */
+	std::vector<uint8_t> file;
+	std::unique_ptr<staged_level> stage;
+	/* Set by the worker once `stage` is ready */
+	std::atomic<bool> staged{false};
+	/* True once the bitmaps of the pig file have been paged out to make
+	 * room for those of the staged level
+	 */
+	bool paging_started = false;
+	/* The replacement files of the level, as a HOG archive */
+	std::vector<uint8_t> replacements;
+	/* The bitmaps of the staged level which are not yet paged in */
+	std::vector<bitmap_index> bitmaps;
+	void run(level_read_tables tables);
+	void read_replacements();
+	void list_bitmaps();
+public:
+	/* What LoadLevel keeps while it loads the level */
+	struct preloaded_level
+	{
+		std::unique_ptr<staged_level> stage;
+		std::vector<uint8_t> replacements;
+		/* Destroyed before `replacements`, which it reads */
+		RAIIPHYSFS_LiteralMount mount;
+		/* The bitmaps of the level are paged in */
+		bool bitmaps_paged_in = false;
+	};
+	~level_preload()
+	{
+		cancel();
+	}
+	void start(const d_fname &name);
+	void cancel();
+	void page_in_bitmaps();
+	preloaded_level take(const d_fname &name);
+};
+
+level_preload next_level_preload;
+
+/* The name of the archive which holds the replacement files */
+constexpr char level_replacements_hog[] = "levelpreload.hog";
+
+void level_preload::start(const d_fname &name)
+{
+	if ((worker.joinable() || stage) && level_name == name)
+		return;
+	cancel();
+	file = read_level_file(name.data());
+	if (file.empty())
+		return;
+	level_name = name;
+	read_replacements();
+	try {
+		worker = std::thread(&level_preload::run, this, get_level_read_tables());
+	} catch (const std::system_error &) {
+		/* Without a worker, LoadLevel reads the level itself. */
+		con_puts(CON_VERBOSE, "Failed to start level preload thread");
+		file = {};
+		replacements = {};
+		level_name.fill(0);
+	}
+}
+
+/* Copy the files which LoadLevel opens by the name of the level into a
+ * HOG archive, under the names which the loaders compute.  The loaders
+ * find nothing in the archive which they would not find without it.
+ */
+void level_preload::read_replacements()
+{
+	const auto add = [this](const std::span<const char, 4> extension) {
+		/* A HOG entry is a name of 13 bytes, the length, and the data. */
+		static_assert(FILENAME_LEN == 13);
+		std::array<char, FILENAME_LEN> filename{};
+		if (!change_filename_extension(filename, level_name.data(), extension))
+			return;
+		const auto fp = PHYSFSX_openReadBuffered(filename.data()).first;
+		if (!fp)
+			return;
+		const auto length = PHYSFS_fileLength(fp);
+		if (length <= 0 || length > UINT32_MAX)
+			return;
+		if (replacements.empty())
+			replacements = {'D', 'H', 'F'};
+		const std::size_t entry = replacements.size();
+		replacements.resize(entry + filename.size() + 4 + length);
+		const auto p = &replacements[entry];
+		std::copy(filename.begin(), filename.end(), p);
+		PUT_INTEL_INT(p + filename.size(), static_cast<uint32_t>(length));
+		if (PHYSFS_read(fp, p + filename.size() + 4, 1, length) != length)
+			replacements.resize(entry);
+	};
+#if defined(DXX_BUILD_DESCENT_I)
+	/* As load_custom_data names them */
+	add("pg1");
+	add("dtx");
+	add("hx1");
+#elif defined(DXX_BUILD_DESCENT_II)
+	/* As load_robot_replacements and load_bitmap_replacements name them */
+	add("HXM");
+	add("POG");
+#endif
+}
+
+void level_preload::cancel()
+{
+	if (worker.joinable())
+		worker.join();
+	stage.reset();
+	staged = false;
+	paging_started = false;
+	replacements = {};
+	bitmaps = {};
+	level_name.fill(0);
+}
+
+/* List the bitmaps which paging_touch_all pages in for the sides and
+ * the wall animations of the staged level, so that they can be paged in
+ * before LoadLevel runs.
+ */
+void level_preload::list_bitmaps()
+{
+	auto &WallAnims = GameSharedState.WallAnims;
+	const auto touch = [this](const texture_index t) {
+		if (t < Textures.size())
+			bitmaps.emplace_back(Textures[t]);
+	};
+	for (const auto &&[ss, us] : zip(stage->mine.shared_segments, stage->mine.unique_segments))
+		for (const auto &&[child, sside, uside] : zip(ss.children, ss.sides, us.sides))
+		{
+			if (IS_CHILD(child) && sside.wall_num == wall_none)
+				continue;
+			touch(get_texture_index(uside.tmap_num));
+			if (uside.tmap_num2 != texture2_value::None)
+				touch(get_texture_index(uside.tmap_num2));
+		}
+	for (const auto &w : stage->game_data.walls)
+		if (w.clip_num > -1 && static_cast<unsigned>(w.clip_num) < Num_wall_anims)
+		{
+			const auto &anim = WallAnims[w.clip_num];
+			for (const auto j : partial_const_range(anim.frames, std::min<std::size_t>(anim.num_frames, anim.frames.size())))
+				touch(j);
+		}
+	std::sort(bitmaps.begin(), bitmaps.end());
+	bitmaps.erase(std::unique(bitmaps.begin(), bitmaps.end()), bitmaps.end());
+}
+
+void level_preload::page_in_bitmaps()
+{
+	if (!staged.load(std::memory_order_acquire))
+		return;
+	if (worker.joinable())
+	{
+		worker.join();
+		if (!stage)
+			return;
+#if defined(DXX_BUILD_DESCENT_II)
+		/* If the level uses another pig file, load_palette replaces
+		 * every bitmap, so there is nothing to do until then.
+		 */
+		if (d_stricmp(last_palette_loaded_pig, stage->palette))
+			return;
+#endif
+		list_bitmaps();
+		/* As piggy_load_level_data would, drop the bitmaps of the level
+		 * which has ended, so that the cache has room for this one.
+		 */
+		piggy_bitmap_page_out_all();
+		paging_started = true;
+	}
+	/* Each page in reads one bitmap from the pig file.  A few per idle
+	 * event leave the screen responsive.
+	 */
+	for (unsigned n = 16; n && !bitmaps.empty(); --n)
+	{
+		PIGGY_PAGE_IN(bitmaps.back());
+		bitmaps.pop_back();
+	}
+}
+
+level_preload::preloaded_level level_preload::take(const d_fname &name)
+{
+	preloaded_level r;
+	if (worker.joinable())
+		worker.join();
+	if (level_name == name)
+	{
+		r.stage = std::move(stage);
+		r.bitmaps_paged_in = paging_started;
+		if (!replacements.empty())
+		{
+			r.replacements = std::move(replacements);
+			if (PHYSFS_mountMemory(r.replacements.data(), r.replacements.size(), nullptr, level_replacements_hog, nullptr, 0))
+				r.mount.reset(level_replacements_hog);
+		}
+	}
+	cancel();
+	return r;
+}
+
+void level_preload::run(const level_read_tables tables)
+{
+	try {
+		stage = stage_level(file, level_name.data(), tables);
+	} catch (const std::exception &) {
+		/* load_level reads the level itself, and reports what is wrong
+		 * with it.
+		 */
+	}
+	file = {};
+	staged.store(true, std::memory_order_release);
+}
+
+}
+
+void preload_level(const int level_num)
+{
+	if (level_num > Current_mission->last_level || level_num < Current_mission->last_secret_level || level_num == 0)
+		return;
+	next_level_preload.start(get_level_file(level_num));
+}
+
+void cancel_level_preload()
+{
+	next_level_preload.cancel();
+}
+
+void page_in_preloaded_level()
+{
+	next_level_preload.page_in_bitmaps();
+}
+
+//load a level off disk. level numbers start at 1.  Secret levels are -1,-2,-3
 void LoadLevel(int level_num,int page_in_textures)
 {
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
@@ -1045,8 +1301,9 @@ void LoadLevel(int level_num,int page_in_textures)
 
 	assert(level_num <= Current_mission->last_level && level_num >= Current_mission->last_secret_level && level_num != 0);
 	const d_fname &level_name = get_level_file(level_num);
+	const auto preloaded = next_level_preload.take(level_name);
 #if defined(DXX_BUILD_DESCENT_I)
-	if (!load_level(level_name))
+	if (!load_level(level_name, preloaded.stage.get()))
 		Current_level_num=level_num;
 
 	gr_use_palette_table( "palette.256" );
@@ -1057,7 +1314,7 @@ void LoadLevel(int level_num,int page_in_textures)
 	load_level_robots(level_name);
 
 	auto &LevelSharedDestructibleLightState = LevelSharedSegmentState.DestructibleLights;
-	int load_ret = load_level(LevelSharedDestructibleLightState, level_name);		//actually load the data from disk!
+	int load_ret = load_level(LevelSharedDestructibleLightState, level_name, preloaded.stage.get());		//actually load the data from disk!
 
 	if (load_ret)
 		Error("Could not load level file <%s>, error = %d",static_cast<const char *>(level_name),load_ret);
@@ -1089,7 +1346,7 @@ void LoadLevel(int level_num,int page_in_textures)
 		load_bitmap_replacements(level_name);
 
 	if ( page_in_textures )
-		piggy_load_level_data();
+		piggy_load_level_data(preloaded.bitmaps_paged_in);
 #endif
 
 	my_segments_checksum = netmisc_calc_checksum();
@@ -1109,7 +1366,7 @@ void LoadLevel(int level_num,int page_in_textures)
 	gr_palette_load(gr_palette);		//actually load the palette
 #if defined(DXX_BUILD_DESCENT_I)
 	if ( page_in_textures )
-		piggy_load_level_data();
+		piggy_load_level_data(preloaded.bitmaps_paged_in);
 #endif
 
 	gameseq_init_network_players(LevelSharedRobotInfoState.Robot_info, Objects);
@@ -1793,6 +2050,14 @@ static window_event_result (AdvanceLevel)(
 #endif
 	if (Current_level_num != Current_mission->last_level)
 	{
+		/* Read the next level while the scores are shown.  If the level
+		 * actually started differs, LoadLevel discards this.
+		 */
+#if defined(DXX_BUILD_DESCENT_I)
+		preload_level(find_next_level(secret_flag, Current_level_num, *Current_mission.get()));
+#elif defined(DXX_BUILD_DESCENT_II)
+		preload_level(Current_level_num < 0 && EMULATING_D1 ? Entered_from_level + 1 : Current_level_num + 1);
+#endif
 		if (Game_mode & GM_MULTI)
 		{
 			const auto result = multi_endlevel_score();
@@ -2205,6 +2470,7 @@ window_event_result StartNewLevel(int level_num)
 	/* Autosave is permitted immediately on entering a new level */
 	state_set_immediate_autosave(GameUniqueState);
 	ThisLevelTime = {};
+	preload_level(level_num);
 
 #if defined(DXX_BUILD_DESCENT_I)
 	if (!(Game_mode & GM_MULTI)) {
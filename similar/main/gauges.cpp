@@ -62,7 +62,9 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "vclip.h"
 #include "compiler-range_for.h"
 #include "d_levelstate.h"
+#include "d_zip.h"
 #include "partial_range.h"
+#include <chrono>
 #include <utility>
 
 using std::min;
@@ -395,6 +397,23 @@ enum class weapon_box_state : uint8_t
 };
 static_assert(static_cast<unsigned>(weapon_box_state::set) == 0, "weapon_box_states must start at zero");
 
+/* The weapon a weapon box shows in one frame.  Between fading out one
+ * weapon and fading in the next, a box may show no weapon.
+ */
+struct weapon_box_image
+{
+	weapon_index weapon;
+	laser_level level{};
+	bool shown = false;
+};
+
+struct weapon_box_frame
+{
+	weapon_box_image image;
+	/* The ammunition count shown in the box, or -1 if none */
+	int ammo = -1;
+};
+
 #if DXX_USE_OGL
 template <char tag>
 class hud_scale_float;
@@ -1329,6 +1348,13 @@ namespace dsx {
 
 namespace {
 
+static void format_bomb_count(char (&txt)[5], const int count)
+{
+	snprintf(txt, sizeof(txt), "B:%02d", count);
+	//convert to wide '1'
+	std::replace(&txt[2], &txt[4], '1', '\x84');
+}
+
 static void show_bomb_count(grs_canvas &canvas, const player_info &player_info, const int x, const int y, const int bg_color, const int always_show, const int right_align)
 {
 #if defined(DXX_BUILD_DESCENT_I)
@@ -1353,9 +1379,7 @@ static void show_bomb_count(grs_canvas &canvas, const player_info &player_info,
 		bg_color);
 
 	char txt[5];
-	snprintf(txt, sizeof(txt), "B:%02d", count);
-	//convert to wide '1'
-	std::replace(&txt[2], &txt[4], '1', '\x84');
+	format_bomb_count(txt, count);
 
 	const auto &&[w, h] = gr_get_string_size(*canvas.cv_font, txt);
 	gr_string(canvas, *canvas.cv_font, right_align ? x - w : x, y, txt, w, h);
@@ -2177,9 +2201,8 @@ static void cockpit_decode_alpha(const hud_draw_context_mr hudctx, grs_bitmap *c
 
 namespace dsx {
 namespace {
-static void draw_wbu_overlay(const hud_draw_context_hs_mr hudctx)
+static grs_bitmap &get_cockpit_bitmap([[maybe_unused]] const local_multires_gauge_graphic multires_gauge_graphic)
 {
-	auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
 	const auto raw_cockpit_mode = PlayerCfg.CockpitMode[1];
 	const auto cockpit_idx =
 #if defined(DXX_BUILD_DESCENT_II)
@@ -2190,9 +2213,13 @@ static void draw_wbu_overlay(const hud_draw_context_hs_mr hudctx)
 		raw_cockpit_mode;
 	const auto cb = cockpit_bitmap[cockpit_idx];
 	PIGGY_PAGE_IN(cb);
-	grs_bitmap *const bm = &GameBitmaps[cb];
+	return GameBitmaps[cb];
+}
 
-	cockpit_decode_alpha(hudctx, bm);
+static void draw_wbu_overlay(const hud_draw_context_hs_mr hudctx)
+{
+	auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
+	cockpit_decode_alpha(hudctx, &get_cockpit_bitmap(multires_gauge_graphic));
 
 	/* The code that rendered the inset windows drew simple square
 	 * boxes, which partially overwrote the frame surrounding the inset
@@ -2213,11 +2240,47 @@ void close_gauges()
 	WinBoxOverlay = {};
 }
 
+#if defined(DXX_BUILD_DESCENT_II)
+namespace dsx {
+namespace {
+
+/* The most recent image rendered for an inset window.  It is shown again
+ * until the next render is due, which is every -insetinterval frames, or
+ * at once if the window starts showing something else.
+ */
+struct inset_view_cache
+{
+	const object *viewer = nullptr;
+	int rear_view_flag = 0;
+	weapon_box_user user = weapon_box_user::weapon;
+	uint16_t w = 0, h = 0;
+	bool valid = false;
+	unsigned frames_since_render = 0;
+#if DXX_USE_OGL
+	ogl_canvas_capture image;
+#else
+	grs_canvas_ptr image;
+#endif
+	/* For -renderstats */
+	std::chrono::steady_clock::duration render_cost{};
+	unsigned frames = 0, renders = 0;
+};
+
+enumerated_array<inset_view_cache, 2, gauge_inset_window_view> Inset_view_cache;
+
+}
+}
+#endif
+
 namespace dsx {
 void init_gauges()
 {
 	inset_window[gauge_inset_window_view::primary] = {};
 	inset_window[gauge_inset_window_view::secondary] = {};
+#if defined(DXX_BUILD_DESCENT_II)
+	for (auto &cache : Inset_view_cache)
+		cache.valid = false;
+#endif
 	old_laser_level	= {};
 }
 }
@@ -2435,17 +2498,33 @@ static void draw_shield_bar(const hud_draw_context_hs_mr hudctx, const int shiel
 	hud_gauge_bitblt(hudctx, SHIELD_GAUGE_X, SHIELD_GAUGE_Y, GAUGE_SHIELDS + 9 - bm_num);
 }
 
-static void show_cockpit_cloak_invul_timer(grs_canvas &canvas, const fix64 effect_end, const int y)
+/* The text of a cloak or invulnerability timer, centered over the ship
+ * gauge.
+ */
+struct cockpit_timer_text
 {
 	char countdown[8];
-	snprintf(countdown, sizeof(countdown), "%lu", static_cast<unsigned long>(effect_end / F1_0));
+	int x;
+	unsigned w, h;
+	cockpit_timer_text(const grs_font &font, const fix64 effect_end)
+	{
+		snprintf(countdown, sizeof(countdown), "%lu", static_cast<unsigned long>(effect_end / F1_0));
+		const auto &&[ow, oh] = gr_get_string_size(font, countdown);
+		const int center = grd_curscreen->get_screen_width() / (PlayerCfg.CockpitMode[1] == cockpit_mode_t::status_bar
+			? 2.266
+			: 1.951
+		);
+		x = center - (ow / 2);
+		w = ow;
+		h = oh;
+	}
+};
+
+static void show_cockpit_cloak_invul_timer(grs_canvas &canvas, const fix64 effect_end, const int y)
+{
+	const cockpit_timer_text t(*canvas.cv_font, effect_end);
 	gr_set_fontcolor(canvas, BM_XRGB(31, 31, 31), -1);
-	const auto &&[ow, oh] = gr_get_string_size(*canvas.cv_font, countdown);
-	const int x = grd_curscreen->get_screen_width() / (PlayerCfg.CockpitMode[1] == cockpit_mode_t::status_bar
-		? 2.266
-		: 1.951
-	);
-	gr_string(canvas, *canvas.cv_font, x - (ow / 2), y, countdown, ow, oh);
+	gr_string(canvas, *canvas.cv_font, t.x, y, t.countdown, t.w, t.h);
 }
 
 }
@@ -2456,7 +2535,10 @@ namespace dsx {
 
 namespace {
 
-static void draw_player_ship(const hud_draw_context_hs_mr hudctx, const player_info &player_info, const int cloak_state, const int x, const int y)
+/* Advance the fade of the ship gauge while cloaked, and return the fade
+ * level to draw it with.
+ */
+static int8_t update_cloak_fade(const player_info &player_info, const int cloak_state)
 {
 	static fix cloak_fade_timer=0;
 	static int8_t cloak_fade_value = GR_FADE_LEVELS - 1;
@@ -2505,7 +2587,11 @@ static void draw_player_ship(const hud_draw_context_hs_mr hudctx, const player_i
 		cloak_fade_timer = 0;
 		cloak_fade_value = GR_FADE_LEVELS-1;
 	}
+	return cloak_fade_value;
+}
 
+static void draw_player_ship(const hud_draw_context_hs_mr hudctx, const player_info &player_info, const int8_t cloak_fade_value, const int x, const int y)
+{
 	const auto color = get_player_or_team_color(Player_num);
 #if defined(DXX_BUILD_DESCENT_II)
 	auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
@@ -2758,11 +2844,10 @@ static void draw_secondary_ammo_info(const hud_draw_context_hs_mr hudctx, const
 	draw_ammo_info(hudctx.canvas, hudctx.xscale(x), hudctx.yscale(y), ammo_count);
 }
 
-static void draw_weapon_box(const hud_draw_context_hs_mr hudctx, const player_info &player_info, const weapon_index weapon_num, const gauge_inset_window_view wt)
+//	Advances the fade between weapons in a weapon box, and returns the
+//	weapon it shows this frame.
+static weapon_box_image update_weapon_box(const player_info &player_info, const weapon_index weapon_num, const gauge_inset_window_view wt)
 {
-	auto &canvas = hudctx.canvas;
-	gr_set_curfont(canvas, *GAME_FONT);
-
 	const auto laser_level_changed = (wt == gauge_inset_window_view::primary && weapon_num.primary == primary_weapon_index_t::LASER_INDEX && (player_info.laser_level != old_laser_level));
 
 	auto &inset = inset_window[wt];
@@ -2772,17 +2857,15 @@ static void draw_weapon_box(const hud_draw_context_hs_mr hudctx, const player_in
 		inset.fade_value = i2f(GR_FADE_LEVELS - 1);
 	}
 
-	const local_multires_gauge_graphic multires_gauge_graphic{};
 	if (inset.old_weapon == weapon_index{})
 	{
-		draw_weapon_info(hudctx, player_info, weapon_num, player_info.laser_level, wt);
 		inset.old_weapon = weapon_num;
 		inset.box_state = weapon_box_state::set;
 	}
 
 	if (inset.box_state == weapon_box_state::fading_out)
 	{
-		draw_weapon_info(hudctx, player_info, inset.old_weapon, old_laser_level, wt);
+		const weapon_box_image image{inset.old_weapon, old_laser_level, true};
 		inset.fade_value -= FrameTime * FADE_SCALE;
 		if (inset.fade_value <= 0)
 		{
@@ -2791,29 +2874,37 @@ static void draw_weapon_box(const hud_draw_context_hs_mr hudctx, const player_in
 			inset.old_weapon = weapon_num;
 			old_laser_level = player_info.laser_level;
 		}
+		return image;
 	}
 	else if (inset.box_state == weapon_box_state::fading_in)
 	{
 		if (weapon_num != inset.old_weapon) {
 			inset.box_state = weapon_box_state::fading_out;
+			return {};
 		}
-		else {
-			draw_weapon_info(hudctx, player_info, weapon_num, player_info.laser_level, wt);
-			inset.fade_value += FrameTime * FADE_SCALE;
-			if (inset.fade_value >= i2f(GR_FADE_LEVELS - 1))
-			{
-				inset.old_weapon = {};
-				inset.box_state = weapon_box_state::set;
-			}
+		inset.fade_value += FrameTime * FADE_SCALE;
+		if (inset.fade_value >= i2f(GR_FADE_LEVELS - 1))
+		{
+			inset.old_weapon = {};
+			inset.box_state = weapon_box_state::set;
 		}
-	} else
-	{
-		draw_weapon_info(hudctx, player_info, weapon_num, player_info.laser_level, wt);
-		inset.old_weapon = weapon_num;
-		old_laser_level = player_info.laser_level;
+		return {weapon_num, player_info.laser_level, true};
 	}
+	inset.old_weapon = weapon_num;
+	old_laser_level = player_info.laser_level;
+	return {weapon_num, player_info.laser_level, true};
+}
+
+static void draw_weapon_box(const hud_draw_context_hs_mr hudctx, const player_info &player_info, const weapon_box_image image, const gauge_inset_window_view wt)
+{
+	auto &canvas = hudctx.canvas;
+	gr_set_curfont(canvas, *GAME_FONT);
 
-	if (inset.box_state != weapon_box_state::set)		//fade gauge
+	const local_multires_gauge_graphic multires_gauge_graphic{};
+	if (image.shown)
+		draw_weapon_info(hudctx, player_info, image.weapon, image.level, wt);
+
+	if (inset_window[wt].box_state != weapon_box_state::set)		//fade gauge
 	{
 		int fade_value = f2i(inset_window[wt].fade_value);
 
@@ -2877,39 +2968,52 @@ static void draw_static(const d_vclip_array &Vclip, const hud_draw_context_hs_mr
 }
 #endif
 
-static void draw_weapon_box0(const hud_draw_context_hs_mr hudctx, const player_info &player_info)
+static weapon_box_frame update_weapon_box0(const player_info &player_info)
 {
+	weapon_box_frame f;
 #if defined(DXX_BUILD_DESCENT_II)
-	const auto user = inset_window[gauge_inset_window_view::primary].user;
-	if (user == weapon_box_user::weapon)
+	if (inset_window[gauge_inset_window_view::primary].user != weapon_box_user::weapon)
+		return f;
 #endif
-	{
-		const auto Primary_weapon = player_info.Primary_weapon;
-		draw_weapon_box(hudctx, player_info, Primary_weapon.get_active(), gauge_inset_window_view::primary);
+	const auto Primary_weapon = player_info.Primary_weapon;
+	f.image = update_weapon_box(player_info, Primary_weapon.get_active(), gauge_inset_window_view::primary);
 
-		if (inset_window[gauge_inset_window_view::primary].box_state == weapon_box_state::set)
+	if (inset_window[gauge_inset_window_view::primary].box_state == weapon_box_state::set)
+	{
+		unsigned nd_ammo;
+		unsigned ammo_count;
+		if (weapon_index_uses_vulcan_ammo(Primary_weapon))
 		{
-			unsigned nd_ammo;
-			unsigned ammo_count;
-			if (weapon_index_uses_vulcan_ammo(Primary_weapon))
-			{
-				nd_ammo = player_info.vulcan_ammo;
-				ammo_count = vulcan_ammo_scale(nd_ammo);
-			}
+			nd_ammo = player_info.vulcan_ammo;
+			ammo_count = vulcan_ammo_scale(nd_ammo);
+		}
 #if defined(DXX_BUILD_DESCENT_II)
-			else if (Primary_weapon == primary_weapon_index_t::OMEGA_INDEX)
-			{
-				auto &Omega_charge = player_info.Omega_charge;
-				nd_ammo = Omega_charge;
-				ammo_count = Omega_charge * 100/MAX_OMEGA_CHARGE;
-			}
-#endif
-			else
-				return;
-			if (Newdemo_state == ND_STATE_RECORDING)
-				newdemo_record_primary_ammo(nd_ammo);
-			draw_primary_ammo_info(hudctx, ammo_count);
+		else if (Primary_weapon == primary_weapon_index_t::OMEGA_INDEX)
+		{
+			auto &Omega_charge = player_info.Omega_charge;
+			nd_ammo = Omega_charge;
+			ammo_count = Omega_charge * 100/MAX_OMEGA_CHARGE;
 		}
+#endif
+		else
+			return f;
+		if (Newdemo_state == ND_STATE_RECORDING)
+			newdemo_record_primary_ammo(nd_ammo);
+		f.ammo = ammo_count;
+	}
+	return f;
+}
+
+static void draw_weapon_box0(const hud_draw_context_hs_mr hudctx, const player_info &player_info, const weapon_box_frame &f)
+{
+#if defined(DXX_BUILD_DESCENT_II)
+	const auto user = inset_window[gauge_inset_window_view::primary].user;
+	if (user == weapon_box_user::weapon)
+#endif
+	{
+		draw_weapon_box(hudctx, player_info, f.image, gauge_inset_window_view::primary);
+		if (f.ammo >= 0)
+			draw_primary_ammo_info(hudctx, f.ammo);
 	}
 #if defined(DXX_BUILD_DESCENT_II)
 	else if (user == weapon_box_user::post_missile_static)
@@ -2917,32 +3021,46 @@ static void draw_weapon_box0(const hud_draw_context_hs_mr hudctx, const player_i
 #endif
 }
 
-static void draw_weapon_box1(const hud_draw_context_hs_mr hudctx, const player_info &player_info)
+static weapon_box_frame update_weapon_box1(const player_info &player_info)
 {
+	weapon_box_frame f;
 #if defined(DXX_BUILD_DESCENT_II)
-	if (inset_window[gauge_inset_window_view::secondary].user == weapon_box_user::weapon)
+	if (inset_window[gauge_inset_window_view::secondary].user != weapon_box_user::weapon)
+		return f;
 #endif
+	auto &Secondary_weapon = player_info.Secondary_weapon;
+	f.image = update_weapon_box(player_info, Secondary_weapon.get_active(), gauge_inset_window_view::secondary);
+	if (inset_window[gauge_inset_window_view::secondary].box_state == weapon_box_state::set)
 	{
-		auto &Secondary_weapon = player_info.Secondary_weapon;
-		draw_weapon_box(hudctx, player_info, Secondary_weapon.get_active(), gauge_inset_window_view::secondary);
-		if (inset_window[gauge_inset_window_view::secondary].box_state == weapon_box_state::set)
-		{
-			const auto ammo = player_info.secondary_ammo[Secondary_weapon];
-			if (Newdemo_state == ND_STATE_RECORDING)
-				newdemo_record_secondary_ammo(ammo);
-			draw_secondary_ammo_info(hudctx, ammo);
-		}
+		const auto ammo = player_info.secondary_ammo[Secondary_weapon];
+		if (Newdemo_state == ND_STATE_RECORDING)
+			newdemo_record_secondary_ammo(ammo);
+		f.ammo = ammo;
+	}
+	return f;
+}
+
+static void draw_weapon_box1(const hud_draw_context_hs_mr hudctx, const player_info &player_info, const weapon_box_frame &f)
+{
+#if defined(DXX_BUILD_DESCENT_II)
+	const auto user = inset_window[gauge_inset_window_view::secondary].user;
+	if (user == weapon_box_user::weapon)
+#endif
+	{
+		draw_weapon_box(hudctx, player_info, f.image, gauge_inset_window_view::secondary);
+		if (f.ammo >= 0)
+			draw_secondary_ammo_info(hudctx, f.ammo);
 	}
 #if defined(DXX_BUILD_DESCENT_II)
-	else if (inset_window[gauge_inset_window_view::secondary].user == weapon_box_user::post_missile_static)
+	else if (user == weapon_box_user::post_missile_static)
 		draw_static(Vclip, hudctx, gauge_inset_window_view::secondary);
 #endif
 }
 
 static void draw_weapon_boxes(const hud_draw_context_hs_mr hudctx, const player_info &player_info)
 {
-	draw_weapon_box0(hudctx, player_info);
-	draw_weapon_box1(hudctx, player_info);
+	draw_weapon_box0(hudctx, player_info, update_weapon_box0(player_info));
+	draw_weapon_box1(hudctx, player_info, update_weapon_box1(player_info));
 }
 
 static void sb_draw_energy_bar(const hud_draw_context_hs_mr hudctx, const unsigned energy)
@@ -3045,24 +3163,35 @@ void draw_keys_state::draw_all_statusbar_keys()
 	draw_one_key(SB_GAUGE_KEYS_X, SB_GAUGE_RED_KEY_Y, SB_GAUGE_RED_KEY, PLAYER_FLAGS_RED_KEY);
 }
 
+//	Advances the invulnerable ship animation.  Returns the frame to draw, or
+//	-1 if the shield gauge shows instead, as it does while flashing before
+//	invulnerability runs out.
+static int update_invulnerable_ship(const player_info &player_info)
+{
+	const auto t = player_info.invulnerable_time;
+	if (!(t + INVULNERABLE_TIME_MAX - GameTime64 > F1_0*4 || GameTime64 & 0x8000))
+		return -1;
+	static fix time;
+	auto ltime = time + FrameTime;
+	const auto old_invulnerable_frame = invulnerable_frame;
+	while (ltime > INV_FRAME_TIME)
+	{
+		ltime -= INV_FRAME_TIME;
+		if (++invulnerable_frame == N_INVULNERABLE_FRAMES)
+			invulnerable_frame=0;
+	}
+	time = ltime;
+	return old_invulnerable_frame;
+}
+
 //	Draws invulnerable ship, or maybe the flashing ship, depending on invulnerability time left.
-static void draw_invulnerable_ship(const hud_draw_context_hs_mr hudctx, const object &plrobj)
+static void draw_invulnerable_ship(const hud_draw_context_hs_mr hudctx, const object &plrobj, const int frame)
 {
 	auto &player_info = plrobj.ctype.player_info;
 	const auto cmmode = PlayerCfg.CockpitMode[1];
 	const auto t = player_info.invulnerable_time;
-	if (t + INVULNERABLE_TIME_MAX - GameTime64 > F1_0*4 || GameTime64 & 0x8000)
+	if (frame >= 0)
 	{
-		static fix time;
-		auto ltime = time + FrameTime;
-		const auto old_invulnerable_frame = invulnerable_frame;
-		while (ltime > INV_FRAME_TIME)
-		{
-			ltime -= INV_FRAME_TIME;
-			if (++invulnerable_frame == N_INVULNERABLE_FRAMES)
-				invulnerable_frame=0;
-		}
-		time = ltime;
 		unsigned x, y;
 		auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
 		if (cmmode == cockpit_mode_t::status_bar)
@@ -3075,7 +3204,7 @@ static void draw_invulnerable_ship(const hud_draw_context_hs_mr hudctx, const ob
 			x = SHIELD_GAUGE_X;
 			y = SHIELD_GAUGE_Y;
 		}
-		hud_gauge_bitblt(hudctx, x, y, GAUGE_INVULNERABLE + old_invulnerable_frame);
+		hud_gauge_bitblt(hudctx, x, y, GAUGE_INVULNERABLE + frame);
 
                 // Show Invulnerability Timer if enabled
 		if (show_cloak_invul_timer())
@@ -3811,6 +3940,349 @@ void draw_hud(const d_robot_info_array &Robot_info, grs_canvas &canvas, const ob
 	}
 }
 
+#if !DXX_USE_OGL
+namespace {
+
+/* In full cockpit mode, the software renderer keeps the cockpit of the
+ * previous frame on the canvas when nothing else drew over it (see
+ * update_cockpits), and redraws only the gauges whose inputs changed.
+ * Each gauge remembers the inputs it was last drawn with and the area of
+ * the screen it covers.  Gauges are drawn with transparency and
+ * blending, so the cockpit bitmap is restored under a gauge before it is
+ * drawn again.
+ */
+enum class cockpit_gauge : uint8_t
+{
+	primary_box,
+	secondary_box,
+	energy,
+	afterburner,
+	bomb_count,
+	ship,
+	shield,
+	numerical,
+	keys,
+	homing_warning,
+};
+
+constexpr std::size_t cockpit_gauge_count = static_cast<std::size_t>(cockpit_gauge::homing_warning) + 1;
+
+/* Right and bottom are exclusive. */
+struct cockpit_gauge_area
+{
+	int left = 0, top = 0, right = 0, bottom = 0;
+	constexpr bool operator==(const cockpit_gauge_area &) const = default;
+	bool overlaps(const cockpit_gauge_area &a) const
+	{
+		return left < a.right && a.left < right && top < a.bottom && a.top < bottom;
+	}
+	cockpit_gauge_area operator|(const cockpit_gauge_area &a) const
+	{
+		if (left == right)
+			return a;
+		if (a.left == a.right)
+			return *this;
+		return {std::min(left, a.left), std::min(top, a.top), std::max(right, a.right), std::max(bottom, a.bottom)};
+	}
+	cockpit_gauge_area grow(const int n) const
+	{
+		return {left - n, top - n, right + n, bottom + n};
+	}
+};
+
+using cockpit_gauge_key = std::array<int, 8>;
+
+struct cockpit_gauge_state
+{
+	cockpit_gauge_key key{};
+	cockpit_gauge_area area, restore_area;
+	bool drawn = false;
+	bool redraw = true;
+};
+
+class cockpit_gauge_tracker
+{
+	enumerated_array<cockpit_gauge_state, cockpit_gauge_count, cockpit_gauge> gauges;
+public:
+	/* Rows at the top of the screen which update_cockpits redrew from
+	 * the cockpit bitmap this frame, or -1 if it drew the whole cockpit.
+	 */
+	int redrawn_height = -1;
+	/* Record what gauge `g` shows this frame.  A gauge which cannot
+	 * describe its inputs passes `always`.
+	 */
+	void note(const cockpit_gauge g, const cockpit_gauge_key &key, const cockpit_gauge_area &area, const bool always = false)
+	{
+		auto &s = gauges[g];
+		s.redraw = always || redrawn_height < 0 || !s.drawn || s.key != key || s.area != area || area.top < redrawn_height;
+		s.restore_area = s.drawn ? s.area | area : area;
+		s.key = key;
+		s.area = area;
+		s.drawn = true;
+	}
+	bool redraw(const cockpit_gauge g) const
+	{
+		return gauges[g].redraw;
+	}
+	void restore(grs_canvas &canvas, const grs_bitmap &cockpit);
+};
+
+static cockpit_gauge_tracker Cockpit_gauges;
+
+void cockpit_gauge_tracker::restore(grs_canvas &canvas, const grs_bitmap &cockpit)
+{
+	if (redrawn_height < 0)
+		return;
+	/* Restoring the cockpit under one gauge erases any gauge which
+	 * overlaps it, so that gauge must be restored and redrawn too.
+	 */
+	for (bool changed = true; changed;)
+	{
+		changed = false;
+		for (auto &a : gauges)
+		{
+			if (!a.redraw)
+				continue;
+			for (auto &b : gauges)
+				if (!b.redraw && a.restore_area.overlaps(b.area))
+				{
+					b.redraw = true;
+					b.restore_area = b.area;
+					changed = true;
+				}
+		}
+	}
+	const cockpit_gauge_area screen{0, 0, canvas.cv_bitmap.bm_w, canvas.cv_bitmap.bm_h};
+	for (auto &s : gauges)
+	{
+		if (!s.redraw)
+			continue;
+		const auto &r = s.restore_area;
+		const int left = std::max(r.left, screen.left), top = std::max(r.top, screen.top);
+		const int right = std::min(r.right, screen.right), bottom = std::min(r.bottom, screen.bottom);
+		if (left >= right || top >= bottom)
+			continue;
+		grs_subcanvas area;
+		gr_init_sub_canvas(area, canvas, left, top, right - left, bottom - top);
+		/* gr_bitmapm clips the part of the bitmap above and to the left
+		 * of the canvas.
+		 */
+		gr_bitmapm(area, static_cast<unsigned>(-left), static_cast<unsigned>(-top), cockpit);
+		gr_flip_dirty_rect(left, top, right - left, bottom - top);
+	}
+}
+
+static cockpit_gauge_area gauge_bitmap_area(const hud_draw_context_hs_mr hudctx, const int x, const int y, const unsigned gauge)
+{
+#if defined(DXX_BUILD_DESCENT_II)
+	auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
+#else
+	(void)hudctx;
+#endif
+	auto &bm = GameBitmaps[GET_GAUGE_INDEX(gauge)];
+	return {x, y, x + bm.bm_w, y + bm.bm_h};
+}
+
+static cockpit_gauge_area text_area(const grs_font &font, const char *const text, const int x, const int y)
+{
+	const auto &&[w, h] = gr_get_string_size(font, text);
+	return {x, y, x + static_cast<int>(w), y + static_cast<int>(h)};
+}
+
+static cockpit_gauge_area cockpit_timer_area(const grs_font &font, const fix64 effect_end, const int y)
+{
+	const cockpit_timer_text t(font, effect_end);
+	return {t.x, y, t.x + static_cast<int>(t.w), y + static_cast<int>(t.h)};
+}
+
+static cockpit_gauge_area weapon_box_area(const hud_draw_context_hs_mr hudctx, const gauge_inset_window_view wt)
+{
+	auto &box = gauge_boxes[hudctx.multires_gauge_graphic.hiresmode][wt][gauge_hud_type::cockpit];
+	/* draw_weapon_info_sub clears one row more in Descent 1 */
+	const cockpit_gauge_area a{box.left, box.top, box.right + 1, box.bot + 2};
+	/* draw_wbu_overlay puts back the frame around the box */
+	if (auto &overlay = WinBoxOverlay[static_cast<unsigned>(wt)])
+	{
+		auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
+		const int x = (wt == gauge_inset_window_view::primary ? PRIMARY_W_BOX_LEFT : SECONDARY_W_BOX_LEFT) - 2;
+		const int y = (wt == gauge_inset_window_view::primary ? PRIMARY_W_BOX_TOP : SECONDARY_W_BOX_TOP) - 2;
+		return a | cockpit_gauge_area{x, y, x + overlay->bm_w, y + overlay->bm_h};
+	}
+	return a;
+}
+
+static void note_weapon_box(const hud_draw_context_hs_mr hudctx, const player_info &player_info, const weapon_box_frame &f, const gauge_inset_window_view wt, const cockpit_gauge g)
+{
+	auto &inset = inset_window[wt];
+#if defined(DXX_BUILD_DESCENT_II)
+	/* Static and inset views change the box every frame. */
+	const bool always = inset.user != weapon_box_user::weapon || PlayerCfg.HudMode != HudType::Standard;
+	const int user = static_cast<int>(inset.user);
+#else
+	const bool always = PlayerCfg.HudMode != HudType::Standard;
+	const int user = 0;
+#endif
+	Cockpit_gauges.note(g, {{
+		user,
+		static_cast<int>(f.image.weapon.primary),
+		static_cast<int>(f.image.level),
+		f.image.shown,
+		inset.box_state == weapon_box_state::set ? -1 : f2i(inset.fade_value),
+		f.ammo,
+		!!(player_info.powerup_flags & PLAYER_FLAGS_QUAD_LASERS),
+	}}, weapon_box_area(hudctx, wt), always);
+}
+
+static cockpit_gauge_area numerical_display_area(const hud_draw_context_hs_mr hudctx, const int shield, const int energy)
+{
+	auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
+	auto &game_font = *GAME_FONT;
+	const int xb = grd_curscreen->get_screen_width() / 1.951;
+	const auto screen_height = grd_curscreen->get_screen_height();
+	const auto a = [&game_font, xb](const int v, const int y) {
+		const auto w = gr_get_string_size(game_font, get_gauge_width_string(v)).width;
+		char text[12];
+		snprintf(text, sizeof(text), "%d", v);
+		return text_area(game_font, text, xb - (w / 2), y);
+	};
+	return gauge_bitmap_area(hudctx, NUMERICAL_GAUGE_X, NUMERICAL_GAUGE_Y, GAUGE_NUMERICAL) |
+		a(shield, screen_height / 1.365) |
+		a(energy, screen_height / 1.5);
+}
+
+static void render_cockpit_gauges(const hud_draw_context_hs_mr hudctx, const object &plrobj, const int energy, const int shields)
+{
+	auto &player_info = plrobj.ctype.player_info;
+	auto &multires_gauge_graphic = hudctx.multires_gauge_graphic;
+	auto &canvas = hudctx.canvas;
+	auto &t = Cockpit_gauges;
+
+	const auto box0 = update_weapon_box0(player_info);
+	const auto box1 = update_weapon_box1(player_info);
+	note_weapon_box(hudctx, player_info, box0, gauge_inset_window_view::primary, cockpit_gauge::primary_box);
+	note_weapon_box(hudctx, player_info, box1, gauge_inset_window_view::secondary, cockpit_gauge::secondary_box);
+
+	if (Newdemo_state == ND_STATE_RECORDING)
+		newdemo_record_player_energy(energy);
+	/* The bars start a pixel to the left of the gauge bitmap. */
+	t.note(cockpit_gauge::energy, {{energy}}, (
+		gauge_bitmap_area(hudctx, LEFT_ENERGY_GAUGE_X, LEFT_ENERGY_GAUGE_Y, GAUGE_ENERGY_LEFT) |
+		gauge_bitmap_area(hudctx, RIGHT_ENERGY_GAUGE_X, RIGHT_ENERGY_GAUGE_Y, GAUGE_ENERGY_RIGHT)
+	).grow(1));
+#if defined(DXX_BUILD_DESCENT_I)
+	const bool show_bombs = PlayerCfg.HudMode == HudType::Standard && PlayerCfg.BombGauge;
+#elif defined(DXX_BUILD_DESCENT_II)
+	if (Newdemo_state==ND_STATE_RECORDING )
+		newdemo_record_player_afterburner(Afterburner_charge);
+	t.note(cockpit_gauge::afterburner, {{fixmul(f1_0 - Afterburner_charge, AFTERBURNER_GAUGE_H)}}, gauge_bitmap_area(hudctx, AFTERBURNER_GAUGE_X, AFTERBURNER_GAUGE_Y, GAUGE_AFTERBURNER).grow(1));
+	constexpr bool show_bombs = true;
+#endif
+	const auto bomb = which_bomb(player_info);
+	const int bomb_count = min(static_cast<int>(player_info.secondary_ammo[bomb]), 99);
+	{
+		char txt[5];
+		format_bomb_count(txt, bomb_count);
+		t.note(cockpit_gauge::bomb_count, {{show_bombs, static_cast<int>(bomb), bomb_count}}, text_area(*canvas.cv_font, txt, BOMB_COUNT_X, BOMB_COUNT_Y));
+	}
+
+	const auto cloak_fade = update_cloak_fade(player_info, player_info.powerup_flags & PLAYER_FLAGS_CLOAKED);
+	{
+		const auto color = get_player_or_team_color(Player_num);
+		auto &bm = GameBitmaps[GET_GAUGE_INDEX(GAUGE_SHIPS + color)];
+		auto area = cockpit_gauge_area{SHIP_GAUGE_X - 3, SHIP_GAUGE_Y - 3, SHIP_GAUGE_X + bm.bm_w + 4, SHIP_GAUGE_Y + bm.bm_h + 4};
+		int timer = -1;
+		if (cloak_fade < GR_FADE_LEVELS / 2 && show_cloak_invul_timer())
+		{
+			const auto effect_end = player_info.cloak_time + CLOAK_TIME_MAX - GameTime64;
+			timer = effect_end / F1_0;
+			area = area | cockpit_timer_area(*canvas.cv_font, effect_end, SHIP_GAUGE_Y + (bm.bm_h / 2));
+		}
+		t.note(cockpit_gauge::ship, {{static_cast<int>(color), cloak_fade, timer}}, area);
+	}
+
+	const int invulnerable_ship_frame = (player_info.powerup_flags & PLAYER_FLAGS_INVULNERABLE) ? update_invulnerable_ship(player_info) : -1;
+	{
+		auto area = gauge_bitmap_area(hudctx, SHIELD_GAUGE_X, SHIELD_GAUGE_Y, GAUGE_SHIELDS) |
+			gauge_bitmap_area(hudctx, SHIELD_GAUGE_X, SHIELD_GAUGE_Y, GAUGE_INVULNERABLE);
+		int timer = -1;
+		if (invulnerable_ship_frame >= 0 && show_cloak_invul_timer())
+		{
+			const auto effect_end = player_info.invulnerable_time + INVULNERABLE_TIME_MAX - GameTime64;
+			timer = effect_end / F1_0;
+			area = area | cockpit_timer_area(*canvas.cv_font, effect_end, SHIELD_GAUGE_Y);
+		}
+		/* The flashing ship shows the shield gauge for the shields
+		 * rounded from the player object, before they are clamped.
+		 */
+		const int shield_bm = (invulnerable_ship_frame >= 0)
+			? -1
+			: std::min(std::max((player_info.powerup_flags & PLAYER_FLAGS_INVULNERABLE) ? f2ir(plrobj.shields) : shields, 0), 100) / 10;
+		t.note(cockpit_gauge::shield, {{invulnerable_ship_frame, shield_bm, timer}}, area);
+	}
+	t.note(cockpit_gauge::numerical, {{shields, energy}}, numerical_display_area(hudctx, shields, energy));
+	{
+		const auto keys = player_info.powerup_flags & (PLAYER_FLAGS_BLUE_KEY | PLAYER_FLAGS_GOLD_KEY | PLAYER_FLAGS_RED_KEY);
+		t.note(cockpit_gauge::keys, {{static_cast<int>(keys)}},
+			gauge_bitmap_area(hudctx, GAUGE_BLUE_KEY_X, GAUGE_BLUE_KEY_Y, GAUGE_BLUE_KEY) |
+			gauge_bitmap_area(hudctx, GAUGE_GOLD_KEY_X, GAUGE_GOLD_KEY_Y, GAUGE_GOLD_KEY) |
+			gauge_bitmap_area(hudctx, GAUGE_RED_KEY_X, GAUGE_RED_KEY_Y, GAUGE_RED_KEY));
+	}
+	{
+		const auto homing_on = !Endlevel_sequence && (GameTime64 & 0x4000) && player_info.homing_object_dist >= 0;
+		t.note(cockpit_gauge::homing_warning, {{homing_on}},
+			gauge_bitmap_area(hudctx, HOMING_WARNING_X, HOMING_WARNING_Y, GAUGE_HOMING_WARNING_ON) |
+			gauge_bitmap_area(hudctx, HOMING_WARNING_X, HOMING_WARNING_Y, GAUGE_HOMING_WARNING_OFF));
+	}
+
+	t.restore(canvas, get_cockpit_bitmap(multires_gauge_graphic));
+
+	const auto redraw_box0 = t.redraw(cockpit_gauge::primary_box);
+	const auto redraw_box1 = t.redraw(cockpit_gauge::secondary_box);
+	if (redraw_box0)
+		draw_weapon_box0(hudctx, player_info, box0);
+	if (redraw_box1)
+		draw_weapon_box1(hudctx, player_info, box1);
+	if (t.redraw(cockpit_gauge::energy))
+		draw_energy_bar(canvas, hudctx, energy);
+#if defined(DXX_BUILD_DESCENT_II)
+	if (t.redraw(cockpit_gauge::afterburner))
+		draw_afterburner_bar(hudctx, Afterburner_charge);
+#endif
+	if (show_bombs && t.redraw(cockpit_gauge::bomb_count))
+		show_bomb_count(canvas, player_info, BOMB_COUNT_X, BOMB_COUNT_Y, gr_find_closest_color(0, 0, 0), 0, 0);
+	if (t.redraw(cockpit_gauge::ship))
+		draw_player_ship(hudctx, player_info, cloak_fade, SHIP_GAUGE_X, SHIP_GAUGE_Y);
+	if (t.redraw(cockpit_gauge::shield))
+	{
+		if (player_info.powerup_flags & PLAYER_FLAGS_INVULNERABLE)
+			draw_invulnerable_ship(hudctx, plrobj, invulnerable_ship_frame);
+		else
+			draw_shield_bar(hudctx, shields);
+	}
+	if (t.redraw(cockpit_gauge::numerical))
+		draw_numerical_display(hudctx, shields, energy);
+
+	if (Newdemo_state==ND_STATE_RECORDING)
+	{
+		newdemo_record_player_shields(shields);
+		newdemo_record_player_flags(player_info.powerup_flags.get_player_flags());
+	}
+	if (t.redraw(cockpit_gauge::keys))
+		draw_keys_state(hudctx, player_info.powerup_flags).draw_all_cockpit_keys();
+	if (t.redraw(cockpit_gauge::homing_warning))
+		show_homing_warning(hudctx, player_info.homing_object_dist);
+	if (redraw_box0 || redraw_box1)
+		draw_wbu_overlay(hudctx);
+}
+
+}
+
+void cockpit_gauges_begin_frame(const int redrawn_height)
+{
+	Cockpit_gauges.redrawn_height = redrawn_height;
+}
+#endif
+
 //print out some player statistics
 void render_gauges(grs_canvas &canvas, const game_mode_flags Game_mode)
 {
@@ -3838,6 +4310,13 @@ void render_gauges(grs_canvas &canvas, const game_mode_flags Game_mode)
 
 	const local_multires_gauge_graphic multires_gauge_graphic{};
 	const hud_draw_context_hs_mr hudctx(canvas, grd_curscreen->get_screen_width(), grd_curscreen->get_screen_height(), multires_gauge_graphic);
+#if !DXX_USE_OGL
+	if (PlayerCfg.CockpitMode[1] == cockpit_mode_t::full_cockpit)
+	{
+		render_cockpit_gauges(hudctx, plrobj, energy, shields);
+		return;
+	}
+#endif
 	draw_weapon_boxes(hudctx, player_info);
 	if (PlayerCfg.CockpitMode[1] == cockpit_mode_t::full_cockpit)
 	{
@@ -3853,10 +4332,10 @@ void render_gauges(grs_canvas &canvas, const game_mode_flags Game_mode)
 		draw_afterburner_bar(hudctx, Afterburner_charge);
 #endif
 		show_bomb_count(hudctx.canvas, player_info, hudctx.xscale(BOMB_COUNT_X), hudctx.yscale(BOMB_COUNT_Y), gr_find_closest_color(0, 0, 0), 0, 0);
-		draw_player_ship(hudctx, player_info, cloak, SHIP_GAUGE_X, SHIP_GAUGE_Y);
+		draw_player_ship(hudctx, player_info, update_cloak_fade(player_info, cloak), SHIP_GAUGE_X, SHIP_GAUGE_Y);
 
 		if (player_info.powerup_flags & PLAYER_FLAGS_INVULNERABLE)
-			draw_invulnerable_ship(hudctx, plrobj);
+			draw_invulnerable_ship(hudctx, plrobj, update_invulnerable_ship(player_info));
 		else
 			draw_shield_bar(hudctx, shields);
 		draw_numerical_display(hudctx, shields, energy);
@@ -3888,10 +4367,10 @@ void render_gauges(grs_canvas &canvas, const game_mode_flags Game_mode)
 #endif
 			show_bomb_count(hudctx.canvas, player_info, hudctx.xscale(SB_BOMB_COUNT_X), hudctx.yscale(SB_BOMB_COUNT_Y), gr_find_closest_color(0, 0, 0), 0, 0);
 
-		draw_player_ship(hudctx, player_info, cloak, SB_SHIP_GAUGE_X, SB_SHIP_GAUGE_Y);
+		draw_player_ship(hudctx, player_info, update_cloak_fade(player_info, cloak), SB_SHIP_GAUGE_X, SB_SHIP_GAUGE_Y);
 
 		if (player_info.powerup_flags & PLAYER_FLAGS_INVULNERABLE)
-			draw_invulnerable_ship(hudctx, plrobj);
+			draw_invulnerable_ship(hudctx, plrobj, update_invulnerable_ship(player_info));
 		else
 			sb_draw_shield_bar(hudctx, shields);
 		sb_draw_shield_num(hudctx, shields);
@@ -3914,7 +4393,7 @@ void render_gauges(grs_canvas &canvas, const game_mode_flags Game_mode)
 	}
 #if defined(DXX_BUILD_DESCENT_I)
 	else
-		draw_player_ship(hudctx, player_info, cloak, SB_SHIP_GAUGE_X, SB_SHIP_GAUGE_Y);
+		draw_player_ship(hudctx, player_info, update_cloak_fade(player_info, cloak), SB_SHIP_GAUGE_X, SB_SHIP_GAUGE_Y);
 #endif
 }
 
@@ -3930,6 +4409,74 @@ void update_laser_weapon_info(void)
 
 #if defined(DXX_BUILD_DESCENT_II)
 
+namespace {
+
+/* Render the view at 1/-insetscale of the window size into the cache. */
+static void render_inset_view(grs_canvas &window_canv, inset_view_cache &cache, window_rendered_data &window)
+{
+	const unsigned scale = GameArg.GfxInsetScale;
+	const uint16_t w = std::max(window_canv.cv_bitmap.bm_w / scale, 1u);
+	const uint16_t h = std::max(window_canv.cv_bitmap.bm_h / scale, 1u);
+	const auto start = std::chrono::steady_clock::now();
+#if DXX_USE_OGL
+	/* Render into the top left of the window, then keep a copy.  The
+	 * copy is drawn over the whole window afterward.
+	 */
+	grs_subcanvas render_canv;
+	gr_init_sub_canvas(render_canv, window_canv, 0, 0, w, h);
+	gr_set_current_canvas(render_canv);
+	render_frame(render_canv, 0, window);
+	ogl_capture_canvas(render_canv, w, h, cache.image);
+#else
+	if (!cache.image || cache.image->cv_bitmap.bm_w != w || cache.image->cv_bitmap.bm_h != h)
+		cache.image = gr_create_canvas(w, h);
+	gr_set_current_canvas(*cache.image);
+	render_frame(*cache.image, 0, window);
+#endif
+	gr_set_current_canvas(window_canv);
+	cache.render_cost = std::chrono::steady_clock::now() - start;
+	cache.frames_since_render = 0;
+	cache.valid = true;
+	++cache.renders;
+}
+
+static bool draw_inset_view(grs_canvas &window_canv, inset_view_cache &cache)
+{
+#if DXX_USE_OGL
+	return ogl_draw_canvas_capture(window_canv, cache.image);
+#else
+	auto &bm = cache.image->cv_bitmap;
+	if (bm.bm_w == window_canv.cv_bitmap.bm_w && bm.bm_h == window_canv.cv_bitmap.bm_h)
+		gr_bitmap(window_canv, 0, 0, bm);
+	else
+		show_fullscr(window_canv, bm);
+	return true;
+#endif
+}
+
+}
+
+void show_inset_view_stats(grs_canvas &canvas)
+{
+	const auto &game_font = *GAME_FONT;
+	const auto line_spacing = LINE_SPACING(game_font, game_font);
+	gr_set_fontcolor(canvas, BM_XRGB(63, 63, 63), -1);
+	unsigned line = 4;
+	for (auto &&[cache, inset] : zip(Inset_view_cache, inset_window))
+	{
+		if (inset.user == weapon_box_user::weapon || inset.user == weapon_box_user::post_missile_static || !cache.frames)
+			continue;
+		const auto us = std::chrono::duration_cast<std::chrono::microseconds>(cache.render_cost).count();
+		gr_printf(canvas, game_font, FSPACX(2), FSPACY(1) + line_spacing * line++, "inset view: %luus per render, rendered %u of %u frames at 1/%u", static_cast<unsigned long>(us), cache.renders, cache.frames, GameArg.GfxInsetScale);
+		/* Decay the counts, so that they describe recent frames. */
+		if (cache.frames >= 256)
+		{
+			cache.frames /= 2;
+			cache.renders /= 2;
+		}
+	}
+}
+
 //draws a 3d view into one of the cockpit windows.  win is 0 for left,
 //1 for right.  viewer is object.  NULL object means give up window
 //user is one of the WBU_ constants.  If rear_view_flag is set, show a
@@ -3938,6 +4485,7 @@ void update_laser_weapon_info(void)
 void do_cockpit_window_view(const gauge_inset_window_view win, const weapon_box_user user)
 {
 	assert(user == weapon_box_user::weapon || user == weapon_box_user::post_missile_static);
+	Inset_view_cache[win].valid = false;
 	auto &inset = inset_window[win];
 	auto &inset_user = inset.user;
 	if (user == weapon_box_user::post_missile_static && inset_user != weapon_box_user::post_missile_static)
@@ -3991,7 +4539,39 @@ void do_cockpit_window_view(grs_canvas &canvas, const gauge_inset_window_view wi
 
 	gr_set_current_canvas(window_canv);
 
-	render_frame(window_canv, 0, window);
+	if (GameArg.GfxInsetInterval == 1 && GameArg.GfxInsetScale == 1)
+		/* Neither -insetinterval nor -insetscale is in use, so there is
+		 * nothing to keep.  Render into the window, as without them.
+		 */
+		render_frame(window_canv, 0, window);
+	else
+	{
+		auto &cache = Inset_view_cache[win];
+		/* The player steers the guided missile by this view, and a demo
+		 * being recorded needs every frame of every view.
+		 */
+		const bool render = !cache.valid ||
+			cache.viewer != &viewer || cache.rear_view_flag != rear_view_flag || cache.user != user ||
+			cache.w != window_canv.cv_bitmap.bm_w || cache.h != window_canv.cv_bitmap.bm_h ||
+			user == weapon_box_user::guided || Newdemo_state == ND_STATE_RECORDING ||
+			++cache.frames_since_render >= GameArg.GfxInsetInterval;
+		if (render)
+		{
+			cache.viewer = &viewer;
+			cache.rear_view_flag = rear_view_flag;
+			cache.user = user;
+			cache.w = window_canv.cv_bitmap.bm_w;
+			cache.h = window_canv.cv_bitmap.bm_h;
+			render_inset_view(window_canv, cache, window);
+		}
+		if (!draw_inset_view(window_canv, cache))
+		{
+			//the copy was lost with the textures
+			render_inset_view(window_canv, cache, window);
+			draw_inset_view(window_canv, cache);
+		}
+		++cache.frames;
+	}
 
 	//	HACK! If guided missile, wake up robots as necessary.
 	if (viewer.type == OBJ_WEAPON) {
@@ -180,6 +180,11 @@ static void print_commandline_help()
 	VERB("  -pilot <s>                    Select pilot <s> automatically\n")	\
 	VERB("  -auto-record-demo             Start recording on level entry\n")	\
 	VERB("  -record-demo-format           Set demo name automatically\n")	\
+	VERB("  -record-packed-demo           Record demos in the smaller packed format\n")	\
+	VERB("  -pack-demos                   Convert all demos to the packed format, then quit\n")	\
+	VERB("  -export-demo <s>              Play demo <s> as fast as possible, write its video and audio, then quit\n")	\
+	VERB("  -export-demo-file <s>         Write the video to <s>, or - for stdout (default: demos/<demo>.y4m)\n")	\
+	VERB("  -export-demo-fps <n>          Frames per second of the video (default: 30)\n")	\
 	VERB("  -autodemo                     Start in demo mode\n")	\
 	VERB("  -window                       Run the game in a window\n")	\
 	VERB("  -noborders                    Don't show borders in window mode\n")	\
@@ -205,9 +210,15 @@ static void print_commandline_help()
 	))	\
 	VERB("\n Graphics:\n\n")	\
 	VERB("  -lowresfont                   Force use of low resolution fonts\n")	\
+	VERB("  -adaptivefps <n>              Lower detail when frames are slower than <n> FPS (default: 0, off)\n")	\
+	VERB("  -adaptivemin <n>              Lowest detail level for -adaptivefps, 0 to 4 (default: 0)\n")	\
+	VERB("  -adaptivemax <n>              Highest detail level for -adaptivefps, 0 to 4 (default: 4)\n")	\
 	DXX_COMMAND_LINE_HELP_D2(	\
 		VERB("  -lowresgraphics               Force use of low resolution graphics\n")	\
 		VERB("  -lowresmovies                 Play low resolution movies if available (for slow machines)\n")	\
+		VERB("  -moviethreads <n>             Decode movie frames on up to <n> threads (default: 1)\n")	\
+		VERB("  -insetinterval <n>            Render cockpit inset views every <n> frames (default: " DXX_STRINGIZE(INSET_VIEW_INTERVAL_DEFAULT) ")\n")	\
+		VERB("  -insetscale <n>               Render cockpit inset views at 1/<n> resolution (default: 1)\n")	\
 	)	\
 	DXX_COMMAND_LINE_HELP_OGL(	\
 		VERB("  -gl_fixedfont                 Don't scale fonts to current resolution\n")	\
@@ -220,6 +231,9 @@ static void print_commandline_help()
 		VERB("                                    5: Auto: if VSync is enabled and ARB_sync is supported, use mode 2, otherwise mode 0\n")	\
 		VERB("  -gl_syncwait <n>              Wait interval (ms) for sync mode 2 (default: " DXX_STRINGIZE(OGL_SYNC_WAIT_DEFAULT) ")\n")	\
 		VERB("  -gl_darkedges                 Re-enable dark edges around filtered textures (as present in earlier versions of the engine)\n")	\
+		VERB("  -gl_lightshader               Compute dynamic lighting per pixel with a GLSL shader, if supported\n")	\
+		VERB("  -gl_nolevelmesh               Send level geometry every frame instead of keeping it on the GPU\n")	\
+		VERB("  -gl_texturebudget <n>         Delete least recently used textures above <n> MB (default: 0, no limit)\n")	\
 		DXX_if_defined_01(DXX_USE_STEREOSCOPIC_RENDER, (	\
 		VERB("  -gl_stereo                    Enable OpenGL stereo quad buffering, if available\n")	\
 		VERB("  -gl_stereoview <n>            Select OpenGL stereo viewport mode (experimental; incomplete)\n")	\
@@ -234,6 +248,8 @@ static void print_commandline_help()
 		VERB("  -udp_hostaddr <s>             Use IP address/Hostname <s> for manual game joining\n\t\t\t\t(default: %s)\n", UDP_MANUAL_ADDR_DEFAULT)	\
 		VERB("  -udp_hostport <n>             Use UDP port <n> for manual game joining (default: %hu)\n", UDP_PORT_DEFAULT)	\
 		VERB("  -udp_myport <n>               Set my own UDP port to <n> (default: %hu)\n", UDP_PORT_DEFAULT)	\
+		VERB("  -udp_interpdelay <n>          Smooth remote ships by showing them <n> ms behind (default: %hu, 0: off)\n", UDP_INTERP_DELAY_DEFAULT)	\
+		VERB("  -udp_syncwindow <n>           Send up to <n> unacknowledged object packets to joining players (default: %u)\n", UDP_OBJECT_WINDOW_DEFAULT)	\
 		DXX_if_defined_01(DXX_USE_TRACKER, (	\
 			VERB("  -no-tracker                   Disable tracker (unless overridden by later -tracker_hostaddr)\n")	\
 			VERB("  -tracker_hostaddr <n>         Address of tracker server to register/query games to/from\n\t\t\t\t(default: %s)\n", TRACKER_ADDR_DEFAULT)	\
@@ -275,6 +291,8 @@ static void print_commandline_help()
 		VERB("  -tmap <s>                     Select texmapper <s> to use\n\t\t\t\t(default: c, available: c, fp, quad)\n")	\
 		VERB("  -hwsurface                    Use SDL HW Surface\n")	\
 		VERB("  -asyncblit                    Use queued blits over SDL. Can speed up rendering\n")	\
+		VERB("  -nomipmap                     Always sample textures at full resolution\n")	\
+		VERB("  -nospancoverage               Texture hidden parts of opaque walls too\n")	\
 	)	\
 	VERB("\n Help:\n\n")	\
 	VERB("  -help, -h, -?, ?             View this help screen\n")	\
@@ -360,8 +378,10 @@ window_event_result standard_handler(const d_event &event)
 			}
 			break;
 
-		case EVENT_WINDOW_DRAW:
 		case EVENT_IDLE:
+			page_in_preloaded_level();
+			[[fallthrough]];
+		case EVENT_WINDOW_DRAW:
 			//see if redbook song needs to be restarted
 #if DXX_USE_SDL_REDBOOK_AUDIO
 			RBACheckFinishedHook();
@@ -25,6 +25,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #include <algorithm>
 #include <bitset>
+#include <limits>
 #include <numeric>
 #include <stdio.h>
 #include <string.h>	// for memset()
@@ -55,6 +56,9 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "palette.h"
 #include "bm.h"
 #include "wall.h"
+#if DXX_USE_OGL
+#include "ogl_lighting.h"
+#endif
 
 #include "compiler-range_for.h"
 #include "d_bitset.h"
@@ -69,6 +73,9 @@ using std::min;
 #define	HEADLIGHT_SCALE		(F1_0*10)
 
 namespace dcx {
+
+fix Dynamic_light_interval = F1_0 / 60;
+
 namespace {
 
 static int Do_dynamic_light=1;
@@ -181,6 +188,24 @@ static void apply_light(fvmsegptridx &vmsegptridx, const g3s_lrgb obj_light_emis
 						}
 					}
 			}
+#endif
+#if DXX_USE_OGL
+			if (!(use_fcd_lighting && abs(obji_64) > F1_0*32) && ogl_light_shader_enabled())
+			{
+				//let the light shader evaluate this light per pixel, if it has room
+				ogl_shader_light l{};
+				l.pos = obj_pos;
+				l.emission = obj_light_emission;
+				l.range = abs(obji_64);
+				if (headlight_shift && objnum)
+				{
+					l.headlight_scale = HEADLIGHT_SCALE;
+					l.fvec = objnum->orient.fvec;
+					l.cone_range = (Game_mode & GM_MULTI) ? max_headlight_dist : std::numeric_limits<fix>::max();
+				}
+				if (ogl_light_shader_add_light(l))
+					return;
+			}
 #endif
 			range_for (const unsigned vv, xrange(n_render_vertices))
 			{
@@ -524,9 +549,12 @@ void set_dynamic_light(const d_robot_info_array &Robot_info, render_state_t &rst
 		return;
 
 	light_time += FrameTime;
-	if (light_time < (F1_0/60)) // it's enough to stress the CPU 60 times per second
+	if (light_time < Dynamic_light_interval) // it's enough to stress the CPU 60 times per second, or less often under -adaptivefps
 		return;
-	light_time = light_time - (F1_0/60);
+	light_time = light_time - Dynamic_light_interval;
+#if DXX_USE_OGL
+	ogl_light_shader_clear_lights();
+#endif
 
 	enumerated_bitset<MAX_VERTICES, vertnum_t> render_vertex_flags;
 
@@ -44,6 +44,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "palette.h"
 #include "args.h"
 #include "newdemo.h"
+#include "demoexport.h"
 #include "timer.h"
 #include "sounds.h"
 #include "gameseq.h"
@@ -771,6 +772,31 @@ window_event_result main_menu::event_handler(const d_event &event)
 #elif defined(DXX_BUILD_DESCENT_II)
 #define DXX_DEMO_KEY_DELAY	25
 #endif
+			if (CGameArg.SysPackDemos)
+			{
+				CGameArg.SysPackDemos = false;
+				newdemo_pack_all();
+				/* -pack-demos is for unattended use, so quit when it is
+				 * done.
+				 */
+				SDL_Event quit{};
+				quit.type = SDL_QUIT;
+				SDL_PushEvent(&quit);
+				break;
+			}
+			if (!CGameArg.SysExportDemo.empty())
+			{
+				const auto demo = std::exchange(CGameArg.SysExportDemo, {});
+				if (!demo_export_start(demo.c_str()))
+					break;
+				newdemo_start_playback(demo.c_str());
+				/* If playback did not start, nothing else will finish the
+				 * export.
+				 */
+				if (Newdemo_state != ND_STATE_PLAYBACK)
+					demo_export_finish();
+				break;
+			}
 			if (keyd_time_when_last_pressed + i2f(DXX_DEMO_KEY_DELAY) < timer_query() || CGameArg.SysAutoDemo)
 			{
 				keyd_time_when_last_pressed = timer_query();			// Reset timer so that disk won't thrash if no demos.
@@ -887,6 +913,26 @@ static window_event_result demo_menu_keycommand( listbox *lb,const d_event &even
 				return window_event_result::handled;
 			}
 			break;
+
+		case KEY_CTRLED+KEY_K:
+			if (citem >= 0)
+			{
+				std::array<char, PATH_MAX> bakname;
+
+				const auto ic = items[citem];
+				if (!change_filename_extension(bakname, ic, DEMO_BACKUP_EXT))
+					return window_event_result::handled;
+				const auto x = nm_messagebox(menu_title{nullptr}, {TXT_YES, TXT_NO}, "Convert %s\n"
+								  "to the packed demo format?\n"
+								  "Older versions will not be able\n"
+								  "to play it.  A backup\n"
+								  "%s will be created.", ic, bakname.data());
+				if (!x)
+					newdemo_pack(ic);
+
+				return window_event_result::handled;
+			}
+			break;
 	}
 	return window_event_result::ignored;
 }
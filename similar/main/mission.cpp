@@ -37,6 +37,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "window.h"
 #include "mission.h"
 #include "gamesave.h"
+#include "gameseq.h"
 #include "piggy.h"
 #include "console.h"
 #include "polyobj.h"
@@ -754,6 +755,8 @@ static void promote (mission_list_type &mission_list, const char *const name, st
 
 Mission::~Mission()
 {
+	/* Discard a level read from this mission. */
+	cancel_level_preload();
     // May become more complex with the editor
 	if (!path.empty() && builtin_hogsize == 0)
 		{
@@ -308,9 +308,8 @@ namespace dcx {
 
 // For rejoin object syncing (used here and all protocols - globally)
 
-int	Network_send_objects = 0;  // Are we in the process of sending objects to a player?
-int	Network_send_object_mode = 0; // What type of objects are we sending, static or dynamic?
-int 	Network_send_objnum = -1;   // What object are we sending next?
+int	Network_send_objects = 0;  // How many players are we sending objects to?
+int 	Network_send_objnum = -1;   // Set to -1 to send all objects again
 int     Network_rejoined = 0;       // Did WE rejoin this game?
 int     Network_sending_extras=0;
 int     VerifyPlayerJoined=-1;      // Player (num) to enter game before any ingame/extra stuff is being sent
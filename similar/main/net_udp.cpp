@@ -39,6 +39,7 @@
 #include "text.h"
 #include "newdemo.h"
 #include "multibot.h"
+#include "net_jitter.h"
 #include "state.h"
 #include "wall.h"
 #include "bm.h"
@@ -98,6 +99,7 @@ enum class upid : uint8_t
 	mdata_pnorm,	// Packet containing multi buffer from a player. Priority 0,1 - no ACK needed.
 	mdata_pneedack,	// Packet containing multi buffer from a player. Priority 2 - ACK needed. Also contains pkt_num
 	mdata_ack,	// ACK packet for UPID_MDATA_P1.
+	object_data_ack,	// ACK packet for UPID_OBJECT_DATA, from a joining player.
 #if DXX_USE_TRACKER
 	/* Tracker upid codes are special.  They must be compatible with the
 	 * tracker, which is a separate program maintained in a different
@@ -160,11 +162,14 @@ template <>
 constexpr std::size_t upid_length<upid::pong> = 10;
 
 template <>
-constexpr std::size_t upid_length<upid::pdata> = 49;
+constexpr std::size_t upid_length<upid::pdata> = 53;
 
 template <>
 constexpr std::size_t upid_length<upid::mdata_ack> = 7;
 
+template <>
+constexpr std::size_t upid_length<upid::object_data_ack> = 3;
+
 template <upid id>
 using upid_rspan = std::span<const uint8_t, upid_length<id>>;
 
@@ -191,6 +196,7 @@ struct UDP_frame_info : prohibit_void_ptr<UDP_frame_info>
 	ubyte				Player_num;
 	player_connection_status connected;
 	quaternionpos			qpp;
+	net_sender_time			sender_time;
 };
 
 enum class join_netgame_status_code : unsigned
@@ -428,6 +434,67 @@ struct UDP_sequence_syncplayer_packet
 	}
 };
 
+/* Position in the object stream sent to a joining player.  The stream
+ * first sends the objects owned by the joiner or by nobody (mode 0), then
+ * everyone else's (mode 1), then the number of objects sent (mode 2).
+ */
+struct UDP_object_stream_position
+{
+	/* Next object to send, or -1 if the next packet first tells the
+	 * joiner to clear its objects.
+	 */
+	int objnum;
+	uint8_t mode;
+	/* Objects sent before this position */
+	unsigned obj_count;
+};
+
+/* Time without acknowledgement after which object data packets are sent
+ * again, and after which the joiner is dropped.
+ */
+constexpr fix UDP_OBJECT_RESEND_TIME = F1_0 / 2;
+constexpr fix UDP_OBJECT_GIVE_UP_TIME = F1_0 * 10;
+
+/* Object data packets sent to one joining player.  Each packet carries a
+ * sequence number, which the joiner acknowledges cumulatively.  Up to
+ * -udp_syncwindow packets may be unacknowledged.  If no acknowledgement
+ * arrives for a while, every unacknowledged packet is sent again, built
+ * from the same range of objects as before.
+ */
+struct UDP_object_stream
+{
+	UDP_sequence_syncplayer_packet player;
+	bool active = false;
+	/* The player takes a slot which was never used in this game */
+	bool player_added = false;
+	uint16_t next_seq = 0, acked_seq = 0;
+	UDP_object_stream_position position{-1, 0, 0};
+	fix64 last_ack_time = 0, last_resend_time = 0;
+	struct sent_packet
+	{
+		UDP_object_stream_position start, end;
+	};
+	/* Indexed by sequence number modulo UDP_OBJECT_WINDOW_MAX */
+	std::array<sent_packet, UDP_OBJECT_WINDOW_MAX> sent;
+	/* True once everything, including the count, has been acknowledged */
+	bool complete() const
+	{
+		return position.mode > 2 && acked_seq == next_seq;
+	}
+	/* True if object `objnum` of mode `obj_mode` has already been sent */
+	bool is_past(const unsigned obj_mode, const int objnum) const
+	{
+		return obj_mode < position.mode || (obj_mode == position.mode && objnum < position.objnum);
+	}
+	/* Packets in flight keep their ranges, in case they must be sent
+	 * again.  The packets which follow them start over.
+	 */
+	void restart()
+	{
+		position = {-1, 0, 0};
+	}
+};
+
 // Prototypes
 static void net_udp_init();
 static void net_udp_close();
@@ -480,6 +547,7 @@ static void net_udp_process_mdata(const d_level_shared_robot_info_state &LevelSh
 static void net_udp_send_pdata();
 static void net_udp_process_pdata (std::span<const uint8_t> data, const _sockaddr &sender_addr);
 static void net_udp_read_pdata_packet(UDP_frame_info *pd);
+static void net_udp_interpolate_players(fix64 time);
 static void net_udp_timeout_check(fix64 time);
 static int net_udp_get_new_player_num ();
 static void net_udp_noloss_got_ack(std::span<const uint8_t>);
@@ -495,6 +563,14 @@ static unsigned UDP_mdata_queue_highest;
 static std::array<UDP_mdata_store, UDP_MDATA_STOR_QUEUE_SIZE> UDP_mdata_queue;
 static per_player_array<UDP_mdata_check> UDP_mdata_trace;
 static UDP_sequence_syncplayer_packet UDP_sync_player; // For rejoin object syncing
+/* Objects being sent to joining players, by the slot they join into */
+static per_player_array<UDP_object_stream> UDP_object_streams;
+/* Sequence number of the next object data packet this joiner accepts */
+static uint16_t UDP_object_data_expected;
+/* Received player positions, played out by net_udp_interpolate_players.
+ * At the maximum packet rate this holds ~400ms of history.
+ */
+static per_player_array<net_jitter_buffer<quaternionpos, 16>> UDP_pdata_buffer;
 static uint16_t UDP_MyPort;
 #if DXX_USE_TRACKER
 static _sockaddr TrackerSocket;
@@ -954,6 +1030,7 @@ static std::optional<upid> build_upid_from_untrusted(const uint8_t cmd)
 		case static_cast<uint8_t>(upid::mdata_pnorm):
 		case static_cast<uint8_t>(upid::mdata_pneedack):
 		case static_cast<uint8_t>(upid::mdata_ack):
+		case static_cast<uint8_t>(upid::object_data_ack):
 #if DXX_USE_TRACKER
 		case static_cast<uint8_t>(upid::tracker_gameinfo):
 		case static_cast<uint8_t>(upid::tracker_ack):
@@ -1707,6 +1784,7 @@ void net_udp_list_join_game(grs_canvas &canvas)
 	change_playernum_to(1);
 	N_players = 0;
 	Network_send_objects = 0;
+	UDP_object_streams = {};
 	Network_sending_extras=0;
 	Network_rejoined=0;
 
@@ -1788,6 +1866,8 @@ void net_udp_init()
 	Netgame = {};
 	UDP_MData = {};
 	net_udp_noloss_init_mdata_queue();
+	for (auto &b : UDP_pdata_buffer)
+		b.reset();
 	UDP_sequence_request_packet UDP_Seq{GetMyNetRanking(), InterfaceUniqueState.PilotName, 0};
 
 	multi_new_game();
@@ -1998,11 +2078,9 @@ static void net_udp_welcome_player(const UDP_sequence_request_packet &their, con
 		return; 
 	}
 
-	if (Network_send_objects || Network_sending_extras)
+	if (std::any_of(UDP_object_streams.begin(), UDP_object_streams.end(), [&udp_addr](const UDP_object_stream &s) { return s.active && s.player.udp_addr == udp_addr; }))
 	{
-		// Ignore silently, we're already responding to someone and we can't
-		// do more than one person at a time.  If we don't dump them they will
-		// re-request in a few seconds.
+		// Ignore silently, we're already sending their objects.
 		return;
 	}
 
@@ -2018,8 +2096,7 @@ static void net_udp_welcome_player(const UDP_sequence_request_packet &their, con
 	}
 
 	unsigned player_num = UINT_MAX;
-	UDP_sync_player = {};
-	Network_player_added = 0;
+	bool player_added = false;
 
 	for (unsigned i = 0; i < N_players; i++)
 	{
@@ -2046,7 +2123,11 @@ static void net_udp_welcome_player(const UDP_sequence_request_packet &their, con
 			// Add player in an open slot, game not full yet
 
 			player_num = N_players;
-			Network_player_added = 1;
+			player_added = true;
+			// Another new player is being synced into this slot.  If we
+			// don't dump them they will re-request in a few seconds.
+			if (UDP_object_streams[player_num].active)
+				return;
 		}
 		else
 		{
@@ -2072,7 +2153,7 @@ static void net_udp_welcome_player(const UDP_sequence_request_packet &their, con
 
 			for (unsigned i = 0; i < N_players; i++)
 			{
-				if (vcplayerptr(i)->connected == player_connection_status::disconnected && Netgame.players[i].LastPacketTime < oldest_time)
+				if (vcplayerptr(i)->connected == player_connection_status::disconnected && Netgame.players[i].LastPacketTime < oldest_time && !UDP_object_streams[i].active)
 				{
 					oldest_time = Netgame.players[i].LastPacketTime;
 					oldest_player = i;
@@ -2090,7 +2171,7 @@ static void net_udp_welcome_player(const UDP_sequence_request_packet &their, con
 				// Found a slot!
 
 				player_num = oldest_player;
-				Network_player_added = 1;
+				player_added = true;
 			}
 		}
 	}
@@ -2107,8 +2188,6 @@ static void net_udp_welcome_player(const UDP_sequence_request_packet &their, con
 		if (Newdemo_state == ND_STATE_RECORDING)
 			newdemo_record_multi_reconnect(player_num);
 
-		Network_player_added = 0;
-
 		digi_play_sample(SOUND_HUD_MESSAGE, F1_0);
 
 		const auto &&rankstr = GetRankStringWithSpace(Netgame.players[player_num].rank);
@@ -2125,9 +2204,13 @@ static void net_udp_welcome_player(const UDP_sequence_request_packet &their, con
 
 	// Send updated Objects data to the new/returning player
 
-	UDP_sync_player = UDP_sequence_syncplayer_packet(player_num, their.rank, their.callsign, udp_addr);
-	Network_send_objects = 1;
-	Network_send_objnum = -1;
+	auto &stream = UDP_object_streams[player_num];
+	stream = {};
+	stream.player = UDP_sequence_syncplayer_packet(player_num, their.rank, their.callsign, udp_addr);
+	stream.active = true;
+	stream.player_added = player_added;
+	stream.last_ack_time = timer_query();
+	++Network_send_objects;
 	Netgame.players[player_num].LastPacketTime = timer_query();
 
 	net_udp_send_objects();
@@ -2140,22 +2223,21 @@ namespace udp {
 int dispatch_table::objnum_is_past(const objnum_t objnum) const
 {
 	// determine whether or not a given object number has already been sent
-	// to a re-joining player.
+	// to any re-joining player.
 	
-	int player_num = UDP_sync_player.player_num;
-	int obj_mode = !((object_owner[objnum] == -1) || (object_owner[objnum] == player_num));
-
 	if (!Network_send_objects)
 		return 0; // We're not sending objects to a new player
 
-	if (obj_mode > Network_send_object_mode)
-		return 0;
-	else if (obj_mode < Network_send_object_mode)
-		return 1;
-	else if (objnum < Network_send_objnum)
-		return 1;
-	else
-		return 0;
+	const auto owner = object_owner[objnum];
+	for (auto &stream : UDP_object_streams)
+	{
+		if (!stream.active)
+			continue;
+		const unsigned obj_mode = !(owner == -1 || owner == stream.player.player_num);
+		if (stream.is_past(obj_mode, objnum))
+			return 1;
+	}
+	return 0;
 }
 
 }
@@ -2306,15 +2388,41 @@ static unsigned net_udp_create_monitor_vector(void)
 	return(vector);
 }
 
+static void net_udp_end_object_stream(UDP_object_stream &stream)
+{
+	stream.active = false;
+	Network_send_objects = std::count_if(UDP_object_streams.begin(), UDP_object_streams.end(), [](const UDP_object_stream &s) { return s.active; });
+}
+
 static void net_udp_stop_resync(const struct _sockaddr &udp_addr)
 {
+	for (auto &stream : UDP_object_streams)
+		if (stream.active && stream.player.udp_addr == udp_addr)
+			net_udp_end_object_stream(stream);
 	if (UDP_sync_player.udp_addr == udp_addr)
 	{
-		Network_send_objects = 0;
 		Network_sending_extras=0;
 		Network_rejoined=0;
 		Player_joining_extras=-1;
-		Network_send_objnum = -1;
+	}
+}
+
+static void net_udp_process_object_data_ack(const upid_rspan<upid::object_data_ack> data, const _sockaddr &sender_addr)
+{
+	const uint16_t next = GET_INTEL_SHORT(&data[1]);
+	for (auto &stream : UDP_object_streams)
+	{
+		if (!stream.active || stream.player.udp_addr != sender_addr)
+			continue;
+		// Ignore acknowledgements which are older than the last one, or
+		// which are for packets not sent yet.
+		const uint16_t newly_acked = next - stream.acked_seq;
+		if (newly_acked && newly_acked <= static_cast<uint16_t>(stream.next_seq - stream.acked_seq))
+		{
+			stream.acked_seq = next;
+			stream.last_ack_time = timer_query();
+		}
+		return;
 	}
 }
 
@@ -2323,53 +2431,51 @@ static void net_udp_stop_resync(const struct _sockaddr &udp_addr)
 namespace dsx {
 namespace {
 
-void net_udp_send_objects(void)
+/* Build the packet of `stream` numbered `seq`, which starts at `start`.
+ * If `end` is given, the packet is being sent again and covers the same
+ * objects as the first time.  Otherwise, it takes as many objects as fit.
+ * Sets `next` to the start of the following packet.  Returns the length
+ * of the packet, or 0 if it is empty and need not be sent.
+ */
+static unsigned net_udp_build_object_packet(const UDP_object_stream &stream, const uint16_t seq, const UDP_object_stream_position start, const UDP_object_stream_position *const end, std::array<uint8_t, UPID_MAX_SIZE> &object_buffer, UDP_object_stream_position &next)
 {
-	auto &LevelUniqueControlCenterState = LevelUniqueObjectState.ControlCenterState;
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vmobjptr = Objects.vmptr;
-	uint8_t player_num = UDP_sync_player.player_num;
-	static int obj_count = 0;
+	const uint8_t player_num = stream.player.player_num;
 	unsigned loc = 0, obj_count_frame = 0;
-	static fix64 last_send_time = 0;
-	
-	if (last_send_time + (F1_0/50) > timer_query())
-		return;
-	last_send_time = timer_query();
-
-	// Send clear objects array trigger and send player num
+	auto obj_count = start.obj_count;
 
-	Assert(Network_send_objects != 0);
-	Assert(player_num >= 0);
-	Assert(player_num < Netgame.max_numplayers);
-
-	if (Network_status == network_state::endlevel || LevelUniqueControlCenterState.Control_center_destroyed)
+	object_buffer[0] = underlying_value(upid::object_data);
+	PUT_INTEL_SHORT(&object_buffer[1], seq);
+	if (start.mode == 2)
 	{
-		// Endlevel started before we finished sending the goods, we'll
-		// have to stop and try again after the level.
-		multi::udp::dispatch->kick_player(UDP_sync_player.udp_addr, kick_player_reason::endlevel);
-		Network_send_objects = 0; 
-		return;
+		// Send count so other side can make sure he got them all
+		PUT_INTEL_INT(&object_buffer[3], 1);
+		PUT_INTEL_INT(&object_buffer[7], network_checksum_marker_object);
+		object_buffer[11] = player_num;
+		PUT_INTEL_INT(&object_buffer[12], obj_count);
+		next = {0, 3, obj_count};
+		return 16;
 	}
+	loc = 7;
 
-	std::array<uint8_t, UPID_MAX_SIZE> object_buffer{{
-		underlying_value(upid::object_data)
-	}};
-	loc = 5;
-
-	if (Network_send_objnum == -1)
+	objnum_t first;
+	if (start.objnum == -1)
 	{
-		obj_count = 0;
-		Network_send_object_mode = 0;
+		// Send clear objects array trigger and send player num
 		PUT_INTEL_INT(&object_buffer[loc], -1);                       loc += 4;
 		object_buffer[loc] = player_num;                            loc += 1;
 		/* Placeholder for remote_objnum, not used here */          loc += 4;
-		Network_send_objnum = 0;
+		first = 0;
+		obj_count = 0;
 		obj_count_frame = 1;
 	}
-	
+	else
+		first = start.objnum;
+
+	const unsigned limit = end && end->mode == start.mode ? end->objnum : Highest_object_index + 1;
 	objnum_t i;
-	for (i = Network_send_objnum; i <= Highest_object_index; i++)
+	for (i = first; i < limit && i <= Highest_object_index; i++)
 	{
 		const auto &&objp = vmobjptr(i);
 		if ((objp->type != OBJ_POWERUP) && (objp->type != OBJ_PLAYER) &&
@@ -2380,9 +2486,9 @@ void net_udp_send_objects(void)
 #endif
 				)
 			continue;
-		if ((Network_send_object_mode == 0) && ((object_owner[i] != -1) && (object_owner[i] != player_num)))
+		if ((start.mode == 0) && ((object_owner[i] != -1) && (object_owner[i] != player_num)))
 			continue;
-		if ((Network_send_object_mode == 1) && ((object_owner[i] == -1) || (object_owner[i] == player_num)))
+		if ((start.mode == 1) && ((object_owner[i] == -1) || (object_owner[i] == player_num)))
 			continue;
 
 		if ( loc + sizeof(object_rw) + 9 > UPID_MAX_SIZE-1 )
@@ -2398,59 +2504,115 @@ void net_udp_send_objects(void)
 		object_buffer[loc] = owner;                                 loc += 1;
 		PUT_INTEL_INT(&object_buffer[loc], remote_objnum);            loc += 4;
 		// use object_rw to send objects for now. if object sometime contains some day contains something useful the client should know about, we should use it. but by now it's also easier to use object_rw because then we also do not need fix64 timer values.
-		multi_object_to_object_rw(vmobjptr(i), reinterpret_cast<object_rw *>(&object_buffer[loc]));
+		multi_object_to_object_rw(objp, reinterpret_cast<object_rw *>(&object_buffer[loc]));
 		if constexpr (words_bigendian)
 			object_rw_swap(reinterpret_cast<object_rw *>(&object_buffer[loc]), 1);
 		loc += sizeof(object_rw);
 	}
 
-	if (obj_count_frame) // Send any objects we've buffered
-	{
-		Network_send_objnum = i;
-		PUT_INTEL_INT(&object_buffer[1], obj_count_frame);
+	if (end)
+		next = *end;
+	else if (i > Highest_object_index)
+		next = {0, static_cast<uint8_t>(start.mode + 1), obj_count};
+	else
+		next = {i, start.mode, obj_count};
+	// A packet sent again keeps its number even if it is now empty.
+	if (!obj_count_frame && !end)
+		return 0;
+	PUT_INTEL_INT(&object_buffer[3], obj_count_frame);
+	Assert(loc <= UPID_MAX_SIZE);
+	return loc;
+}
 
-		Assert(loc <= UPID_MAX_SIZE);
+/* All objects have reached the joiner.  Tell them who they are, then send
+ * the extras.  Only one joiner at a time can be in this phase.
+ */
+static void net_udp_finish_object_stream(UDP_object_stream &stream)
+{
+	const unsigned player_num = stream.player.player_num;
+	UDP_sync_player = stream.player;
+	Network_player_added = stream.player_added;
+	net_udp_end_object_stream(stream);
 
-		dxx_sendto(UDP_Socket[0], std::span(object_buffer).first(loc), 0, UDP_sync_player.udp_addr);
-	}
+	// Send sync packet which tells the player who he is and to start!
+	net_udp_send_rejoin_sync(player_num);
+
+#if defined(DXX_BUILD_DESCENT_I)
+	Network_sending_extras=3; // start to send extras
+#elif defined(DXX_BUILD_DESCENT_II)
+	Network_sending_extras=9; // start to send extras
+#endif
+	VerifyPlayerJoined = Player_joining_extras = player_num;
+}
 
-	if (i > Highest_object_index)
+void net_udp_send_objects(void)
+{
+	auto &LevelUniqueControlCenterState = LevelUniqueObjectState.ControlCenterState;
+
+	if (Network_status == network_state::endlevel || LevelUniqueControlCenterState.Control_center_destroyed)
 	{
-		if (Network_send_object_mode == 0)
-		{
-			Network_send_objnum = 0;
-			Network_send_object_mode = 1; // go to next mode
-		}
-		else 
-		{
-			Assert(Network_send_object_mode == 1); 
+		// Endlevel started before we finished sending the goods, we'll
+		// have to stop and try again after the level.
+		for (auto &stream : UDP_object_streams)
+			if (stream.active)
+			{
+				multi::udp::dispatch->kick_player(stream.player.udp_addr, kick_player_reason::endlevel);
+				net_udp_end_object_stream(stream);
+			}
+		return;
+	}
 
-			// Send count so other side can make sure he got them all
-			object_buffer[0] = underlying_value(upid::object_data);
-			PUT_INTEL_INT(&object_buffer[1], 1);
-			PUT_INTEL_INT(&object_buffer[5], network_checksum_marker_object);
-			object_buffer[9] = player_num;
-			PUT_INTEL_INT(&object_buffer[10], obj_count);
-			dxx_sendto(UDP_Socket[0], std::span(object_buffer).first<14>(), 0, UDP_sync_player.udp_addr);
+	// Objects which a joiner already has were changed, so start over.
+	const bool restart = (Network_send_objnum == -1);
+	Network_send_objnum = 0;
 
-			// Send sync packet which tells the player who he is and to start!
-			net_udp_send_rejoin_sync(player_num);
+	const auto time = timer_query();
+	const unsigned window = CGameArg.MplUdpSyncWindow;
+	std::array<uint8_t, UPID_MAX_SIZE> object_buffer;
+	for (auto &stream : UDP_object_streams)
+	{
+		if (!stream.active)
+			continue;
+		if (restart)
+			stream.restart();
 
-			// Turn off send object mode
-			Network_send_objnum = -1;
-			Network_send_objects = 0;
-			obj_count = 0;
+		if (stream.acked_seq != stream.next_seq && time >= std::max(stream.last_ack_time, stream.last_resend_time) + UDP_OBJECT_RESEND_TIME)
+		{
+			if (time >= stream.last_ack_time + UDP_OBJECT_GIVE_UP_TIME)
+			{
+				multi::udp::dispatch->kick_player(stream.player.udp_addr, kick_player_reason::pkttimeout);
+				net_udp_end_object_stream(stream);
+				continue;
+			}
+			// Nothing was acknowledged for a while, so send every
+			// unacknowledged packet again.
+			for (uint16_t seq = stream.acked_seq; seq != stream.next_seq; ++seq)
+			{
+				auto &sent = stream.sent[seq % UDP_OBJECT_WINDOW_MAX];
+				UDP_object_stream_position next;
+				const auto length = net_udp_build_object_packet(stream, seq, sent.start, &sent.end, object_buffer, next);
+				dxx_sendto(UDP_Socket[0], std::span(object_buffer).first(length), 0, stream.player.udp_addr);
+			}
+			stream.last_resend_time = time;
+		}
 
-#if defined(DXX_BUILD_DESCENT_I)
-			Network_sending_extras=3; // start to send extras
-#elif defined(DXX_BUILD_DESCENT_II)
-			Network_sending_extras=9; // start to send extras
-#endif
-			VerifyPlayerJoined = Player_joining_extras = player_num;
+		while (stream.position.mode < 3 && static_cast<uint16_t>(stream.next_seq - stream.acked_seq) < window)
+		{
+			const auto start = stream.position;
+			const auto length = net_udp_build_object_packet(stream, stream.next_seq, start, nullptr, object_buffer, stream.position);
+			if (!length)
+				continue;
+			// Time out from the oldest packet in flight.
+			if (stream.acked_seq == stream.next_seq)
+				stream.last_ack_time = time;
+			stream.sent[stream.next_seq % UDP_OBJECT_WINDOW_MAX] = {start, stream.position};
+			dxx_sendto(UDP_Socket[0], std::span(object_buffer).first(length), 0, stream.player.udp_addr);
+			++stream.next_seq;
+		}
 
-			return;
-		} // mode == 1;
-	} // i > Highest_object_index
+		if (stream.complete() && !Network_sending_extras && VerifyPlayerJoined == -1)
+			net_udp_finish_object_stream(stream);
+	}
 }
 
 }
@@ -2479,16 +2641,33 @@ static int net_udp_verify_objects(int remote, int local)
 	return(1);
 }
 
-static void net_udp_read_object_packet(const uint8_t *const data)
+static void net_udp_send_object_data_ack(const _sockaddr &host_addr)
+{
+	std::array<uint8_t, upid_length<upid::object_data_ack>> buf;
+	buf[0] = underlying_value(upid::object_data_ack);
+	PUT_INTEL_SHORT(&buf[1], UDP_object_data_expected);
+	dxx_sendto(UDP_Socket[0], buf, 0, host_addr);
+}
+
+static void net_udp_read_object_packet(const uint8_t *const data, const _sockaddr &sender_addr)
 {
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vmobjptridx = Objects.vmptridx;
 	// Object from another net player we need to sync with
 	sbyte obj_owner;
 	static int mode = 0, object_count = 0, my_pnum = 0;
-	int remote_objnum = 0, nobj = 0, loc = 5;
+	int remote_objnum = 0, nobj = 0, loc = 7;
+
+	// Packets must be used in order.  Acknowledge every packet, so that
+	// the host learns of a gap as soon as possible.
+	const bool in_order = (GET_INTEL_SHORT(data + 1) == UDP_object_data_expected);
+	if (in_order)
+		++UDP_object_data_expected;
+	net_udp_send_object_data_ack(sender_addr);
+	if (!in_order)
+		return;
 	
-	nobj = GET_INTEL_INT(data + 1);
+	nobj = GET_INTEL_INT(data + 3);
 
 	for (int i = 0; i < nobj; i++)
 	{
@@ -2589,7 +2768,6 @@ void net_udp_send_rejoin_sync(const unsigned player_num)
 
 		multi::udp::dispatch->kick_player(UDP_sync_player.udp_addr, kick_player_reason::endlevel);
 
-		Network_send_objects = 0; 
 		Network_sending_extras=0;
 		return;
 	}
@@ -3476,7 +3654,13 @@ static void net_udp_process_packet(const d_level_shared_robot_info_state &LevelS
 		case upid::object_data:
 			if (multi_i_am_master() || length > UPID_MAX_SIZE || Network_status != network_state::waiting)
 				break;
-			net_udp_read_object_packet(data);
+			net_udp_read_object_packet(data, sender_addr);
+			break;
+		case upid::object_data_ack:
+			if (!multi_i_am_master() || Network_status != network_state::playing)
+				break;
+			if (const auto s = build_upid_rspan<upid::object_data_ack>(buf))
+				net_udp_process_object_data_ack(*s, sender_addr);
 			break;
 		case upid::ping:
 			if (multi_i_am_master())
@@ -4935,6 +5119,7 @@ static int net_udp_wait_for_sync(void)
 		newmenu_item::nm_item_text{text},
 		newmenu_item::nm_item_text{TXT_NET_LEAVE},
 	}};
+	UDP_object_data_expected = 0;
 	auto i = net_udp_send_request();
 
 	if (i >= MAX_PLAYERS)
@@ -5041,6 +5226,9 @@ window_event_result dispatch_table::level_sync() const
 
 	UDP_MData = {};
 	net_udp_noloss_init_mdata_queue();
+	/* Positions from the previous level name its segments */
+	for (auto &b : UDP_pdata_buffer)
+		b.reset();
 
 	net_udp_flush(UDP_Socket); // Flush any old packets
 
@@ -5372,6 +5560,9 @@ void dispatch_table::do_protocol_frame(int force, int listen) const
 	if (WaitForRefuseAnswer && time>(RefuseTimeLimit+(F1_0*12)))
 		WaitForRefuseAnswer=0;
 
+	if (CGameArg.MplUdpInterpDelay && Network_status == network_state::playing)
+		net_udp_interpolate_players(time);
+
 	// Send positional update either in the regular PPS interval OR if forced
 	if (force || (time >= (last_pdata_time+(F1_0/Netgame.PacketsPerSec))))
 	{
@@ -5875,7 +6066,7 @@ void net_udp_send_pdata()
 {
 	auto &Objects = LevelUniqueObjectState.Objects;
 	auto &vmobjptr = Objects.vmptr;
-	std::array<uint8_t, 3 + quaternionpos::packed_size::value> buf;
+	std::array<uint8_t, 3 + quaternionpos::packed_size::value + sizeof(net_sender_time)> buf;
 	int len = 0;
 
 	if (!(Game_mode&GM_NETWORK) || !UDP_Socket[0])
@@ -5903,7 +6094,8 @@ void net_udp_send_pdata()
 	len += 12;
 	multi_put_vector(&buf[len], qpp.rotvel);
 	len += 12;
-	// 46 + 3 = 49
+	PUT_INTEL_INT(&buf[len], static_cast<net_sender_time>(timer_query()));	len += 4;
+	// 46 + 3 + 4 = 53
 
 	if (multi_i_am_master())
 	{
@@ -5953,6 +6145,7 @@ void net_udp_process_pdata(const std::span<const uint8_t> data, const _sockaddr
 	len += 12;
 	pd.qpp.rotvel = multi_get_vector(&data[len]);
 	len += 12;
+	pd.sender_time = GET_INTEL_INT(&data[len]);				len += 4;
 
 	if (multi_i_am_master()) // I am host - must relay this packet to others!
 	{
@@ -6009,6 +6202,7 @@ void net_udp_read_pdata_packet(UDP_frame_info *pd)
 			multi_send_score();
 
 			net_udp_noloss_clear_mdata_trace(TheirPlayernum);
+			UDP_pdata_buffer[TheirPlayernum].reset();
 		}
 	}
 
@@ -6028,17 +6222,127 @@ void net_udp_read_pdata_packet(UDP_frame_info *pd)
 	}
 
 	const auto TheirObj = vmobjptridx(TheirObjnum);
-	Netgame.players[TheirPlayernum].LastPacketTime = timer_query();
+	const auto now = timer_query();
+	Netgame.players[TheirPlayernum].LastPacketTime = now;
 
 	// do not read the packet unless the level is loaded.
 	if (vcplayerptr(Player_num)->connected == player_connection_status::disconnected || vcplayerptr(Player_num)->connected == player_connection_status::waiting)
                 return;
 	//------------ Read the player's ship's object info ----------------------
+	if (CGameArg.MplUdpInterpDelay)
+	{
+		/* Queue the position.  net_udp_interpolate_players places the
+		 * ship every frame.  After a long silence, the retained history
+		 * describes where the ship used to be, not how it got here, so
+		 * start over.
+		 */
+		auto &b = UDP_pdata_buffer[TheirPlayernum];
+		if (const auto arrival = b.newest_arrival(); arrival && now - *arrival > F1_0)
+			b.reset();
+		b.insert(pd->sender_time, now, pd->qpp);
+		return;
+	}
 	extract_quaternionpos(TheirObj, pd->qpp);
 	if (TheirObj->movement_source == object::movement_type::physics)
 		set_thrust_from_velocity(TheirObj);
 }
 
+static vms_quaternion net_udp_blend_quaternion(const vms_quaternion &a, const vms_quaternion &b, const fix fraction)
+{
+	/* q and -q are the same rotation.  Blend towards whichever of them is
+	 * nearer to `a`, or the ship will spin the long way around.
+	 * vms_matrix_from_quaternion normalizes, so a plain linear blend is
+	 * enough.
+	 */
+	const int sign = (int64_t{a.w} * b.w + int64_t{a.x} * b.x + int64_t{a.y} * b.y + int64_t{a.z} * b.z) < 0 ? -1 : 1;
+	const auto blend = [fraction, sign](const short p, const short q) {
+		return static_cast<short>(p + fixmul(sign * q - p, fraction));
+	};
+	return {blend(a.w, b.w), blend(a.x, b.x), blend(a.y, b.y), blend(a.z, b.z)};
+}
+
+/* Compute the state to show for a remote ship from the buffered states.
+ * Returns false if no usable segment could be found for the computed
+ * position, in which case `qpp` is the nearest received state.
+ */
+static bool net_udp_blend_quaternionpos(quaternionpos &qpp, const net_jitter_sample<quaternionpos> &s)
+{
+	auto &nearest = s.fraction < F1_0 / 2 ? s.from : s.to;
+	qpp = nearest;
+	switch (s.kind)
+	{
+		case net_jitter_sample_kind::hold:
+			return true;
+		case net_jitter_sample_kind::extrapolate:
+			vm_vec_scale_add2(qpp.pos, qpp.vel, s.extrapolate_time);
+			break;
+		case net_jitter_sample_kind::interpolate:
+		{
+			auto &a = s.from;
+			auto &b = s.to;
+			/* A jump this long between two updates is a respawn or a
+			 * teleport, not flight.  Do not slide the ship through the
+			 * walls between the two positions.
+			 */
+			if (vm_vec_dist_quick(a.pos, b.pos) > i2f(80))
+				return true;
+			vm_vec_scale_add(qpp.pos, a.pos, vm_vec_sub(b.pos, a.pos), s.fraction);
+			vm_vec_scale_add(qpp.vel, a.vel, vm_vec_sub(b.vel, a.vel), s.fraction);
+			vm_vec_scale_add(qpp.rotvel, a.rotvel, vm_vec_sub(b.rotvel, a.rotvel), s.fraction);
+			qpp.orient = net_udp_blend_quaternion(a.orient, b.orient, s.fraction);
+			break;
+		}
+	}
+	const auto &&segp = find_point_seg(LevelSharedSegmentState, qpp.pos, vcsegptridx(nearest.segment));
+	if (segp == segment_none)
+	{
+		qpp = nearest;
+		return false;
+	}
+	qpp.segment = segp;
+	return true;
+}
+
+/* A buffered sample names its segment by number.  Only use it if that
+ * number exists in the level being played.
+ */
+static bool net_udp_valid_sample_segment(const quaternionpos &qpp)
+{
+	return static_cast<std::size_t>(qpp.segment) < Segments.get_count();
+}
+
+/* Place every remote ship at its buffered position for this frame.
+ */
+static void net_udp_interpolate_players(const fix64 time)
+{
+	auto &Objects = LevelUniqueObjectState.Objects;
+	auto &vmobjptridx = Objects.vmptridx;
+	const fix delay = (fix{CGameArg.MplUdpInterpDelay} * F1_0) / 1000;
+	/* Past the newest update, keep the ship moving along its last known
+	 * velocity for at most this long before it freezes in place.
+	 */
+	constexpr fix max_extrapolation = F1_0 / 4;
+	for (unsigned i = 0; i < N_players; ++i)
+	{
+		if (i == Player_num)
+			continue;
+		auto &plr = *vcplayerptr(i);
+		if (plr.connected != player_connection_status::playing)
+			continue;
+		const auto s = UDP_pdata_buffer[i].sample(time, delay, max_extrapolation);
+		if (!s)
+			continue;
+		if (!net_udp_valid_sample_segment(s->from) || !net_udp_valid_sample_segment(s->to))
+			continue;
+		quaternionpos qpp;
+		net_udp_blend_quaternionpos(qpp, *s);
+		const auto &&obj = vmobjptridx(plr.objnum);
+		extract_quaternionpos(obj, qpp);
+		if (obj->movement_source == object::movement_type::physics)
+			set_thrust_from_velocity(obj);
+	}
+}
+
 }
 
 #if defined(DXX_BUILD_DESCENT_II)
@@ -61,6 +61,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #include "lighting.h"
 #include "newdemo.h"
+#include "demoexport.h"
 #include "newmenu.h"
 #include "gameseq.h"
 #include "hudmsg.h"
@@ -82,9 +83,15 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "playsave.h"
 
 #include "compiler-range_for.h"
+#include "d_enumerate.h"
 #include "d_levelstate.h"
 #include "partial_range.h"
+#include "byteutil.h"
+#include "lz_block.h"
+#include "timer.h"
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #define ND_EVENT_EOF				0	// EOF
 #define ND_EVENT_START_DEMO			1	// Followed by 16 character, NULL terminated filename of .SAV file to use
@@ -160,6 +167,39 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #endif
 
 #define DEMO_FILENAME				DEMO_DIR "tmpdemo.dem"
+// A packed demo unpacked from blocks, before it is expanded
+#define DEMO_STAGING_FILENAME			DEMO_DIR "tmpstage.tmp"
+// A packed demo expanded for playback
+#define DEMO_PLAYBACK_FILENAME			DEMO_DIR "tmpplay.tmp"
+
+/* A packed demo starts with nd_packed_signature and a storage byte,
+ * which older versions reject as not starting with ND_EVENT_START_DEMO.
+ * The events that follow are those of DEMO_VERSION, but with smaller
+ * object records, and with each object's shortpos stored as a change
+ * from the previous record of that object: see nd_write_object.  The
+ * previous records are forgotten every ND_PACKED_KEYFRAME_INTERVAL
+ * frames.
+ *
+ * Demos are recorded as raw storage, and packed into blocks of at most
+ * ND_PACKED_BLOCK_SIZE bytes when recording stops.  Each block has a
+ * little endian 32 bit stored size and original size, and then the
+ * stored bytes, which are an lz_block if the stored size is smaller.
+ * Playback seeks between frames, so a packed demo is expanded to the
+ * DEMO_VERSION format before it is played.
+ */
+constexpr std::array<uint8_t, 4> nd_packed_signature{{'D', 'X', 'D', 'Z'}};
+#define ND_PACKED_KEYFRAME_INTERVAL		64
+#define ND_PACKED_BLOCK_SIZE			0x10000
+
+enum class nd_packed_storage : uint8_t
+{
+	raw,
+	blocks,
+	/* Signature with an unknown storage byte */
+	invalid = UINT8_MAX - 1,
+	/* No signature: a DEMO_VERSION demo */
+	none = UINT8_MAX,
+};
 
 #define DEMO_MAX_LEVELS				29
 
@@ -187,6 +227,8 @@ static void nd_render_extras (ubyte which,const object &obj);
 
 // local var used for swapping endian demos
 static int swap_endian = 0;
+// local var set when rewritten frames differ in length from the originals
+static int rewrite_resizes = 0;
 
 // playback variables
 static unsigned int nd_playback_v_demosize;
@@ -197,6 +239,8 @@ static sbyte nd_playback_v_bad_read;
 static int nd_playback_v_framecount;
 static fix nd_playback_total, nd_recorded_total, nd_recorded_time;
 static sbyte nd_playback_v_style;
+static sbyte nd_playback_v_packed;
+static std::unordered_map<uint16_t, shortpos> nd_playback_v_shortpos;
 static ubyte nd_playback_v_dead = 0, nd_playback_v_rear = 0;
 #if defined(DXX_BUILD_DESCENT_II)
 static ubyte nd_playback_v_guided = 0;
@@ -211,6 +255,8 @@ static short nd_record_v_framebytes_written = 0;
 static int nd_record_v_recordframe = 1;
 static fix64 nd_record_v_recordframe_last_time = 0;
 static sbyte nd_record_v_no_space;
+static sbyte nd_record_v_packed;
+static std::unordered_map<uint16_t, shortpos> nd_record_v_shortpos;
 #if defined(DXX_BUILD_DESCENT_II)
 static int nd_record_v_juststarted = 0;
 static std::array<sbyte, MAX_OBJECTS> nd_record_v_objs,
@@ -342,6 +388,38 @@ static int newdemo_write(const T *buffer, int elsize, int nelem )
 	return _newdemo_write(buffer, elsize, nelem);
 }
 
+/* The header is not an event, so it is not counted in the frame bytes
+ * or in Newdemo_num_written.
+ */
+static int nd_write_packed_header(PHYSFS_File *const fp, const nd_packed_storage storage)
+{
+	std::array<uint8_t, 5> header;
+	std::copy(nd_packed_signature.begin(), nd_packed_signature.end(), header.begin());
+	header[4] = static_cast<uint8_t>(storage);
+	return (PHYSFS_write)(fp, header.data(), header.size(), 1) == 1;
+}
+
+/* Read the header of a packed demo.  If `fp` has none, seek back to the
+ * start and return nd_packed_storage::none.
+ */
+static nd_packed_storage nd_read_packed_header(PHYSFS_File *const fp)
+{
+	std::array<uint8_t, 5> header;
+	if ((PHYSFS_read)(fp, header.data(), header.size(), 1) != 1 || !std::equal(nd_packed_signature.begin(), nd_packed_signature.end(), header.begin()))
+	{
+		PHYSFS_seek(fp, 0);
+		return nd_packed_storage::none;
+	}
+	switch (const auto storage = nd_packed_storage{header[4]})
+	{
+		case nd_packed_storage::raw:
+		case nd_packed_storage::blocks:
+			return storage;
+		default:
+			return nd_packed_storage::invalid;
+	}
+}
+
 /*
  *  The next bunch of files taken from Matt's gamesave.c.  We have to modify
  *  these since the demo must save more information about objects that
@@ -394,7 +472,74 @@ static void nd_write_angvec(const vms_angvec &v)
 	nd_write_fixang(v.h);
 }
 
-static void nd_write_shortpos(const object_base &obj)
+/* Thrust is stored with the precision shortpos uses for velocity */
+static void nd_write_short_vector(const vms_vector &v)
+{
+	nd_write_short(v.x >> VEL_PRECISION);
+	nd_write_short(v.y >> VEL_PRECISION);
+	nd_write_short(v.z >> VEL_PRECISION);
+}
+
+/* The fields of a shortpos after its orientation, in the order they are
+ * stored.
+ */
+static std::array<int16_t, 7> nd_shortpos_fields(const shortpos &sp)
+{
+	return {{sp.xo, sp.yo, sp.zo, static_cast<int16_t>(sp.segment), sp.velx, sp.vely, sp.velz}};
+}
+
+static void nd_set_shortpos_fields(shortpos &sp, const std::array<int16_t, 7> &f)
+{
+	sp.xo = f[0];
+	sp.yo = f[1];
+	sp.zo = f[2];
+	sp.segment = segnum_t{static_cast<uint16_t>(f[3])};
+	sp.velx = f[4];
+	sp.vely = f[5];
+	sp.velz = f[6];
+}
+
+/* Write `d` zigzag encoded, seven bits per byte, with the high bit set on
+ * all but the last byte.  The difference of two shorts needs at most
+ * three bytes.
+ */
+static void nd_write_delta(const int32_t d)
+{
+	for (uint32_t z = (static_cast<uint32_t>(d) << 1) ^ static_cast<uint32_t>(d >> 31);; z >>= 7)
+	{
+		if (z < 0x80)
+		{
+			nd_write_byte(static_cast<int8_t>(z));
+			break;
+		}
+		nd_write_byte(static_cast<int8_t>(z | 0x80));
+	}
+}
+
+/* Write a mask of the parts of `sp` that differ from the previous record
+ * of the object with `signature`, with bit 0 for the orientation and
+ * the following bits for each of nd_shortpos_fields, and then those
+ * parts.
+ */
+static void nd_write_packed_shortpos(const shortpos &sp, const uint16_t signature)
+{
+	auto &prev = nd_record_v_shortpos[signature];
+	const auto fields = nd_shortpos_fields(sp), prev_fields = nd_shortpos_fields(prev);
+	uint8_t mask = (sp.bytemat != prev.bytemat);
+	for (std::size_t i = 0; i < fields.size(); ++i)
+		if (fields[i] != prev_fields[i])
+			mask |= 2 << i;
+	nd_write_byte(mask);
+	if (mask & 1)
+		range_for (auto &i, sp.bytemat)
+			nd_write_byte(i);
+	for (std::size_t i = 0; i < fields.size(); ++i)
+		if (mask & (2 << i))
+			nd_write_delta(fields[i] - prev_fields[i]);
+	prev = sp;
+}
+
+static void nd_write_shortpos(const object_base &obj, const uint16_t signature)
 {
 	shortpos sp;
 	ubyte render_type;
@@ -415,6 +560,15 @@ static void nd_write_shortpos(const object_base &obj)
 			Int3();         // contact Allender about this.
 		}
 	}
+	else if (nd_record_v_packed)
+		/* Not stored, so keep it out of the previous record */
+		sp.bytemat = {};
+
+	if (nd_record_v_packed)
+	{
+		nd_write_packed_shortpos(sp, signature);
+		return;
+	}
 
 	nd_write_short(sp.xo);
 	nd_write_short(sp.yo);
@@ -529,7 +683,56 @@ static void nd_read_angvec(vms_angvec &v)
 	nd_read_fixang(&v.h);
 }
 
-static void nd_read_shortpos(object_base &obj)
+static void nd_read_short_vector(vms_vector &v)
+{
+	int16_t x, y, z;
+	nd_read_short(&x);
+	nd_read_short(&y);
+	nd_read_short(&z);
+	v.x = x << VEL_PRECISION;
+	v.y = y << VEL_PRECISION;
+	v.z = z << VEL_PRECISION;
+}
+
+static int32_t nd_read_delta()
+{
+	uint32_t z = 0;
+	for (unsigned shift = 0;; shift += 7)
+	{
+		uint8_t b;
+		nd_read_byte(&b);
+		z |= static_cast<uint32_t>(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			break;
+		if (shift == 14)
+		{
+			/* Longer than any difference of two shorts */
+			nd_playback_v_bad_read = -1;
+			break;
+		}
+	}
+	return static_cast<int32_t>(z >> 1) ^ -static_cast<int32_t>(z & 1);
+}
+
+/* Read the record written by nd_write_packed_shortpos. */
+static void nd_read_packed_shortpos(shortpos &sp, const uint16_t signature)
+{
+	auto &prev = nd_playback_v_shortpos[signature];
+	uint8_t mask;
+	nd_read_byte(&mask);
+	sp.bytemat = prev.bytemat;
+	if (mask & 1)
+		range_for (auto &i, sp.bytemat)
+			nd_read_byte(&i);
+	auto fields = nd_shortpos_fields(prev);
+	for (std::size_t i = 0; i < fields.size(); ++i)
+		if (mask & (2 << i))
+			fields[i] = static_cast<int16_t>(fields[i] + nd_read_delta());
+	nd_set_shortpos_fields(sp, fields);
+	prev = sp;
+}
+
+static void nd_read_shortpos(object_base &obj, const uint16_t signature)
 {
 	auto &LevelSharedVertexState = LevelSharedSegmentState.get_vertex_state();
 	auto &Vertices = LevelSharedVertexState.get_vertices();
@@ -538,6 +741,10 @@ static void nd_read_shortpos(object_base &obj)
 	shortpos sp{};
 
 	render_type = obj.render_type;
+	if (nd_playback_v_packed)
+		nd_read_packed_shortpos(sp, signature);
+	else
+	{
 	if ((render_type == RT_POLYOBJ || render_type == RT_HOSTAGE || render_type == RT_MORPH) || obj.type == OBJ_CAMERA)
 	{
 		range_for (auto &i, sp.bytemat)
@@ -551,6 +758,7 @@ static void nd_read_shortpos(object_base &obj)
 	nd_read_short(&sp.velx);
 	nd_read_short(&sp.vely);
 	nd_read_short(&sp.velz);
+	}
 
 	my_extract_shortpos(obj, &sp);
 	if (obj.type == OBJ_FIREBALL && get_fireball_id(obj) == VCLIP_MORPHING_ROBOT && render_type == RT_FIREBALL && obj.control_source == object::control_type::explosion)
@@ -618,7 +826,7 @@ static void nd_read_object(const vmobjptridx_t obj)
 	nd_read_short(&shortsig);
 	// It's OKAY! We made sure, obj->signature is never has a value which short cannot handle!!! We cannot do this otherwise, without breaking the demo format!
 	obj->signature = object_signature_t{static_cast<uint16_t>(shortsig)};
-	nd_read_shortpos(obj);
+	nd_read_shortpos(obj, static_cast<uint16_t>(shortsig));
 
 #if defined(DXX_BUILD_DESCENT_II)
 	if ((obj->type == OBJ_ROBOT) && (get_robot_id(obj) == SPECIAL_REACTOR_ROBOT))
@@ -697,6 +905,7 @@ static void nd_read_object(const vmobjptridx_t obj)
 	}
 
 
+	if (!nd_playback_v_packed)
 	{
 		vms_vector last_pos;
 		nd_read_vector(last_pos);
@@ -727,8 +936,14 @@ static void nd_read_object(const vmobjptridx_t obj)
 	switch (obj->movement_source) {
 
 	case object::movement_type::physics:
-		nd_read_vector(obj->mtype.phys_info.velocity);
-		nd_read_vector(obj->mtype.phys_info.thrust);
+		if (nd_playback_v_packed)
+			/* Velocity was already read from the shortpos */
+			nd_read_short_vector(obj->mtype.phys_info.thrust);
+		else
+		{
+			nd_read_vector(obj->mtype.phys_info.velocity);
+			nd_read_vector(obj->mtype.phys_info.thrust);
+		}
 		break;
 
 	case object::movement_type::spinning:
@@ -800,21 +1015,50 @@ static void nd_read_object(const vmobjptridx_t obj)
 		int tmo;
 
 		if ((obj->type != OBJ_ROBOT) && (obj->type != OBJ_PLAYER) && (obj->type != OBJ_CLUTTER)) {
-			int i;
-			nd_read_int(&i);
-			obj->rtype.pobj_info.model_num = static_cast<polygon_model_index>(i);
+			if (nd_playback_v_packed)
+			{
+				uint8_t i;
+				nd_read_byte(&i);
+				obj->rtype.pobj_info.model_num = static_cast<polygon_model_index>(i);
+			}
+			else
+			{
+				int i;
+				nd_read_int(&i);
+				obj->rtype.pobj_info.model_num = static_cast<polygon_model_index>(i);
+			}
 			nd_read_int(&(obj->rtype.pobj_info.subobj_flags));
 		}
 
 		if ((obj->type != OBJ_PLAYER) && (obj->type != OBJ_DEBRIS))
+		{
 #if 0
 			range_for (auto &i, obj->pobj_info.anim_angles)
 				nd_read_angvec(&(i));
 #endif
-		range_for (auto &i, partial_range(obj->rtype.pobj_info.anim_angles, Polygon_models[obj->rtype.pobj_info.model_num].n_models))
-			nd_read_angvec(i);
+			const auto &&anim_angles = partial_range(obj->rtype.pobj_info.anim_angles, Polygon_models[obj->rtype.pobj_info.model_num].n_models);
+			if (nd_playback_v_packed)
+			{
+				/* Only the submodels whose bit is set have angles */
+				uint16_t mask;
+				nd_read_short(&mask);
+				for (auto &&[idx, i] : enumerate(anim_angles))
+					if (mask & (1u << idx))
+						nd_read_angvec(i);
+			}
+			else
+				range_for (auto &i, anim_angles)
+					nd_read_angvec(i);
+		}
 
-		nd_read_int(&tmo);
+		if (nd_playback_v_packed)
+		{
+			int16_t s;
+			nd_read_short(&s);
+			tmo = s;
+		}
+		else
+			nd_read_int(&tmo);
 
 #if !DXX_USE_EDITOR
 		obj->rtype.pobj_info.tmap_override = tmo;
@@ -838,7 +1082,14 @@ static void nd_read_object(const vmobjptridx_t obj)
 	case RT_WEAPON_VCLIP:
 	case RT_FIREBALL:
 	case RT_HOSTAGE:
-		nd_read_int(&(obj->rtype.vclip_info.vclip_num));
+		if (nd_playback_v_packed)
+		{
+			int16_t s;
+			nd_read_short(&s);
+			obj->rtype.vclip_info.vclip_num = s;
+		}
+		else
+			nd_read_int(&(obj->rtype.vclip_info.vclip_num));
 		nd_read_fix(&(obj->rtype.vclip_info.frametime));
 		nd_read_byte(&obj->rtype.vclip_info.framenum);
 		break;
@@ -880,7 +1131,7 @@ static void nd_write_object(const vcobjptridx_t objp)
 	nd_write_byte(obj.flags);
 	shortsig = nd_get_object_signature(objp);
 	nd_write_short(shortsig);
-	nd_write_shortpos(obj);
+	nd_write_shortpos(obj, shortsig);
 
 	if (obj.type != OBJ_HOSTAGE && obj.type != OBJ_ROBOT && obj.type != OBJ_PLAYER && obj.type != OBJ_POWERUP && obj.type != OBJ_CLUTTER)
 	{
@@ -891,7 +1142,9 @@ static void nd_write_object(const vcobjptridx_t objp)
 	if (obj.type == OBJ_POWERUP)
 		nd_write_byte(static_cast<uint8_t>(obj.movement_source));
 
-	nd_write_vector(obj.pos);
+	// Unused on playback, and the shortpos already has the position
+	if (!nd_record_v_packed)
+		nd_write_vector(obj.pos);
 
 	if (obj.type == OBJ_WEAPON && obj.render_type == RT_WEAPON_VCLIP)
 		nd_write_fix(obj.lifeleft);
@@ -917,8 +1170,13 @@ static void nd_write_object(const vcobjptridx_t objp)
 	switch (obj.movement_source) {
 
 	case object::movement_type::physics:
-		nd_write_vector(obj.mtype.phys_info.velocity);
-		nd_write_vector(obj.mtype.phys_info.thrust);
+		if (nd_record_v_packed)
+			nd_write_short_vector(obj.mtype.phys_info.thrust);
+		else
+		{
+			nd_write_vector(obj.mtype.phys_info.velocity);
+			nd_write_vector(obj.mtype.phys_info.thrust);
+		}
 		break;
 
 	case object::movement_type::spinning:
@@ -977,15 +1235,39 @@ static void nd_write_object(const vcobjptridx_t objp)
 	case RT_MORPH:
 	case RT_POLYOBJ: {
 		if ((obj.type != OBJ_ROBOT) && (obj.type != OBJ_PLAYER) && (obj.type != OBJ_CLUTTER)) {
-			nd_write_int(underlying_value(obj.rtype.pobj_info.model_num));
+			if (nd_record_v_packed)
+				nd_write_byte(underlying_value(obj.rtype.pobj_info.model_num));
+			else
+				nd_write_int(underlying_value(obj.rtype.pobj_info.model_num));
 			nd_write_int(obj.rtype.pobj_info.subobj_flags);
 		}
 
 		if ((obj.type != OBJ_PLAYER) && (obj.type != OBJ_DEBRIS))
-			range_for (auto &i, partial_const_range(obj.rtype.pobj_info.anim_angles, Polygon_models[obj.rtype.pobj_info.model_num].n_models))
-			nd_write_angvec(i);
+		{
+			const auto &&anim_angles = partial_const_range(obj.rtype.pobj_info.anim_angles, Polygon_models[obj.rtype.pobj_info.model_num].n_models);
+			if (nd_record_v_packed)
+			{
+				/* Most submodels are at rest, so write a mask of those
+				 * which are not, then only their angles.
+				 */
+				uint16_t mask = 0;
+				for (auto &&[idx, i] : enumerate(anim_angles))
+					if (i.p || i.b || i.h)
+						mask |= 1u << idx;
+				nd_write_short(mask);
+				for (auto &&[idx, i] : enumerate(anim_angles))
+					if (mask & (1u << idx))
+						nd_write_angvec(i);
+			}
+			else
+				range_for (auto &i, anim_angles)
+					nd_write_angvec(i);
+		}
 
-		nd_write_int(obj.rtype.pobj_info.tmap_override);
+		if (nd_record_v_packed)
+			nd_write_short(obj.rtype.pobj_info.tmap_override);
+		else
+			nd_write_int(obj.rtype.pobj_info.tmap_override);
 
 		break;
 	}
@@ -994,7 +1276,10 @@ static void nd_write_object(const vcobjptridx_t objp)
 	case RT_WEAPON_VCLIP:
 	case RT_FIREBALL:
 	case RT_HOSTAGE:
-		nd_write_int(obj.rtype.vclip_info.vclip_num);
+		if (nd_record_v_packed)
+			nd_write_short(obj.rtype.vclip_info.vclip_num);
+		else
+			nd_write_int(obj.rtype.vclip_info.vclip_num);
 		nd_write_fix(obj.rtype.vclip_info.frametime);
 		nd_write_byte(obj.rtype.vclip_info.framenum);
 		break;
@@ -1080,6 +1365,10 @@ void newdemo_record_start_demo()
 	nd_record_v_recordframe_last_time=GameTime64-REC_DELAY; // make sure first frame is recorded!
 
 	pause_game_world_time p;
+	nd_record_v_packed = CGameArg.SysRecordPackedDemo;
+	nd_record_v_shortpos.clear();
+	if (nd_record_v_packed)
+		nd_write_packed_header(outfile, nd_packed_storage::raw);
 	nd_write_byte(ND_EVENT_START_DEMO);
 	nd_write_byte(DEMO_VERSION);
 	nd_write_byte(DEMO_GAME_TYPE);
@@ -1190,6 +1479,8 @@ void newdemo_record_start_frame(fix frame_time )
 		nd_write_short(nd_record_v_framebytes_written - 1);        // from previous frame
 		nd_record_v_framebytes_written=3;
 		nd_write_int(nd_record_v_frame_number);
+		if (!(nd_record_v_frame_number % ND_PACKED_KEYFRAME_INTERVAL))
+			nd_record_v_shortpos.clear();
 		nd_record_v_frame_number++;
 		nd_write_int(frame_time);
 	}
@@ -1738,8 +2029,7 @@ static int newdemo_read_demo_start(enum purpose_type purpose)
 		return 1;
 	}
 	nd_read_byte(&version);
-	if (purpose == PURPOSE_REWRITE)
-		nd_write_byte(version);
+	nd_playback_v_shortpos.clear();
 #if defined(DXX_BUILD_DESCENT_I)
 	if (version == DEMO_VERSION_SHAREWARE)
 		shareware = 1;
@@ -1750,6 +2040,14 @@ static int newdemo_read_demo_start(enum purpose_type purpose)
 		return 1;
 	}
 #endif
+	if (purpose == PURPOSE_REWRITE)
+	{
+		/* Shareware demos differ in more than their objects */
+		if (shareware && (nd_playback_v_packed || nd_record_v_packed))
+			return 1;
+		nd_record_v_shortpos.clear();
+		nd_write_byte(version);
+	}
 	nd_read_byte(&game_type);
 	if (purpose == PURPOSE_REWRITE)
 		nd_write_byte(game_type);
@@ -2108,11 +2406,15 @@ static int newdemo_read_frame_information(int rewrite)
 			nd_read_int(&nd_playback_v_framecount);
 			nd_read_int(&nd_recorded_time);
 			if (nd_playback_v_bad_read) { done = -1; break; }
+			if (!(nd_playback_v_framecount % ND_PACKED_KEYFRAME_INTERVAL))
+				nd_playback_v_shortpos.clear();
 			if (rewrite)
 			{
-				nd_write_short(last_frame_length);
+				nd_write_short(rewrite_resizes ? nd_record_v_framebytes_written - 1 : last_frame_length);
 				nd_record_v_framebytes_written = 3;
 				nd_write_int(nd_playback_v_framecount);
+				if (!(nd_playback_v_framecount % ND_PACKED_KEYFRAME_INTERVAL))
+					nd_record_v_shortpos.clear();
 				nd_write_int(nd_recorded_time);
 				break;
 			}
@@ -4032,6 +4334,178 @@ static void newdemo_write_end()
 	nd_write_byte(ND_EVENT_EOF);
 }
 
+namespace {
+
+/* Compress the raw packed demo at `inpath` into blocks at `outpath`. */
+static bool nd_pack_file(const char *const inpath, const char *const outpath)
+{
+	const auto in = PHYSFSX_openReadBuffered(inpath).first;
+	if (!in || nd_read_packed_header(in) != nd_packed_storage::raw)
+		return false;
+	bool ok;
+	{
+		const auto out = PHYSFSX_openWriteBuffered(outpath).first;
+		if (!out)
+			return false;
+		ok = nd_write_packed_header(out, nd_packed_storage::blocks);
+		std::vector<uint8_t> block(ND_PACKED_BLOCK_SIZE), packed(8 + lz_block_bound(ND_PACKED_BLOCK_SIZE));
+		while (ok)
+		{
+			const auto n = (PHYSFS_read)(in, block.data(), 1, block.size());
+			if (n <= 0)
+			{
+				ok = !n;
+				break;
+			}
+			const uint32_t size = n;
+			uint32_t stored = lz_block_compress(std::span(block).first(size), std::span(packed).subspan(8));
+			if (stored >= size)
+			{
+				std::copy_n(block.begin(), size, packed.begin() + 8);
+				stored = size;
+			}
+			PUT_INTEL_INT(&packed[0], stored);
+			PUT_INTEL_INT(&packed[4], size);
+			ok = (PHYSFS_write)(out, packed.data(), 8 + stored, 1) == 1;
+		}
+	}
+	if (!ok)
+		PHYSFS_delete(outpath);
+	return ok;
+}
+
+/* Decompress the blocks of the packed demo at `inpath` into a raw packed
+ * demo at `outpath`.
+ */
+static bool nd_unpack_file(const char *const inpath, const char *const outpath)
+{
+	const auto in = PHYSFSX_openReadBuffered(inpath).first;
+	if (!in || nd_read_packed_header(in) != nd_packed_storage::blocks)
+		return false;
+	bool ok;
+	{
+		const auto out = PHYSFSX_openWriteBuffered(outpath).first;
+		if (!out)
+			return false;
+		ok = nd_write_packed_header(out, nd_packed_storage::raw);
+		std::vector<uint8_t> stored(ND_PACKED_BLOCK_SIZE), block(ND_PACKED_BLOCK_SIZE);
+		while (ok)
+		{
+			std::array<uint8_t, 8> sizes;
+			const auto n = (PHYSFS_read)(in, sizes.data(), 1, sizes.size());
+			if (!n)
+				break;
+			const uint32_t stored_size = GET_INTEL_INT(&sizes[0]), size = GET_INTEL_INT(&sizes[4]);
+			if (n != static_cast<PHYSFS_sint64>(sizes.size()) || !size || size > block.size() || stored_size > size ||
+				(PHYSFS_read)(in, stored.data(), 1, stored_size) != stored_size)
+			{
+				ok = false;
+				break;
+			}
+			if (stored_size == size)
+				ok = (PHYSFS_write)(out, stored.data(), size, 1) == 1;
+			else
+				ok = lz_block_decompress(std::span(stored).first(stored_size), std::span(block).first(size)) &&
+					(PHYSFS_write)(out, block.data(), size, 1) == 1;
+		}
+	}
+	if (!ok)
+		PHYSFS_delete(outpath);
+	return ok;
+}
+
+/* Read the demo at `inpath` and write it to `outpath`, with its objects
+ * packed or not as given.  A packed `inpath` must be raw.  Return true
+ * if the whole demo was rewritten.
+ */
+static bool nd_rewrite_demo(const char *const inpath, const char *const outpath, const bool packed_in, const bool packed_out)
+{
+	infile = PHYSFSX_openReadBuffered(inpath).first;
+	if (!infile)
+		return false;
+	nd_playback_v_demosize = PHYSFS_fileLength(infile);	// should be exactly the same size unless (un)packing
+	if (packed_in && nd_read_packed_header(infile) != nd_packed_storage::raw)
+	{
+		infile.reset();
+		return false;
+	}
+	outfile = PHYSFSX_openWriteBuffered(outpath).first;
+	if (!outfile)
+	{
+		infile.reset();
+		return false;
+	}
+	if (packed_out)
+		nd_write_packed_header(outfile, nd_packed_storage::raw);
+
+	Newdemo_num_written = 0;
+	nd_record_v_framebytes_written = 0;
+	nd_playback_v_bad_read = 0;
+	nd_playback_v_at_eof = 0;
+	nd_playback_v_packed = packed_in;
+	nd_record_v_packed = packed_out;
+	rewrite_resizes = packed_in != packed_out;
+	Newdemo_state = ND_STATE_NORMAL;	// not doing anything special really
+
+	bool complete = false;
+	if (!newdemo_read_demo_start(PURPOSE_REWRITE))
+	{
+		while (newdemo_read_frame_information(1) == 1) {}	// rewrite all frames
+
+		newdemo_goto_end(1);	// get end of demo data
+		newdemo_write_end();	// and write it
+
+		complete = rewrite_resizes
+			? nd_playback_v_at_eof && !nd_playback_v_bad_read
+			: nd_playback_v_demosize == Newdemo_num_written;
+	}
+	nd_playback_v_packed = 0;
+	rewrite_resizes = 0;
+	infile.reset();
+	outfile.reset();
+	return complete;
+}
+
+/* Expand the packed demo at `path` to DEMO_PLAYBACK_FILENAME. */
+static bool nd_expand_demo(const char *const path, const nd_packed_storage storage)
+{
+	const auto start_time = timer_query();
+	const char *rawpath = path;
+	if (storage == nd_packed_storage::blocks)
+	{
+		if (!nd_unpack_file(path, DEMO_STAGING_FILENAME))
+			return false;
+		rawpath = DEMO_STAGING_FILENAME;
+	}
+	else if (storage != nd_packed_storage::raw)
+		return false;
+	const auto complete = nd_rewrite_demo(rawpath, DEMO_PLAYBACK_FILENAME, true, false);
+	if (rawpath != path)
+		PHYSFS_delete(DEMO_STAGING_FILENAME);
+	if (!complete)
+	{
+		PHYSFS_delete(DEMO_PLAYBACK_FILENAME);
+		return false;
+	}
+	con_printf(CON_VERBOSE, "DEMO: expanded %s to %i bytes in %.3f seconds", path, Newdemo_num_written, f2fl(timer_query() - start_time));
+	return true;
+}
+
+/* Move the recording in DEMO_FILENAME to `path`, packed into blocks if
+ * it was recorded packed.  If packing fails, the raw demo is kept, since
+ * it can still be played.
+ */
+static void nd_save_recording(const char *const path)
+{
+	PHYSFS_delete(path);
+	if (nd_record_v_packed && nd_pack_file(DEMO_FILENAME, path))
+		PHYSFS_delete(DEMO_FILENAME);
+	else
+		PHYSFSX_rename(DEMO_FILENAME, path);
+}
+
+}
+
 static bool guess_demo_name(ntstring<PATH_MAX - 16> &filename)
 {
 	filename.front() = 0;
@@ -4160,7 +4634,7 @@ try_again:
 		} else
 			snprintf(save_file, sizeof(save_file), DEMO_FORMAT_STRING("tmp%d"), tmpcnt++);
 		remove(save_file);
-		PHYSFSX_rename(DEMO_FILENAME, save_file);
+		nd_save_recording(save_file);
 		return;
 	}
 	if (exit == -1) {               // pressed ESC
@@ -4192,8 +4666,7 @@ try_again:
 
 	char fullname[PATH_MAX];
 	snprintf(fullname, sizeof(fullname), DEMO_FORMAT_STRING("%s"), filename.data());
-	PHYSFS_delete(fullname);
-	PHYSFSX_rename(DEMO_FILENAME, fullname);
+	nd_save_recording(fullname);
 }
 
 //returns the number of demo files on the disk
@@ -4258,6 +4731,19 @@ void newdemo_start_playback(const char * filename)
 		return;
 	}
 
+	if (const auto storage = nd_read_packed_header(infile); storage != nd_packed_storage::none)
+	{
+		infile.reset();
+		if (!nd_expand_demo(filename2, storage))
+		{
+			nm_messagebox(menu_title{nullptr}, {TXT_OK}, "%s %s", TXT_CANT_PLAYBACK, TXT_DEMO_CORRUPT);
+			return;
+		}
+		infile = PHYSFSX_openReadBuffered(DEMO_PLAYBACK_FILENAME).first;
+		if (!infile)
+			return;
+	}
+
 	nd_playback_v_bad_read = 0;
 	change_playernum_to(0);                 // force playernum to 0
 	auto &plr = get_local_player();
@@ -4305,6 +4791,8 @@ namespace dsx {
 void newdemo_stop_playback()
 {
 	infile.reset();
+	PHYSFS_delete(DEMO_PLAYBACK_FILENAME);
+	demo_export_finish();
 	Newdemo_state = ND_STATE_NORMAL;
 	change_playernum_to(0);             //this is reality
 	get_local_player().callsign = nd_playback_v_save_callsign;
@@ -4319,70 +4807,143 @@ void newdemo_stop_playback()
 }
 }
 
-
 int newdemo_swap_endian(const char *filename)
 {
 	char inpath[PATH_MAX+FILENAME_LEN] = DEMO_DIR;
-	int complete = 0;
 
 	if (filename)
 		strcat(inpath, filename);
 	else
 		return 0;
 
-	infile = PHYSFSX_openReadBuffered(inpath).first;
-	if (!infile)
-		goto read_error;
-
-	nd_playback_v_demosize = PHYSFS_fileLength(infile);	// should be exactly the same size
-	outfile = PHYSFSX_openWriteBuffered(DEMO_FILENAME).first;
-	if (!outfile)
+	if (const auto fp = PHYSFSX_openReadBuffered(inpath).first; fp && nd_read_packed_header(fp) != nd_packed_storage::none)
 	{
-		infile.reset();
-		goto read_error;
+		nm_messagebox(menu_title{nullptr}, {TXT_OK}, "Demo %s is packed\nand cannot be converted", filename);
+		return 0;
 	}
 
-	Newdemo_num_written = 0;
-	nd_playback_v_bad_read = 0;
 	swap_endian = 1;
-	nd_playback_v_at_eof = 0;
-	Newdemo_state = ND_STATE_NORMAL;	// not doing anything special really
+	const auto complete = nd_rewrite_demo(inpath, DEMO_FILENAME, false, false);
+	swap_endian = 0;
 
-	if (newdemo_read_demo_start(PURPOSE_REWRITE)) {
-		infile.reset();
-		outfile.reset();
-		swap_endian = 0;
-		return 0;
+	std::array<char, PATH_MAX> bakpath;
+	if (complete && change_filename_extension(bakpath, inpath, DEMO_BACKUP_EXT))
+	{
+		PHYSFSX_rename(inpath, bakpath.data());
+		PHYSFSX_rename(DEMO_FILENAME, inpath);
 	}
+	else
+		PHYSFS_delete(DEMO_FILENAME);	// clean up the mess
 
-	while (newdemo_read_frame_information(1) == 1) {}	// rewrite all frames
+	nm_messagebox(menu_title{nullptr}, {TXT_OK}, complete ? "Demo %s converted%s" : "Error converting demo\n%s\n%s", filename,
+				  complete ? "" : (nd_playback_v_at_eof ? TXT_DEMO_CORRUPT : PHYSFS_getLastError()));
 
-	newdemo_goto_end(1);	// get end of demo data
-	newdemo_write_end();	// and write it
+	return nd_playback_v_at_eof;
+}
 
-	swap_endian = 0;
-	complete = nd_playback_v_demosize == Newdemo_num_written;
-	infile.reset();
-	outfile.reset();
+namespace {
+
+struct nd_pack_result
+{
+	bool complete;
+	unsigned unpacked_size, packed_size;
+	float elapsed;
+};
+
+/* Pack the demo at `inpath`, which must not already be packed, and keep
+ * the original as a backup.
+ */
+static nd_pack_result nd_pack_demo(const char *const inpath)
+{
+	nd_pack_result r{};
+	const auto start_time = timer_query();
+	/* Delta encode into DEMO_FILENAME, then compress the result into
+	 * DEMO_STAGING_FILENAME.
+	 */
+	r.complete = nd_rewrite_demo(inpath, DEMO_FILENAME, false, true) && nd_pack_file(DEMO_FILENAME, DEMO_STAGING_FILENAME);
+	r.elapsed = f2fl(timer_query() - start_time);
+	r.unpacked_size = nd_playback_v_demosize;
+	PHYSFS_delete(DEMO_FILENAME);
 
 	std::array<char, PATH_MAX> bakpath;
-	if (complete && change_filename_extension(bakpath, inpath, DEMO_BACKUP_EXT))
+	if (r.complete && change_filename_extension(bakpath, inpath, DEMO_BACKUP_EXT))
 	{
+		if (const auto fp = PHYSFSX_openReadBuffered(DEMO_STAGING_FILENAME).first)
+			r.packed_size = PHYSFS_fileLength(fp);
 		PHYSFSX_rename(inpath, bakpath.data());
-		PHYSFSX_rename(DEMO_FILENAME, inpath);
+		PHYSFSX_rename(DEMO_STAGING_FILENAME, inpath);
+		con_printf(CON_VERBOSE, "DEMO: packed %s from %u bytes to %u bytes in %.3f seconds", inpath, r.unpacked_size, r.packed_size, r.elapsed);
 	}
 	else
-		PHYSFS_delete(DEMO_FILENAME);	// clean up the mess
+	{
+		r.complete = false;
+		PHYSFS_delete(DEMO_STAGING_FILENAME);
+	}
+	return r;
+}
+
+static bool nd_is_packed(const char *const inpath)
+{
+	const auto fp = PHYSFSX_openReadBuffered(inpath).first;
+	return fp && nd_read_packed_header(fp) != nd_packed_storage::none;
+}
+
+}
+
+int newdemo_pack(const char *filename)
+{
+	char inpath[PATH_MAX+FILENAME_LEN] = DEMO_DIR;
+
+	if (filename)
+		strcat(inpath, filename);
+	else
+		return 0;
 
-read_error:
+	if (nd_is_packed(inpath))
 	{
-		nm_messagebox(menu_title{nullptr}, {TXT_OK}, complete ? "Demo %s converted%s" : "Error converting demo\n%s\n%s", filename,
-					  complete ? "" : (nd_playback_v_at_eof ? TXT_DEMO_CORRUPT : PHYSFS_getLastError()));
+		nm_messagebox(menu_title{nullptr}, {TXT_OK}, "Demo %s is already packed", filename);
+		return 0;
 	}
 
+	const auto r = nd_pack_demo(inpath);
+	if (r.complete)
+		nm_messagebox(menu_title{nullptr}, {TXT_OK}, "Demo %s packed\n%u bytes, was %u\n%.1f MB/s", filename, r.packed_size, r.unpacked_size,
+					  r.elapsed > 0 ? r.unpacked_size / (r.elapsed * 1048576) : 0.);
+	else
+		nm_messagebox(menu_title{nullptr}, {TXT_OK}, "Error packing demo\n%s\n%s", filename, nd_playback_v_at_eof ? TXT_DEMO_CORRUPT : PHYSFS_getLastError());
+
 	return nd_playback_v_at_eof;
 }
 
+void newdemo_pack_all()
+{
+	unsigned demos = 0, failed = 0;
+	unsigned long long unpacked_size = 0, packed_size = 0;
+	float elapsed = 0;
+	range_for (const auto i, PHYSFSX_findFiles(DEMO_DIR, demo_file_extensions))
+	{
+		char inpath[PATH_MAX+FILENAME_LEN] = DEMO_DIR;
+		strcat(inpath, i);
+		if (nd_is_packed(inpath))
+			continue;
+		const auto r = nd_pack_demo(inpath);
+		if (!r.complete)
+		{
+			con_printf(CON_URGENT, "DEMO: cannot pack %s: %s", inpath, nd_playback_v_at_eof ? TXT_DEMO_CORRUPT : PHYSFS_getLastError());
+			++failed;
+			continue;
+		}
+		con_printf(CON_NORMAL, "DEMO: packed %s: %u bytes, was %u (%.1f%%), %.1f MB/s", inpath, r.packed_size, r.unpacked_size,
+				   r.unpacked_size ? 100. * r.packed_size / r.unpacked_size : 0., r.elapsed > 0 ? r.unpacked_size / (r.elapsed * 1048576) : 0.);
+		++demos;
+		unpacked_size += r.unpacked_size;
+		packed_size += r.packed_size;
+		elapsed += r.elapsed;
+	}
+	con_printf(CON_NORMAL, "DEMO: packed %u demos from %llu bytes to %llu bytes (%.1f%%) in %.3f seconds, %.1f MB/s; %u failed", demos, unpacked_size, packed_size,
+			   unpacked_size ? 100. * packed_size / unpacked_size : 0., elapsed, elapsed > 0 ? unpacked_size / (elapsed * 1048576) : 0., failed);
+}
+
 #if defined(DXX_BUILD_DESCENT_II)
 static void nd_render_extras (ubyte which,const object &obj)
 {
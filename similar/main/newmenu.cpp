@@ -55,6 +55,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #endif
 
 #include "compiler-range_for.h"
+#include "d_range.h"
 #include "d_zip.h"
 #include "partial_range.h"
 
@@ -1692,6 +1693,7 @@ listbox::listbox(int citem, unsigned nitems, const char **item, menu_title title
 	listbox_layout(citem, nitems, item, title, canvas), window(canvas, box_x - BORDERX, box_y - title_height - BORDERY, box_w + 2 * BORDERX, height + 2 * BORDERY),
 	allow_abort_flag(allow_abort_flag)
 {
+	set_animated(0);
 }
 
 const char **listbox_get_items(listbox &lb)
@@ -1716,6 +1718,8 @@ void listbox_delete_item(listbox &lb, int item)
 		auto &items = lb.item;
 		std::rotate(&items[item], &items[item + 1], &items[nitems]);
 	}
+	if (static_cast<std::size_t>(item) < lb.metrics.size())
+		lb.metrics.erase(std::next(lb.metrics.begin(), item));
 	-- lb.nitems;
 	if (lb.citem >= lb.nitems)
 		lb.citem = lb.nitems ? lb.nitems - 1 : 0;
@@ -1917,6 +1921,71 @@ static window_event_result listbox_key_command(const d_event &event, listbox *lb
 
 namespace dcx {
 
+namespace {
+
+static unsigned listbox_max_box_width()
+{
+	return SWIDTH - (BORDERX * 2);
+}
+
+/* Return the number of characters of `text` which are shown at once
+ * when `text` is too wide for a box `max_width` wide.
+ */
+static unsigned listbox_marquee_chars(const grs_font &font, const char *const text, const unsigned max_width)
+{
+	unsigned mmc = 1;
+	for (;; ++mmc)
+	{
+		const auto w2 = gr_get_string_size(font, text, mmc).width;
+		if (w2 > max_width || mmc > 128)
+			break;
+	}
+	/* mmc is now the shortest initial subsequence that is wider
+	 * than max_width.
+	 *
+	 * Next, search for whether any internal subsequences of
+	 * lesser length are also too wide.  This can happen if all
+	 * the initial characters are narrow, then characters
+	 * outside the initial subsequence are wide.
+	 */
+	for (auto j = text;;)
+	{
+		const auto w2 = gr_get_string_size(font, j, mmc).width;
+		if (w2 > max_width)
+		{
+			/* This subsequence is too long.  Reduce the length
+			 * and retry.
+			 */
+			if (!--mmc)
+				break;
+		}
+		else
+		{
+			/* This subsequence fits.  Move to the next
+			 * character.
+			 */
+			if (!*++j)
+				break;
+		}
+	}
+	return mmc;
+}
+
+}
+
+const listbox_layout::item_metrics &listbox_layout::measure_item(const unsigned i)
+{
+	auto &m = metrics[i];
+	auto &medium3_font = *MEDIUM3_FONT;
+	const auto &&fspacx10 = FSPACX(10);
+	if (m.width == item_metrics::unmeasured)
+		m.width = gr_get_string_size(medium3_font, item[i]).width + fspacx10;
+	const auto max_box_width = listbox_max_box_width();
+	if (m.width > max_box_width && m.marquee_chars == item_metrics::unmeasured)
+		m.marquee_chars = listbox_marquee_chars(medium3_font, item[i], max_box_width - fspacx10);
+	return m;
+}
+
 void listbox_layout::create_structure()
 {
 	auto &canvas = parent_canvas;
@@ -1924,54 +1993,21 @@ void listbox_layout::create_structure()
 	auto &medium3_font = *MEDIUM3_FONT;
 
 	box_w = 0;
-	const auto &&fspacx = FSPACX();
-	const auto &&fspacx10 = fspacx(10);
-	const unsigned max_box_width = SWIDTH - (BORDERX * 2);
-	unsigned marquee_maxchars = UINT_MAX;
-	for (const auto i : unchecked_partial_range(item, nitems))
+	const unsigned max_box_width = listbox_max_box_width();
+	/* Only the widths are needed to size the box, and only until one
+	 * item is found which is too wide, since the box then takes the
+	 * full width of the screen.  The characters which fit of a too
+	 * wide item are found when the item is drawn.
+	 */
+	metrics.assign(nitems, {});
+	bool too_wide = false;
+	for (const auto i : xrange(nitems))
 	{
-		auto w = gr_get_string_size(medium3_font, i).width;
-		w += fspacx10;
+		const auto w = measure_item(i).width;
 		if (w > max_box_width)
 		{
-			unsigned mmc = 1;
-			for (;; ++mmc)
-			{
-				const auto w2 = gr_get_string_size(medium3_font, i, mmc).width;
-				if (w2 > max_box_width - fspacx10 || mmc > 128)
-					break;
-			}
-			/* mmc is now the shortest initial subsequence that is wider
-			 * than max_box_width.
-			 *
-			 * Next, search for whether any internal subsequences of
-			 * lesser length are also too wide.  This can happen if all
-			 * the initial characters are narrow, then characters
-			 * outside the initial subsequence are wide.
-			 */
-			for (auto j = i;;)
-			{
-				const auto w2 = gr_get_string_size(medium3_font, j, mmc).width;
-				if (w2 > max_box_width - fspacx10)
-				{
-					/* This subsequence is too long.  Reduce the length
-					 * and retry.
-					 */
-					if (!--mmc)
-						break;
-				}
-				else
-				{
-					/* This subsequence fits.  Move to the next
-					 * character.
-					 */
-					if (!*++j)
-						break;
-				}
-			}
-			w = max_box_width;
-			if (marquee_maxchars > mmc)
-				marquee_maxchars = mmc;
+			too_wide = true;
+			break;
 		}
 		if (box_w < w)
 			box_w = w;
@@ -1984,13 +2020,16 @@ void listbox_layout::create_structure()
 		title_height = h+FSPACY(5);
 	}
 
-	// The box is bigger than we can fit on the screen since at least one string is too long. Check how many chars we can fit on the screen (at least only - MEDIUM*_FONT is variable font!) so we can make a marquee-like effect.
-	if (marquee_maxchars != UINT_MAX)
+	// The box is bigger than we can fit on the screen since at least one string is too long.  Each such string is shown a part at a time, in a marquee-like effect.
+	if (too_wide)
 	{
 		box_w = max_box_width;
-		marquee = listbox::marquee::allocate(marquee_maxchars);
+		/* listbox_marquee_chars returns at most 129 */
+		marquee = listbox::marquee::allocate(130);
 		marquee->lasttime = timer_query();
 	}
+	else
+		marquee.reset();
 
 	const auto &&line_spacing = LINE_SPACING(medium3_font, *GAME_FONT);
 	const unsigned bordery2 = BORDERY * 2;
@@ -2053,7 +2092,8 @@ static window_event_result listbox_draw(listbox *lb)
 
 			const char *showstr;
 			std::size_t item_len;
-			if (lb->marquee && (item_len = strlen(lb->item[i])) > lb->marquee->maxchars)
+			unsigned marquee_chars;
+			if (lb->marquee && (marquee_chars = lb->measure_item(i).marquee_chars) != listbox_layout::item_metrics::unmeasured && (item_len = strlen(lb->item[i])) > marquee_chars)
 			{
 				showstr = lb->marquee->text;
 				static int prev_citem = -1;
@@ -2079,14 +2119,14 @@ static window_event_result listbox_draw(listbox *lb)
 						lb->marquee->pos = 0;
 						lb->marquee->scrollback = 0;
 					}
-					if (lb->marquee->pos + lb->marquee->maxchars - 1 > item_len) // reached end of string -> scroll backward
+					if (lb->marquee->pos + marquee_chars - 1 > item_len) // reached end of string -> scroll backward
 					{
-						lb->marquee->pos = item_len - lb->marquee->maxchars + 1;
+						lb->marquee->pos = item_len - marquee_chars + 1;
 						lb->marquee->scrollback = 1;
 					}
 					srcoffset = lb->marquee->pos;
 				}
-				snprintf(lb->marquee->text, lb->marquee->maxchars, "%s", lb->item[i] + srcoffset);
+				snprintf(lb->marquee->text, marquee_chars, "%s", lb->item[i] + srcoffset);
 			}
 			else
 			{
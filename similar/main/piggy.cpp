@@ -208,7 +208,6 @@ struct DiskSoundHeader
 
 namespace dsx {
 namespace {
-static void piggy_bitmap_page_out_all();
 #if defined(DXX_BUILD_DESCENT_II)
 
 /* the inverse of the d2 Textures array, but for the descent 1 pigfile.
@@ -1427,8 +1426,6 @@ void piggy_bitmap_page_in(GameBitmaps_array &GameBitmaps, const bitmap_index ent
 //@@#endif
 }
 
-namespace {
-
 void piggy_bitmap_page_out_all()
 {
 	Piggy_bitmap_cache_next = 0;
@@ -1446,11 +1443,15 @@ void piggy_bitmap_page_out_all()
 	}
 }
 
-}
-
-void piggy_load_level_data()
+void piggy_load_level_data(const bool keep_paged_bitmaps)
 {
-	piggy_bitmap_page_out_all();
+	if (keep_paged_bitmaps)
+	{
+		texmerge_flush();
+		rle_cache_flush();
+	}
+	else
+		piggy_bitmap_page_out_all();
 	paging_touch_all(Vclip);
 }
 
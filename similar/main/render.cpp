@@ -55,8 +55,13 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "timer.h"
 #include "effects.h"
 #include "playsave.h"
+#include "adaptive_detail.h"
+#include "console.h"
+#include "config.h"
+#include "gamefont.h"
 #if DXX_USE_OGL
 #include "ogl_init.h"
+#include "ogl_lighting.h"
 #endif
 #include "args.h"
 
@@ -80,9 +85,121 @@ using std::max;
 // (former) "detail level" values
 #if DXX_USE_OGL
 int Render_depth = MAX_RENDER_SEGS; //how many segments deep to render
+unsigned Render_resolution_scale = 100;
 #else
 int Render_depth = 20; //how many segments deep to render
 unsigned Max_linear_depth = 50; // Deepest segment at which linear interpolation will be used.
+unsigned Max_linear_depth_objects = 20;
+#endif
+unsigned Simple_model_threshhold_scale = 50;
+unsigned Max_debris_objects = 15;
+
+namespace {
+
+/* Values for each adaptive detail level.  The highest level is the
+ * default above; the others are scaled back the way the old detail level
+ * menu did.
+ */
+struct adaptive_detail_values
+{
+	int render_depth;
+#if DXX_USE_OGL
+	unsigned render_resolution_scale;
+#else
+	unsigned max_linear_depth;
+	unsigned max_linear_depth_objects;
+#endif
+	unsigned simple_model_threshhold_scale;
+	unsigned max_debris_objects;
+	fix dynamic_light_interval;
+};
+
+constexpr std::array<adaptive_detail_values, ADAPTIVE_DETAIL_LEVELS> Adaptive_detail_values{{
+#if DXX_USE_OGL
+	{ 15,  50,  4,  4, F1_0 / 15},
+	{ 25,  63,  8,  7, F1_0 / 20},
+	{ 40,  75, 16, 10, F1_0 / 30},
+	{ 60,  88, 25, 12, F1_0 / 45},
+	{MAX_RENDER_SEGS, 100, 50, 15, F1_0 / 60},
+#else
+	{  6,  3,  1,  4,  4, F1_0 / 15},
+	{  9,  5,  2,  8,  7, F1_0 / 20},
+	{ 12,  7,  3, 16, 10, F1_0 / 30},
+	{ 15, 10,  7, 25, 12, F1_0 / 45},
+	{ 20, 50, 20, 50, 15, F1_0 / 60},
+#endif
+}};
+
+static std::optional<adaptive_detail_controller> Adaptive_detail;
+
+static void set_adaptive_detail_level(const unsigned level)
+{
+	auto &v = Adaptive_detail_values[level];
+	Render_depth = v.render_depth;
+#if DXX_USE_OGL
+	Render_resolution_scale = v.render_resolution_scale;
+#else
+	Max_linear_depth = v.max_linear_depth;
+	Max_linear_depth_objects = v.max_linear_depth_objects;
+#endif
+	Simple_model_threshhold_scale = v.simple_model_threshhold_scale;
+	Max_debris_objects = v.max_debris_objects;
+	Dynamic_light_interval = v.dynamic_light_interval;
+}
+
+}
+
+void adaptive_detail_frame(const fix busy_time)
+{
+	if (!CGameArg.GfxAdaptiveFPS)
+		return;
+	/* The endlevel sequence sets its own render depth. */
+	if (Endlevel_sequence)
+		return;
+	if (!Adaptive_detail)
+	{
+		/* A target above the frame rate limit could never be met. */
+		const auto limit = CGameCfg.VSync ? MAXIMUM_FPS : CGameArg.SysMaxFPS;
+		const auto fps = std::min<unsigned>(CGameArg.GfxAdaptiveFPS, limit);
+		auto &c = Adaptive_detail.emplace(F1_0 / fps, CGameArg.GfxAdaptiveMinDetail, CGameArg.GfxAdaptiveMaxDetail);
+		set_adaptive_detail_level(c.level());
+		con_printf(CON_VERBOSE, "Adaptive detail: target %u FPS, using level %u", fps, c.level());
+		return;
+	}
+	auto &c = *Adaptive_detail;
+	const auto change = c.update(busy_time);
+	if (change == adaptive_detail_change::none)
+		return;
+	set_adaptive_detail_level(c.level());
+	con_printf(CON_VERBOSE, "Adaptive detail: %s to level %u, average frame %.1fms, target %.1fms", change == adaptive_detail_change::lowered ? "lowered" : "raised", c.level(), f2fl(c.average_frame_time()) * 1000, f2fl(c.target_frame_time()) * 1000);
+}
+
+void show_adaptive_detail_stats(grs_canvas &canvas)
+{
+	if (!Adaptive_detail)
+		return;
+	auto &c = *Adaptive_detail;
+	const auto &game_font = *GAME_FONT;
+	gr_set_fontcolor(canvas, BM_XRGB(63, 63, 63), -1);
+	gr_printf(canvas, game_font, FSPACX(2), FSPACY(1) + LINE_SPACING(game_font, game_font) * 6, "detail: level %u, frame %.1fms of %.1fms, depth %i"
+#if DXX_USE_OGL
+		", resolution %u%%"
+#endif
+		, c.level(), f2fl(c.average_frame_time()) * 1000, f2fl(c.target_frame_time()) * 1000, Render_depth
+#if DXX_USE_OGL
+		, Render_resolution_scale
+#endif
+		);
+}
+
+#if !DXX_USE_OGL
+void show_span_stats(grs_canvas &canvas)
+{
+	const auto &game_font = *GAME_FONT;
+	gr_set_fontcolor(canvas, BM_XRGB(63, 63, 63), -1);
+	gr_printf(canvas, game_font, FSPACX(2), FSPACY(1) + LINE_SPACING(game_font, game_font) * 7, "spans: %u pixels shaded, %u skipped", Tmap_span_stats.pixels_shaded, Tmap_span_stats.pixels_skipped);
+	Tmap_span_stats = {};
+}
 #endif
 
 //used for checking if points have been rotated
@@ -102,6 +219,10 @@ fix Render_zoom = 0x9000;					//the player's zoom factor
 
 namespace {
 static uint16_t s_current_generation;
+#if !DXX_USE_OGL
+//coverage records of the faces of the segment being rendered
+static per_side_array<std::array<tmap_coverage_face, 2>> *Segment_coverage_faces;
+#endif
 #ifndef NDEBUG
 static std::bitset<MAX_OBJECTS> object_rendered;
 #endif
@@ -216,7 +337,7 @@ static inline int is_alphablend_eclip(int eclip_num)
 //	they are used for our hideously hacked in headlight system.
 //	vp is a pointer to vertex ids.
 //	tmap1, tmap2 are texture map ids.  tmap2 is the pasty one.
-static void render_face(grs_canvas &canvas, const shared_segment &segp, const sidenum_t sidenum, const unsigned nv, const std::array<vertnum_t, 4> &vp, const texture1_value tmap1, const texture2_value tmap2, std::array<g3s_uvl, 4> uvl_copy, const WALL_IS_DOORWAY_result_t wid_flags)
+static void render_face(grs_canvas &canvas, const vcsegptridx_t segp, const sidenum_t sidenum, const unsigned facenum, const unsigned nv, const std::array<vertnum_t, 4> &vp, const texture1_value tmap1, const texture2_value tmap2, std::array<g3s_uvl, 4> uvl_copy, const WALL_IS_DOORWAY_result_t wid_flags)
 {
 	auto &LevelUniqueControlCenterState = LevelUniqueObjectState.ControlCenterState;
 	auto &TmapInfo = LevelUniqueTmapInfoState.TmapInfo;
@@ -231,16 +352,25 @@ static void render_face(grs_canvas &canvas, const shared_segment &segp, const si
 		pointlist[i] = &Segment_points[vp[i]];
 	}
 
+#if !DXX_USE_OGL
+	(void)facenum;
+#endif
 #if defined(DXX_BUILD_DESCENT_I)
+#if !DXX_USE_OGL
 	(void)segp;
+#endif
 	(void)wid_flags;
-#if !DXX_USE_EDITOR
+#if !DXX_USE_EDITOR && !DXX_USE_OGL
 	(void)sidenum;
 #endif
 #elif defined(DXX_BUILD_DESCENT_II)
 	//handle cloaked walls
 	if (wid_flags & WALL_IS_DOORWAY_FLAG::cloaked) {
-		const auto wall_num = segp.shared_segment::sides[sidenum].wall_num;
+#if !DXX_USE_OGL
+		if (tmap_coverage_recording())
+			return;
+#endif
+		const auto wall_num = segp->shared_segment::sides[sidenum].wall_num;
 		auto &Walls = LevelUniqueWallSubsystemState.Walls;
 		auto &vcwallptr = Walls.vcptr;
 		gr_settransblend(canvas, static_cast<gr_fade_level>(vcwallptr(wall_num)->cloak_value), gr_blend::normal);
@@ -286,6 +416,16 @@ static void render_face(grs_canvas &canvas, const shared_segment &segp, const si
 
 	assert(!bm->get_flag_mask(BM_FLAG_PAGED_OUT));
 
+#if !DXX_USE_OGL
+	if (tmap_coverage_recording())
+	{
+		//only faces which hide everything behind them are recorded, and lighting cannot change which pixels they cover
+		if (!bm->get_flag_mask(BM_FLAG_TRANSPARENT | BM_FLAG_SUPER_TRANSPARENT) && !(PlayerCfg.AlphaBlendEClips && is_alphablend_eclip(TmapInfo[get_texture_index(tmap1)].eclip_num)))
+			g3_draw_tmap(canvas, nv, pointlist, uvl_copy, std::array<g3s_lrgb, 4>{}, *bm);
+		return;
+	}
+#endif
+
 	std::array<g3s_lrgb, 4>		dyn_light;
 #if defined(DXX_BUILD_DESCENT_I)
 	const auto Seismic_tremor_magnitude = 0;
@@ -357,7 +497,11 @@ static void render_face(grs_canvas &canvas, const shared_segment &segp, const si
 #endif
 
 #if DXX_USE_OGL
-		if (bm2){
+		if (!cheats.acid && ogl_draw_level_face(canvas, segp, sidenum, facenum, nv, dyn_light, *bm, bm2, get_texture_rotation_low(tmap2)))
+		{
+			/* drawn from the level mesh */
+		}
+		else if (bm2){
 			g3_draw_tmap_2(canvas, nv, pointlist, uvl_copy, dyn_light, *bm, *bm2, get_texture_rotation_low(tmap2));
 		}else
 #endif
@@ -453,7 +597,20 @@ static inline void check_render_face(grs_canvas &canvas, std::index_sequence<N..
 	const std::array<g3s_uvl, 4> uvl_copy{{
 		{uvlp[N].u, uvlp[N].v, uvlp[N].l}...
 	}};
-	render_face(canvas, segnum, sidenum, nv, vp, tmap1, tmap2, uvl_copy, wid_flags);
+#if DXX_USE_OGL
+	render_face(canvas, segnum, sidenum, facenum, nv, vp, tmap1, tmap2, uvl_copy, wid_flags);
+#else
+	auto &coverage_face = (*Segment_coverage_faces)[sidenum][facenum];
+	if (tmap_coverage_recording())
+	{
+		coverage_face = tmap_coverage_record_face();
+		render_face(canvas, segnum, sidenum, facenum, nv, vp, tmap1, tmap2, uvl_copy, wid_flags);
+		return;
+	}
+	tmap_coverage_replay_face(coverage_face);
+	render_face(canvas, segnum, sidenum, facenum, nv, vp, tmap1, tmap2, uvl_copy, wid_flags);
+	tmap_coverage_replay_face(tmap_coverage_face::none);
+#endif
 	check_face(canvas, segnum, sidenum, facenum, nv, vp, tmap1, tmap2, uvl_copy);
 }
 
@@ -1586,6 +1743,34 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 		}
 	}
 #if !DXX_USE_OGL
+	/* Visit the segments nearest first to record which parts of each
+	 * opaque face are not hidden by nearer opaque faces, then draw
+	 * farthest first as usual, texturing only those parts.  Objects and
+	 * transparent faces are still drawn in full, in the usual order, so
+	 * the image is unchanged.
+	 */
+	const bool span_coverage = !_search_mode && !CGameArg.DbgSdlNoSpanCoverage;
+	if (span_coverage)
+	{
+		tmap_coverage_start_recording(canvas.cv_bitmap);
+		range_for (const auto segnum, render_range)
+		{
+			if (segnum == segment_none || (!_search_mode && visited[segnum] == 3))
+				continue;
+			auto &srsm = rstate.render_seg_map[segnum];
+			Current_seg_depth = srsm.Seg_depth;
+			{
+				const auto &rw = srsm.render_window;
+				Window_clip_left  = rw.left;
+				Window_clip_top   = rw.top;
+				Window_clip_right = rw.right;
+				Window_clip_bot   = rw.bot;
+			}
+			Segment_coverage_faces = &srsm.coverage_faces;
+			render_segment(vcvertptr, vcwallptr, Viewer_eye, *grd_curcanv, vcsegptridx(segnum));
+		}
+		tmap_coverage_start_replay();
+	}
 	range_for (const auto segnum, reversed_render_range)
 	{
 		// Interpolation_method = 0;
@@ -1604,6 +1789,7 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 				Window_clip_bot   = rw.bot;
 			}
 
+			Segment_coverage_faces = &srsm.coverage_faces;
 			render_segment(vcvertptr, vcwallptr, Viewer_eye, *grd_curcanv, vcsegptridx(segnum));
 			visited[segnum]=3;
 			if (srsm.objects.empty())
@@ -1627,6 +1813,8 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 
 		}
 	}
+	if (span_coverage)
+		tmap_coverage_stop();
 #else
         // Two pass rendering. Since sprites and some level geometry can have transparency (blending), we need some fancy sorting.
         // GL_DEPTH_TEST helps to sort everything in view but we should make sure translucent sprites are rendered after geometry to prevent them to turn walls invisible (if rendered BEFORE geometry but still in FRONT of it).
@@ -1635,6 +1823,8 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 	auto &vcvertptr = Vertices.vcptr;
 	auto &Walls = LevelUniqueWallSubsystemState.Walls;
 	auto &vcwallptr = Walls.vcptr;
+	ogl_light_shader_begin_frame(PlayerCfg.AlphaEffects ? .93 : 1);
+	ogl_level_mesh_begin_frame();
         // First Pass: render opaque level geometry and level geometry with alpha pixels (high Alpha-Test func)
 	range_for (const auto segnum, reversed_render_range)
 	{
@@ -1741,6 +1931,8 @@ void render_mine(grs_canvas &canvas, const vms_vector &Viewer_eye, const vcsegid
 			}
 		}
 	}
+	ogl_level_mesh_end_frame();
+	ogl_light_shader_end_frame();
 #endif
 
 	// -- commented out by mk on 09/14/94...did i do a good thing??  object_render_targets();
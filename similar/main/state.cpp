@@ -2169,7 +2169,7 @@ int state_restore_all_sub(const d_level_shared_destructible_light_state &LevelSh
 	//Restore exploding wall info
 	if (version >= 10) {
 		unsigned i = PHYSFSX_readSXE32(fp, swap);
-		expl_wall_read_n_swap(Walls.vmptr, fp, swap, i);
+		expl_wall_read_n_swap(Walls.vmptridx, fp, swap, i);
 	}
 #endif
 	}
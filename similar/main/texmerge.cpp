@@ -42,6 +42,8 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 
 #if DXX_USE_OGL
 #include "ogl_init.h"
+#else
+#include "texmap.h"
 #endif
 #define MAX_NUM_CACHE_BITMAPS 10
 
@@ -250,6 +252,8 @@ grs_bitmap &texmerge_get_cached_bitmap(const texture1_value tmap_bottom, const t
 	least_recently_used->bitmap = gr_create_bitmap(bitmap_bottom->bm_w,  bitmap_bottom->bm_h);
 #if DXX_USE_OGL
 	ogl_freebmtexture(*least_recently_used->bitmap.get());
+#else
+	tmap_mip_invalidate(*least_recently_used->bitmap.get());
 #endif
 
 	auto &expanded_top_bmp = *rle_expand_texture(*bitmap_top);
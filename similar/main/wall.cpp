@@ -25,6 +25,7 @@ COPYRIGHT 1993-1999 PARALLAX SOFTWARE CORPORATION.  ALL RIGHTS RESERVED.
 #include "multi.h"
 #include "gameseq.h"
 #include "physfs-serial.h"
+#include "level_reader.h"
 #include "gameseg.h"
 #include "hudmsg.h"
 #include "effects.h"
@@ -1390,22 +1391,25 @@ static void process_exploding_walls(const d_robot_info_array &Robot_info)
 {
 	if (Newdemo_state == ND_STATE_PLAYBACK)
 		return;
-	if (unsigned num_exploding_walls = Num_exploding_walls)
+	if (Exploding_walls.empty())
+		return;
+	auto &Walls = LevelUniqueWallSubsystemState.Walls;
+	auto &vmwallptr = Walls.vmptr;
+	/* A wall which finishes exploding also stops its partner, and the
+	 * explosions may blast more walls, which explode_wall appends.  Walk
+	 * only the walls which were exploding at the start of the frame, then
+	 * drop the finished walls and restore ascending order.
+	 */
+	for (std::size_t i = 0, n = Exploding_walls.size(); i != n; ++i)
 	{
-		auto &Walls = LevelUniqueWallSubsystemState.Walls;
-		range_for (auto &&wp, Walls.vmptr)
-		{
-			auto &w1 = *wp;
-			if (w1.flags & wall_flag::exploding)
-			{
-				assert(num_exploding_walls);
-				const auto n = do_exploding_wall_frame(Robot_info, w1);
-				num_exploding_walls -= n;
-				if (!num_exploding_walls)
-					break;
-			}
-		}
+		auto &w1 = *vmwallptr(Exploding_walls[i]);
+		if (w1.flags & wall_flag::exploding)
+			do_exploding_wall_frame(Robot_info, w1);
 	}
+	std::erase_if(Exploding_walls, [&vmwallptr](const wallnum_t wn) {
+		return !(vmwallptr(wn)->flags & wall_flag::exploding);
+	});
+	std::sort(Exploding_walls.begin(), Exploding_walls.end());
 }
 
 }
@@ -1689,11 +1693,11 @@ DEFINE_SERIAL_UDT_TO_MESSAGE(wrap_v16_wall, w, _SERIAL_UDT_WALL_V16_MEMBERS(w.w-
 ASSERT_SERIAL_UDT_MESSAGE_SIZE(wrap_v16_wall, 9);
 
 /*
- * reads a v16_wall structure from a PHYSFS_File
+ * reads a v16_wall structure from a level
  */
-void v16_wall_read(PHYSFS_File *fp, v16_wall &w)
+void v16_wall_read(level_reader &r, v16_wall &w)
 {
-	PHYSFSX_serialize_read(fp, w);
+	r.serialize_read(w);
 }
 
 struct wrap_v19_wall
@@ -1708,11 +1712,11 @@ ASSERT_SERIAL_UDT_MESSAGE_SIZE(v19_wall, 21);
 ASSERT_SERIAL_UDT_MESSAGE_SIZE(wrap_v19_wall, 21);
 
 /*
- * reads a v19_wall structure from a PHYSFS_File
+ * reads a v19_wall structure from a level
  */
-void v19_wall_read(PHYSFS_File *fp, v19_wall &w)
+void v19_wall_read(level_reader &r, v19_wall &w)
 {
-	PHYSFSX_serialize_read(fp, w);
+	r.serialize_read(w);
 }
 
 #if defined(DXX_BUILD_DESCENT_I)
@@ -1724,13 +1728,22 @@ DEFINE_SERIAL_UDT_TO_MESSAGE(wall, w, (serial::sign_extend<int>(w.segnum), w.sid
 ASSERT_SERIAL_UDT_MESSAGE_SIZE(wall, 24);
 
 namespace dsx {
+/*
+ * reads a wall structure from a level
+ */
+void wall_read(level_reader &r, wall &w)
+{
+	r.serialize_read(w);
+	w.flags &= ~wall_flag::exploding;
+}
+
 /*
  * reads a wall structure from a PHYSFS_File
  */
 void wall_read(PHYSFS_File *fp, wall &w)
 {
-	PHYSFSX_serialize_read(fp, w);
-	w.flags &= ~wall_flag::exploding;
+	level_reader r(fp);
+	wall_read(r, w);
 }
 
 }
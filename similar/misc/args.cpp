@@ -11,6 +11,7 @@
  *
  */
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <stdlib.h>
@@ -24,6 +25,7 @@
 #include "game.h"
 #include "console.h"
 #include "mission.h"
+#include "adaptive_detail.h"
 #if DXX_USE_UDP
 #include "net_udp.h"
 #endif
@@ -141,8 +143,12 @@ static void arg_port_number(Arglist::iterator &pp, Arglist::const_iterator end,
 static void InitGameArg()
 {
 	CGameArg.SysMaxFPS = MAXIMUM_FPS;
+	CGameArg.GfxAdaptiveMaxDetail = ADAPTIVE_DETAIL_LEVELS - 1;
+	CGameArg.SysExportDemoFPS = 30;
 #if DXX_USE_UDP
 	CGameArg.MplUdpHostAddr = UDP_MANUAL_ADDR_DEFAULT;
+	CGameArg.MplUdpInterpDelay = UDP_INTERP_DELAY_DEFAULT;
+	CGameArg.MplUdpSyncWindow = UDP_OBJECT_WINDOW_DEFAULT;
 #if DXX_USE_TRACKER
 	CGameArg.MplTrackerAddr = TRACKER_ADDR_DEFAULT;
 	CGameArg.MplTrackerPort = TRACKER_PORT_DEFAULT;
@@ -178,6 +184,9 @@ static void InitGameArg()
 {
 #if defined(DXX_BUILD_DESCENT_II)
 	GameArg.SndDigiSampleRate = sound_sample_rate::_22k;
+	GameArg.GfxInsetInterval = INSET_VIEW_INTERVAL_DEFAULT;
+	GameArg.GfxInsetScale = 1;
+	GameArg.GfxMovieThreads = 1;
 #endif
 	::dcx::InitGameArg();
 }
@@ -230,6 +239,16 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 			CGameArg.SysRecordDemoNameTemplate = arg_string(pp, end);
 		else if (!d_stricmp(p, "-auto-record-demo"))
 			CGameArg.SysAutoRecordDemo = true;
+		else if (!d_stricmp(p, "-record-packed-demo"))
+			CGameArg.SysRecordPackedDemo = true;
+		else if (!d_stricmp(p, "-pack-demos"))
+			CGameArg.SysPackDemos = true;
+		else if (!d_stricmp(p, "-export-demo"))
+			CGameArg.SysExportDemo = arg_string(pp, end);
+		else if (!d_stricmp(p, "-export-demo-file"))
+			CGameArg.SysExportDemoFile = arg_string(pp, end);
+		else if (!d_stricmp(p, "-export-demo-fps"))
+			CGameArg.SysExportDemoFPS = std::clamp(arg_integer(pp, end), 1l, static_cast<long>(MAXIMUM_FPS));
 		else if (!d_stricmp(p, "-window"))
 			CGameArg.SysWindow = true;
 		else if (!d_stricmp(p, "-noborders"))
@@ -279,11 +298,23 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 
 		else if (!d_stricmp(p, "-lowresfont"))
 			CGameArg.GfxSkipHiresFNT = true;
+		else if (!d_stricmp(p, "-adaptivefps"))
+			CGameArg.GfxAdaptiveFPS = std::clamp(arg_integer(pp, end), 0l, static_cast<long>(MAXIMUM_FPS));
+		else if (!d_stricmp(p, "-adaptivemin"))
+			CGameArg.GfxAdaptiveMinDetail = std::clamp(arg_integer(pp, end), 0l, static_cast<long>(ADAPTIVE_DETAIL_LEVELS - 1));
+		else if (!d_stricmp(p, "-adaptivemax"))
+			CGameArg.GfxAdaptiveMaxDetail = std::clamp(arg_integer(pp, end), 0l, static_cast<long>(ADAPTIVE_DETAIL_LEVELS - 1));
 #if defined(DXX_BUILD_DESCENT_II)
 		else if (!d_stricmp(p, "-lowresgraphics"))
 			GameArg.GfxSkipHiresGFX	= 1;
 		else if (!d_stricmp(p, "-lowresmovies"))
 			GameArg.GfxSkipHiresMovie 		= 1;
+		else if (!d_stricmp(p, "-moviethreads"))
+			GameArg.GfxMovieThreads = std::clamp(arg_integer(pp, end), 1l, 8l);
+		else if (!d_stricmp(p, "-insetinterval"))
+			GameArg.GfxInsetInterval = std::clamp(arg_integer(pp, end), 1l, 60l);
+		else if (!d_stricmp(p, "-insetscale"))
+			GameArg.GfxInsetScale = std::clamp(arg_integer(pp, end), 1l, 8l);
 #endif
 #if DXX_USE_OGL
 	// OpenGL Options
@@ -296,6 +327,12 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 			CGameArg.OglSyncWait = arg_integer(pp, end);
 		else if (!d_stricmp(p, "-gl_darkedges"))
 			CGameArg.OglDarkEdges = true;
+		else if (!d_stricmp(p, "-gl_lightshader"))
+			CGameArg.OglLightShader = true;
+		else if (!d_stricmp(p, "-gl_nolevelmesh"))
+			CGameArg.OglNoLevelMesh = true;
+		else if (!d_stricmp(p, "-gl_texturebudget"))
+			CGameArg.OglTextureBudget = arg_integer(pp, end);
 #if DXX_USE_STEREOSCOPIC_RENDER
 		else if (!d_stricmp(p, "-gl_stereo"))
 			CGameArg.OglStereo = true;
@@ -318,6 +355,10 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 		{
 			arg_port_number(pp, end, CGameArg.MplUdpMyPort, false);
 		}
+		else if (!d_stricmp(p, "-udp_interpdelay"))
+			CGameArg.MplUdpInterpDelay = std::clamp(arg_integer(pp, end), 0l, 500l);
+		else if (!d_stricmp(p, "-udp_syncwindow"))
+			CGameArg.MplUdpSyncWindow = std::clamp(arg_integer(pp, end), 1l, static_cast<long>(UDP_OBJECT_WINDOW_MAX));
 		else if (!d_stricmp(p, "-no-tracker"))
 		{
 			/* Always recognized.  No-op if tracker support compiled
@@ -404,6 +445,10 @@ static void ReadCmdArgs(Inilist &ini, Arglist &Args)
 			CGameArg.DbgSdlHWSurface = true;
 		else if (!d_stricmp(p, "-asyncblit"))
 			CGameArg.DbgSdlASyncBlit = true;
+		else if (!d_stricmp(p, "-nomipmap"))
+			CGameArg.DbgSdlNoMipmap = true;
+		else if (!d_stricmp(p, "-nospancoverage"))
+			CGameArg.DbgSdlNoSpanCoverage = true;
 #endif
 		else if (!d_stricmp(p, "-ini"))
 		{